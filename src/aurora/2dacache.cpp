@@ -0,0 +1,326 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A persistent cache of precompiled 2DA tables.
+ */
+
+/* Each cache file is a simple little-endian binary file:
+ *
+ *  - uint32 ID ('X2DA')
+ *  - uint32 version
+ *  - key, string
+ *  - uint32 number of signature values
+ *  - uint64 signature values
+ *  - uint32 2DA file ID
+ *  - uint32 2DA file version
+ *  - default string, string
+ *  - int32 default int
+ *  - uint32 default float
+ *  - uint32 number of columns
+ *  - uint32 number of rows
+ *  - column headers, strings
+ *  - for each column:
+ *    - int32 ints, one per row
+ *    - uint32 floats, one per row
+ *    - uint8 empty flags, one per row
+ *    - cell strings, one per row
+ *
+ * Strings are stored as a uint32 length, followed by that many bytes
+ * of UTF-8 data. Floats are stored as IEEE 754 single precision values.
+ *
+ * The version needs to be bumped whenever the format changes.
+ */
+
+#include <cstring>
+#include <new>
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/scopedptr.h"
+#include "src/common/hash.h"
+#include "src/common/filepath.h"
+#include "src/common/writefile.h"
+#include "src/common/mappedfile.h"
+
+#include "src/aurora/2dacache.h"
+#include "src/aurora/2dafile.h"
+
+static const uint32 kCacheID = MKTAG('X', '2', 'D', 'A');
+static const uint32 kVersion = 1;
+
+namespace Aurora {
+
+/** Reads values out of cached data, making sure not to read past its end. */
+class TwoDACacheReader {
+public:
+	TwoDACacheReader(const byte *data, size_t size) : _data(data), _size(size), _pos(0) {
+	}
+
+	/** Return the next count values of size bytes each, and skip past them. */
+	const byte *get(size_t count, size_t size) {
+		if (count > ((_size - _pos) / size))
+			throw Common::Exception(Common::kReadError);
+
+		const byte *data = _data + _pos;
+		_pos += count * size;
+
+		return data;
+	}
+
+	/** Return the number of bytes left to read. */
+	size_t remaining() const {
+		return _size - _pos;
+	}
+
+	uint32 readUint32() {
+		return READ_LE_UINT32(get(1, 4));
+	}
+
+	uint64 readUint64() {
+		return READ_LE_UINT64(get(1, 8));
+	}
+
+	Common::UString readString() {
+		const uint32 length = readUint32();
+
+		return Common::UString(reinterpret_cast<const char *>(get(length, 1)), length);
+	}
+
+private:
+	const byte *_data;
+	size_t _size;
+	size_t _pos;
+};
+
+static void writeString(Common::WriteStream &cache, const Common::UString &string) {
+	const size_t length = std::strlen(string.c_str());
+
+	cache.writeUint32LE(length);
+	cache.write(string.c_str(), length);
+}
+
+
+TwoDACache::TwoDACache() {
+}
+
+TwoDACache::~TwoDACache() {
+}
+
+void TwoDACache::setDirectory(const Common::UString &directory) {
+	_directory = directory;
+}
+
+bool TwoDACache::isEnabled() const {
+	return !_directory.empty();
+}
+
+Common::UString TwoDACache::getKey(const Common::UString &name, const Common::UString &file) {
+	return file + ":" + name.toLower();
+}
+
+Common::UString TwoDACache::getCacheFile(const Common::UString &key) const {
+	return _directory + "/" + Common::formatHash(Common::hashString(key, Common::kHashFNV64)) + ".x2da";
+}
+
+TwoDAFile *TwoDACache::get(const Common::UString &name, const Common::UString &file,
+                           const IndexCache::Signature &signature) const {
+
+	if (!isEnabled())
+		return 0;
+
+	const Common::UString key       = getKey(name, file);
+	const Common::UString cacheFile = getCacheFile(key);
+
+	if (!Common::FilePath::isRegularFile(cacheFile))
+		return 0;
+
+	try {
+		Common::FileMapping cache(cacheFile);
+
+		return read(cache.getData(), cache.getSize(), key, signature);
+
+	} catch (Common::Exception &e) {
+		e.add("Failed to read cached 2DA \"%s\" from \"%s\"", name.c_str(), cacheFile.c_str());
+		Common::printException(e, "WARNING: ");
+
+	} catch (std::bad_alloc &) {
+		warning("Failed to read cached 2DA \"%s\" from \"%s\": Out of memory", name.c_str(), cacheFile.c_str());
+	}
+
+	return 0;
+}
+
+void TwoDACache::set(const Common::UString &name, const Common::UString &file,
+                     const IndexCache::Signature &signature, const TwoDAFile &twoda) const {
+
+	// Nothing worth caching, and the row count of such a table couldn't be checked when reading it
+	if (!isEnabled() || (twoda.getColumnCount() == 0))
+		return;
+
+	const Common::UString key       = getKey(name, file);
+	const Common::UString cacheFile = getCacheFile(key);
+
+	Common::UString tempFile;
+
+	try {
+		Common::FilePath::createDirectories(_directory);
+
+		/* Write into a temporary file first, and only then replace the cache file with it.
+		 * That way, another instance reading the cache file never sees it half-written. */
+		tempFile = Common::FilePath::getUniquePath(cacheFile);
+
+		{
+			Common::WriteFile cache(tempFile);
+
+			write(cache, key, signature, twoda);
+
+			cache.flush();
+			cache.close();
+		}
+
+		Common::FilePath::renameFile(tempFile, cacheFile);
+
+	} catch (Common::Exception &e) {
+		if (!tempFile.empty())
+			Common::FilePath::removeFile(tempFile);
+
+		e.add("Failed to write cached 2DA \"%s\" to \"%s\"", name.c_str(), cacheFile.c_str());
+		Common::printException(e, "WARNING: ");
+	}
+}
+
+TwoDAFile *TwoDACache::read(const byte *data, size_t size, const Common::UString &key,
+                            const IndexCache::Signature &signature) {
+
+	TwoDACacheReader cache(data, size);
+
+	if (size < 8)
+		return 0;
+
+	const uint32 id      = READ_BE_UINT32(cache.get(1, 4));
+	const uint32 version = cache.readUint32();
+
+	// An old cache file is silently replaced
+	if ((id != kCacheID) || (version != kVersion))
+		return 0;
+
+	// So is the cache file of another resource, or of an older version of this resource
+	if (cache.readString() != key)
+		return 0;
+
+	// A signature that can't fit into the rest of the file can't be valid either
+	const uint32 signatureSize = cache.readUint32();
+	if (signatureSize > (cache.remaining() / 8))
+		return 0;
+
+	IndexCache::Signature cachedSignature(signatureSize);
+	for (IndexCache::Signature::iterator s = cachedSignature.begin(); s != cachedSignature.end(); ++s)
+		*s = cache.readUint64();
+
+	if (cachedSignature != signature)
+		return 0;
+
+	Common::ScopedPtr<TwoDAFile> twoda(new TwoDAFile);
+
+	twoda->_id      = cache.readUint32();
+	twoda->_version = cache.readUint32();
+
+	twoda->_defaultString = cache.readString();
+	twoda->_defaultInt    = (int32) cache.readUint32();
+	twoda->_defaultFloat  = convertIEEEFloat(cache.readUint32());
+
+	const uint32 columnCount = cache.readUint32();
+	const uint32 rowCount    = cache.readUint32();
+
+	// Each column needs at least 4 bytes for its header. Tables without columns are never cached
+	if ((columnCount == 0) || (columnCount > (size / 4)))
+		throw Common::Exception("Invalid column count %u", columnCount);
+
+	twoda->_headers.resize(columnCount);
+	for (std::vector<Common::UString>::iterator h = twoda->_headers.begin(); h != twoda->_headers.end(); ++h)
+		*h = cache.readString();
+
+	twoda->_columns.resize(columnCount);
+	for (std::vector<TwoDAFile::Column>::iterator c = twoda->_columns.begin(); c != twoda->_columns.end(); ++c) {
+		const byte *ints   = cache.get(rowCount, 4);
+		const byte *floats = cache.get(rowCount, 4);
+		const byte *empty  = cache.get(rowCount, 1);
+
+		c->ints.resize(rowCount);
+		c->floats.resize(rowCount);
+		c->empty.resize(rowCount);
+		c->strings.resize(rowCount);
+
+		for (uint32 i = 0; i < rowCount; i++) {
+			c->ints  [i] = (int32) READ_LE_UINT32(ints + i * 4);
+			c->floats[i] = convertIEEEFloat(READ_LE_UINT32(floats + i * 4));
+			c->empty [i] = empty[i] != 0;
+		}
+
+		for (std::vector<Common::UString>::iterator s = c->strings.begin(); s != c->strings.end(); ++s)
+			*s = cache.readString();
+	}
+
+	twoda->createHeaderMap();
+	twoda->createRows(rowCount);
+
+	return twoda.release();
+}
+
+void TwoDACache::write(Common::WriteStream &cache, const Common::UString &key,
+                       const IndexCache::Signature &signature, const TwoDAFile &twoda) {
+
+	cache.writeUint32BE(kCacheID);
+	cache.writeUint32LE(kVersion);
+
+	writeString(cache, key);
+
+	cache.writeUint32LE(signature.size());
+	for (IndexCache::Signature::const_iterator s = signature.begin(); s != signature.end(); ++s)
+		cache.writeUint64LE(*s);
+
+	cache.writeUint32LE(twoda._id);
+	cache.writeUint32LE(twoda._version);
+
+	writeString(cache, twoda._defaultString);
+	cache.writeUint32LE((uint32) twoda._defaultInt);
+	cache.writeIEEEFloatLE(twoda._defaultFloat);
+
+	cache.writeUint32LE(twoda._columns.size());
+	cache.writeUint32LE(twoda._rows.size());
+
+	for (std::vector<Common::UString>::const_iterator h = twoda._headers.begin(); h != twoda._headers.end(); ++h)
+		writeString(cache, *h);
+
+	for (std::vector<TwoDAFile::Column>::const_iterator c = twoda._columns.begin(); c != twoda._columns.end(); ++c) {
+		for (std::vector<int32>::const_iterator i = c->ints.begin(); i != c->ints.end(); ++i)
+			cache.writeUint32LE((uint32) *i);
+		for (std::vector<float>::const_iterator f = c->floats.begin(); f != c->floats.end(); ++f)
+			cache.writeIEEEFloatLE(*f);
+		for (std::vector<bool>::const_iterator e = c->empty.begin(); e != c->empty.end(); ++e)
+			cache.writeByte(*e ? 1 : 0);
+
+		for (std::vector<Common::UString>::const_iterator s = c->strings.begin(); s != c->strings.end(); ++s)
+			writeString(cache, *s);
+	}
+}
+
+} // End of namespace Aurora
@@ -0,0 +1,102 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A persistent cache of precompiled 2DA tables.
+ */
+
+#ifndef AURORA_2DACACHE_H
+#define AURORA_2DACACHE_H
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+
+#include "src/aurora/indexcache.h"
+
+namespace Common {
+	class WriteStream;
+}
+
+namespace Aurora {
+
+class TwoDAFile;
+
+/** A persistent, on-disk cache of precompiled 2DA tables.
+ *
+ *  Reading an ASCII 2DA means tokenizing the whole text and parsing every
+ *  cell. The TwoDACache stores a 2DA after it has been read in a compact
+ *  binary form, with all cells already split and parsed into numbers. In
+ *  later sessions, the file is mapped into memory and the 2DA is recreated
+ *  out of it without any tokenizing or parsing.
+ *
+ *  Recreating the 2DA still copies every cell out of the mapping, since a
+ *  TwoDAFile owns its strings and number arrays. Loading a cached table is
+ *  therefore faster than reading the ASCII 2DA, but still linear in its size.
+ *
+ *  Each table gets its own file in the cache directory, and is identified
+ *  by the resource the 2DA was read from, see
+ *  ResourceManager::getResourceIdentity(). A cached table whose resource
+ *  changed is ignored and replaced.
+ */
+class TwoDACache : boost::noncopyable {
+public:
+	TwoDACache();
+	~TwoDACache();
+
+	/** Set the directory the cache files are kept in. An empty directory disables the cache. */
+	void setDirectory(const Common::UString &directory);
+
+	/** Is the cache in use? */
+	bool isEnabled() const;
+
+	/** Recreate a 2DA out of the cache.
+	 *
+	 *  @param  name The name of the 2DA.
+	 *  @param  file The path of the file the 2DA resource is found in.
+	 *  @param  signature The signature identifying the 2DA resource.
+	 *  @return The cached 2DA, or 0 if there's no cached 2DA for this resource.
+	 */
+	TwoDAFile *get(const Common::UString &name, const Common::UString &file,
+	               const IndexCache::Signature &signature) const;
+
+	/** Write a 2DA into the cache, replacing an older one. */
+	void set(const Common::UString &name, const Common::UString &file,
+	         const IndexCache::Signature &signature, const TwoDAFile &twoda) const;
+
+private:
+	Common::UString _directory;
+
+	/** Return the key identifying the cache file of a 2DA. */
+	static Common::UString getKey(const Common::UString &name, const Common::UString &file);
+
+	/** Return the path of the cache file for a key. */
+	Common::UString getCacheFile(const Common::UString &key) const;
+
+	static TwoDAFile *read(const byte *data, size_t size, const Common::UString &key,
+	                       const IndexCache::Signature &signature);
+	static void write(Common::WriteStream &cache, const Common::UString &key,
+	                  const IndexCache::Signature &signature, const TwoDAFile &twoda);
+};
+
+} // End of namespace Aurora
+
+#endif // AURORA_2DACACHE_H
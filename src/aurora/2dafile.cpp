@@ -27,6 +27,9 @@
  */
 
 #include <cassert>
+#include <cerrno>
+#include <cstdlib>
+#include <cctype>
 
 #include "src/common/util.h"
 #include "src/common/error.h"
@@ -50,93 +53,119 @@ static const uint32 kVersion2b = MKTAG('V', '2', '.', 'b');
 
 namespace Aurora {
 
-TwoDARow::TwoDARow(TwoDAFile &parent) : _parent(&parent) {
+TwoDARow::TwoDARow(TwoDAFile &parent, size_t index) : _parent(&parent), _index(index) {
 }
 
 TwoDARow::~TwoDARow() {
 }
 
 const Common::UString &TwoDARow::getString(size_t column) const {
-	const Common::UString &cell = getCell(column);
-	if (cell.empty() || (cell == "****"))
-		return _parent->_defaultString;
-
-	return cell;
+	return _parent->getColumn(column).getString(_index);
 }
 
 const Common::UString &TwoDARow::getString(const Common::UString &column) const {
-	const Common::UString &cell = getCell(_parent->headerToColumn(column));
-	if (cell.empty() || (cell == "****"))
-		return _parent->_defaultString;
+	return _parent->getColumn(column).getString(_index);
+}
 
-	return cell;
+const Common::UString &TwoDARow::getString(const TwoDAColumn &column) const {
+	return column.getString(_index);
 }
 
 int32 TwoDARow::getInt(size_t column) const {
-	const Common::UString &cell = getCell(column);
-	if (cell.empty() || (cell == "****"))
-		return _parent->_defaultInt;
-
-	return _parent->parseInt(cell);
+	return _parent->getColumn(column).getInt(_index);
 }
 
 int32 TwoDARow::getInt(const Common::UString &column) const {
-	const Common::UString &cell = getCell(_parent->headerToColumn(column));
-	if (cell.empty() || (cell == "****"))
-		return _parent->_defaultInt;
+	return _parent->getColumn(column).getInt(_index);
+}
 
-	return _parent->parseInt(cell);
+int32 TwoDARow::getInt(const TwoDAColumn &column) const {
+	return column.getInt(_index);
 }
 
 float TwoDARow::getFloat(size_t column) const {
-	const Common::UString &cell = getCell(column);
-	if (cell.empty() || (cell == "****"))
-		return _parent->_defaultFloat;
-
-	return _parent->parseFloat(cell);
+	return _parent->getColumn(column).getFloat(_index);
 }
 
 float TwoDARow::getFloat(const Common::UString &column) const {
-	const Common::UString &cell = getCell(_parent->headerToColumn(column));
-	if (cell.empty() || (cell == "****"))
-		return _parent->_defaultFloat;
+	return _parent->getColumn(column).getFloat(_index);
+}
 
-	return _parent->parseFloat(cell);
+float TwoDARow::getFloat(const TwoDAColumn &column) const {
+	return column.getFloat(_index);
 }
 
 bool TwoDARow::empty(size_t column) const {
-	const Common::UString &cell = getCell(column);
-	if (cell.empty() || (cell == "****"))
-		return true;
-
-	return false;
+	return _parent->getColumn(column).empty(_index);
 }
 
 bool TwoDARow::empty(const Common::UString &column) const {
-	return empty(_parent->headerToColumn(column));
+	return _parent->getColumn(column).empty(_index);
 }
 
+bool TwoDARow::empty(const TwoDAColumn &column) const {
+	return column.empty(_index);
+}
+
+
 static const Common::UString kEmpty;
-const Common::UString &TwoDARow::getCell(size_t n) const {
-	if (n >= _data.size())
-		return kEmpty;
 
-	return _data[n];
+TwoDAColumn::TwoDAColumn() : _parent(0), _column(0) {
+}
+
+TwoDAColumn::TwoDAColumn(const TwoDAFile &parent, const TwoDAFile::Column *column) :
+	_parent(&parent), _column(column) {
+
+}
+
+bool TwoDAColumn::isValid() const {
+	return _column != 0;
+}
+
+const Common::UString &TwoDAColumn::getString(size_t row) const {
+	if (empty(row))
+		return _parent ? _parent->_defaultString : kEmpty;
+
+	return _column->strings[row];
+}
+
+int32 TwoDAColumn::getInt(size_t row) const {
+	if (!_column || (row >= _column->ints.size()))
+		return _parent ? _parent->_defaultInt : 0;
+
+	return _column->ints[row];
+}
+
+float TwoDAColumn::getFloat(size_t row) const {
+	if (!_column || (row >= _column->floats.size()))
+		return _parent ? _parent->_defaultFloat : 0.0f;
+
+	return _column->floats[row];
+}
+
+bool TwoDAColumn::empty(size_t row) const {
+	if (!_column || (row >= _column->empty.size()))
+		return true;
+
+	return _column->empty[row];
 }
 
 
 TwoDAFile::TwoDAFile(Common::SeekableReadStream &twoda) :
-	_defaultInt(0), _defaultFloat(0.0f), _emptyRow(*this) {
+	_defaultInt(0), _defaultFloat(0.0f), _emptyRow(*this, SIZE_MAX) {
 
 	load(twoda);
 }
 
 TwoDAFile::TwoDAFile(const GDAFile &gda) :
-	_defaultInt(0), _defaultFloat(0.0f), _emptyRow(*this) {
+	_defaultInt(0), _defaultFloat(0.0f), _emptyRow(*this, SIZE_MAX) {
 
 	load(gda);
 }
 
+TwoDAFile::TwoDAFile() : _defaultInt(0), _defaultFloat(0.0f), _emptyRow(*this, SIZE_MAX) {
+}
+
 TwoDAFile::~TwoDAFile() {
 }
 
@@ -162,6 +191,8 @@ void TwoDAFile::load(Common::SeekableReadStream &twoda) {
 		// Create the map to quickly translate headers to column indices
 		createHeaderMap();
 
+		parseColumns();
+
 	} catch (Common::Exception &e) {
 		e.add("Failed reading 2DA file");
 		throw;
@@ -231,8 +262,10 @@ void TwoDAFile::readRows2a(Common::SeekableReadStream &twoda,
 
 	const size_t columnCount = _headers.size();
 
+	_columns.resize(columnCount);
+
+	std::vector<Common::UString> cells;
 	while (!twoda.eos()) {
-		Common::ScopedPtr<TwoDARow> row(new TwoDARow(*this));
 
 		/* Skip the first token, which is the row index, possibly indented.
 		 * The row index is implicit in the data and its use in the 2DA
@@ -242,7 +275,7 @@ void TwoDAFile::readRows2a(Common::SeekableReadStream &twoda,
 		tokenize.skipToken(twoda);
 
 		// Read all the cells in the row
-		size_t count = tokenize.getTokens(twoda, row->_data, columnCount, columnCount, "****");
+		size_t count = tokenize.getTokens(twoda, cells, columnCount, columnCount, "****");
 
 		// And move to the next line
 		tokenize.nextChunk(twoda);
@@ -251,7 +284,7 @@ void TwoDAFile::readRows2a(Common::SeekableReadStream &twoda,
 		if (count == 0)
 			continue;
 
-		_rows.push_back(row.release());
+		addRow(cells);
 	}
 }
 
@@ -280,7 +313,8 @@ void TwoDAFile::skipRowNames2b(Common::SeekableReadStream &twoda) {
 	 */
 
 	const uint32 rowCount = twoda.readUint32LE();
-	_rows.resize(rowCount, 0);
+
+	createRows(rowCount);
 
 	Common::StreamTokenizer tokenize(Common::StreamTokenizer::kRuleHeed);
 
@@ -316,19 +350,21 @@ void TwoDAFile::readRows2b(Common::SeekableReadStream &twoda) {
 
 	const size_t dataOffset = twoda.pos();
 
-	for (size_t i = 0; i < rowCount; i++) {
-		_rows[i] = new TwoDARow(*this);
-
-		_rows[i]->_data.resize(columnCount);
+	_columns.resize(columnCount);
+	for (size_t j = 0; j < columnCount; j++)
+		_columns[j].strings.resize(rowCount);
 
+	for (size_t i = 0; i < rowCount; i++) {
 		for (size_t j = 0; j < columnCount; j++) {
 			const size_t offset = dataOffset + offsets[i * columnCount + j];
 
 			twoda.seek(offset);
 
-			_rows[i]->_data[j] = tokenize.getToken(twoda);
-			if (_rows[i]->_data[j].empty())
-				_rows[i]->_data[j] = "****";
+			Common::UString &cell = _columns[j].strings[i];
+
+			cell = tokenize.getToken(twoda);
+			if (cell.empty())
+				cell = "****";
 		}
 	}
 }
@@ -338,6 +374,48 @@ void TwoDAFile::createHeaderMap() {
 		_headerMap.insert(std::make_pair(_headers[i], i));
 }
 
+void TwoDAFile::createRows(size_t count) {
+	_rows.reserve(_rows.size() + count);
+
+	while (count-- > 0)
+		_rows.push_back(new TwoDARow(*this, _rows.size()));
+}
+
+void TwoDAFile::addRow(std::vector<Common::UString> &cells) {
+	assert(cells.size() == _columns.size());
+
+	for (size_t i = 0; i < _columns.size(); i++) {
+		_columns[i].strings.push_back(Common::UString());
+		_columns[i].strings.back().swap(cells[i]);
+	}
+
+	createRows(1);
+}
+
+void TwoDAFile::parseColumns() {
+	/* Parse every cell once, so that reading a cell as a number later
+	 * is a simple lookup. Cells that are empty already get the default
+	 * values here. */
+
+	for (std::vector<Column>::iterator c = _columns.begin(); c != _columns.end(); ++c) {
+		const size_t rowCount = c->strings.size();
+
+		c->ints.resize(rowCount, _defaultInt);
+		c->floats.resize(rowCount, _defaultFloat);
+		c->empty.resize(rowCount, true);
+
+		for (size_t i = 0; i < rowCount; i++) {
+			const Common::UString &cell = c->strings[i];
+			if (cell.empty() || (cell == "****"))
+				continue;
+
+			c->ints  [i] = parseInt(cell);
+			c->floats[i] = parseFloat(cell);
+			c->empty [i] = false;
+		}
+	}
+}
+
 void TwoDAFile::load(const GDAFile &gda) {
 	try {
 
@@ -351,31 +429,36 @@ void TwoDAFile::load(const GDAFile &gda) {
 			_headers[i] = headerString ? headerString : Common::UString::format("[%u]", headers[i].hash);
 		}
 
+		_columns.resize(gda.getColumnCount());
+		for (size_t j = 0; j < gda.getColumnCount(); j++)
+			_columns[j].strings.resize(gda.getRowCount());
+
 		_rows.resize(gda.getRowCount(), 0);
 		for (size_t i = 0; i < gda.getRowCount(); i++) {
 			const GFF4Struct *row = gda.getRow(i);
 
-			_rows[i] = new TwoDARow(*this);
-			_rows[i]->_data.resize(gda.getColumnCount());
+			_rows[i] = new TwoDARow(*this, i);
 
 			for (size_t j = 0; j < gda.getColumnCount(); j++) {
+				Common::UString &cell = _columns[j].strings[i];
+
 				if (row) {
 					switch (headers[j].type) {
 						case GDAFile::kTypeString:
 						case GDAFile::kTypeResource:
-							_rows[i]->_data[j] = row->getString(headers[j].field);
+							cell = row->getString(headers[j].field);
 							break;
 
 						case GDAFile::kTypeInt:
-							_rows[i]->_data[j] = Common::UString::format("%d", (int) row->getSint(headers[j].field));
+							cell = Common::UString::format("%d", (int) row->getSint(headers[j].field));
 							break;
 
 						case GDAFile::kTypeFloat:
-							_rows[i]->_data[j] = Common::UString::format("%f", row->getDouble(headers[j].field));
+							cell = Common::UString::format("%f", row->getDouble(headers[j].field));
 							break;
 
 						case GDAFile::kTypeBool:
-							_rows[i]->_data[j] = Common::UString::format("%u", (uint) row->getUint(headers[j].field));
+							cell = Common::UString::format("%u", (uint) row->getUint(headers[j].field));
 							break;
 
 						default:
@@ -383,8 +466,8 @@ void TwoDAFile::load(const GDAFile &gda) {
 					}
 				}
 
-				if (_rows[i]->_data[j].empty())
-					_rows[i]->_data[j] = "****";
+				if (cell.empty())
+					cell = "****";
 
 			}
 		}
@@ -395,6 +478,7 @@ void TwoDAFile::load(const GDAFile &gda) {
 	}
 
 	createHeaderMap();
+	parseColumns();
 }
 
 size_t TwoDAFile::getRowCount() const {
@@ -418,6 +502,17 @@ size_t TwoDAFile::headerToColumn(const Common::UString &header) const {
 	return column->second;
 }
 
+TwoDAColumn TwoDAFile::getColumn(size_t column) const {
+	if (column >= _columns.size())
+		return TwoDAColumn(*this, 0);
+
+	return TwoDAColumn(*this, &_columns[column]);
+}
+
+TwoDAColumn TwoDAFile::getColumn(const Common::UString &header) const {
+	return getColumn(headerToColumn(header));
+}
+
 const TwoDARow &TwoDAFile::getRow(size_t row) const {
 	if ((row >= _rows.size()) || !_rows[row])
 		// No such row
@@ -427,17 +522,39 @@ const TwoDARow &TwoDAFile::getRow(size_t row) const {
 }
 
 const TwoDARow &TwoDAFile::getRow(const Common::UString &header, const Common::UString &value) const {
-	size_t columnIndex = headerToColumn(header);
-	if (columnIndex == kFieldIDInvalid)
+	const size_t column = headerToColumn(header);
+	if (column >= _columns.size())
 		return _emptyRow;
 
-	for (std::vector<TwoDARow *>::const_iterator row = _rows.begin(); row != _rows.end(); ++row) {
-		if ((*row)->getString(columnIndex).equalsIgnoreCase(value))
-			return **row;
-	}
+	const RowIndex &index = getRowIndex(column);
 
-	// No such row
-	return _emptyRow;
+	RowIndex::const_iterator row = index.find(value);
+	if (row == index.end())
+		// No such row
+		return _emptyRow;
+
+	return *_rows[row->second];
+}
+
+const TwoDAFile::RowIndex &TwoDAFile::getRowIndex(size_t column) const {
+	assert(column < _columns.size());
+
+	if (_rowIndices.empty())
+		_rowIndices.resize(_columns.size(), 0);
+
+	if (_rowIndices[column])
+		return *_rowIndices[column];
+
+	Common::ScopedPtr<RowIndex> index(new RowIndex);
+
+	const TwoDAColumn cells = getColumn(column);
+	for (size_t i = 0; i < _rows.size(); i++)
+		// Only the first row with a certain value can be found
+		index->insert(std::make_pair(cells.getString(i), i));
+
+	_rowIndices[column] = index.release();
+
+	return *_rowIndices[column];
 }
 
 void TwoDAFile::writeASCII(Common::WriteStream &out) const {
@@ -460,9 +577,9 @@ void TwoDAFile::writeASCII(Common::WriteStream &out) const {
 		colLength[i + 1] = _headers[i].size();
 
 	for (size_t i = 0; i < _rows.size(); i++) {
-		for (size_t j = 0; j < _rows[i]->_data.size(); j++) {
-			const bool   needQuote = _rows[i]->_data[j].contains(' ');
-			const size_t length    = needQuote ? _rows[i]->_data[j].size() + 2 : _rows[i]->_data[j].size();
+		for (size_t j = 0; j < _columns.size(); j++) {
+			const bool   needQuote = _columns[j].strings[i].contains(' ');
+			const size_t length    = needQuote ? _columns[j].strings[i].size() + 2 : _columns[j].strings[i].size();
 
 			colLength[j + 1] = MAX<size_t>(colLength[j + 1], length);
 		}
@@ -482,14 +599,14 @@ void TwoDAFile::writeASCII(Common::WriteStream &out) const {
 	for (size_t i = 0; i < _rows.size(); i++) {
 		out.writeString(Common::UString::format("%*u", (int)colLength[0], (uint)i));
 
-		for (size_t j = 0; j < _rows[i]->_data.size(); j++) {
-			const bool needQuote = _rows[i]->_data[j].contains(' ');
+		for (size_t j = 0; j < _columns.size(); j++) {
+			const bool needQuote = _columns[j].strings[i].contains(' ');
 
 			Common::UString cellString;
 			if (needQuote)
-				cellString = Common::UString::format("\"%s\"", _rows[i]->_data[j].c_str());
+				cellString = Common::UString::format("\"%s\"", _columns[j].strings[i].c_str());
 			else
-				cellString = _rows[i]->_data[j];
+				cellString = _columns[j].strings[i];
 
 			out.writeString(Common::UString::format(" %-*s", (int)colLength[j + 1], cellString.c_str()));
 
@@ -641,19 +758,19 @@ void TwoDAFile::writeCSV(Common::WriteStream &out) const {
 	// Write array
 
 	for (size_t i = 0; i < _rows.size(); i++) {
-		for (size_t j = 0; j < _rows[i]->_data.size(); j++) {
-			const bool needQuote = _rows[i]->_data[j].contains(',');
+		for (size_t j = 0; j < _columns.size(); j++) {
+			const bool needQuote = _columns[j].strings[i].contains(',');
 
 			if (needQuote)
 				out.writeByte('"');
 
-			if (_rows[i]->_data[j] != "****")
-				out.writeString(_rows[i]->_data[j]);
+			if (_columns[j].strings[i] != "****")
+				out.writeString(_columns[j].strings[i]);
 
 			if (needQuote)
 				out.writeByte('"');
 
-			if (j < (_rows[i]->_data.size() - 1))
+			if (j < (_columns.size() - 1))
 				out.writeByte(',');
 		}
 
@@ -674,30 +791,48 @@ bool TwoDAFile::writeCSV(const Common::UString &fileName) const {
 	return true;
 }
 
+/* Most cells aren't numbers at all, so these don't go through
+ * Common::parseString(), which throws for every cell it can't convert. */
+
+/** Did the conversion that stopped at end use up the whole string, except for trailing spaces? */
+static bool isParsed(const char *str, const char *end) {
+	if (end == str)
+		return false;
+
+	while (std::isspace(static_cast<unsigned char>(*end)))
+		end++;
+
+	return *end == '\0';
+}
+
 int32 TwoDAFile::parseInt(const Common::UString &str) {
 	if (str.empty())
 		return 0;
 
-	int32 v = 0;
+	const char *cStr = str.c_str();
+	char *end = 0;
 
-	try {
-		Common::parseString(str, v);
-	} catch (...) {
-	}
+	errno = 0;
+	const long v = std::strtol(cStr, &end, 0);
 
-	return v;
+	if (!isParsed(cStr, end) || (errno == ERANGE) || (v < INT32_MIN) || (v > INT32_MAX))
+		return 0;
+
+	return (int32) v;
 }
 
 float TwoDAFile::parseFloat(const Common::UString &str) {
 	if (str.empty())
 		return 0;
 
-	float v = 0.0f;
+	const char *cStr = str.c_str();
+	char *end = 0;
 
-	try {
-		Common::parseString(str, v);
-	} catch (...) {
-	}
+	errno = 0;
+	const float v = strtof(cStr, &end);
+
+	if (!isParsed(cStr, end) || (errno == ERANGE))
+		return 0.0f;
 
 	return v;
 }
@@ -29,6 +29,7 @@
 #include <map>
 
 #include <boost/noncopyable.hpp>
+#include <boost/unordered/unordered_map.hpp>
 
 #include "src/common/types.h"
 #include "src/common/ustring.h"
@@ -45,16 +46,18 @@ namespace Common {
 namespace Aurora {
 
 class TwoDAFile;
+class TwoDAColumn;
 class GDAFile;
 
 /** A row within a 2DA file.
  *
  *  Each row inside a 2DA file contains several cells with string
- *  data, identified by either their column index or column header
- *  string.
+ *  data, identified by either their column index, column header
+ *  string or a column resolved with TwoDAFile::getColumn().
  *
- *  For convenience's sake, there are also methods to directly parse
- *  the cell strings into integer or floating point values.
+ *  For convenience's sake, there are also methods to directly get
+ *  the cells as integer or floating point values. These values are
+ *  parsed once, when the 2DA is loaded.
  *
  *  See also class TwoDAFile.
  */
@@ -64,32 +67,38 @@ public:
 	const Common::UString &getString(size_t column) const;
 	/** Return the contents of a cell as a string. */
 	const Common::UString &getString(const Common::UString &column) const;
+	/** Return the contents of a cell as a string. */
+	const Common::UString &getString(const TwoDAColumn &column) const;
 
 	/** Return the contents of a cell as an int. */
 	int32 getInt(size_t column) const;
 	/** Return the contents of a cell as an int. */
 	int32 getInt(const Common::UString &column) const;
+	/** Return the contents of a cell as an int. */
+	int32 getInt(const TwoDAColumn &column) const;
 
 	/** Return the contents of a cell as a float. */
 	float getFloat(size_t column) const;
 	/** Return the contents of a cell as a float. */
 	float getFloat(const Common::UString &column) const;
+	/** Return the contents of a cell as a float. */
+	float getFloat(const TwoDAColumn &column) const;
 
 	/** Check if the cell is empty. */
 	bool empty(size_t column) const;
 	/** Check if the cell is empty. */
 	bool empty(const Common::UString &column) const;
+	/** Check if the cell is empty. */
+	bool empty(const TwoDAColumn &column) const;
 
 private:
 	TwoDAFile *_parent; ///< The parent 2DA.
 
-	std::vector<Common::UString> _data;
+	size_t _index; ///< The index of this row, or SIZE_MAX for the empty row.
 
-	TwoDARow(TwoDAFile &parent);
+	TwoDARow(TwoDAFile &parent, size_t index);
 	~TwoDARow();
 
-	const Common::UString &getCell(size_t n) const;
-
 	friend class TwoDAFile;
 
 	template<typename T>
@@ -139,10 +148,22 @@ public:
 	/** Translate a column header to a column index. */
 	size_t headerToColumn(const Common::UString &header) const;
 
+	/** Get a column, to access the cells of many rows without looking up the column each time. */
+	TwoDAColumn getColumn(size_t column) const;
+	/** Get a column, to access the cells of many rows without looking up the header each time. */
+	TwoDAColumn getColumn(const Common::UString &header) const;
+
 	/** Get a row. */
 	const TwoDARow &getRow(size_t row) const;
 
-	/** Get a row whose value in the column named header is the given string value. */
+	/** Get a row whose value in the column named header is the given string value.
+	 *
+	 *  The value is compared case-insensitively. If several rows match, the first
+	 *  one is returned.
+	 *
+	 *  The first search in a column builds an index of all its values, so that
+	 *  all following searches in that column are quick.
+	 */
 	const TwoDARow &getRow(const Common::UString &header, const Common::UString &value) const;
 
 	// .--- 2DA file writers
@@ -165,6 +186,20 @@ public:
 private:
 	typedef std::map<Common::UString, size_t, Common::UString::iless> HeaderMap;
 
+	/** An index mapping the cell strings of a column to the first row containing them. */
+	typedef boost::unordered_map<Common::UString, size_t, Common::hashUStringCaseInsensitive,
+	                             Common::UString::iequal> RowIndex;
+
+	/** The cells of one column, as strings and parsed into numbers. */
+	struct Column {
+		std::vector<Common::UString> strings; ///< The cell strings as found in the file.
+
+		std::vector<int32> ints;   ///< The cells parsed as ints, or the default int if empty.
+		std::vector<float> floats; ///< The cells parsed as floats, or the default float if empty.
+
+		std::vector<bool> empty; ///< Is this cell empty?
+	};
+
 	Common::UString _defaultString; ///< The default string to return should a cell not exist.
 	int32           _defaultInt;    ///< The default int to return should a cell not exist.
 	float           _defaultFloat;  ///< The default float to return should a cell not exist.
@@ -175,6 +210,11 @@ private:
 	TwoDARow _emptyRow;
 	Common::PtrVector<TwoDARow> _rows;
 
+	std::vector<Column> _columns;
+
+	/** The row index of each column, created when it's first searched. */
+	mutable Common::PtrVector<RowIndex> _rowIndices;
+
 	// Loading helpers
 	void load(Common::SeekableReadStream &twoda);
 	void read2a(Common::SeekableReadStream &twoda);
@@ -195,10 +235,63 @@ private:
 
 	void createHeaderMap();
 
+	/** Add a row, taking over the strings of its cells. */
+	void addRow(std::vector<Common::UString> &cells);
+	/** Parse the cell strings of all columns into numbers. */
+	void parseColumns();
+
+	/** Return the row index of a column, creating it if necessary. */
+	const RowIndex &getRowIndex(size_t column) const;
+
 	static int32 parseInt(const Common::UString &str);
 	static float parseFloat(const Common::UString &str);
 
+	// Precompiled table cache helpers
+	TwoDAFile();
+
+	void createRows(size_t count);
+
 	friend class TwoDARow;
+	friend class TwoDAColumn;
+	friend class TwoDACache;
+};
+
+/** A resolved column within a 2DA file.
+ *
+ *  Looking up a cell by its column header string needs to find the
+ *  header first. When the same column is read in many rows, it can
+ *  instead be resolved once with TwoDAFile::getColumn(), making the
+ *  access of each cell a simple array lookup.
+ *
+ *  A column is only valid as long as the 2DA it belongs to exists.
+ *  Accessing a column that doesn't exist in the 2DA, or a row that
+ *  doesn't exist in the column, returns the 2DA's default values.
+ */
+class TwoDAColumn {
+public:
+	/** Create an invalid column, that doesn't belong to any 2DA. */
+	TwoDAColumn();
+
+	/** Does this column exist within its 2DA? */
+	bool isValid() const;
+
+	/** Return the contents of a cell as a string. */
+	const Common::UString &getString(size_t row) const;
+	/** Return the contents of a cell as an int. */
+	int32 getInt(size_t row) const;
+	/** Return the contents of a cell as a float. */
+	float getFloat(size_t row) const;
+
+	/** Check if the cell is empty. */
+	bool empty(size_t row) const;
+
+private:
+	const TwoDAFile *_parent;
+	const TwoDAFile::Column *_column;
+
+	TwoDAColumn(const TwoDAFile &parent, const TwoDAFile::Column *column);
+
+	friend class TwoDAFile;
 };
 
 } // End of namespace Aurora
@@ -48,6 +48,10 @@ void TwoDARegistry::clear() {
 	_gdas.clear();
 }
 
+void TwoDARegistry::setCacheDirectory(const Common::UString &directory) {
+	_cache.setDirectory(directory);
+}
+
 const TwoDAFile &TwoDARegistry::get2DA(const Common::UString &name) {
 	TwoDAMap::const_iterator twoda = _twodas.find(name);
 	if (twoda != _twodas.end())
@@ -148,6 +152,16 @@ TwoDAFile *TwoDARegistry::load2DA(const Common::UString &name) {
 	Common::ScopedPtr<Common::SeekableReadStream> twodaFile;
 	Common::ScopedPtr<TwoDAFile> twoda;
 
+	Common::UString file;
+	IndexCache::Signature signature;
+
+	const bool cacheable = _cache.isEnabled() && ResMan.getResourceIdentity(name, kFileType2DA, file, signature);
+	if (cacheable) {
+		twoda.reset(_cache.get(name, file, signature));
+		if (twoda)
+			return twoda.release();
+	}
+
 	try {
 		twodaFile.reset(ResMan.getResource(name, kFileType2DA));
 		if (!twodaFile)
@@ -160,6 +174,9 @@ TwoDAFile *TwoDARegistry::load2DA(const Common::UString &name) {
 		throw;
 	}
 
+	if (cacheable)
+		_cache.set(name, file, signature, *twoda);
+
 	return twoda.release();
 }
 
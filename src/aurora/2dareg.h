@@ -29,6 +29,8 @@
 #include "src/common/singleton.h"
 #include "src/common/ustring.h"
 
+#include "src/aurora/2dacache.h"
+
 namespace Aurora {
 
 class TwoDAFile;
@@ -44,6 +46,9 @@ class GDAFile;
  *  method is called, which should be done in a moment appropriate for
  *  the game. Most likely, this moment is the unloading of a module
  *  or campaign, when the context of the current 2DAs/GDAs expires.
+ *  Since the 2DAs stay loaded, so do the row indices they build when
+ *  they're searched for values (see TwoDAFile::getRow()), and later
+ *  searches by the same column don't need to look at each row again.
  *
  *  TwoDARegistry can also be used to load a so-called MGDA, a concat-
  *  enation of multiple GDA files with the same prefix. This is used
@@ -62,6 +67,12 @@ public:
 
 	void clear();
 
+	/** Set the directory precompiled 2DAs are cached in, see TwoDACache.
+	 *
+	 *  An empty directory, the default, disables the cache.
+	 */
+	void setCacheDirectory(const Common::UString &directory);
+
 	/** Get a certain 2DA, loading it if necessary. */
 	const TwoDAFile &get2DA(const Common::UString &name);
 
@@ -90,6 +101,8 @@ private:
 	TwoDAMap _twodas;
 	GDAMap   _gdas;
 
+	TwoDACache _cache;
+
 	TwoDAFile *load2DA(const Common::UString &name);
 	GDAFile   *loadGDA(const Common::UString &name);
 	GDAFile   *loadMGDA(Common::UString prefix);
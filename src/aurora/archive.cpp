@@ -23,6 +23,10 @@
  */
 
 #include "src/common/system.h"
+#include "src/common/error.h"
+#include "src/common/mappedfile.h"
+#include "src/common/writestream.h"
+#include "src/common/encoding.h"
 
 #include "src/aurora/archive.h"
 
@@ -41,6 +45,18 @@ uint32 Archive::getResourceSize(uint32 UNUSED(index)) const {
 	return 0xFFFFFFFF;
 }
 
+uint32 Archive::getResourcePackedSize(uint32 index) const {
+	return getResourceSize(index);
+}
+
+bool Archive::isResourceCompressed(uint32 UNUSED(index)) const {
+	return false;
+}
+
+bool Archive::isThreadSafe() const {
+	return false;
+}
+
 Common::HashAlgo Archive::getNameHashAlgo() const {
 	return Common::kHashNone;
 }
@@ -64,4 +80,53 @@ uint32 Archive::findResource(const Common::UString &name, FileType type) const {
 	return 0xFFFFFFFF;
 }
 
+bool Archive::writeIndex(Common::WriteStream &UNUSED(index)) const {
+	return false;
+}
+
+void Archive::writeResourceList(Common::WriteStream &index, const ResourceList &resources) {
+	index.writeUint32LE(resources.size());
+
+	for (ResourceList::const_iterator r = resources.begin(); r != resources.end(); ++r) {
+		Common::writeString(index, r->name, Common::kEncodingUTF8);
+
+		index.writeUint64LE(r->hash);
+		index.writeUint32LE((uint32) r->type);
+		index.writeUint32LE(r->index);
+	}
+}
+
+void Archive::readResourceList(Common::SeekableReadStream &index, ResourceList &resources) {
+	resources.clear();
+
+	// Name terminator, hash, type and index
+	const uint32 count = readIndexCount(index, 17);
+	for (uint32 i = 0; i < count; i++) {
+		resources.push_back(Resource());
+
+		resources.back().name  = Common::readString(index, Common::kEncodingUTF8);
+		resources.back().hash  = index.readUint64LE();
+		resources.back().type  = (FileType) index.readUint32LE();
+		resources.back().index = index.readUint32LE();
+	}
+}
+
+uint32 Archive::readIndexCount(Common::SeekableReadStream &index, size_t entrySize) {
+	const uint32 count = index.readUint32LE();
+	if (count > ((index.size() - index.pos()) / entrySize))
+		throw Common::Exception("Invalid index entry count %u", count);
+
+	return count;
+}
+
+Common::MemoryReadStream *Archive::getMappedView(const Common::SeekableReadStream &archive,
+                                                 size_t offset, size_t size) {
+
+	const Common::MappedFile *mapped = dynamic_cast<const Common::MappedFile *>(&archive);
+	if (!mapped)
+		return 0;
+
+	return mapped->getView(offset, offset + size);
+}
+
 } // End of namespace Aurora
@@ -37,6 +37,8 @@
 
 namespace Common {
 	class SeekableReadStream;
+	class MemoryReadStream;
+	class WriteStream;
 }
 
 namespace Aurora {
@@ -65,14 +67,32 @@ public:
 	/** Return the size of a resource. */
 	virtual uint32 getResourceSize(uint32 index) const;
 
+	/** Return the size a resource takes up within the archive, i.e. before unpacking. */
+	virtual uint32 getResourcePackedSize(uint32 index) const;
+
+	/** Is this resource stored compressed or encrypted, i.e. expensive to read? */
+	virtual bool isResourceCompressed(uint32 index) const;
+
 	/** Return a stream of the resource's contents.
+	 *
+	 *  If the archive was opened from a memory-mapped file (see Common::MappedFile),
+	 *  uncompressed resources are returned as views directly into the mapping, and
+	 *  are never copied.
 	 *
 	 *  @param  index The index of the resource we want.
-	 *  @param  tryNoCopy Try to return a SeekableSubReadStream of the archive instead of copying.
+	 *  @param  tryNoCopy Try to return a substream of the archive instead of copying.
 	 *  @return A (sub)stream of the resource's contents.
 	 */
 	virtual Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const = 0;
 
+	/** Can resources be read from several threads at the same time?
+	 *
+	 *  If this returns false, calls to getResource() need to be serialized,
+	 *  and streams returned with tryNoCopy set might not be read while
+	 *  another resource is being read.
+	 */
+	virtual bool isThreadSafe() const;
+
 	/** Return with which algorithm the name is hashed. */
 	virtual Common::HashAlgo getNameHashAlgo() const;
 
@@ -80,6 +100,40 @@ public:
 	uint32 findResource(uint64 hash) const;
 	/** Return the index of the resource matching the name and type, or 0xFFFFFFFF if not found. */
 	uint32 findResource(const Common::UString &name, FileType type) const;
+
+	/** Write the archive's index into a stream.
+	 *
+	 *  The index holds everything the archive read out of its header and
+	 *  resource tables, so that the archive can later be recreated from it
+	 *  without having to parse the archive file again. See IndexCache.
+	 *
+	 *  @return true if the index was written, false if the archive doesn't support it.
+	 */
+	virtual bool writeIndex(Common::WriteStream &index) const;
+
+protected:
+	/** Write a list of resources into an archive index. */
+	static void writeResourceList(Common::WriteStream &index, const ResourceList &resources);
+	/** Read a list of resources out of an archive index. */
+	static void readResourceList(Common::SeekableReadStream &index, ResourceList &resources);
+
+	/** Read the number of entries of a list in an archive index.
+	 *
+	 *  Throws if the rest of the index is too small to hold that many entries.
+	 *
+	 *  @param  index The archive index to read from.
+	 *  @param  entrySize The minimum number of bytes each entry takes up.
+	 */
+	static uint32 readIndexCount(Common::SeekableReadStream &index, size_t entrySize);
+
+	/** Try to return a view into the archive data, without copying it.
+	 *
+	 *  If the archive stream is a memory-mapped file, a new stream sharing
+	 *  the mapping and covering the range [offset, offset + size) is returned.
+	 *  Otherwise, 0 is returned, and the data has to be read the usual way.
+	 */
+	static Common::MemoryReadStream *getMappedView(const Common::SeekableReadStream &archive,
+	                                               size_t offset, size_t size);
 };
 
 } // End of namespace Aurora
@@ -32,6 +32,7 @@
 #include "src/common/strutil.h"
 #include "src/common/error.h"
 #include "src/common/memreadstream.h"
+#include "src/common/writestream.h"
 
 #include "src/aurora/biffile.h"
 #include "src/aurora/keyfile.h"
@@ -48,6 +49,12 @@ BIFFile::BIFFile(Common::SeekableReadStream *bif) : _bif(bif) {
 	load(*_bif);
 }
 
+BIFFile::BIFFile(Common::SeekableReadStream *bif, Common::SeekableReadStream &index) : _bif(bif) {
+	assert(_bif);
+
+	readIndex(index);
+}
+
 BIFFile::~BIFFile() {
 }
 
@@ -123,6 +130,36 @@ void BIFFile::mergeKEY(const KEYFile &key, uint32 bifIndex) {
 
 }
 
+bool BIFFile::writeIndex(Common::WriteStream &index) const {
+	index.writeUint32BE(_id);
+	index.writeUint32BE(_version);
+
+	writeResourceList(index, _resources);
+
+	index.writeUint32LE(_iResources.size());
+	for (IResourceList::const_iterator res = _iResources.begin(); res != _iResources.end(); ++res) {
+		index.writeUint32LE((uint32) res->type);
+		index.writeUint32LE(res->offset);
+		index.writeUint32LE(res->size);
+	}
+
+	return true;
+}
+
+void BIFFile::readIndex(Common::SeekableReadStream &index) {
+	_id      = index.readUint32BE();
+	_version = index.readUint32BE();
+
+	readResourceList(index, _resources);
+
+	_iResources.resize(readIndexCount(index, 12));
+	for (IResourceList::iterator res = _iResources.begin(); res != _iResources.end(); ++res) {
+		res->type   = (FileType) index.readUint32LE();
+		res->offset = index.readUint32LE();
+		res->size   = index.readUint32LE();
+	}
+}
+
 const Archive::ResourceList &BIFFile::getResources() const {
 	return _resources;
 }
@@ -141,12 +178,18 @@ uint32 BIFFile::getResourceSize(uint32 index) const {
 Common::SeekableReadStream *BIFFile::getResource(uint32 index, bool tryNoCopy) const {
 	const IResource &res = getIResource(index);
 
+	Common::SeekableReadStream *view = getMappedView(*_bif, res.offset, res.size);
+	if (view)
+		return view;
+
 	if (tryNoCopy)
-		return new Common::SeekableSubReadStream(_bif.get(), res.offset, res.offset + res.size);
+		return new Common::PositionalSubReadStream(_bif.get(), res.offset, res.offset + res.size);
 
-	_bif->seek(res.offset);
+	return _bif->readStreamAt(res.offset, res.size);
+}
 
-	return _bif->readStream(res.size);
+bool BIFFile::isThreadSafe() const {
+	return _bif->isReadAtThreadSafe();
 }
 
 } // End of namespace Aurora
@@ -36,6 +36,7 @@
 
 namespace Common {
 	class SeekableReadStream;
+	class WriteStream;
 }
 
 namespace Aurora {
@@ -72,6 +73,8 @@ class BIFFile : public Archive, public AuroraFile {
 public:
 	/** Take over this stream and read a BIF file out of it. */
 	BIFFile(Common::SeekableReadStream *bif);
+	/** Take over this stream and recreate a BIF file out of a previously written index. */
+	BIFFile(Common::SeekableReadStream *bif, Common::SeekableReadStream &index);
 	~BIFFile();
 
 	/** Return the list of resources. */
@@ -83,6 +86,9 @@ public:
 	/** Return a stream of the resource's contents. */
 	Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const;
 
+	/** Can resources be read from several threads at the same time? */
+	bool isThreadSafe() const;
+
 	/** Merge information from the KEY into the BIF.
 	 *
 	 *  Without this step, this BIFFile archive does not contain any
@@ -93,6 +99,9 @@ public:
 	 */
 	void mergeKEY(const KEYFile &key, uint32 bifIndex);
 
+	/** Write the BIF's index, including the information merged from the KEY. */
+	bool writeIndex(Common::WriteStream &index) const;
+
 private:
 	/** Internal resource information. */
 	struct IResource {
@@ -115,6 +124,8 @@ private:
 	void load(Common::SeekableReadStream &bif);
 	void readVarResTable(Common::SeekableReadStream &bif, uint32 offset);
 
+	void readIndex(Common::SeekableReadStream &index);
+
 	const IResource &getIResource(uint32 index) const;
 };
 
@@ -143,12 +143,32 @@ uint32 BZFFile::getResourceSize(uint32 index) const {
 	return getIResource(index).size;
 }
 
+uint32 BZFFile::getResourcePackedSize(uint32 index) const {
+	return getIResource(index).packedSize;
+}
+
+bool BZFFile::isResourceCompressed(uint32 UNUSED(index)) const {
+	return true;
+}
+
 Common::SeekableReadStream *BZFFile::getResource(uint32 index, bool UNUSED(tryNoCopy)) const {
 	const IResource &res = getIResource(index);
 
-	_bzf->seek(res.offset);
+	// If the BZF is memory-mapped, decompress straight out of the mapping
+	Common::ScopedPtr<Common::MemoryReadStream> packed(getMappedView(*_bzf, res.offset, res.packedSize));
+	if (packed) {
+		const byte *data = Common::decompressLZMA1(packed->getData(), res.packedSize, res.size);
+
+		return new Common::MemoryReadStream(data, res.size, true);
+	}
+
+	Common::PositionalSubReadStream packedStream(_bzf.get(), res.offset, res.offset + res.packedSize);
+
+	return Common::decompressLZMA1(packedStream, res.packedSize, res.size);
+}
 
-	return Common::decompressLZMA1(*_bzf, res.packedSize, res.size);
+bool BZFFile::isThreadSafe() const {
+	return _bzf->isReadAtThreadSafe();
 }
 
 } // End of namespace Aurora
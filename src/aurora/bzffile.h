@@ -64,9 +64,18 @@ public:
 	/** Return the size of a resource. */
 	uint32 getResourceSize(uint32 index) const;
 
+	/** Return the size a resource takes up within the archive. */
+	uint32 getResourcePackedSize(uint32 index) const;
+
+	/** Is this resource stored compressed or encrypted? */
+	bool isResourceCompressed(uint32 index) const;
+
 	/** Return a stream of the resource's contents. */
 	Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const;
 
+	/** Can resources be read from several threads at the same time? */
+	bool isThreadSafe() const;
+
 	/** Merge information from the KEY into the BZF. */
 	void mergeKEY(const KEYFile &key, uint32 bifIndex);
 
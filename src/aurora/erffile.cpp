@@ -30,6 +30,7 @@
 
 #include "src/common/memreadstream.h"
 #include "src/common/readfile.h"
+#include "src/common/writestream.h"
 #include "src/common/util.h"
 #include "src/common/strutil.h"
 #include "src/common/error.h"
@@ -154,6 +155,17 @@ ERFFile::ERFFile(Common::SeekableReadStream *erf, const std::vector<byte> &passw
 	load();
 }
 
+ERFFile::ERFFile(Common::SeekableReadStream *erf, Common::SeekableReadStream &index) : _erf(erf) {
+	assert(_erf);
+
+	try {
+		readIndex(index);
+	} catch (Common::Exception &e) {
+		e.add("Failed reading ERF index");
+		throw;
+	}
+}
+
 ERFFile::~ERFFile() {
 }
 
@@ -632,6 +644,62 @@ void ERFFile::readV30ResList(Common::SeekableReadStream &erf, const ERFHeader &h
 
 }
 
+bool ERFFile::writeIndex(Common::WriteStream &index) const {
+	/* We don't want to store any passwords or keys, so encrypted ERFs
+	 * always need to be read the normal way. */
+	if ((_header.encryption != kEncryptionNone) || _header.isNWNPremium || !_password.empty())
+		return false;
+
+	index.writeUint32BE(_id);
+	index.writeUint32BE(_version);
+	index.writeByte(_utf16le ? 1 : 0);
+
+	index.writeUint32LE(_header.buildYear);
+	index.writeUint32LE(_header.buildDay);
+	index.writeUint32LE(_header.offDescription);
+	index.writeUint32LE(_header.langCount);
+	index.writeUint32LE(_header.descriptionID);
+	index.writeUint32LE((uint32) _header.compression);
+
+	writeResourceList(index, _resources);
+
+	index.writeUint32LE(_iResources.size());
+	for (IResourceList::const_iterator res = _iResources.begin(); res != _iResources.end(); ++res) {
+		index.writeUint32LE(res->offset);
+		index.writeUint32LE(res->packedSize);
+		index.writeUint32LE(res->unpackedSize);
+	}
+
+	return true;
+}
+
+void ERFFile::readIndex(Common::SeekableReadStream &index) {
+	_id      = index.readUint32BE();
+	_version = index.readUint32BE();
+	_utf16le = index.readByte() != 0;
+
+	_header.clear();
+
+	_header.buildYear      = index.readUint32LE();
+	_header.buildDay       = index.readUint32LE();
+	_header.offDescription = index.readUint32LE();
+	_header.langCount      = index.readUint32LE();
+	_header.descriptionID  = index.readUint32LE();
+	_header.compression    = (Compression) index.readUint32LE();
+
+	readResourceList(index, _resources);
+
+	_iResources.resize(readIndexCount(index, 12));
+	for (IResourceList::iterator res = _iResources.begin(); res != _iResources.end(); ++res) {
+		res->offset       = index.readUint32LE();
+		res->packedSize   = index.readUint32LE();
+		res->unpackedSize = index.readUint32LE();
+	}
+
+	// The description is small, just read it from the ERF itself
+	readDescription(_description, *_erf, _header);
+}
+
 uint32 ERFFile::getBuildYear() const {
 	return _header.buildYear;
 }
@@ -659,16 +727,34 @@ uint32 ERFFile::getResourceSize(uint32 index) const {
 	return getIResource(index).unpackedSize;
 }
 
+uint32 ERFFile::getResourcePackedSize(uint32 index) const {
+	return getIResource(index).packedSize;
+}
+
+bool ERFFile::isResourceCompressed(uint32 index) const {
+	if (_header.encryption != kEncryptionNone)
+		return true;
+
+	// Big resources are inflated on demand, which doesn't have any up-front cost
+	if (_header.compression != kCompressionNone)
+		return getIResource(index).unpackedSize < Common::kInflateOnDemandSize;
+
+	return false;
+}
+
 Common::SeekableReadStream *ERFFile::getResource(uint32 index, bool tryNoCopy) const {
 	const IResource &res = getIResource(index);
 
 	if (tryNoCopy && (_header.encryption == kEncryptionNone) && (_header.compression == kCompressionNone))
-		return new Common::SeekableSubReadStream(_erf.get(), res.offset, res.offset + res.packedSize);
+		return new Common::PositionalSubReadStream(_erf.get(), res.offset, res.offset + res.packedSize);
 
-	_erf->seek(res.offset);
+	// Read, or look directly into the archive if it's memory-mapped
+	Common::MemoryReadStream *stream = 0;
+	if (_header.encryption == kEncryptionNone)
+		stream = getMappedView(*_erf, res.offset, res.packedSize);
 
-	// Read
-	Common::MemoryReadStream *stream = _erf->readStream(res.packedSize);
+	if (!stream)
+		stream = _erf->readStreamAt(res.offset, res.packedSize);
 
 	// Decrypt
 	if (_header.encryption != kEncryptionNone)
@@ -678,6 +764,10 @@ Common::SeekableReadStream *ERFFile::getResource(uint32 index, bool tryNoCopy) c
 	return decompress(stream, res.unpackedSize);
 }
 
+bool ERFFile::isThreadSafe() const {
+	return _erf->isReadAtThreadSafe();
+}
+
 Common::MemoryReadStream *ERFFile::decrypt(Common::SeekableReadStream &cryptStream,
                                            Encryption encryption, const std::vector<byte> &password) {
 	switch (encryption) {
@@ -747,10 +837,9 @@ Common::SeekableReadStream *ERFFile::decompressBiowareZlib(Common::MemoryReadStr
 
 	Common::ScopedPtr<Common::MemoryReadStream> stream(packedStream);
 
-	const byte * const compressedData = stream->getData();
-	const uint32 packedSize = stream->size();
+	const int windowBits = *stream->getData() >> 4;
 
-	return decompressZlib(compressedData + 1, packedSize - 1, unpackedSize, *compressedData >> 4);
+	return decompressZlib(stream.release(), 1, unpackedSize, windowBits);
 }
 
 Common::SeekableReadStream *ERFFile::decompressHeaderlessZlib(Common::MemoryReadStream *packedStream,
@@ -758,21 +847,31 @@ Common::SeekableReadStream *ERFFile::decompressHeaderlessZlib(Common::MemoryRead
 
 	/* Decompress using raw inflate. Use the default maximum window size (15). */
 
+	return decompressZlib(packedStream, 0, unpackedSize, Common::kWindowBitsMax);
+}
+
+Common::SeekableReadStream *ERFFile::decompressZlib(Common::MemoryReadStream *packedStream, uint32 offset,
+                                                    uint32 unpackedSize, int windowBits) const {
+
 	assert(packedStream);
 
 	Common::ScopedPtr<Common::MemoryReadStream> stream(packedStream);
 
-	const byte * const compressedData = stream->getData();
 	const uint32 packedSize = stream->size();
+	if (offset > packedSize)
+		throw Common::Exception("Invalid compressed ERF resource");
 
-	return decompressZlib(compressedData, packedSize, unpackedSize, Common::kWindowBitsMax);
-}
+	// Inflate big resources, like music and movies, on demand while they're read
+	if (unpackedSize >= Common::kInflateOnDemandSize) {
+		Common::SeekableReadStream *input =
+			new Common::SeekableSubReadStream(stream.release(), offset, packedSize, true);
 
-Common::SeekableReadStream *ERFFile::decompressZlib(const byte *compressedData, uint32 packedSize,
-                                                    uint32 unpackedSize, int windowBits) const {
+		return Common::decompressDeflateOnDemand(input, unpackedSize, -windowBits);
+	}
 
 	// Decompress. Negative window size to signal not to look for a gzip header.
-	const byte *data = Common::decompressDeflate(compressedData, packedSize, unpackedSize, -windowBits);
+	const byte *data = Common::decompressDeflate(stream->getData() + offset, packedSize - offset,
+	                                             unpackedSize, -windowBits);
 
 	return new Common::MemoryReadStream(data, unpackedSize, true);
 }
@@ -38,6 +38,7 @@
 
 namespace Common {
 	class SeekableReadStream;
+	class WriteStream;
 }
 
 namespace Aurora {
@@ -113,6 +114,8 @@ public:
 	 *  to calculate the key to decrypt the .hak file.
 	 */
 	ERFFile(Common::SeekableReadStream *erf, const std::vector<byte> &password = std::vector<byte>());
+	/** Take over this stream and recreate an ERF file out of a previously written index. */
+	ERFFile(Common::SeekableReadStream *erf, Common::SeekableReadStream &index);
 	~ERFFile();
 
 	/** Return the list of resources. */
@@ -121,9 +124,18 @@ public:
 	/** Return the size of a resource. */
 	uint32 getResourceSize(uint32 index) const;
 
+	/** Return the size a resource takes up within the archive. */
+	uint32 getResourcePackedSize(uint32 index) const;
+
+	/** Is this resource stored compressed or encrypted? */
+	bool isResourceCompressed(uint32 index) const;
+
 	/** Return a stream of the resource's contents. */
 	Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const;
 
+	/** Can resources be read from several threads at the same time? */
+	bool isThreadSafe() const;
+
 	/** Return the year the ERF was built. */
 	uint32 getBuildYear() const;
 	/** Return the day of year the ERF was built. */
@@ -135,6 +147,9 @@ public:
 	/** Return with which algorithm the name is hashed. */
 	Common::HashAlgo getNameHashAlgo() const;
 
+	/** Write the ERF's index. Encrypted ERFs are not supported. */
+	bool writeIndex(Common::WriteStream &index) const;
+
 	static LocString getDescription(Common::SeekableReadStream &erf);
 	static LocString getDescription(const Common::UString &fileName);
 
@@ -218,6 +233,8 @@ private:
 
 	void load();
 
+	void readIndex(Common::SeekableReadStream &index);
+
 	// .--- Header
 	static void verifyVersion(uint32 id, uint32 version, bool utf16le);
 
@@ -287,7 +304,7 @@ private:
 	Common::SeekableReadStream *decompressHeaderlessZlib(Common::MemoryReadStream *packedStream,
 	                                                     uint32 unpackedSize) const;
 
-	Common::SeekableReadStream *decompressZlib(const byte *compressedData, uint32 packedSize,
+	Common::SeekableReadStream *decompressZlib(Common::MemoryReadStream *packedStream, uint32 offset,
 	                                           uint32 unpackedSize, int windowBits) const;
 	// '---
 
@@ -27,7 +27,11 @@
  */
 
 #include <cassert>
+#include <cstring>
+#include <algorithm>
 
+#include "src/common/util.h"
+#include "src/common/endianness.h"
 #include "src/common/error.h"
 #include "src/common/memreadstream.h"
 #include "src/common/encoding.h"
@@ -42,8 +46,65 @@
 static const uint32 kVersion32 = MKTAG('V', '3', '.', '2');
 static const uint32 kVersion33 = MKTAG('V', '3', '.', '3'); // Found in The Witcher, different language table
 
+/** Block size of the arena for structs and fields. Most GFF3s are small. */
+static const size_t kArenaBlockSize = 8 * 1024;
+
 namespace Aurora {
 
+GFF3Label::GFF3Label() {
+	_key[0] = 0;
+	_key[1] = 0;
+}
+
+GFF3Label::GFF3Label(const char *label) {
+	size_t length = 0;
+	while ((length <= kLength) && label[length])
+		length++;
+
+	set(label, length);
+}
+
+GFF3Label::GFF3Label(const Common::UString &label) {
+	set(label.c_str(), std::strlen(label.c_str()));
+}
+
+GFF3Label::GFF3Label(const byte *data, size_t size) {
+	// Labels are 0-terminated, unless they use up all 16 characters
+	const byte *end = (const byte *) std::memchr(data, 0, size);
+
+	set((const char *) data, end ? (end - data) : size);
+}
+
+void GFF3Label::set(const char *label, size_t length) {
+	if (length > kLength) {
+		// Can't ever match a label found in a GFF3
+		_key[0] = 0xFFFFFFFFFFFFFFFFULL;
+		_key[1] = 0xFFFFFFFFFFFFFFFFULL;
+		return;
+	}
+
+	byte data[kLength] = { 0 };
+	std::memcpy(data, label, length);
+
+	std::memcpy(_key, data, kLength);
+}
+
+bool GFF3Label::operator==(const GFF3Label &label) const {
+	return (_key[0] == label._key[0]) && (_key[1] == label._key[1]);
+}
+
+bool GFF3Label::operator!=(const GFF3Label &label) const {
+	return !(*this == label);
+}
+
+bool GFF3Label::operator<(const GFF3Label &label) const {
+	if (_key[0] != label._key[0])
+		return _key[0] < label._key[0];
+
+	return _key[1] < label._key[1];
+}
+
+
 GFF3File::Header::Header() {
 }
 
@@ -64,7 +125,8 @@ void GFF3File::Header::read(Common::SeekableReadStream &gff3) {
 
 
 GFF3File::GFF3File(Common::SeekableReadStream *gff3, uint32 id, bool repairNWNPremium) :
-	_stream(gff3), _repairNWNPremium(repairNWNPremium), _offsetCorrection(0) {
+	_stream(gff3), _data(0), _size(0), _repairNWNPremium(repairNWNPremium), _offsetCorrection(0),
+	_arena(kArenaBlockSize) {
 
 	assert(_stream);
 
@@ -72,7 +134,8 @@ GFF3File::GFF3File(Common::SeekableReadStream *gff3, uint32 id, bool repairNWNPr
 }
 
 GFF3File::GFF3File(const Common::UString &gff3, FileType type, uint32 id, bool repairNWNPremium) :
-	_repairNWNPremium(repairNWNPremium), _offsetCorrection(0) {
+	_data(0), _size(0), _repairNWNPremium(repairNWNPremium), _offsetCorrection(0),
+	_arena(kArenaBlockSize) {
 
 	_stream.reset(ResMan.getResource(gff3, type));
 	if (!_stream)
@@ -97,6 +160,7 @@ const GFF3Struct &GFF3File::getTopLevel() const {
 void GFF3File::load(uint32 id) {
 	try {
 
+		loadData();
 		loadHeader(id);
 		loadStructs();
 		loadLists();
@@ -107,6 +171,23 @@ void GFF3File::load(uint32 id) {
 	}
 }
 
+void GFF3File::loadData() {
+	// Parse directly out of the stream's memory if we can. Otherwise, read it all into memory
+
+	Common::MemoryReadStream *memory = dynamic_cast<Common::MemoryReadStream *>(_stream.get());
+	if (!memory) {
+		_stream->seek(0);
+
+		memory = _stream->readStream(_stream->size());
+		_stream.reset(memory);
+	}
+
+	_data = memory->getData();
+	_size = memory->size();
+
+	_stream->seek(0);
+}
+
 void GFF3File::loadHeader(uint32 id) {
 	if (_repairNWNPremium) {
 		/* The GFF3 files in the encrypted premium module archive for Neverwinter
@@ -181,11 +262,48 @@ void GFF3File::loadHeader(uint32 id) {
 }
 
 void GFF3File::loadStructs() {
-	static const uint32 kStructSize = 12;
+	static const size_t kStructSize = 12;
+
+	// Make sure all structs are there. They're only created once they're needed, though
+	const byte *rawStructs = getData(_header.structOffset, (size_t) _header.structCount * kStructSize);
 
-	_structs.reserve(_header.structCount);
-	for (uint32 i = 0; i < _header.structCount; i++)
-		_structs.push_back(new GFF3Struct(*this, _header.structOffset + i * kStructSize));
+	/* Still, check that all field indices, fields and labels of all structs are
+	 * valid now, so that a broken GFF3 is rejected while loading, as before,
+	 * and not only once an affected struct is first accessed. */
+
+	for (uint32 i = 0; i < _header.structCount; i++) {
+		const byte *rawStruct = rawStructs + i * kStructSize;
+
+		const uint32 fieldIndex = READ_LE_UINT32(rawStruct + 4);
+		const uint32 fieldCount = READ_LE_UINT32(rawStruct + 8);
+
+		if (fieldCount == 1) {
+			checkField(fieldIndex);
+			continue;
+		}
+
+		if (fieldCount == 0)
+			continue;
+
+		if (fieldIndex > _header.fieldIndicesCount)
+			throw Common::Exception("GFF3: Field indices index out of range (%d/%d)",
+			                        fieldIndex, _header.fieldIndicesCount);
+
+		const byte *indices = getData(_header.fieldIndicesOffset + (size_t) fieldIndex, (size_t) fieldCount * 4);
+		for (uint32 j = 0; j < fieldCount; j++)
+			checkField(READ_LE_UINT32(indices + j * 4));
+	}
+
+	_structs.resize(_header.structCount, 0);
+}
+
+void GFF3File::checkField(uint32 index) const {
+	if (index > _header.fieldCount)
+		throw Common::Exception("GFF3: Field index out of range (%d/%d)", index, _header.fieldCount);
+
+	const byte *field = getData(_header.fieldOffset + (size_t) index * 12, 12);
+
+	getLabelData(READ_LE_UINT32(field + 4));
 }
 
 void GFF3File::loadLists() {
@@ -204,56 +322,46 @@ void GFF3File::loadLists() {
 	 * list of lists into a list index.
 	 */
 
-	_stream->seek(_header.listIndicesOffset);
-
-	// Read list array
-	std::vector<uint32> rawLists;
-	rawLists.resize(_header.listIndicesCount / 4);
-	for (std::vector<uint32>::iterator it = rawLists.begin(); it != rawLists.end(); ++it)
-		*it = _stream->readUint32LE();
+	const uint32 rawListCount = _header.listIndicesCount / 4;
 
-	// Counting the actual amount of lists
-	uint32 listCount = 0;
-	for (size_t i = 0; i < rawLists.size(); i++) {
-		uint32 n = rawLists[i];
+	const byte *rawLists = getData(_header.listIndicesOffset, rawListCount * 4);
 
-		if ((i + n) > rawLists.size())
-			throw Common::Exception("GFF3: List indices broken during counting");
+	/* Find where each list starts and check that all struct indices are valid.
+	 * The lists themselves are only filled once they're needed. */
 
-		i += n;
-		listCount++;
-	}
+	_listOffsetToIndex.resize(rawListCount, 0xFFFFFFFF);
 
-	_lists.resize(listCount);
-	_listOffsetToIndex.resize(rawLists.size(), 0xFFFFFFFF);
-
-	// Converting the raw list array into real, usable lists
-	uint32 listIndex = 0;
-	for (size_t i = 0; i < rawLists.size(); listIndex++) {
-		_listOffsetToIndex[i] = listIndex;
+	uint32 listCount = 0;
+	for (uint32 i = 0; i < rawListCount; listCount++) {
+		_listOffsetToIndex[i] = listCount;
 
-		const uint32 n = rawLists[i++];
-		if ((i + n) > rawLists.size())
-			throw Common::Exception("GFF3: List indices broken during conversion");
+		const uint32 n = READ_LE_UINT32(rawLists + i++ * 4);
+		if (n > (rawListCount - i))
+			throw Common::Exception("GFF3: List indices broken during counting");
 
-		_lists[listIndex].resize(n);
 		for (uint32 j = 0; j < n; j++, i++) {
-			const size_t structIndex = rawLists[i];
+			const uint32 structIndex = READ_LE_UINT32(rawLists + i * 4);
 			if (structIndex >= _structs.size())
 				throw Common::Exception("GFF3: List struct index out of range (%u >= %u)",
-				                        (uint) structIndex, (uint) _structs.size());
-
-			_lists[listIndex][j] = _structs[structIndex];
+				                        structIndex, (uint) _structs.size());
 		}
 	}
+
+	_lists.resize(listCount);
+	_listLoaded.resize(listCount, false);
 }
 
 // --- Helpers for GFF3Struct ---
 
 const GFF3Struct &GFF3File::getStruct(uint32 i) const {
+	static const size_t kStructSize = 12;
+
 	if (i >= _structs.size())
 		throw Common::Exception("GFF3: Struct index out of range (%u >= %u)", i, (uint) _structs.size());
 
+	if (!_structs[i])
+		_structs[i] = _arena.create<GFF3Struct>(*this, _header.structOffset + i * kStructSize);
+
 	return *_structs[i];
 }
 
@@ -269,24 +377,67 @@ const GFF3List &GFF3File::getList(uint32 i) const {
 
 	assert(listIndex < _lists.size());
 
-	return _lists[listIndex];
+	GFF3List &list = _lists[listIndex];
+	if (!_listLoaded[listIndex]) {
+		// The list indices were already checked in loadLists()
+		const byte *rawList = _data + _header.listIndicesOffset + i * 4;
+		const uint32 n = READ_LE_UINT32(rawList);
+
+		list.resize(n);
+		for (uint32 j = 0; j < n; j++)
+			list[j] = &getStruct(READ_LE_UINT32(rawList + 4 + j * 4));
+
+		_listLoaded[listIndex] = true;
+	}
+
+	return list;
+}
+
+const byte *GFF3File::getData(size_t offset, size_t size) const {
+	if ((offset > _size) || (size > (_size - offset)))
+		throw Common::Exception("GFF3: Data out of range (%u + %u > %u)",
+		                        (uint) offset, (uint) size, (uint) _size);
+
+	return _data + offset;
 }
 
-Common::SeekableReadStream &GFF3File::getStream(uint32 offset) const {
-	_stream->seek(offset);
+const byte *GFF3File::getFieldData(uint32 offset, size_t size) const {
+	return getData(_header.fieldDataOffset + (size_t) offset, size);
+}
 
-	return *_stream;
+const byte *GFF3File::getLabelData(uint32 index) const {
+	return getData(_header.labelOffset + (size_t) index * 16, 16);
 }
 
-Common::SeekableReadStream &GFF3File::getFieldData() const {
-	return getStream(_header.fieldDataOffset);
+const Common::UString &GFF3File::getLabelName(uint32 index) const {
+	if (index >= _header.labelCount)
+		throw Common::Exception("GFF3: Label index out of range (%u >= %u)", index, _header.labelCount);
+
+	if (_labelNames.empty()) {
+		// Make sure all labels are there before allocating room for their names
+		getData(_header.labelOffset, (size_t) _header.labelCount * 16);
+
+		_labelNames.resize(_header.labelCount);
+	}
+
+	Common::UString &name = _labelNames[index];
+	if (name.empty()) {
+		const byte *label = getLabelData(index);
+
+		// Labels are 0-terminated, unless they use up all 16 characters
+		const byte *end = (const byte *) std::memchr(label, 0, 16);
+
+		name = Common::readString(label, end ? (end - label) : 16, Common::kEncodingASCII);
+	}
+
+	return name;
 }
 
 
 GFF3Struct::Field::Field() : type(kFieldTypeNone), data(0), extended(false) {
 }
 
-GFF3Struct::Field::Field(FieldType t, uint32 d) : type(t), data(d) {
+GFF3Struct::Field::Field(const GFF3Label &l, FieldType t, uint32 d) : label(l), type(t), data(d) {
 	// These field types need extended field data
 	extended = (type == kFieldTypeUint64     ) ||
 	           (type == kFieldTypeSint64     ) ||
@@ -300,8 +451,18 @@ GFF3Struct::Field::Field(FieldType t, uint32 d) : type(t), data(d) {
 	           (type == kFieldTypeStrRef     );
 }
 
+bool GFF3Struct::Field::operator<(const Field &field) const {
+	return label < field.label;
+}
+
+bool GFF3Struct::Field::operator<(const GFF3Label &l) const {
+	return label < l;
+}
+
+
+GFF3Struct::GFF3Struct(const GFF3File &parent, uint32 offset) : _parent(&parent),
+	_fieldsLoaded(false), _fieldNamesLoaded(false), _fields(Common::ArenaAllocator<Field>(parent._arena)) {
 
-GFF3Struct::GFF3Struct(const GFF3File &parent, uint32 offset) : _parent(&parent) {
 	load(offset);
 }
 
@@ -315,97 +476,125 @@ uint32 GFF3Struct::getID() const {
 // --- Loader ---
 
 void GFF3Struct::load(uint32 offset) {
-	Common::SeekableReadStream &data = _parent->getStream(offset);
+	const byte *data = _parent->getData(offset, 12);
 
-	_id         = data.readUint32LE();
-	_fieldIndex = data.readUint32LE();
-	_fieldCount = data.readUint32LE();
+	_id         = READ_LE_UINT32(data + 0);
+	_fieldIndex = READ_LE_UINT32(data + 4);
+	_fieldCount = READ_LE_UINT32(data + 8);
+}
+
+void GFF3Struct::loadFields() const {
+	if (_fieldsLoaded)
+		return;
+
+	std::vector<uint32> indices;
+	readFieldIndices(indices);
+
+	_fields.reserve(indices.size());
 
 	// Read the field(s)
-	if      (_fieldCount == 1)
-		readField (data, _fieldIndex);
-	else if (_fieldCount > 1)
-		readFields(data, _fieldIndex, _fieldCount);
-}
+	for (std::vector<uint32>::const_iterator i = indices.begin(); i != indices.end(); ++i) {
+		const byte *data = readField(*i);
 
-void GFF3Struct::readField(Common::SeekableReadStream &data, uint32 index) {
-	// Sanity check
-	if (index > _parent->_header.fieldCount)
-		throw Common::Exception("GFF3: Field index out of range (%d/%d)",
-				index, _parent->_header.fieldCount);
+		const uint32 fieldType  = READ_LE_UINT32(data + 0);
+		const uint32 fieldLabel = READ_LE_UINT32(data + 4);
+		const uint32 fieldData  = READ_LE_UINT32(data + 8);
 
-	// Seek
-	data.seek(_parent->_header.fieldOffset + index * 12);
+		const GFF3Label label(_parent->getLabelData(fieldLabel), 16);
 
-	// Read the field data
-	const uint32 fieldType  = data.readUint32LE();
-	const uint32 fieldLabel = data.readUint32LE();
-	const uint32 fieldData  = data.readUint32LE();
+		_fields.push_back(Field(label, (FieldType) fieldType, fieldData));
+	}
+
+	// Sort the fields by label, so that we can find them quickly
+	std::stable_sort(_fields.begin(), _fields.end());
 
-	// Read the name
-	Common::UString fieldName = readLabel(data, fieldLabel);
+	// If a label appears more than once, the last field with that label wins
+	FieldArray::iterator last = _fields.begin();
+	for (FieldArray::const_iterator f = _fields.begin(); f != _fields.end(); ++f) {
+		if (((f + 1) != _fields.end()) && ((f + 1)->label == f->label))
+			continue;
 
-	// And add the field to the map and name list
-	_fields[fieldName] = Field((FieldType) fieldType, fieldData);
+		*last++ = *f;
+	}
 
-	_fieldNames.push_back(fieldName);
+	_fields.erase(last, _fields.end());
+
+	_fieldsLoaded = true;
 }
 
-void GFF3Struct::readFields(Common::SeekableReadStream &data, uint32 index, uint32 count) {
+void GFF3Struct::readFieldIndices(std::vector<uint32> &indices) const {
+	if (_fieldCount == 1) {
+		indices.push_back(_fieldIndex);
+		return;
+	}
+
+	if (_fieldCount == 0)
+		return;
+
 	// Sanity check
-	if (index > _parent->_header.fieldIndicesCount)
+	if (_fieldIndex > _parent->_header.fieldIndicesCount)
 		throw Common::Exception("GFF3: Field indices index out of range (%d/%d)",
-		                        index , _parent->_header.fieldIndicesCount);
-
-	// Seek
-	data.seek(_parent->_header.fieldIndicesOffset + index);
+		                        _fieldIndex , _parent->_header.fieldIndicesCount);
 
 	// Read the field indices
-	std::vector<uint32> indices;
-	readIndices(data, indices, count);
-
-	// Read the fields
-	for (std::vector<uint32>::const_iterator i = indices.begin(); i != indices.end(); ++i)
-		readField(data, *i);
-}
+	const byte *data = _parent->getData(_parent->_header.fieldIndicesOffset + (size_t) _fieldIndex,
+	                                    (size_t) _fieldCount * 4);
 
-void GFF3Struct::readIndices(Common::SeekableReadStream &data,
-                             std::vector<uint32> &indices, uint32 count) const {
-	indices.reserve(count);
-	while (count-- > 0)
-		indices.push_back(data.readUint32LE());
+	indices.reserve(_fieldCount);
+	for (uint32 i = 0; i < _fieldCount; i++)
+		indices.push_back(READ_LE_UINT32(data + i * 4));
 }
 
-Common::UString GFF3Struct::readLabel(Common::SeekableReadStream &data, uint32 index) const {
-	data.seek(_parent->_header.labelOffset + index * 16);
+const byte *GFF3Struct::readField(uint32 index) const {
+	// Sanity check
+	if (index > _parent->_header.fieldCount)
+		throw Common::Exception("GFF3: Field index out of range (%d/%d)",
+				index, _parent->_header.fieldCount);
 
-	return Common::readStringFixed(data, Common::kEncodingASCII, 16);
+	return _parent->getData(_parent->_header.fieldOffset + (size_t) index * 12, 12);
 }
 
-Common::SeekableReadStream &GFF3Struct::getData(const Field &field) const {
+const byte *GFF3Struct::getData(const Field &field, size_t size) const {
 	assert(field.extended);
 
-	Common::SeekableReadStream &data = _parent->getFieldData();
-	data.skip(field.data);
+	return _parent->getFieldData(field.data, size);
+}
+
+const byte *GFF3Struct::getSizedData(const Field &field, uint32 &size) const {
+	size = READ_LE_UINT32(getData(field, 4));
 
-	return data;
+	return getData(field, 4 + (size_t) size) + 4;
 }
 
 // --- Field properties ---
 
 size_t GFF3Struct::getFieldCount() const {
+	loadFields();
+
 	return _fields.size();
 }
 
-bool GFF3Struct::hasField(const Common::UString &field) const {
+bool GFF3Struct::hasField(const GFF3Label &field) const {
 	return getField(field) != 0;
 }
 
 const std::vector<Common::UString> &GFF3Struct::getFieldNames() const {
+	if (_fieldNamesLoaded)
+		return _fieldNames;
+
+	std::vector<uint32> indices;
+	readFieldIndices(indices);
+
+	_fieldNames.reserve(indices.size());
+	for (std::vector<uint32>::const_iterator i = indices.begin(); i != indices.end(); ++i)
+		_fieldNames.push_back(_parent->getLabelName(READ_LE_UINT32(readField(*i) + 4)));
+
+	_fieldNamesLoaded = true;
+
 	return _fieldNames;
 }
 
-GFF3Struct::FieldType GFF3Struct::getFieldType(const Common::UString &field) const {
+GFF3Struct::FieldType GFF3Struct::getFieldType(const GFF3Label &field) const {
 	const Field *f = getField(field);
 	if (!f)
 		return kFieldTypeNone;
@@ -415,15 +604,17 @@ GFF3Struct::FieldType GFF3Struct::getFieldType(const Common::UString &field) con
 
 // --- Field value reader helpers ---
 
-const GFF3Struct::Field *GFF3Struct::getField(const Common::UString &name) const {
-	FieldMap::const_iterator field = _fields.find(name);
-	if (field == _fields.end())
+const GFF3Struct::Field *GFF3Struct::getField(const GFF3Label &label) const {
+	loadFields();
+
+	FieldArray::const_iterator field = std::lower_bound(_fields.begin(), _fields.end(), label);
+	if ((field == _fields.end()) || (field->label != label))
 		return 0;
 
-	return &field->second;
+	return &*field;
 }
 
-char GFF3Struct::getChar(const Common::UString &field, char def) const {
+char GFF3Struct::getChar(const GFF3Label &field, char def) const {
 	const Field *f = getField(field);
 	if (!f)
 		return def;
@@ -433,7 +624,7 @@ char GFF3Struct::getChar(const Common::UString &field, char def) const {
 	return (char) f->data;
 }
 
-uint64 GFF3Struct::getUint(const Common::UString &field, uint64 def) const {
+uint64 GFF3Struct::getUint(const GFF3Label &field, uint64 def) const {
 	const Field *f = getField(field);
 	if (!f)
 		return def;
@@ -452,25 +643,25 @@ uint64 GFF3Struct::getUint(const Common::UString &field, uint64 def) const {
 	if (f->type == kFieldTypeSint32)
 		return (uint64) ((int64) ((int32) ((uint32) f->data)));
 	if (f->type == kFieldTypeUint64)
-		return (uint64) getData(*f).readUint64LE();
+		return (uint64) READ_LE_UINT64(getData(*f, 8));
 	if (f->type == kFieldTypeSint64)
-		return ( int64) getData(*f).readUint64LE();
+		return ( int64) READ_LE_UINT64(getData(*f, 8));
 
 	// StrRef, a numerical reference to a string in a talk table
 	if (f->type == kFieldTypeStrRef) {
-		Common::SeekableReadStream &data = getData(*f);
+		const byte *data = getData(*f, 8);
 
-		const uint32 size = data.readUint32LE();
+		const uint32 size = READ_LE_UINT32(data);
 		if (size != 4)
 			Common::Exception("StrRef field with invalid size (%d)", size);
 
-		return (uint64) data.readUint32LE();
+		return (uint64) READ_LE_UINT32(data + 4);
 	}
 
 	throw Common::Exception("GFF3: Field is not an int type");
 }
 
-int64 GFF3Struct::getSint(const Common::UString &field, int64 def) const {
+int64 GFF3Struct::getSint(const GFF3Label &field, int64 def) const {
 	const Field *f = getField(field);
 	if (!f)
 		return def;
@@ -489,29 +680,29 @@ int64 GFF3Struct::getSint(const Common::UString &field, int64 def) const {
 	if (f->type == kFieldTypeSint32)
 		return (int64) ((int32) ((uint32) f->data));
 	if (f->type == kFieldTypeUint64)
-		return (int64) getData(*f).readUint64LE();
+		return (int64) READ_LE_UINT64(getData(*f, 8));
 	if (f->type == kFieldTypeSint64)
-		return (int64) getData(*f).readUint64LE();
+		return (int64) READ_LE_UINT64(getData(*f, 8));
 
 	// StrRef, a numerical reference to a string in a talk table
 	if (f->type == kFieldTypeStrRef) {
-		Common::SeekableReadStream &data = getData(*f);
+		const byte *data = getData(*f, 8);
 
-		const uint32 size = data.readUint32LE();
+		const uint32 size = READ_LE_UINT32(data);
 		if (size != 4)
 			Common::Exception("GFF3: StrRef field with invalid size (%d)", size);
 
-		return (int64) ((uint64) data.readUint32LE());
+		return (int64) ((uint64) READ_LE_UINT32(data + 4));
 	}
 
 	throw Common::Exception("GFF3: Field is not an int type");
 }
 
-bool GFF3Struct::getBool(const Common::UString &field, bool def) const {
+bool GFF3Struct::getBool(const GFF3Label &field, bool def) const {
 	return getUint(field, def) != 0;
 }
 
-double GFF3Struct::getDouble(const Common::UString &field, double def) const {
+double GFF3Struct::getDouble(const GFF3Label &field, double def) const {
 	const Field *f = getField(field);
 	if (!f)
 		return def;
@@ -519,12 +710,12 @@ double GFF3Struct::getDouble(const Common::UString &field, double def) const {
 	if (f->type == kFieldTypeFloat)
 		return convertIEEEFloat(f->data);
 	if (f->type == kFieldTypeDouble)
-		return getData(*f).readIEEEDoubleLE();
+		return convertIEEEDouble(READ_LE_UINT64(getData(*f, 8)));
 
 	throw Common::Exception("GFF3: Field is not a double type");
 }
 
-Common::UString GFF3Struct::getString(const Common::UString &field,
+Common::UString GFF3Struct::getString(const GFF3Label &field,
                                       const Common::UString &def) const {
 
 	const Field *f = getField(field);
@@ -533,10 +724,10 @@ Common::UString GFF3Struct::getString(const Common::UString &field,
 
 	// Direct string
 	if (f->type == kFieldTypeExoString) {
-		Common::SeekableReadStream &data = getData(*f);
+		uint32 length = 0;
+		const byte *data = getSizedData(*f, length);
 
-		const uint32 length = data.readUint32LE();
-		return Common::readStringFixed(data, Common::kEncodingASCII, length);
+		return Common::readString(data, length, Common::kEncodingASCII);
 	}
 
 	// ResRef, resource reference, a shorter string
@@ -547,10 +738,9 @@ Common::UString GFF3Struct::getString(const Common::UString &field,
 		 * however, this limit has been lifted, and a full 255 characters
 		 * are available in ResRef string fields. */
 
-		Common::SeekableReadStream &data = getData(*f);
+		const uint32 length = *getData(*f, 1);
 
-		const uint32 length = data.readByte();
-		return Common::readStringFixed(data, Common::kEncodingASCII, length);
+		return Common::readString(getData(*f, 1 + length) + 1, length, Common::kEncodingASCII);
 	}
 
 	// LocString, a localized string
@@ -611,7 +801,7 @@ Common::UString GFF3Struct::getString(const Common::UString &field,
 	throw Common::Exception("GFF3: Field is not a string(able) type");
 }
 
-bool GFF3Struct::getLocString(const Common::UString &field, LocString &str) const {
+bool GFF3Struct::getLocString(const GFF3Label &field, LocString &str) const {
 	const Field *f = getField(field);
 	if (!f || (f->type != kFieldTypeLocString))
 		return false;
@@ -620,10 +810,10 @@ bool GFF3Struct::getLocString(const Common::UString &field, LocString &str) cons
 
 	try {
 
-		Common::SeekableReadStream &data = getData(*f);
+		uint32 size = 0;
+		const byte *data = getSizedData(*f, size);
 
-		const uint32 size = data.readUint32LE();
-		Common::SeekableSubReadStream locStringData(&data, data.pos(), data.pos() + size);
+		Common::MemoryReadStream locStringData(data, size);
 
 		locString.readLocString(locStringData);
 
@@ -635,7 +825,7 @@ bool GFF3Struct::getLocString(const Common::UString &field, LocString &str) cons
 	return true;
 }
 
-Common::SeekableReadStream *GFF3Struct::getData(const Common::UString &field) const {
+Common::SeekableReadStream *GFF3Struct::getData(const GFF3Label &field) const {
 	const Field *f = getField(field);
 	if (!f)
 		return 0;
@@ -644,20 +834,25 @@ Common::SeekableReadStream *GFF3Struct::getData(const Common::UString &field) co
 	    (f->type != kFieldTypeResRef))
 		throw Common::Exception("GFF3: Field is not a data type");
 
-	Common::SeekableReadStream &data = getData(*f);
-
 	uint32 size = 0;
-	if      ((f->type == kFieldTypeVoid) || (f->type == kFieldTypeExoString))
-		size = data.readUint32LE();
-	else if ( f->type == kFieldTypeResRef)
-		size = data.readByte();
-	else
+	const byte *data = 0;
+
+	if      ((f->type == kFieldTypeVoid) || (f->type == kFieldTypeExoString)) {
+		data = getSizedData(*f, size);
+	} else if ( f->type == kFieldTypeResRef) {
+		size = *getData(*f, 1);
+		data = getData(*f, 1 + size) + 1;
+	} else
 		throw Common::Exception("GFF3: Field is not a data type");
 
-	return data.readStream(size);
+	// Hand out a copy, since the stream might outlive the GFF3
+	byte *copy = new byte[size];
+	std::memcpy(copy, data, size);
+
+	return new Common::MemoryReadStream(copy, size, true);
 }
 
-void GFF3Struct::getVector(const Common::UString &field,
+void GFF3Struct::getVector(const GFF3Label &field,
                            float &x, float &y, float &z) const {
 
 	const Field *f = getField(field);
@@ -666,14 +861,14 @@ void GFF3Struct::getVector(const Common::UString &field,
 	if (f->type != kFieldTypeVector)
 		throw Common::Exception("GFF3: Field is not a vector type");
 
-	Common::SeekableReadStream &data = getData(*f);
+	const byte *data = getData(*f, 12);
 
-	x = data.readIEEEFloatLE();
-	y = data.readIEEEFloatLE();
-	z = data.readIEEEFloatLE();
+	x = convertIEEEFloat(READ_LE_UINT32(data + 0));
+	y = convertIEEEFloat(READ_LE_UINT32(data + 4));
+	z = convertIEEEFloat(READ_LE_UINT32(data + 8));
 }
 
-void GFF3Struct::getOrientation(const Common::UString &field,
+void GFF3Struct::getOrientation(const GFF3Label &field,
                                 float &a, float &b, float &c, float &d) const {
 
 	const Field *f = getField(field);
@@ -682,15 +877,15 @@ void GFF3Struct::getOrientation(const Common::UString &field,
 	if (f->type != kFieldTypeOrientation)
 		throw Common::Exception("GFF3: Field is not an orientation type");
 
-	Common::SeekableReadStream &data = getData(*f);
+	const byte *data = getData(*f, 16);
 
-	a = data.readIEEEFloatLE();
-	b = data.readIEEEFloatLE();
-	c = data.readIEEEFloatLE();
-	d = data.readIEEEFloatLE();
+	a = convertIEEEFloat(READ_LE_UINT32(data +  0));
+	b = convertIEEEFloat(READ_LE_UINT32(data +  4));
+	c = convertIEEEFloat(READ_LE_UINT32(data +  8));
+	d = convertIEEEFloat(READ_LE_UINT32(data + 12));
 }
 
-void GFF3Struct::getVector(const Common::UString &field,
+void GFF3Struct::getVector(const GFF3Label &field,
                            double &x, double &y, double &z) const {
 
 	const Field *f = getField(field);
@@ -699,14 +894,14 @@ void GFF3Struct::getVector(const Common::UString &field,
 	if (f->type != kFieldTypeVector)
 		throw Common::Exception("GFF3: Field is not a vector type");
 
-	Common::SeekableReadStream &data = getData(*f);
+	const byte *data = getData(*f, 12);
 
-	x = data.readIEEEFloatLE();
-	y = data.readIEEEFloatLE();
-	z = data.readIEEEFloatLE();
+	x = convertIEEEFloat(READ_LE_UINT32(data + 0));
+	y = convertIEEEFloat(READ_LE_UINT32(data + 4));
+	z = convertIEEEFloat(READ_LE_UINT32(data + 8));
 }
 
-void GFF3Struct::getOrientation(const Common::UString &field,
+void GFF3Struct::getOrientation(const GFF3Label &field,
                                 double &a, double &b, double &c, double &d) const {
 
 	const Field *f = getField(field);
@@ -715,17 +910,17 @@ void GFF3Struct::getOrientation(const Common::UString &field,
 	if (f->type != kFieldTypeOrientation)
 		throw Common::Exception("GFF3: Field is not an orientation type");
 
-	Common::SeekableReadStream &data = getData(*f);
+	const byte *data = getData(*f, 16);
 
-	a = data.readIEEEFloatLE();
-	b = data.readIEEEFloatLE();
-	c = data.readIEEEFloatLE();
-	d = data.readIEEEFloatLE();
+	a = convertIEEEFloat(READ_LE_UINT32(data +  0));
+	b = convertIEEEFloat(READ_LE_UINT32(data +  4));
+	c = convertIEEEFloat(READ_LE_UINT32(data +  8));
+	d = convertIEEEFloat(READ_LE_UINT32(data + 12));
 }
 
 // --- Struct reader ---
 
-const GFF3Struct &GFF3Struct::getStruct(const Common::UString &field) const {
+const GFF3Struct &GFF3Struct::getStruct(const GFF3Label &field) const {
 	const Field *f = getField(field);
 	if (!f)
 		throw Common::Exception("GFF3: No such field");
@@ -738,7 +933,7 @@ const GFF3Struct &GFF3Struct::getStruct(const Common::UString &field) const {
 
 // --- Struct list reader ---
 
-const GFF3List &GFF3Struct::getList(const Common::UString &field) const {
+const GFF3List &GFF3Struct::getList(const GFF3Label &field) const {
 	const Field *f = getField(field);
 	if (!f)
 		throw Common::Exception("GFF3: No such field");
@@ -749,4 +944,70 @@ const GFF3List &GFF3Struct::getList(const Common::UString &field) const {
 	return _parent->getList(f->data / 4);
 }
 
+// --- Field access by label strings ---
+
+bool GFF3Struct::hasField(const Common::UString &field) const {
+	return hasField(GFF3Label(field));
+}
+
+GFF3Struct::FieldType GFF3Struct::getFieldType(const Common::UString &field) const {
+	return getFieldType(GFF3Label(field));
+}
+
+char GFF3Struct::getChar(const Common::UString &field, char def) const {
+	return getChar(GFF3Label(field), def);
+}
+
+uint64 GFF3Struct::getUint(const Common::UString &field, uint64 def) const {
+	return getUint(GFF3Label(field), def);
+}
+
+int64 GFF3Struct::getSint(const Common::UString &field, int64 def) const {
+	return getSint(GFF3Label(field), def);
+}
+
+bool GFF3Struct::getBool(const Common::UString &field, bool def) const {
+	return getBool(GFF3Label(field), def);
+}
+
+double GFF3Struct::getDouble(const Common::UString &field, double def) const {
+	return getDouble(GFF3Label(field), def);
+}
+
+Common::UString GFF3Struct::getString(const Common::UString &field, const Common::UString &def) const {
+	return getString(GFF3Label(field), def);
+}
+
+bool GFF3Struct::getLocString(const Common::UString &field, LocString &str) const {
+	return getLocString(GFF3Label(field), str);
+}
+
+void GFF3Struct::getVector(const Common::UString &field, float &x, float &y, float &z) const {
+	getVector(GFF3Label(field), x, y, z);
+}
+
+void GFF3Struct::getOrientation(const Common::UString &field, float &a, float &b, float &c, float &d) const {
+	getOrientation(GFF3Label(field), a, b, c, d);
+}
+
+void GFF3Struct::getVector(const Common::UString &field, double &x, double &y, double &z) const {
+	getVector(GFF3Label(field), x, y, z);
+}
+
+void GFF3Struct::getOrientation(const Common::UString &field, double &a, double &b, double &c, double &d) const {
+	getOrientation(GFF3Label(field), a, b, c, d);
+}
+
+Common::SeekableReadStream *GFF3Struct::getData(const Common::UString &field) const {
+	return getData(GFF3Label(field));
+}
+
+const GFF3Struct &GFF3Struct::getStruct(const Common::UString &field) const {
+	return getStruct(GFF3Label(field));
+}
+
+const GFF3List &GFF3Struct::getList(const Common::UString &field) const {
+	return getList(GFF3Label(field));
+}
+
 } // End of namespace Aurora
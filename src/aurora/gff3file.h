@@ -26,13 +26,12 @@
 #define AURORA_GFF3FILE_H
 
 #include <vector>
-#include <map>
 
 #include <boost/noncopyable.hpp>
 
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
-#include "src/common/ptrvector.h"
+#include "src/common/arena.h"
 #include "src/common/ustring.h"
 
 #include "src/aurora/types.h"
@@ -47,6 +46,43 @@ namespace Aurora {
 class LocString;
 class GFF3Struct;
 
+/** A precomputed key for the label of a field in a GFF3 struct.
+ *
+ *  GFF3 field labels are at most 16 ASCII characters long. A GFF3Label packs
+ *  such a label into two integers, so that finding a field by its label only
+ *  needs integer comparisons instead of creating and comparing strings.
+ *
+ *  Code that reads the same fields over and over again can create GFF3Labels
+ *  once, for example as static constants, and then use the GFF3Struct methods
+ *  taking a GFF3Label directly. The methods taking a string simply convert
+ *  that string into a GFF3Label first.
+ *
+ *  A string longer than 16 characters will never match any field.
+ */
+class GFF3Label {
+public:
+	/** The empty label. */
+	GFF3Label();
+	explicit GFF3Label(const char *label);
+	explicit GFF3Label(const Common::UString &label);
+
+	bool operator==(const GFF3Label &label) const;
+	bool operator!=(const GFF3Label &label) const;
+	bool operator< (const GFF3Label &label) const;
+
+private:
+	static const size_t kLength = 16;
+
+	uint64 _key[2];
+
+	/** Create a label out of the raw label data found in a GFF3. */
+	GFF3Label(const byte *data, size_t size);
+
+	void set(const char *label, size_t length);
+
+	friend class GFF3Struct;
+};
+
 /** A GFF (generic file format) V3.2/V3.3 file, found in all Aurora games
  *  except Sonic Chronicles: The Dark Brotherhood. Even games that have
  *  V4.0/V4.1 GFFs additionally use V3.2/V3.3 files as well.
@@ -79,6 +115,18 @@ class GFF3Struct;
  *  LocStrings is different. Since xoreos has more flexible handling of
  *  language IDs anyway, this doesn't concern us.
  *
+ *  The GFF3 is parsed directly out of one contiguous block of memory. If
+ *  the stream is a MemoryReadStream (for example a view onto a memory-mapped
+ *  archive), its data is used without copying. Structs are only created,
+ *  and their fields only read, once they are first accessed. The layout of
+ *  all structs, fields and labels is still validated while loading, so a
+ *  broken GFF3 throws in the constructor.
+ *
+ *  Since this lazy creation modifies the GFF3File and its structs, even
+ *  the const accessors of GFF3File, GFF3Struct and GFF3List are not
+ *  thread-safe. A GFF3File must not be used by several threads at once
+ *  without external locking.
+ *
  *  See also: GFF4File in gff4file.h for the later V4.0/V4.1 versions of
  *  the GFF format.
  */
@@ -118,12 +166,15 @@ private:
 		void read(Common::SeekableReadStream &gff3);
 	};
 
-	typedef Common::PtrVector<GFF3Struct> StructArray;
+	typedef std::vector<GFF3Struct *> StructArray;
 	typedef std::vector<GFF3List> ListArray;
 
 
 	Common::ScopedPtr<Common::SeekableReadStream> _stream;
 
+	const byte *_data; ///< The whole GFF3 data, owned by _stream.
+	size_t      _size; ///< The size of the GFF3 data.
+
 	Header _header; ///< The GFF3's header.
 
 	/** Should we try to read GFF3 files found in Neverwinter Nights premium modules? */
@@ -131,8 +182,18 @@ private:
 	/** The correctional value for offsets to repair Neverwinter Nights premium modules. */
 	uint32 _offsetCorrection;
 
-	StructArray _structs; ///< Our structs.
-	ListArray   _lists;   ///< Our lists.
+	/** Holds our structs and their fields, which all die with the GFF3. */
+	mutable Common::MemoryArena _arena;
+
+	/** Our structs, created on first access. */
+	mutable StructArray _structs;
+	/** Our lists, filled on first access. */
+	mutable ListArray _lists;
+	/** Has this list already been filled? */
+	mutable std::vector<bool> _listLoaded;
+
+	/** The labels as strings, read once they are needed and then shared by all structs. */
+	mutable std::vector<Common::UString> _labelNames;
 
 	/** To convert list offsets found in GFF3 to real indices. */
 	std::vector<uint32> _listOffsetToIndex;
@@ -140,16 +201,25 @@ private:
 
 	// .--- Loading helpers
 	void load(uint32 id);
+	void loadData();
 	void loadHeader(uint32 id);
 	void loadStructs();
 	void loadLists();
+
+	/** Check that this field and its label lie within the GFF3. */
+	void checkField(uint32 index) const;
 	// '---
 
 	// .--- Helper methods called by GFF3Struct
-	/** Return the GFF3 stream. */
-	Common::SeekableReadStream &getStream(uint32 offset) const;
-	/** Return the GFF3 stream seeked to the start of the field data. */
-	Common::SeekableReadStream &getFieldData() const;
+	/** Return a pointer to size bytes of GFF3 data at this offset. Throws if out of range. */
+	const byte *getData(size_t offset, size_t size) const;
+	/** Return a pointer to size bytes of the field data at this offset. Throws if out of range. */
+	const byte *getFieldData(uint32 offset, size_t size) const;
+
+	/** Return a pointer to the raw label data of this label. */
+	const byte *getLabelData(uint32 index) const;
+	/** Return the label as a string. */
+	const Common::UString &getLabelName(uint32 index) const;
 
 	/** Return a struct within the GFF3. */
 	const GFF3Struct &getStruct(uint32 i) const;
@@ -160,7 +230,11 @@ private:
 	friend class GFF3Struct;
 };
 
-/** A struct within a GFF3. */
+/** A struct within a GFF3.
+ *
+ *  The fields are read on first access, so, like its GFF3File, a GFF3Struct
+ *  is not thread-safe, not even through its const methods.
+ */
 class GFF3Struct {
 public:
 	/** The type of a GFF3 field. */
@@ -202,12 +276,14 @@ public:
 	size_t getFieldCount() const;
 	/** Does this specific field exist? */
 	bool hasField(const Common::UString &field) const;
+	bool hasField(const GFF3Label &field) const;
 
 	/** Return a list of all field names in this struct. */
 	const std::vector<Common::UString> &getFieldNames() const;
 
 	/** Return the type of this field, or kFieldTypeNone if such a field doesn't exist. */
 	FieldType getFieldType(const Common::UString &field) const;
+	FieldType getFieldType(const GFF3Label &field) const;
 
 
 	// .--- Read field values
@@ -216,43 +292,71 @@ public:
 	 int64 getSint(const Common::UString &field,  int64 def = 0    ) const;
 	bool   getBool(const Common::UString &field, bool   def = false) const;
 
+	char   getChar(const GFF3Label &field, char   def = '\0' ) const;
+	uint64 getUint(const GFF3Label &field, uint64 def = 0    ) const;
+	 int64 getSint(const GFF3Label &field,  int64 def = 0    ) const;
+	bool   getBool(const GFF3Label &field, bool   def = false) const;
+
 	double getDouble(const Common::UString &field, double def = 0.0) const;
+	double getDouble(const GFF3Label       &field, double def = 0.0) const;
 
 	Common::UString getString(const Common::UString &field,
 	                          const Common::UString &def = "") const;
+	Common::UString getString(const GFF3Label &field,
+	                          const Common::UString &def = "") const;
 
 	bool getLocString(const Common::UString &field, LocString &str) const;
+	bool getLocString(const GFF3Label       &field, LocString &str) const;
 
 	void getVector     (const Common::UString &field,
 	                    float &x, float &y, float &z          ) const;
 	void getOrientation(const Common::UString &field,
 	                    float &a, float &b, float &c, float &d) const;
 
+	void getVector     (const GFF3Label &field,
+	                    float &x, float &y, float &z          ) const;
+	void getOrientation(const GFF3Label &field,
+	                    float &a, float &b, float &c, float &d) const;
+
 	void getVector     (const Common::UString &field,
 	                    double &x, double &y, double &z           ) const;
 	void getOrientation(const Common::UString &field,
 	                    double &a, double &b, double &c, double &d) const;
 
+	void getVector     (const GFF3Label &field,
+	                    double &x, double &y, double &z           ) const;
+	void getOrientation(const GFF3Label &field,
+	                    double &a, double &b, double &c, double &d) const;
+
 	Common::SeekableReadStream *getData(const Common::UString &field) const;
+	Common::SeekableReadStream *getData(const GFF3Label       &field) const;
 	// '---
 
 	// .--- Structs and lists of structs
 	const GFF3Struct &getStruct(const Common::UString &field) const;
 	const GFF3List   &getList  (const Common::UString &field) const;
+
+	const GFF3Struct &getStruct(const GFF3Label &field) const;
+	const GFF3List   &getList  (const GFF3Label &field) const;
 	// '---
 
 private:
 	/** A field in the GFF3 struct. */
 	struct Field {
+		GFF3Label label;    ///< Label of the field.
 		FieldType type;     ///< Type of the field.
 		uint32    data;     ///< Data of the field.
 		bool      extended; ///< Does this field need extended data?
 
 		Field();
-		Field(FieldType t, uint32 d);
+		Field(const GFF3Label &l, FieldType t, uint32 d);
+
+		bool operator<(const Field &field) const;
+		bool operator<(const GFF3Label &l) const;
 	};
 
-	typedef std::map<Common::UString, Field> FieldMap;
+	/** The fields, sorted by their label. */
+	typedef std::vector<Field, Common::ArenaAllocator<Field> > FieldArray;
 
 
 	const GFF3File *_parent; ///< The parent GFF3.
@@ -261,10 +365,15 @@ private:
 	uint32 _fieldIndex; ///< Field / Field indices index.
 	uint32 _fieldCount; ///< Field count.
 
-	FieldMap _fields; ///< The fields, indexed by their label.
+	/** Have the fields been read yet? */
+	mutable bool _fieldsLoaded;
+	/** Have the field names been read yet? */
+	mutable bool _fieldNamesLoaded;
+
+	mutable FieldArray _fields; ///< The fields, sorted by their label.
 
 	/** The names of all fields in this struct. */
-	std::vector<Common::UString> _fieldNames;
+	mutable std::vector<Common::UString> _fieldNames;
 
 
 	// .--- Loader
@@ -273,25 +382,26 @@ private:
 
 	void load(uint32 offset);
 
-	void readField  (Common::SeekableReadStream &data, uint32 index);
-	void readFields (Common::SeekableReadStream &data, uint32 index, uint32 count);
-	void readIndices(Common::SeekableReadStream &data,
-	                 std::vector<uint32> &indices, uint32 count) const;
+	/** Read the fields, if that hasn't happened yet. */
+	void loadFields() const;
 
-	Common::UString readLabel(Common::SeekableReadStream &data, uint32 index) const;
+	/** Read the indices of this struct's fields, in the order they appear in the GFF3. */
+	void readFieldIndices(std::vector<uint32> &indices) const;
+	/** Return the raw data of a field. */
+	const byte *readField(uint32 index) const;
 	// '---
 
 	// .--- Field and field data accessors
-	/** Returns the field with this tag. */
-	const Field *getField(const Common::UString &name) const;
-	/** Returns the extended field data for this field. */
-	Common::SeekableReadStream &getData(const Field &field) const;
+	/** Returns the field with this label. */
+	const Field *getField(const GFF3Label &label) const;
+	/** Returns size bytes of the extended field data for this field. */
+	const byte *getData(const Field &field, size_t size) const;
+	/** Returns the extended field data for this field, prefixed by a 32-bit size. */
+	const byte *getSizedData(const Field &field, uint32 &size) const;
 	// '---
 
 	friend class GFF3File;
-
-	template<typename T>
-	friend void Common::DeallocatorDefault::destroy(T *);
+	friend class Common::MemoryArena;
 };
 
 } // End of namespace Aurora
@@ -159,12 +159,18 @@ uint32 HERFFile::getResourceSize(uint32 index) const {
 Common::SeekableReadStream *HERFFile::getResource(uint32 index, bool tryNoCopy) const {
 	const IResource &res = getIResource(index);
 
+	Common::SeekableReadStream *view = getMappedView(*_herf, res.offset, res.size);
+	if (view)
+		return view;
+
 	if (tryNoCopy)
-		return new Common::SeekableSubReadStream(_herf.get(), res.offset, res.offset + res.size);
+		return new Common::PositionalSubReadStream(_herf.get(), res.offset, res.offset + res.size);
 
-	_herf->seek(res.offset);
+	return _herf->readStreamAt(res.offset, res.size);
+}
 
-	return _herf->readStream(res.size);
+bool HERFFile::isThreadSafe() const {
+	return _herf->isReadAtThreadSafe();
 }
 
 Common::HashAlgo HERFFile::getNameHashAlgo() const {
@@ -0,0 +1,227 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A persistent cache of archive indices.
+ */
+
+/* The cache file is a simple little-endian binary file:
+ *
+ *  - uint32 ID ('XIDX')
+ *  - uint32 version
+ *  - uint32 number of entries
+ *  - for each entry:
+ *    - key, null-terminated UTF-8 string
+ *    - uint32 number of signature values
+ *    - uint64 signature values
+ *    - uint32 data size
+ *    - data
+ *
+ * The version needs to be bumped whenever the format of the cache file,
+ * or the format of any archive index, changes.
+ */
+
+#include <cstring>
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/filepath.h"
+#include "src/common/readfile.h"
+#include "src/common/writefile.h"
+#include "src/common/memreadstream.h"
+#include "src/common/encoding.h"
+
+#include "src/aurora/indexcache.h"
+
+static const uint32 kCacheID = MKTAG('X', 'I', 'D', 'X');
+static const uint32 kVersion = 1;
+
+namespace Aurora {
+
+IndexCache::IndexCache() : _changed(false) {
+}
+
+IndexCache::~IndexCache() {
+}
+
+bool IndexCache::isLoaded() const {
+	return !_fileName.empty();
+}
+
+void IndexCache::clear() {
+	_fileName.clear();
+	_entries.clear();
+
+	_changed = false;
+}
+
+void IndexCache::load(const Common::UString &fileName) {
+	clear();
+
+	_fileName = fileName;
+
+	if (!Common::FilePath::isRegularFile(_fileName))
+		return;
+
+	try {
+		Common::ReadFile cache(_fileName);
+
+		read(cache);
+
+	} catch (Common::Exception &e) {
+		_entries.clear();
+
+		e.add("Failed to read index cache \"%s\"", _fileName.c_str());
+		Common::printException(e, "WARNING: ");
+	}
+}
+
+void IndexCache::read(Common::SeekableReadStream &cache) {
+	const uint32 id      = cache.readUint32BE();
+	const uint32 version = cache.readUint32LE();
+
+	// An old cache is silently discarded
+	if ((id != kCacheID) || (version != kVersion))
+		return;
+
+	// Each entry needs at least 9 bytes: the key's terminator, the signature count and the size
+	const uint32 count = cache.readUint32LE();
+	if (count > ((cache.size() - cache.pos()) / 9))
+		throw Common::Exception("Invalid entry count %u", count);
+
+	for (uint32 i = 0; i < count; i++) {
+		const Common::UString key = Common::readString(cache, Common::kEncodingUTF8);
+
+		Entry &entry = _entries[key];
+
+		readSignature(cache, entry.signature);
+
+		const uint32 size = cache.readUint32LE();
+		if (size > (cache.size() - cache.pos()))
+			throw Common::Exception("Invalid entry size %u", size);
+
+		entry.data.resize(size);
+		if ((size > 0) && (cache.read(&entry.data[0], size) != size))
+			throw Common::Exception(Common::kReadError);
+	}
+}
+
+void IndexCache::save() {
+	if (!isLoaded() || !_changed)
+		return;
+
+	// Drop entries of archives that have vanished
+	for (EntryMap::iterator e = _entries.begin(); e != _entries.end(); ) {
+		if (!Common::FilePath::isRegularFile(e->first))
+			_entries.erase(e++);
+		else
+			++e;
+	}
+
+	try {
+		write(_fileName);
+	} catch (Common::Exception &e) {
+		e.add("Failed to write index cache \"%s\"", _fileName.c_str());
+		Common::printException(e, "WARNING: ");
+	}
+
+	_changed = false;
+}
+
+void IndexCache::write(const Common::UString &fileName) const {
+	Common::FilePath::createDirectories(Common::FilePath::getDirectory(fileName));
+
+	Common::WriteFile cache(fileName);
+
+	cache.writeUint32BE(kCacheID);
+	cache.writeUint32LE(kVersion);
+
+	cache.writeUint32LE(_entries.size());
+	for (EntryMap::const_iterator e = _entries.begin(); e != _entries.end(); ++e) {
+		Common::writeString(cache, e->first, Common::kEncodingUTF8);
+
+		writeSignature(cache, e->second.signature);
+
+		cache.writeUint32LE(e->second.data.size());
+		if (!e->second.data.empty())
+			cache.write(&e->second.data[0], e->second.data.size());
+	}
+
+	cache.flush();
+	cache.close();
+}
+
+bool IndexCache::addSignature(Signature &signature, const Common::UString &file) {
+	const size_t size = Common::FilePath::getFileSize(file);
+	if (size == Common::kFileInvalid)
+		return false;
+
+	signature.push_back(size);
+	signature.push_back(Common::FilePath::getModificationTime(file));
+
+	return true;
+}
+
+void IndexCache::readSignature(Common::SeekableReadStream &stream, Signature &signature) {
+	const uint32 count = stream.readUint32LE();
+	if (count > ((stream.size() - stream.pos()) / 8))
+		throw Common::Exception("Invalid signature size %u", count);
+
+	signature.resize(count);
+	for (Signature::iterator s = signature.begin(); s != signature.end(); ++s)
+		*s = stream.readUint64LE();
+}
+
+void IndexCache::writeSignature(Common::WriteStream &stream, const Signature &signature) {
+	stream.writeUint32LE(signature.size());
+	for (Signature::const_iterator s = signature.begin(); s != signature.end(); ++s)
+		stream.writeUint64LE(*s);
+}
+
+Common::SeekableReadStream *IndexCache::get(const Common::UString &key, const Signature &signature) const {
+	Common::StackLock lock(_mutex);
+
+	EntryMap::const_iterator entry = _entries.find(key);
+	if ((entry == _entries.end()) || (entry->second.signature != signature) || entry->second.data.empty())
+		return 0;
+
+	const std::vector<byte> &data = entry->second.data;
+
+	byte *copy = new byte[data.size()];
+	std::memcpy(copy, &data[0], data.size());
+
+	return new Common::MemoryReadStream(copy, data.size(), true);
+}
+
+void IndexCache::set(const Common::UString &key, const Signature &signature, const byte *data, size_t size) {
+	if (!isLoaded())
+		return;
+
+	Common::StackLock lock(_mutex);
+
+	Entry &entry = _entries[key];
+
+	entry.signature = signature;
+	entry.data.assign(data, data + size);
+
+	_changed = true;
+}
+
+} // End of namespace Aurora
@@ -0,0 +1,119 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A persistent cache of archive indices.
+ */
+
+#ifndef AURORA_INDEXCACHE_H
+#define AURORA_INDEXCACHE_H
+
+#include <vector>
+#include <map>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+#include "src/common/mutex.h"
+
+namespace Common {
+	class SeekableReadStream;
+	class WriteStream;
+}
+
+namespace Aurora {
+
+/** A persistent, on-disk cache of archive indices.
+ *
+ *  Parsing the resource tables of all archives a game uses can take quite
+ *  a while, especially for games with hundreds of archives. The IndexCache
+ *  stores the parsed indices (see Archive::writeIndex()) in one binary file,
+ *  which is read back in one go on later starts.
+ *
+ *  Each entry is keyed by the path of the archive, and carries a signature
+ *  made of the sizes and modification times of all files the entry was
+ *  created from. Entries whose signature doesn't match the files on disk
+ *  anymore are ignored, and replaced when the archive has been indexed anew.
+ *
+ *  Entries can be read and written from multiple threads at once.
+ */
+class IndexCache : boost::noncopyable {
+public:
+	/** The sizes and modification times of the files an entry was created from. */
+	typedef std::vector<uint64> Signature;
+
+	IndexCache();
+	~IndexCache();
+
+	/** Is the cache in use, i.e. was a cache file loaded? */
+	bool isLoaded() const;
+
+	/** Clear the cache, without saving it. */
+	void clear();
+
+	/** Load the cache file. A missing or invalid file results in an empty cache. */
+	void load(const Common::UString &fileName);
+	/** Write the cache back into the file it was loaded from, if it was changed. */
+	void save();
+
+	/** Add the size and modification time of a file to a signature.
+	 *
+	 *  @return false if the file doesn't exist.
+	 */
+	static bool addSignature(Signature &signature, const Common::UString &file);
+
+	/** Read a signature, as written by writeSignature(), out of a stream. */
+	static void readSignature(Common::SeekableReadStream &stream, Signature &signature);
+	/** Write a signature into a stream. */
+	static void writeSignature(Common::WriteStream &stream, const Signature &signature);
+
+	/** Return the data of a cache entry, or 0 if there's no entry with a matching signature.
+	 *
+	 *  The stream holds its own copy of the data, so it stays valid even when
+	 *  the entry is replaced while the stream is still in use.
+	 */
+	Common::SeekableReadStream *get(const Common::UString &key, const Signature &signature) const;
+	/** Create or replace a cache entry. */
+	void set(const Common::UString &key, const Signature &signature, const byte *data, size_t size);
+
+private:
+	struct Entry {
+		Signature signature;
+		std::vector<byte> data;
+	};
+
+	typedef std::map<Common::UString, Entry> EntryMap;
+
+	Common::UString _fileName;
+
+	EntryMap _entries;
+
+	bool _changed;
+
+	mutable Common::Mutex _mutex; ///< Mutex protecting the entries.
+
+	void read(Common::SeekableReadStream &cache);
+	void write(const Common::UString &fileName) const;
+};
+
+} // End of namespace Aurora
+
+#endif // AURORA_INDEXCACHE_H
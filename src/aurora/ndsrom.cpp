@@ -166,14 +166,18 @@ uint32 NDSFile::getResourceSize(uint32 index) const {
 Common::SeekableReadStream *NDSFile::getResource(uint32 index, bool tryNoCopy) const {
 	const IResource &res = getIResource(index);
 
-	_nds->seek(res.offset);
+	Common::SeekableReadStream *view = getMappedView(*_nds, res.offset, res.size);
+	if (view)
+		return view;
 
 	if (tryNoCopy)
-		return new Common::SeekableSubReadStream(_nds.get(), res.offset, res.offset + res.size);
+		return new Common::PositionalSubReadStream(_nds.get(), res.offset, res.offset + res.size);
 
-	_nds->seek(res.offset);
+	return _nds->readStreamAt(res.offset, res.size);
+}
 
-	return _nds->readStream(res.size);
+bool NDSFile::isThreadSafe() const {
+	return _nds->isReadAtThreadSafe();
 }
 
 } // End of namespace Aurora
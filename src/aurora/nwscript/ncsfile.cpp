@@ -28,6 +28,8 @@
  * a mirror (<https://github.com/xoreos/xoreos-docs>).
  */
 
+#include <algorithm>
+
 #include <boost/make_shared.hpp>
 
 #include "src/common/util.h"
@@ -35,12 +37,14 @@
 #include "src/common/maths.h"
 #include "src/common/ustring.h"
 #include "src/common/readstream.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memreader.h"
 #include "src/common/encoding.h"
 #include "src/common/debug.h"
-
-#include "src/aurora/resman.h"
+#include "src/common/debugman.h"
 
 #include "src/aurora/nwscript/ncsfile.h"
+#include "src/aurora/nwscript/ncsreg.h"
 #include "src/aurora/nwscript/object.h"
 #include "src/aurora/nwscript/functionman.h"
 
@@ -188,102 +192,416 @@ void NCSStack::print() const {
 }
 
 
-#define OPCODE(x) { &NCSFile::x, #x }
-#define OPCODE0() { 0, "" }
-
-void NCSFile::setupOpcodes() {
-	static const Opcode opcodes[] = {
-		// 0x00
-		OPCODE(o_nop), // Doesn't exist
-		OPCODE(o_cpdownsp),
-		OPCODE(o_rsadd),
-		OPCODE(o_cptopsp),
-		// 0x04
-		OPCODE(o_const),
-		OPCODE(o_action),
-		OPCODE(o_logand),
-		OPCODE(o_logor),
-		// 0x08
-		OPCODE(o_incor),
-		OPCODE(o_excor),
-		OPCODE(o_booland),
-		OPCODE(o_eq),
-		// 0x0C
-		OPCODE(o_neq),
-		OPCODE(o_geq),
-		OPCODE(o_gt),
-		OPCODE(o_lt),
-		// 0x10
-		OPCODE(o_leq),
-		OPCODE(o_shleft),
-		OPCODE(o_shright),
-		OPCODE(o_ushright),
-		// 0x14
-		OPCODE(o_add),
-		OPCODE(o_sub),
-		OPCODE(o_mul),
-		OPCODE(o_div),
-		// 0x18
-		OPCODE(o_mod),
-		OPCODE(o_neg),
-		OPCODE(o_comp),
-		OPCODE(o_movsp),
-		// 0x1C
-		OPCODE(o_storestateall),
-		OPCODE(o_jmp),
-		OPCODE(o_jsr),
-		OPCODE(o_jz),
-		// 0x20
-		OPCODE(o_retn),
-		OPCODE(o_destruct),
-		OPCODE(o_not),
-		OPCODE(o_decsp),
-		// 0x24
-		OPCODE(o_incsp),
-		OPCODE(o_jnz),
-		OPCODE(o_cpdownbp),
-		OPCODE(o_cptopbp),
-		// 0x28
-		OPCODE(o_decbp),
-		OPCODE(o_incbp),
-		OPCODE(o_savebp),
-		OPCODE(o_restorebp),
-		// 0x2C
-		OPCODE(o_storestate),
-		OPCODE(o_nop),
-		OPCODE0(),
-		OPCODE0(),
-		// 0x30
-		OPCODE(o_writearray),
-		OPCODE0(),
-		OPCODE(o_readarray),
-		OPCODE0(),
-		// 0x34
-		OPCODE0(),
-		OPCODE0(),
-		OPCODE0(),
-		OPCODE(o_getref),
-		// 0x38
-		OPCODE0(),
-		OPCODE(o_getrefarray)
-	};
-
-	_opcodes = opcodes;
-	_opcodeListSize = ARRAYSIZE(opcodes);
-}
-
-#undef OPCODE
-
-NCSFile::NCSFile(Common::SeekableReadStream *ncs) : _script(ncs), _owner(0), _triggerer(0) {
-	assert(_script);
+/** The names of the opcodes, for debug output. */
+static const char * const kOpcodeNames[] = {
+	// 0x00
+	"o_nop", // Doesn't exist
+	"o_cpdownsp",
+	"o_rsadd",
+	"o_cptopsp",
+	// 0x04
+	"o_const",
+	"o_action",
+	"o_logand",
+	"o_logor",
+	// 0x08
+	"o_incor",
+	"o_excor",
+	"o_booland",
+	"o_eq",
+	// 0x0C
+	"o_neq",
+	"o_geq",
+	"o_gt",
+	"o_lt",
+	// 0x10
+	"o_leq",
+	"o_shleft",
+	"o_shright",
+	"o_ushright",
+	// 0x14
+	"o_add",
+	"o_sub",
+	"o_mul",
+	"o_div",
+	// 0x18
+	"o_mod",
+	"o_neg",
+	"o_comp",
+	"o_movsp",
+	// 0x1C
+	"o_storestateall",
+	"o_jmp",
+	"o_jsr",
+	"o_jz",
+	// 0x20
+	"o_retn",
+	"o_destruct",
+	"o_not",
+	"o_decsp",
+	// 0x24
+	"o_incsp",
+	"o_jnz",
+	"o_cpdownbp",
+	"o_cptopbp",
+	// 0x28
+	"o_decbp",
+	"o_incbp",
+	"o_savebp",
+	"o_restorebp",
+	// 0x2C
+	"o_storestate",
+	"o_nop",
+	"",
+	"",
+	// 0x30
+	"o_writearray",
+	"",
+	"o_readarray",
+	"",
+	// 0x34
+	"",
+	"",
+	"",
+	"o_getref",
+	// 0x38
+	"",
+	"o_getrefarray"
+};
+
+static const char *getOpcodeName(uint8 opcode) {
+	if (opcode >= ARRAYSIZE(kOpcodeNames))
+		return "";
+
+	return kOpcodeNames[opcode];
+}
+
+static bool isJump(uint8 opcode) {
+	return (opcode == kOpcodeJMP) || (opcode == kOpcodeJSR) ||
+	       (opcode == kOpcodeJZ)  || (opcode == kOpcodeJNZ);
+}
+
+static bool isInstructionBefore(const NCSProgram::Instruction &instr, uint32 address) {
+	return instr.address < address;
+}
+
+static bool compareInstructions(const NCSProgram::Instruction &a, const NCSProgram::Instruction &b) {
+	return a.address < b.address;
+}
+
+/** Return the offset an instruction can continue the script at, other than the next instruction. */
+static bool getTarget(const NCSProgram::Instruction &instr, uint32 &target) {
+	if (isJump(instr.opcode)) {
+		target = instr.address + (uint32) instr.args[0];
+		return true;
+	}
+
+	if (instr.opcode == kOpcodeSTORESTATE) {
+		target = instr.address + instr.type;
+		return true;
+	}
+
+	return false;
+}
+
+
+NCSProgram::NCSProgram(Common::SeekableReadStream *ncs, const Common::UString &name) :
+	_name(name), _size(0) {
+
+	assert(ncs);
+
+	Common::ScopedPtr<Common::MemoryReadStream> data(Common::toMemoryReadStream(ncs));
+
+	load(*data);
+}
+
+NCSProgram::~NCSProgram() {
+}
+
+const Common::UString &NCSProgram::getName() const {
+	return _name;
+}
+
+size_t NCSProgram::getInstructionCount() const {
+	return _instructions.size();
+}
+
+const NCSProgram::Instruction *NCSProgram::getInstructions() const {
+	return _instructions.empty() ? 0 : &_instructions[0];
+}
+
+const Variable &NCSProgram::getConstant(size_t index) const {
+	assert(index < _constants.size());
+
+	return _constants[index];
+}
+
+size_t NCSProgram::findInstruction(uint32 address) const {
+	std::vector<Instruction>::const_iterator instr =
+		std::lower_bound(_instructions.begin(), _instructions.end(), address, isInstructionBefore);
+
+	if ((instr != _instructions.end()) && (instr->address == address))
+		return instr - _instructions.begin();
+
+	// Not even an opcode and a type fit here anymore, so the script ends
+	if ((address <= _size) && ((_size - address) < 2))
+		return _instructions.size();
+
+	return kInvalidIndex;
+}
+
+void NCSProgram::load(Common::MemoryReadStream &ncs) {
+	ncs.seek(0);
+
+	readHeader(ncs);
+
+	if (_id != kNCSTag)
+		throw Common::Exception("Try to load non-NCS file");
+
+	if (_version != kVersion10)
+		throw Common::Exception("Unsupported NCS file version %08X", _version);
+
+	byte lengthOpcode = ncs.readByte();
+	if (lengthOpcode != kOpcodeSCRIPTSIZE)
+		throw Common::Exception("Script size opcode != 0x42 (0x%02X)", lengthOpcode);
+
+	uint32 length = ncs.readUint32BE();
+	if (length > ((uint32) ncs.size()))
+		throw Common::Exception("Script size %u > stream size %u", length, (uint)ncs.size());
+	if (length < ((uint32) ncs.size()))
+		warning("TODO: NCSProgram::load(): Script size %u < stream size %u", length, (uint)ncs.size());
+
+	Common::MemoryReader reader(ncs);
+
+	decode(reader);
+	resolveJumps();
+}
+
+void NCSProgram::decode(Common::MemoryReader &ncs) {
+	std::map<Common::UString, size_t> strings;
+	Addresses addresses;
+
+	_size = ncs.size();
+
+	const uint32 codeStart = ncs.pos();
+
+	decodeRange(ncs, codeStart, addresses, strings);
+
+	/* Decoding a range stops at an instruction we can't decode, since we
+	 * can't know where the next one would start. Code behind it might
+	 * still be reached by a jump, though, so continue at every target.
+	 * A jump might also land in the middle of an instruction, and the
+	 * script then continues with whatever these bytes decode to. */
+	for (size_t i = 0; i < _instructions.size(); i++) {
+		uint32 target;
+		if (getTarget(_instructions[i], target) && (target >= codeStart) && (target < _size))
+			decodeRange(ncs, target, addresses, strings);
+	}
+
+	std::sort(_instructions.begin(), _instructions.end(), compareInstructions);
+}
+
+void NCSProgram::decodeRange(Common::MemoryReader &ncs, uint32 start, Addresses &addresses,
+                             std::map<Common::UString, size_t> &strings) {
+
+	ncs.seek(start);
+
+	// Each instruction is at least an opcode and a type byte
+	while ((ncs.size() - ncs.pos()) >= 2) {
+		// Joining code decoded before
+		if (addresses.find(ncs.pos()) != addresses.end())
+			return;
+
+		Instruction instr;
+
+		instr.address = ncs.pos();
+		instr.opcode  = ncs.readByte();
+		instr.type    = ncs.readByte();
+		instr.index   = kInvalidIndex;
+
+		instr.args[0] = instr.args[1] = instr.args[2] = 0;
+
+		bool decoded = false;
+		try {
+			decoded = decodeArguments(ncs, instr, strings);
+		} catch (Common::Exception &) {
+			instr.opcode = kOpcodeBroken;
+		}
+
+		// For now, the offset of the following instruction. resolveJumps() turns it into an index
+		instr.next = ncs.pos();
+
+		_instructions.push_back(instr);
+		addresses.insert(instr.address);
+
+		/* We can't know where the next instruction would start. Nothing
+		 * after this can be run, and running this one throws. */
+		if (!decoded)
+			return;
+	}
+}
+
+bool NCSProgram::decodeArguments(Common::MemoryReader &ncs, Instruction &instr,
+                                 std::map<Common::UString, size_t> &strings) {
+
+	switch (instr.opcode) {
+		case kOpcodeNone:
+		case kOpcodeRSADD:
+		case kOpcodeLOGAND:
+		case kOpcodeLOGOR:
+		case kOpcodeINCOR:
+		case kOpcodeEXCOR:
+		case kOpcodeBOOLAND:
+		case kOpcodeGEQ:
+		case kOpcodeGT:
+		case kOpcodeLT:
+		case kOpcodeLEQ:
+		case kOpcodeSHLEFT:
+		case kOpcodeSHRIGHT:
+		case kOpcodeUSHRIGHT:
+		case kOpcodeADD:
+		case kOpcodeSUB:
+		case kOpcodeMUL:
+		case kOpcodeDIV:
+		case kOpcodeMOD:
+		case kOpcodeNEG:
+		case kOpcodeCOMP:
+		case kOpcodeSTORESTATEALL:
+		case kOpcodeRETN:
+		case kOpcodeNOT:
+		case kOpcodeSAVEBP:
+		case kOpcodeRESTOREBP:
+		case kOpcodeNOP:
+			break;
+
+		case kOpcodeCPDOWNSP:
+		case kOpcodeCPTOPSP:
+		case kOpcodeCPDOWNBP:
+		case kOpcodeCPTOPBP:
+		case kOpcodeWRITEARRAY:
+		case kOpcodeREADARRAY:
+		case kOpcodeGETREF:
+		case kOpcodeGETREFARRAY:
+			// Stack offset and size
+			instr.args[0] = ncs.readSint32BE();
+			instr.args[1] = ncs.readSint16BE();
+			break;
+
+		case kOpcodeMOVSP:
+		case kOpcodeJMP:
+		case kOpcodeJSR:
+		case kOpcodeJZ:
+		case kOpcodeJNZ:
+		case kOpcodeDECSP:
+		case kOpcodeINCSP:
+		case kOpcodeDECBP:
+		case kOpcodeINCBP:
+			// Stack or jump offset
+			instr.args[0] = ncs.readSint32BE();
+			break;
+
+		case kOpcodeACTION:
+			// Routine number and argument count
+			instr.args[0] = ncs.readUint16BE();
+			instr.args[1] = ncs.readByte();
+			break;
+
+		case kOpcodeEQ:
+		case kOpcodeNEQ:
+			// Comparisons between two structs (or two vectors) come with the size of the type
+			if (instr.type == kInstTypeStructStruct)
+				instr.args[0] = ncs.readUint16BE();
+			break;
+
+		case kOpcodeDESTRUCT:
+			// Stack size, offset and size of the element to keep
+			instr.args[0] = ncs.readSint16BE();
+			instr.args[1] = ncs.readSint16BE();
+			instr.args[2] = ncs.readSint16BE();
+			break;
+
+		case kOpcodeSTORESTATE:
+			// Base-pointer and stack-pointer size
+			instr.args[0] = (int32) ncs.readUint32BE();
+			instr.args[1] = (int32) ncs.readUint32BE();
+			break;
+
+		case kOpcodeCONST:
+			switch (instr.type) {
+				case kInstTypeInt:
+					instr.index = addConstant(ncs.readSint32BE());
+					break;
+
+				case kInstTypeFloat:
+					instr.index = addConstant(ncs.readIEEEFloatBE());
+					break;
+
+				case kInstTypeString:
+				case kInstTypeResource: {
+					const size_t length = ncs.readUint16BE();
+
+					const byte *data = ncs.getData();
+					ncs.skip(length);
+
+					Common::MemoryReadStream stringStream(data, length);
+					const Common::UString string = Common::readStringFixed(stringStream, Common::kEncodingASCII, length);
+
+					// Scripts use the same strings over and over, so keep only one of each
+					std::map<Common::UString, size_t>::const_iterator s = strings.find(string);
+					if (s == strings.end())
+						s = strings.insert(std::make_pair(string, addConstant(string))).first;
+
+					instr.index = s->second;
+					break;
+				}
+
+				case kInstTypeObject:
+					// Depends on the owner, so it can only be resolved when running
+					instr.args[0] = (int32) ncs.readUint32BE();
+					break;
+
+				default:
+					return false;
+			}
+			break;
+
+		default:
+			return false;
+	}
+
+	return true;
+}
+
+void NCSProgram::resolveJumps() {
+	for (std::vector<Instruction>::iterator instr = _instructions.begin(); instr != _instructions.end(); ++instr) {
+		if (isJump(instr->opcode))
+			instr->index = findInstruction(instr->address + (uint32) instr->args[0]);
+
+		instr->next = (instr->opcode != kOpcodeBroken) ? findInstruction(instr->next) : kInvalidIndex;
+	}
+}
+
+size_t NCSProgram::addConstant(const Variable &value) {
+	_constants.push_back(value);
+
+	return _constants.size() - 1;
+}
+
+
+NCSFile::NCSFile(Common::SeekableReadStream *ncs) : _pc(0), _owner(0), _triggerer(0) {
+	_program.reset(new NCSProgram(ncs));
 
 	load();
 }
 
-NCSFile::NCSFile(const Common::UString &ncs) : _name(ncs), _owner(0), _triggerer(0) {
-	_script.reset(ResMan.getResource(ncs, kFileTypeNCS));
-	if (!_script)
-		throw Common::Exception("No such NCS \"%s\"", ncs.c_str());
+NCSFile::NCSFile(const Common::UString &ncs) : _name(ncs), _pc(0), _owner(0), _triggerer(0) {
+	_program = NCSReg.get(ncs);
+
+	load();
+}
+
+NCSFile::NCSFile(const NCSProgramPtr &program) : _name(program->getName()),
+	_program(program), _pc(0), _owner(0), _triggerer(0) {
 
 	load();
 }
@@ -312,25 +630,8 @@ ScriptState NCSFile::getEmptyState() {
 }
 
 void NCSFile::load() {
-	readHeader(*_script);
-
-	if (_id != kNCSTag)
-		throw Common::Exception("Try to load non-NCS file");
-
-	if (_version != kVersion10)
-		throw Common::Exception("Unsupported NCS file version %08X", _version);
-
-	byte lengthOpcode = _script->readByte();
-	if (lengthOpcode != 0x42)
-		throw Common::Exception("Script size opcode != 0x42 (0x%02X)", lengthOpcode);
-
-	uint32 length = _script->readUint32BE();
-	if (length > ((uint32) _script->size()))
-		throw Common::Exception("Script size %u > stream size %u", length, (uint)_script->size());
-	if (length < ((uint32) _script->size()))
-		warning("TODO: NCSFile::load(): Script size %u < stream size %u", length, (uint)_script->size());
-
-	setupOpcodes();
+	_id      = _program->getID();
+	_version = _program->getVersion();
 
 	reset();
 }
@@ -344,7 +645,7 @@ void NCSFile::reset() {
 	_storedState.setType(kTypeVoid);
 	_return.setType(kTypeVoid);
 
-	_script->seek(13); // 8 byte header + 5 byte program size dummy op
+	_pc = 0;
 }
 
 const Variable &NCSFile::run(Object *owner, Object *triggerer) {
@@ -357,7 +658,9 @@ const Variable &NCSFile::run(const ScriptState &state, Object *owner, Object *tr
 
 	reset();
 
-	_script->seek(state.offset);
+	_pc = _program->findInstruction(state.offset);
+	if (_pc == NCSProgram::kInvalidIndex)
+		throw Common::Exception("NCSFile::run(): No instruction at offset %u", state.offset);
 
 	// Push global variables
 	std::vector<class Variable>::const_reverse_iterator var;
@@ -377,8 +680,85 @@ const Variable &NCSFile::execute(Object *owner, Object *triggerer) {
 	_owner     = owner;
 	_triggerer = triggerer;
 
-	while (executeStep())
-		;
+	const Instruction *instructions = _program->getInstructions();
+	const size_t count = _program->getInstructionCount();
+
+	const bool debug = DebugMan.isEnabled(kDebugScripts, 1);
+
+	while (_pc < count) {
+		const Instruction &instr = instructions[_pc];
+
+		_pc = instr.next;
+
+		if (debug)
+			debugC(kDebugScripts, 1, "NWScript opcode %s [0x%02X]", getOpcodeName(instr.opcode), instr.opcode);
+
+		switch (instr.opcode) {
+			case kOpcodeNone:          o_nop(instr);           break;
+			case kOpcodeCPDOWNSP:      o_cpdownsp(instr);      break;
+			case kOpcodeRSADD:         o_rsadd(instr);         break;
+			case kOpcodeCPTOPSP:       o_cptopsp(instr);       break;
+			case kOpcodeCONST:         o_const(instr);         break;
+			case kOpcodeACTION:        o_action(instr);        break;
+			case kOpcodeLOGAND:        o_logand(instr);        break;
+			case kOpcodeLOGOR:         o_logor(instr);         break;
+			case kOpcodeINCOR:         o_incor(instr);         break;
+			case kOpcodeEXCOR:         o_excor(instr);         break;
+			case kOpcodeBOOLAND:       o_booland(instr);       break;
+			case kOpcodeEQ:            o_eq(instr);            break;
+			case kOpcodeNEQ:           o_neq(instr);           break;
+			case kOpcodeGEQ:           o_geq(instr);           break;
+			case kOpcodeGT:            o_gt(instr);            break;
+			case kOpcodeLT:            o_lt(instr);            break;
+			case kOpcodeLEQ:           o_leq(instr);           break;
+			case kOpcodeSHLEFT:        o_shleft(instr);        break;
+			case kOpcodeSHRIGHT:       o_shright(instr);       break;
+			case kOpcodeUSHRIGHT:      o_ushright(instr);      break;
+			case kOpcodeADD:           o_add(instr);           break;
+			case kOpcodeSUB:           o_sub(instr);           break;
+			case kOpcodeMUL:           o_mul(instr);           break;
+			case kOpcodeDIV:           o_div(instr);           break;
+			case kOpcodeMOD:           o_mod(instr);           break;
+			case kOpcodeNEG:           o_neg(instr);           break;
+			case kOpcodeCOMP:          o_comp(instr);          break;
+			case kOpcodeMOVSP:         o_movsp(instr);         break;
+			case kOpcodeSTORESTATEALL: o_storestateall(instr); break;
+			case kOpcodeJMP:           o_jmp(instr);           break;
+			case kOpcodeJSR:           o_jsr(instr);           break;
+			case kOpcodeJZ:            o_jz(instr);            break;
+			case kOpcodeRETN:          o_retn(instr);          break;
+			case kOpcodeDESTRUCT:      o_destruct(instr);      break;
+			case kOpcodeNOT:           o_not(instr);           break;
+			case kOpcodeDECSP:         o_decsp(instr);         break;
+			case kOpcodeINCSP:         o_incsp(instr);         break;
+			case kOpcodeJNZ:           o_jnz(instr);           break;
+			case kOpcodeCPDOWNBP:      o_cpdownbp(instr);      break;
+			case kOpcodeCPTOPBP:       o_cptopbp(instr);       break;
+			case kOpcodeDECBP:         o_decbp(instr);         break;
+			case kOpcodeINCBP:         o_incbp(instr);         break;
+			case kOpcodeSAVEBP:        o_savebp(instr);        break;
+			case kOpcodeRESTOREBP:     o_restorebp(instr);     break;
+			case kOpcodeSTORESTATE:    o_storestate(instr);    break;
+			case kOpcodeNOP:           o_nop(instr);           break;
+			case kOpcodeWRITEARRAY:    o_writearray(instr);    break;
+			case kOpcodeREADARRAY:     o_readarray(instr);     break;
+			case kOpcodeGETREF:        o_getref(instr);        break;
+			case kOpcodeGETREFARRAY:   o_getrefarray(instr);   break;
+
+			case kOpcodeBroken:
+				throw Common::Exception("NCSFile::execute(): Can't decode the instruction at %u",
+				                        instr.address);
+
+			default:
+				throw Common::Exception("NCSFile::execute(): Illegal instruction 0x%02x", instr.opcode);
+		}
+
+		if (debug) {
+			_stack.print();
+			debugC(kDebugScripts, 2, "[RETURN: %d]",
+			       _returnOffsets.empty() ? -1 : (int) _returnOffsets.top());
+		}
+	}
 
 	if (!_stack.empty())
 		_return = _stack.top();
@@ -393,44 +773,19 @@ const Variable &NCSFile::execute(Object *owner, Object *triggerer) {
 	return _return;
 }
 
-bool NCSFile::executeStep() {
-	byte opcode, type;
-
-	try {
-		opcode = _script->readByte();
-		type   = _script->readByte();
-	} catch (...) {
-		return false;
-	}
-
-	if ((opcode >= _opcodeListSize) || (!_opcodes[opcode].proc))
-		throw Common::Exception("NCSFile::executeStep(): Illegal instruction 0x%02x", opcode);
-
-	debugC(kDebugScripts, 1, "NWScript opcode %s [0x%02X]", _opcodes[opcode].desc, opcode);
-
-	(this->*(_opcodes[opcode].proc))((InstructionType)type);
-
-	_stack.print();
-	debugC(kDebugScripts, 2, "[RETURN: %d]",
-	       _returnOffsets.empty() ? -1 : _returnOffsets.top());
-
-	return true;
-}
-
-void NCSFile::decompile() {
-	uint32 oldScriptPos = _script->pos();
-	_script->seek(13); // 8 byte header + 5 byte program size dummy op
-
-	// TODO
+void NCSFile::jump(const Instruction &instr) {
+	if (instr.index == NCSProgram::kInvalidIndex)
+		throw Common::Exception("NCSFile::jump(): No instruction at jump target %u",
+		                        (uint) (instr.address + instr.args[0]));
 
-	_script->seek(oldScriptPos);
+	_pc = instr.index;
 }
 
 // OPCODES!
 
 /** RSADD: push an empty variable onto the stack. */
-void NCSFile::o_rsadd(InstructionType type) {
-	switch (type) {
+void NCSFile::o_rsadd(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeInt:
 			_stack.push(kTypeInt);
 			break;
@@ -466,26 +821,19 @@ void NCSFile::o_rsadd(InstructionType type) {
 			_stack.push(kTypeArray);
 			break;
 		default:
-			throw Common::Exception("NCSFile::o_rsadd(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_rsadd(): Illegal type %d", instr.type);
 	}
 }
 
 /** CONST: push a constant (predetermined value) variable onto the stack. */
-void NCSFile::o_const(InstructionType type) {
-	switch (type) {
+void NCSFile::o_const(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeInt:
-			_stack.push(_script->readSint32BE());
-			break;
-
 		case kInstTypeFloat:
-			_stack.push(_script->readIEEEFloatBE());
-			break;
-
 		case kInstTypeString:
-		case kInstTypeResource: {
-			_stack.push(Common::readStringFixed(*_script, Common::kEncodingASCII, _script->readUint16BE()));
+		case kInstTypeResource:
+			_stack.push(_program->getConstant(instr.index));
 			break;
-		}
 
 		case kInstTypeObject: {
 			/* The scripts only know of two constant objects:
@@ -496,7 +844,7 @@ void NCSFile::o_const(InstructionType type) {
 			 * magic values. They *should* all have the same effect, though.
 			 */
 
-			uint32 objectID = _script->readUint32BE();
+			uint32 objectID = (uint32) instr.args[0];
 
 			if      (objectID == kScriptObjectSelf)
 				_stack.push(_owner);
@@ -513,7 +861,7 @@ void NCSFile::o_const(InstructionType type) {
 		}
 
 		default:
-			throw Common::Exception("NCSFile::o_const(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_const(): Illegal type %d", instr.type);
 	}
 }
 
@@ -614,12 +962,12 @@ void NCSFile::callEngine(Aurora::NWScript::FunctionContext &ctx,
 }
 
 /** ACTION: call a game-specific engine function. */
-void NCSFile::o_action(InstructionType type) {
-	if (type != kInstTypeNone)
-		throw Common::Exception("NCSFile::o_action(): Illegal type %d", type);
+void NCSFile::o_action(const Instruction &instr) {
+	if (instr.type != kInstTypeNone)
+		throw Common::Exception("NCSFile::o_action(): Illegal type %d", instr.type);
 
-	uint16 routineNumber = _script->readUint16BE();
-	uint8  argCount      = _script->readByte();
+	uint16 routineNumber = instr.args[0];
+	uint8  argCount      = instr.args[1];
 
 	Aurora::NWScript::FunctionContext ctx = FunctionMan.createContext(routineNumber);
 
@@ -633,9 +981,9 @@ void NCSFile::o_action(InstructionType type) {
 }
 
 /** LOGAND: perform a logical boolean AND (&&). */
-void NCSFile::o_logand(InstructionType type) {
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_logand(): Illegal type %d", type);
+void NCSFile::o_logand(const Instruction &instr) {
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_logand(): Illegal type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -643,9 +991,9 @@ void NCSFile::o_logand(InstructionType type) {
 }
 
 /** LOGOR: perform a logical boolean OR (||). */
-void NCSFile::o_logor(InstructionType type) {
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_logor(): Illegal type %d", type);
+void NCSFile::o_logor(const Instruction &instr) {
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_logor(): Illegal type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -653,9 +1001,9 @@ void NCSFile::o_logor(InstructionType type) {
 }
 
 /** INCOR: perform a bit-wise inclusive OR (|). */
-void NCSFile::o_incor(InstructionType type) {
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_incor(): Illegal type %d", type);
+void NCSFile::o_incor(const Instruction &instr) {
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_incor(): Illegal type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -663,9 +1011,9 @@ void NCSFile::o_incor(InstructionType type) {
 }
 
 /** EXCOR: perform a bit-wise exclusive OR (^). */
-void NCSFile::o_excor(InstructionType type) {
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_excor(): Illegal type %d", type);
+void NCSFile::o_excor(const Instruction &instr) {
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_excor(): Illegal type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -673,9 +1021,9 @@ void NCSFile::o_excor(InstructionType type) {
 }
 
 /** BOOLAND: perform a bit-wise AND (&). */
-void NCSFile::o_booland(InstructionType type) {
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_booland(): Illegal type %d", type);
+void NCSFile::o_booland(const Instruction &instr) {
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_booland(): Illegal type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -683,13 +1031,13 @@ void NCSFile::o_booland(InstructionType type) {
 }
 
 /** EQ: compare the top-most stack elements for equality (==). */
-void NCSFile::o_eq(InstructionType type) {
+void NCSFile::o_eq(const Instruction &instr) {
 	size_t n = 1;
 
-	if (type == kInstTypeStructStruct) {
+	if (instr.type == kInstTypeStructStruct) {
 		// Comparisons between two structs (or two vectors) come with the size of the type
 
-		const size_t size = _script->readUint16BE();
+		const size_t size = instr.args[0];
 
 		if ((size % 4) != 0)
 			throw Common::Exception("NCSFile::o_eq(): size %% 4 != 0");
@@ -712,13 +1060,13 @@ void NCSFile::o_eq(InstructionType type) {
 }
 
 /** NEQ: compare the top-most stack elements for inequality (!=). */
-void NCSFile::o_neq(InstructionType type) {
+void NCSFile::o_neq(const Instruction &instr) {
 	size_t n = 1;
 
-	if (type == kInstTypeStructStruct) {
+	if (instr.type == kInstTypeStructStruct) {
 		// Comparisons between two structs (or two vectors) come with the size of the type
 
-		const size_t size = _script->readUint16BE();
+		const size_t size = instr.args[0];
 
 		if ((size % 4) != 0)
 			throw Common::Exception("NCSFile::o_neq(): size %% 4 != 0");
@@ -741,8 +1089,8 @@ void NCSFile::o_neq(InstructionType type) {
 }
 
 /** GEQ: compare the top-most stack elements, greater-or-equal (>=). */
-void NCSFile::o_geq(InstructionType type) {
-	switch (type) {
+void NCSFile::o_geq(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeIntInt:
 			{
 				int32 arg1 = _stack.pop().getInt();
@@ -760,13 +1108,13 @@ void NCSFile::o_geq(InstructionType type) {
 			break;
 
 		default:
-			throw Common::Exception("NCSFile::o_geq(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_geq(): Illegal type %d", instr.type);
 	}
 }
 
 /** GT: compare the top-most stack elements, greater (>). */
-void NCSFile::o_gt(InstructionType type) {
-	switch (type) {
+void NCSFile::o_gt(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeIntInt:
 			{
 				int32 arg1 = _stack.pop().getInt();
@@ -784,13 +1132,13 @@ void NCSFile::o_gt(InstructionType type) {
 			break;
 
 		default:
-			throw Common::Exception("NCSFile::o_gt(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_gt(): Illegal type %d", instr.type);
 	}
 }
 
 /** LT: compare the top-most stack elements, less (<). */
-void NCSFile::o_lt(InstructionType type) {
-	switch (type) {
+void NCSFile::o_lt(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeIntInt:
 			{
 				int32 arg1 = _stack.pop().getInt();
@@ -808,13 +1156,13 @@ void NCSFile::o_lt(InstructionType type) {
 			break;
 
 		default:
-			throw Common::Exception("NCSFile::o_lt(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_lt(): Illegal type %d", instr.type);
 	}
 }
 
 /** LEQ: compare the top-most stack elements, less-or-equal (<=). */
-void NCSFile::o_leq(InstructionType type) {
-	switch (type) {
+void NCSFile::o_leq(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeIntInt:
 			{
 				int32 arg1 = _stack.pop().getInt();
@@ -832,14 +1180,14 @@ void NCSFile::o_leq(InstructionType type) {
 			break;
 
 		default:
-			throw Common::Exception("NCSFile::o_leq(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_leq(): Illegal type %d", instr.type);
 	}
 }
 
 /** SHLEFT: shift the top-most stack element to the left (<<). */
-void NCSFile::o_shleft(InstructionType type) {
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_shleft(): Illegal type %d", type);
+void NCSFile::o_shleft(const Instruction &instr) {
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_shleft(): Illegal type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -847,15 +1195,15 @@ void NCSFile::o_shleft(InstructionType type) {
 }
 
 /** SHRIGHT: signed-shift the top-most stack element to the right (>>>). */
-void NCSFile::o_shright(InstructionType type) {
+void NCSFile::o_shright(const Instruction &instr) {
 	/* According to Skywing's NWNScriptLib
 	 * (<https://github.com/SkywingvL/nwn2dev-public/blob/master/NWNScriptLib/NWScriptVM.cpp#L2233>):
 	 * "The operation implemented here is actually a complex sequence that, if
 	 *  the amount to be shifted is negative, involves both a front-loaded and
 	 *  end-loaded negate built on top of a signed shift." */
 
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_shright(): Illegal type %d", type);
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_shright(): Illegal type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -868,14 +1216,14 @@ void NCSFile::o_shright(InstructionType type) {
 }
 
 /** USHRIGHT: shift the top-most stack element to the right (>>). */
-void NCSFile::o_ushright(InstructionType type) {
+void NCSFile::o_ushright(const Instruction &instr) {
 	/* According to Skywing's NWNScriptLib
 	 * (<https://github.com/SkywingvL/nwn2dev-public/blob/master/NWNScriptLib/NWScriptVM.cpp#L2272>):
 	 * "While this operator may have originally been intended to implement
 	 *  an unsigned shift, it actually performs an arithmetic (signed) shift." */
 
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_ushright(): Illegal type %d", type);
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_ushright(): Illegal type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -883,9 +1231,9 @@ void NCSFile::o_ushright(InstructionType type) {
 }
 
 /** MOD: calculate the remainder (modulo) of an integer division (%). */
-void NCSFile::o_mod(InstructionType type) {
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_mod(): Illegal type %d", type);
+void NCSFile::o_mod(const Instruction &instr) {
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_mod(): Illegal type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -899,8 +1247,8 @@ void NCSFile::o_mod(InstructionType type) {
 }
 
 /** NEQ: negate the top-most stack element (unary -). */
-void NCSFile::o_neg(InstructionType type) {
-	switch (type) {
+void NCSFile::o_neg(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeInt:
 			_stack.push(-_stack.pop().getInt());
 			break;
@@ -910,101 +1258,96 @@ void NCSFile::o_neg(InstructionType type) {
 			break;
 
 		default:
-			throw Common::Exception("NCSFile::o_neg(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_neg(): Illegal type %d", instr.type);
 	}
 }
 
 /** COMP: calculate the 1-complement of the top-most stack element (~). */
-void NCSFile::o_comp(InstructionType type) {
-	if (type != kInstTypeInt)
-		throw Common::Exception("NCSFile::o_comp(): Illegal type %d", type);
+void NCSFile::o_comp(const Instruction &instr) {
+	if (instr.type != kInstTypeInt)
+		throw Common::Exception("NCSFile::o_comp(): Illegal type %d", instr.type);
 
 	_stack.push(~_stack.pop().getInt());
 }
 
 /** MOVSP: pop elements off the stack. */
-void NCSFile::o_movsp(InstructionType type) {
-	if (type != kInstTypeNone)
-		throw Common::Exception("NCSFile::o_movsp(): Illegal type %d", type);
+void NCSFile::o_movsp(const Instruction &instr) {
+	if (instr.type != kInstTypeNone)
+		throw Common::Exception("NCSFile::o_movsp(): Illegal type %d", instr.type);
 
-	_stack.setStackPtr(_stack.getStackPtr() - _script->readSint32BE());
+	_stack.setStackPtr(_stack.getStackPtr() - instr.args[0]);
 }
 
 /** JMP: jump directly to a different script offset. */
-void NCSFile::o_jmp(InstructionType type) {
-	if (type != kInstTypeNone)
-		throw Common::Exception("NCSFile::o_jmp(): Illegal type %d", type);
+void NCSFile::o_jmp(const Instruction &instr) {
+	if (instr.type != kInstTypeNone)
+		throw Common::Exception("NCSFile::o_jmp(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
-	_script->skip(offset - 6);
+	jump(instr);
 }
 
 /** JZ: jump conditionally if the top-most stack element is 0. */
-void NCSFile::o_jz(InstructionType type) {
-	if (type != kInstTypeNone)
-		throw Common::Exception("NCSFile::o_jz(): Illegal type %d", type);
-
-	int32 offset = _script->readSint32BE();
+void NCSFile::o_jz(const Instruction &instr) {
+	if (instr.type != kInstTypeNone)
+		throw Common::Exception("NCSFile::o_jz(): Illegal type %d", instr.type);
 
 	if (!_stack.pop().getInt())
-		_script->skip(offset - 6);
+		jump(instr);
 }
 
 /** NOT: boolean-negate the top-most stack element (!). */
-void NCSFile::o_not(InstructionType type) {
-	if (type != kInstTypeInt)
-		throw Common::Exception("NCSFile::o_not(): Illegal type %d", type);
+void NCSFile::o_not(const Instruction &instr) {
+	if (instr.type != kInstTypeInt)
+		throw Common::Exception("NCSFile::o_not(): Illegal type %d", instr.type);
 
 	_stack.push(!_stack.pop().getInt());
 }
 
 /** DECSP: decrement the value of a stack element (--). */
-void NCSFile::o_decsp(InstructionType type) {
-	if (type != kInstTypeInt)
-		throw Common::Exception("NCSFile::o_decsp(): Illegal type %d", type);
+void NCSFile::o_decsp(const Instruction &instr) {
+	if (instr.type != kInstTypeInt)
+		throw Common::Exception("NCSFile::o_decsp(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
+	int32 offset = instr.args[0];
 
 	_stack.setRelSP(offset, _stack.getRelSP(offset).getInt() - 1);
 }
 
 /** INCSP: increment the value of a stack element (++). */
-void NCSFile::o_incsp(InstructionType type) {
-	if (type != kInstTypeInt)
-		throw Common::Exception("NCSFile::o_incsp(): Illegal type %d", type);
+void NCSFile::o_incsp(const Instruction &instr) {
+	if (instr.type != kInstTypeInt)
+		throw Common::Exception("NCSFile::o_incsp(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
+	int32 offset = instr.args[0];
 
 	_stack.setRelSP(offset, _stack.getRelSP(offset).getInt() + 1);
 }
 
 /** JNZ: jump conditionally if the top-most stack element is not 0. */
-void NCSFile::o_jnz(InstructionType type) {
-	if (type != kInstTypeNone)
-		throw Common::Exception("NCSFile::o_jnz(): Illegal type %d", type);
-
-	int32 offset = _script->readSint32BE();
+void NCSFile::o_jnz(const Instruction &instr) {
+	if (instr.type != kInstTypeNone)
+		throw Common::Exception("NCSFile::o_jnz(): Illegal type %d", instr.type);
 
 	if (_stack.pop().getInt())
-		_script->skip(offset - 6);
+		jump(instr);
 }
 
 /** DECBP: decrement the value of a base-pointer stack element (--). */
-void NCSFile::o_decbp(InstructionType type) {
-	if (type != kInstTypeInt)
-		throw Common::Exception("NCSFile::o_decbp(): Illegal type %d", type);
+void NCSFile::o_decbp(const Instruction &instr) {
+	if (instr.type != kInstTypeInt)
+		throw Common::Exception("NCSFile::o_decbp(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
+	int32 offset = instr.args[0];
 
 	_stack.setRelBP(offset, _stack.getRelBP(offset).getInt() - 1);
 }
 
 /** INCBP: increment the value of a base-pointer stack element (++). */
-void NCSFile::o_incbp(InstructionType type) {
-	if (type != kInstTypeInt)
-		throw Common::Exception("NCSFile::o_incbp(): Illegal type %d", type);
+void NCSFile::o_incbp(const Instruction &instr) {
+	if (instr.type != kInstTypeInt)
+		throw Common::Exception("NCSFile::o_incbp(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
+	int32 offset = instr.args[0];
 
 	_stack.setRelBP(offset, _stack.getRelBP(offset).getInt() + 1);
 }
@@ -1013,9 +1356,9 @@ void NCSFile::o_incbp(InstructionType type) {
  *
  *  Used to create an anchor point to access global variables.
  */
-void NCSFile::o_savebp(InstructionType type) {
-	if (type != kInstTypeNone)
-		throw Common::Exception("NCSFile::o_savebp(): Illegal type %d", type);
+void NCSFile::o_savebp(const Instruction &instr) {
+	if (instr.type != kInstTypeNone)
+		throw Common::Exception("NCSFile::o_savebp(): Illegal type %d", instr.type);
 
 	_stack.push(_stack.getBasePtr());
 	_stack.setBasePtr(_stack.getStackPtr());
@@ -1025,25 +1368,25 @@ void NCSFile::o_savebp(InstructionType type) {
  *
  *  Destroy the global variables anchor point after use.
  */
-void NCSFile::o_restorebp(InstructionType type) {
-	if (type != kInstTypeNone)
-		throw Common::Exception("NCSFile::o_restorebp(): Illegal type %d", type);
+void NCSFile::o_restorebp(const Instruction &instr) {
+	if (instr.type != kInstTypeNone)
+		throw Common::Exception("NCSFile::o_restorebp(): Illegal type %d", instr.type);
 
 	_stack.setBasePtr(_stack.pop().getInt());
 }
 
 /** NOP: no operation. */
-void NCSFile::o_nop(InstructionType UNUSED(type)) {
+void NCSFile::o_nop(const Instruction &UNUSED(instr)) {
 	// Nothing! Yay!
 }
 
 /** CPDOWNSP: copy a value into an existing stack element. */
-void NCSFile::o_cpdownsp(InstructionType type) {
-	if (type != kInstTypeDirect)
-		throw Common::Exception("NCSFile::o_cpdownsp(): Illegal type %d", type);
+void NCSFile::o_cpdownsp(const Instruction &instr) {
+	if (instr.type != kInstTypeDirect)
+		throw Common::Exception("NCSFile::o_cpdownsp(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
-	int16 size   = _script->readSint16BE();
+	int32 offset = instr.args[0];
+	int16 size   = instr.args[1];
 
 	if ((size % 4) != 0)
 		throw Common::Exception("NCSFile::o_cpdownsp(): Illegal size %d", size);
@@ -1059,12 +1402,12 @@ void NCSFile::o_cpdownsp(InstructionType type) {
 }
 
 /** CPTOPSP: push a copy of a stack element on top of the stack. */
-void NCSFile::o_cptopsp(InstructionType type) {
-	if (type != kInstTypeDirect)
-		throw Common::Exception("NCSFile::o_cptopsp(): Illegal type %d", type);
+void NCSFile::o_cptopsp(const Instruction &instr) {
+	if (instr.type != kInstTypeDirect)
+		throw Common::Exception("NCSFile::o_cptopsp(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
-	int16 size   = _script->readSint16BE();
+	int32 offset = instr.args[0];
+	int16 size   = instr.args[1];
 
 	if ((size % 4) != 0)
 		throw Common::Exception("NCSFile::o_cptopsp(): Illegal size %d", size);
@@ -1077,8 +1420,8 @@ void NCSFile::o_cptopsp(InstructionType type) {
 }
 
 /** ADD: add the top-most stack elements (+). */
-void NCSFile::o_add(InstructionType type) {
-	switch (type) {
+void NCSFile::o_add(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeIntInt: {
 			Variable op2 = _stack.pop();
 			Variable op1 = _stack.pop();
@@ -1134,13 +1477,13 @@ void NCSFile::o_add(InstructionType type) {
 		}
 
 		default:
-			throw Common::Exception("NCSFile::o_add(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_add(): Illegal type %d", instr.type);
 	}
 }
 
 /** SUB: subtract the top-most stack elements (-). */
-void NCSFile::o_sub(InstructionType type) {
-	switch (type) {
+void NCSFile::o_sub(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeIntInt: {
 			Variable op2 = _stack.pop();
 			Variable op1 = _stack.pop();
@@ -1188,13 +1531,13 @@ void NCSFile::o_sub(InstructionType type) {
 		}
 
 		default:
-			throw Common::Exception("NCSFile::o_sub(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_sub(): Illegal type %d", instr.type);
 	}
 }
 
 /** MUL: multiply the top-most stack elements (*). */
-void NCSFile::o_mul(InstructionType type) {
-	switch (type) {
+void NCSFile::o_mul(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeIntInt: {
 			Variable op2 = _stack.pop();
 			Variable op1 = _stack.pop();
@@ -1252,13 +1595,13 @@ void NCSFile::o_mul(InstructionType type) {
 		}
 
 		default:
-			throw Common::Exception("NCSFile::o_mul(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_mul(): Illegal type %d", instr.type);
 	}
 }
 
 /** DIV: divide the top-most stack elements (/). */
-void NCSFile::o_div(InstructionType type) {
-	switch (type) {
+void NCSFile::o_div(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeIntInt: {
 			Variable op2 = _stack.pop();
 			Variable op1 = _stack.pop();
@@ -1337,13 +1680,13 @@ void NCSFile::o_div(InstructionType type) {
 		}
 
 		default:
-			throw Common::Exception("NCSFile::o_div(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_div(): Illegal type %d", instr.type);
 	}
 }
 
 /** STORESTATEALL: unused, obsolete opcode. Hopefully. */
-void NCSFile::o_storestateall(InstructionType type) {
-	uint8  offset = (uint8) type;
+void NCSFile::o_storestateall(const Instruction &instr) {
+	uint8  offset = (uint8) instr.type;
 
 	// TODO: NCSFile::o_storestateall(): See o_storestate.
 	//       Supposedly obsolete. Whether it's used anywhere remains to be seen.
@@ -1351,37 +1694,35 @@ void NCSFile::o_storestateall(InstructionType type) {
 }
 
 /** JSR: call a subroutine. */
-void NCSFile::o_jsr(InstructionType type) {
-	if (type != kInstTypeNone)
-		throw Common::Exception("NCSFile::o_jsr(): Illegal type %d", type);
-
-	int32 offset = _script->readSint32BE();
+void NCSFile::o_jsr(const Instruction &instr) {
+	if (instr.type != kInstTypeNone)
+		throw Common::Exception("NCSFile::o_jsr(): Illegal type %d", instr.type);
 
-	// Push the current script position
-	_returnOffsets.push(_script->pos());
+	// Push the position of the next instruction
+	_returnOffsets.push(_pc);
 
-	_script->skip(offset - 6);
+	jump(instr);
 }
 
 /** RETN: return from a subroutine call. */
-void NCSFile::o_retn(InstructionType UNUSED(type)) {
-	uint32 returnAddress = _script->size();
+void NCSFile::o_retn(const Instruction &UNUSED(instr)) {
+	size_t returnAddress = _program->getInstructionCount();
 	if (!_returnOffsets.empty()) {
 		returnAddress = _returnOffsets.top();
 		_returnOffsets.pop();
 	}
 
-	_script->seek(returnAddress);
+	_pc = returnAddress;
 }
 
 /** DESTRUCT: remove elements from the stack.
  *
  *  Used to isolate struct elements.
  */
-void NCSFile::o_destruct(InstructionType UNUSED(type)) {
-	int16 stackSize        = _script->readSint16BE();
-	int16 dontRemoveOffset = _script->readSint16BE();
-	int16 dontRemoveSize   = _script->readSint16BE();
+void NCSFile::o_destruct(const Instruction &instr) {
+	int16 stackSize        = instr.args[0];
+	int16 dontRemoveOffset = instr.args[1];
+	int16 dontRemoveSize   = instr.args[2];
 
 	if ((stackSize % 4) != 0)
 		throw Common::Exception("NCSFile::o_destruct(): Illegal stack size %d", stackSize);
@@ -1412,12 +1753,12 @@ void NCSFile::o_destruct(InstructionType UNUSED(type)) {
  *
  *  Used to write into a global variable.
  */
-void NCSFile::o_cpdownbp(InstructionType type) {
-	if (type != kInstTypeDirect)
-		throw Common::Exception("NCSFile::o_cpdownbp(): Illegal type %d", type);
+void NCSFile::o_cpdownbp(const Instruction &instr) {
+	if (instr.type != kInstTypeDirect)
+		throw Common::Exception("NCSFile::o_cpdownbp(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE() - 4;
-	int16 size   = _script->readSint16BE();
+	int32 offset = instr.args[0] - 4;
+	int16 size   = instr.args[1];
 
 	if ((size % 4) != 0)
 		throw Common::Exception("NCSFile::o_cpdownbp(): Illegal size %d", size);
@@ -1436,12 +1777,12 @@ void NCSFile::o_cpdownbp(InstructionType type) {
  *
  *  Used to read from a global variable.
  */
-void NCSFile::o_cptopbp(InstructionType type) {
-	if (type != kInstTypeDirect)
-		throw Common::Exception("NCSFile::o_cptopbp(): Illegal type %d", type);
+void NCSFile::o_cptopbp(const Instruction &instr) {
+	if (instr.type != kInstTypeDirect)
+		throw Common::Exception("NCSFile::o_cptopbp(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE() - 4;
-	int16 size   = _script->readSint16BE();
+	int32 offset = instr.args[0] - 4;
+	int16 size   = instr.args[1];
 
 	if ((size % 4) != 0)
 		throw Common::Exception("NCSFile::o_cptopbp(): Illegal size %d", size);
@@ -1459,10 +1800,10 @@ void NCSFile::o_cptopbp(InstructionType type) {
  *  Used to create the "action" variables when calling an engine function that
  *  assigns a function to an object, or delays a function, or similar.
  */
-void NCSFile::o_storestate(InstructionType type) {
-	uint8  offset = (uint8) type;
-	uint32 sizeBP = _script->readUint32BE();
-	uint32 sizeSP = _script->readUint32BE();
+void NCSFile::o_storestate(const Instruction &instr) {
+	uint8  offset = (uint8) instr.type;
+	uint32 sizeBP = (uint32) instr.args[0];
+	uint32 sizeSP = (uint32) instr.args[1];
 
 	if ((sizeBP % 4) != 0)
 		throw Common::Exception("NCSFile::o_storestate(): Illegal BP size %d", sizeBP);
@@ -1472,7 +1813,7 @@ void NCSFile::o_storestate(InstructionType type) {
 	_storedState.setType(kTypeScriptState);
 	ScriptState &state = _storedState.getScriptState();
 
-	state.offset = _script->pos() - 10 + offset;
+	state.offset = instr.address + offset;
 
 	sizeBP /= 4;
 	sizeSP /= 4;
@@ -1495,12 +1836,12 @@ void NCSFile::o_storestate(InstructionType type) {
  *
  *  The index is popped off the stack, but the value written remains.
  */
-void NCSFile::o_writearray(InstructionType type) {
-	if (type != kInstTypeDirect)
-		throw Common::Exception("NCSFile::o_writearray(): Illegal type %d", type);
+void NCSFile::o_writearray(const Instruction &instr) {
+	if (instr.type != kInstTypeDirect)
+		throw Common::Exception("NCSFile::o_writearray(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
-	int16 size   = _script->readSint16BE();
+	int32 offset = instr.args[0];
+	int16 size   = instr.args[1];
 
 	if (size != 4)
 		throw Common::Exception("NCSFile::o_writearray(): Invalid size %d", size);
@@ -1530,12 +1871,12 @@ void NCSFile::o_writearray(InstructionType type) {
  *  The index is popped off the stack, and the value read out of the
  *  array is pushed on top.
  */
-void NCSFile::o_readarray(InstructionType type) {
-	if (type != kInstTypeDirect)
-		throw Common::Exception("NCSFile::o_readarray(): Illegal type %d", type);
+void NCSFile::o_readarray(const Instruction &instr) {
+	if (instr.type != kInstTypeDirect)
+		throw Common::Exception("NCSFile::o_readarray(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
-	int16 size   = _script->readSint16BE();
+	int32 offset = instr.args[0];
+	int16 size   = instr.args[1];
 
 	if (size != 4)
 		throw Common::Exception("NCSFile::o_readarray(): Invalid size %d", size);
@@ -1562,12 +1903,12 @@ void NCSFile::o_readarray(InstructionType type) {
  *  The offset to the variable to create a reference to is passed
  *  as a direct argument to the instruction.
  */
-void NCSFile::o_getref(InstructionType type) {
-	if (type != kInstTypeDirect)
-		throw Common::Exception("NCSFile::o_getref(): Illegal type %d", type);
+void NCSFile::o_getref(const Instruction &instr) {
+	if (instr.type != kInstTypeDirect)
+		throw Common::Exception("NCSFile::o_getref(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
-	int16 size   = _script->readSint16BE();
+	int32 offset = instr.args[0];
+	int16 size   = instr.args[1];
 
 	if (size != 4)
 		throw Common::Exception("NCSFile::o_getref(): Invalid size %d", size);
@@ -1593,12 +1934,12 @@ void NCSFile::o_getref(InstructionType type) {
  *  The index is popped off the stack, and the reference to the
  *  variable inside the array is pushed on top.
  */
-void NCSFile::o_getrefarray(InstructionType type) {
-	if (type != kInstTypeDirect)
-		throw Common::Exception("NCSFile::o_getrefarray(): Illegal type %d", type);
+void NCSFile::o_getrefarray(const Instruction &instr) {
+	if (instr.type != kInstTypeDirect)
+		throw Common::Exception("NCSFile::o_getrefarray(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
-	int16 size   = _script->readSint16BE();
+	int32 offset = instr.args[0];
+	int16 size   = instr.args[1];
 
 	if (size != 4)
 		throw Common::Exception("NCSFile::o_getrefarray(): Invalid size %d", size);
@@ -27,9 +27,15 @@
 
 #include <vector>
 #include <stack>
+#include <map>
+#include <set>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
 
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
+#include "src/common/ustring.h"
 
 #include "src/aurora/types.h"
 #include "src/aurora/aurorafile.h"
@@ -39,8 +45,9 @@
 #include "src/aurora/nwscript/variablecontainer.h"
 
 namespace Common {
-	class UString;
 	class SeekableReadStream;
+	class MemoryReadStream;
+	class MemoryReader;
 }
 
 namespace Aurora {
@@ -79,13 +86,217 @@ private:
 	int32 _basePtr;
 };
 
-#define DECLARE_OPCODE(x) void x(InstructionType type)
+/** The opcode of an NCS instruction. */
+enum Opcode {
+	kOpcodeNone          = 0x00, ///< Doesn't exist, treated as a no-op.
+	kOpcodeCPDOWNSP      = 0x01,
+	kOpcodeRSADD         = 0x02,
+	kOpcodeCPTOPSP       = 0x03,
+	kOpcodeCONST         = 0x04,
+	kOpcodeACTION        = 0x05,
+	kOpcodeLOGAND        = 0x06,
+	kOpcodeLOGOR         = 0x07,
+	kOpcodeINCOR         = 0x08,
+	kOpcodeEXCOR         = 0x09,
+	kOpcodeBOOLAND       = 0x0A,
+	kOpcodeEQ            = 0x0B,
+	kOpcodeNEQ           = 0x0C,
+	kOpcodeGEQ           = 0x0D,
+	kOpcodeGT            = 0x0E,
+	kOpcodeLT            = 0x0F,
+	kOpcodeLEQ           = 0x10,
+	kOpcodeSHLEFT        = 0x11,
+	kOpcodeSHRIGHT       = 0x12,
+	kOpcodeUSHRIGHT      = 0x13,
+	kOpcodeADD           = 0x14,
+	kOpcodeSUB           = 0x15,
+	kOpcodeMUL           = 0x16,
+	kOpcodeDIV           = 0x17,
+	kOpcodeMOD           = 0x18,
+	kOpcodeNEG           = 0x19,
+	kOpcodeCOMP          = 0x1A,
+	kOpcodeMOVSP         = 0x1B,
+	kOpcodeSTORESTATEALL = 0x1C,
+	kOpcodeJMP           = 0x1D,
+	kOpcodeJSR           = 0x1E,
+	kOpcodeJZ            = 0x1F,
+	kOpcodeRETN          = 0x20,
+	kOpcodeDESTRUCT      = 0x21,
+	kOpcodeNOT           = 0x22,
+	kOpcodeDECSP         = 0x23,
+	kOpcodeINCSP         = 0x24,
+	kOpcodeJNZ           = 0x25,
+	kOpcodeCPDOWNBP      = 0x26,
+	kOpcodeCPTOPBP       = 0x27,
+	kOpcodeDECBP         = 0x28,
+	kOpcodeINCBP         = 0x29,
+	kOpcodeSAVEBP        = 0x2A,
+	kOpcodeRESTOREBP     = 0x2B,
+	kOpcodeSTORESTATE    = 0x2C,
+	kOpcodeNOP           = 0x2D,
+	kOpcodeWRITEARRAY    = 0x30,
+	kOpcodeREADARRAY     = 0x32,
+	kOpcodeGETREF        = 0x37,
+	kOpcodeGETREFARRAY   = 0x39,
+	kOpcodeSCRIPTSIZE    = 0x42, ///< The program size, only found in the header.
+
+	kOpcodeBroken        = 0xFF  ///< An instruction cut off by the end of the script or by other code.
+};
+
+/** The type of an NCS instruction, the byte following the opcode. */
+enum InstructionType {
+	// Unary
+	kInstTypeNone        =  0,
+	kInstTypeDirect      =  1,
+	kInstTypeInt         =  3,
+	kInstTypeFloat       =  4,
+	kInstTypeString      =  5,
+	kInstTypeObject      =  6,
+	kInstTypeResource    = 96,
+	kInstTypeEngineType0 = 16, // NWN:     effect        DA: event
+	kInstTypeEngineType1 = 17, // NWN:     event         DA: location
+	kInstTypeEngineType2 = 18, // NWN:     location      DA: command
+	kInstTypeEngineType3 = 19, // NWN:     talent        DA: effect
+	kInstTypeEngineType4 = 20, // NWN:     itemproperty  DA: itemproperty
+	kInstTypeEngineType5 = 21, // Witcher: mod           DA: player
+
+	// Arrays
+	kInstTypeIntArray          = 64,
+	kInstTypeFloatArray        = 65,
+	kInstTypeStringArray       = 66,
+	kInstTypeObjectArray       = 67,
+	kInstTypeResourceArray     = 68,
+	kInstTypeEngineType0Array  = 80,
+	kInstTypeEngineType1Array  = 81,
+	kInstTypeEngineType2Array  = 82,
+	kInstTypeEngineType3Array  = 83,
+	kInstTypeEngineType4Array  = 84,
+	kInstTypeEngineType5Array  = 85,
+
+	// Binary
+	kInstTypeIntInt                 = 32,
+	kInstTypeFloatFloat             = 33,
+	kInstTypeObjectObject           = 34,
+	kInstTypeStringString           = 35,
+	kInstTypeStructStruct           = 36,
+	kInstTypeIntFloat               = 37,
+	kInstTypeFloatInt               = 38,
+	kInstTypeEngineType0EngineType0 = 48,
+	kInstTypeEngineType1EngineType1 = 49,
+	kInstTypeEngineType2EngineType2 = 50,
+	kInstTypeEngineType3EngineType3 = 51,
+	kInstTypeEngineType4EngineType4 = 52,
+	kInstTypeEngineType5EngineType5 = 53,
+	kInstTypeVectorVector           = 58,
+	kInstTypeVectorFloat            = 59,
+	kInstTypeFloatVector            = 60
+};
+
+/** The program of an NCS: its decoded, unchanging instructions.
+ *
+ *  When loading, the bytecode is decoded into an array of instructions
+ *  once, with all direct arguments read, jump targets resolved to
+ *  instruction indices and constants prepared as variables. Running the
+ *  script then only steps through that array.
+ *
+ *  A program holds nothing that changes while the script runs, so it can
+ *  be shared between any number of NCSFile instances running it, even at
+ *  the same time. See NCSRegistry.
+ */
+class NCSProgram : boost::noncopyable, public AuroraFile {
+public:
+	/** A decoded instruction. */
+	struct Instruction {
+		uint32 address; ///< The offset of the instruction within the NCS file.
+
+		uint8 opcode; ///< The Opcode.
+		uint8 type;   ///< The InstructionType.
+
+		/** The direct arguments, like stack offsets and sizes, in the order they appear. */
+		int32 args[3];
+
+		/** For jumps, the index of the target instruction. For constants, the index of the value. */
+		size_t index;
+
+		/** The index of the instruction directly following this one within the NCS file.
+		 *
+		 *  This isn't always the next instruction in the array: when a jump lands
+		 *  in the middle of another instruction, the code from there on is decoded
+		 *  on its own, overlapping the instructions decoded before.
+		 */
+		size_t next;
+	};
+
+	/** Marks an instruction index that doesn't point to the start of any instruction. */
+	static const size_t kInvalidIndex = SIZE_MAX;
+
+	/** Take over this stream and read the program out of it. */
+	NCSProgram(Common::SeekableReadStream *ncs, const Common::UString &name = "");
+	~NCSProgram();
+
+	const Common::UString &getName() const;
+
+	/** Return the number of instructions. */
+	size_t getInstructionCount() const;
+	/** Return all instructions. */
+	const Instruction *getInstructions() const;
 
-/** An NCS, BioWare's NWN Compile Script. */
+	/** Return a constant value an instruction refers to. */
+	const Variable &getConstant(size_t index) const;
+
+	/** Return the index of the instruction starting at this offset within the NCS file.
+	 *
+	 *  An offset at the end of the script, where not even the opcode of another
+	 *  instruction fits anymore, yields the instruction count. Any other offset
+	 *  not starting an instruction yields kInvalidIndex.
+	 */
+	size_t findInstruction(uint32 address) const;
+
+private:
+	Common::UString _name;
+
+	std::vector<Instruction> _instructions;
+	std::vector<Variable> _constants;
+
+	/** The size of the NCS file. */
+	uint32 _size;
+
+	/** The offsets of all instructions decoded so far. */
+	typedef std::set<uint32> Addresses;
+
+	void load(Common::MemoryReadStream &ncs);
+
+	/** Decode all instructions that can be reached from the start of the script. */
+	void decode(Common::MemoryReader &ncs);
+	/** Decode the instructions starting at this offset, until we reach an instruction
+	 *  decoded before, the end of the script, or an instruction we can't decode. */
+	void decodeRange(Common::MemoryReader &ncs, uint32 start, Addresses &addresses,
+	                 std::map<Common::UString, size_t> &strings);
+	/** Read the direct arguments of an instruction. Return false if we can't decode it. */
+	bool decodeArguments(Common::MemoryReader &ncs, Instruction &instr,
+	                     std::map<Common::UString, size_t> &strings);
+	/** Resolve the jump offsets and following instructions into instruction indices. */
+	void resolveJumps();
+
+	size_t addConstant(const Variable &value);
+};
+
+typedef boost::shared_ptr<const NCSProgram> NCSProgramPtr;
+
+#define DECLARE_OPCODE(x) void x(const Instruction &instr)
+
+/** An NCS, BioWare's NWN Compile Script.
+ *
+ *  This is a script being run: its stack and position, on top of the
+ *  program it runs. Scripts created by name take their program out of
+ *  the NCSRegistry, so running the same script again doesn't need to
+ *  load it again.
+ */
 class NCSFile : public AuroraFile {
 public:
 	NCSFile(Common::SeekableReadStream *ncs);
 	NCSFile(const Common::UString &ncs);
+	NCSFile(const NCSProgramPtr &program);
 	~NCSFile();
 
 	const Common::UString &getName() const;
@@ -110,58 +321,16 @@ public:
 	static ScriptState getEmptyState();
 
 private:
-	enum InstructionType {
-		// Unary
-		kInstTypeNone        =  0,
-		kInstTypeDirect      =  1,
-		kInstTypeInt         =  3,
-		kInstTypeFloat       =  4,
-		kInstTypeString      =  5,
-		kInstTypeObject      =  6,
-		kInstTypeResource    = 96,
-		kInstTypeEngineType0 = 16, // NWN:     effect        DA: event
-		kInstTypeEngineType1 = 17, // NWN:     event         DA: location
-		kInstTypeEngineType2 = 18, // NWN:     location      DA: command
-		kInstTypeEngineType3 = 19, // NWN:     talent        DA: effect
-		kInstTypeEngineType4 = 20, // NWN:     itemproperty  DA: itemproperty
-		kInstTypeEngineType5 = 21, // Witcher: mod           DA: player
-
-		// Arrays
-		kInstTypeIntArray          = 64,
-		kInstTypeFloatArray        = 65,
-		kInstTypeStringArray       = 66,
-		kInstTypeObjectArray       = 67,
-		kInstTypeResourceArray     = 68,
-		kInstTypeEngineType0Array  = 80,
-		kInstTypeEngineType1Array  = 81,
-		kInstTypeEngineType2Array  = 82,
-		kInstTypeEngineType3Array  = 83,
-		kInstTypeEngineType4Array  = 84,
-		kInstTypeEngineType5Array  = 85,
-
-		// Binary
-		kInstTypeIntInt                 = 32,
-		kInstTypeFloatFloat             = 33,
-		kInstTypeObjectObject           = 34,
-		kInstTypeStringString           = 35,
-		kInstTypeStructStruct           = 36,
-		kInstTypeIntFloat               = 37,
-		kInstTypeFloatInt               = 38,
-		kInstTypeEngineType0EngineType0 = 48,
-		kInstTypeEngineType1EngineType1 = 49,
-		kInstTypeEngineType2EngineType2 = 50,
-		kInstTypeEngineType3EngineType3 = 51,
-		kInstTypeEngineType4EngineType4 = 52,
-		kInstTypeEngineType5EngineType5 = 53,
-		kInstTypeVectorVector           = 58,
-		kInstTypeVectorFloat            = 59,
-		kInstTypeFloatVector            = 60
-	};
+	typedef NCSProgram::Instruction Instruction;
 
 	Common::UString _name;
 
+	NCSProgramPtr _program;
+
 	NCSStack _stack;
-	Common::ScopedPtr<Common::SeekableReadStream> _script;
+
+	/** The index of the next instruction to execute. */
+	size_t _pc;
 
 	Variable _return;
 
@@ -170,19 +339,11 @@ private:
 
 	VariableContainer _env;
 
-	std::stack<uint32> _returnOffsets;
+	/** Indices of the instructions to return to from subroutines. */
+	std::stack<size_t> _returnOffsets;
 
 	Variable _storedState;
 
-	typedef void (NCSFile::*OpcodeProc)(InstructionType type);
-	struct Opcode {
-		OpcodeProc proc;
-		const char *desc;
-	};
-	const Opcode *_opcodes;
-	size_t _opcodeListSize;
-	void setupOpcodes();
-
 	void load();
 
 	/** Reset the script for another execution. */
@@ -190,10 +351,8 @@ private:
 
 	const Variable &execute(Object *owner = 0, Object *triggerer = 0);
 
-	/** Execute one script step. */
-	bool executeStep();
-
-	void decompile(); // TODO
+	/** Continue execution at the target of this jump instruction. */
+	void jump(const Instruction &instr);
 
 	void callEngine(Aurora::NWScript::FunctionContext &ctx, uint32 function, uint8 argCount);
 
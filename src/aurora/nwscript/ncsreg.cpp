@@ -0,0 +1,92 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  The global registry of loaded NWScript programs.
+ */
+
+#include "src/common/error.h"
+#include "src/common/scopedptr.h"
+#include "src/common/readstream.h"
+
+#include "src/aurora/types.h"
+#include "src/aurora/resman.h"
+
+#include "src/aurora/nwscript/ncsreg.h"
+
+DECLARE_SINGLETON(Aurora::NWScript::NCSRegistry)
+
+namespace Aurora {
+
+namespace NWScript {
+
+NCSRegistry::NCSRegistry() {
+}
+
+NCSRegistry::~NCSRegistry() {
+	clear();
+}
+
+void NCSRegistry::clear() {
+	_programs.clear();
+}
+
+NCSProgramPtr NCSRegistry::get(const Common::UString &name) {
+	const ResRef resRef(name);
+
+	ProgramMap::const_iterator program = _programs.find(resRef);
+	if (program != _programs.end())
+		// Entry exists => return
+		return program->second;
+
+	// Entry doesn't exist => load and add
+
+	NCSProgramPtr newProgram(load(resRef));
+
+	_programs.insert(std::make_pair(resRef, newProgram));
+
+	return newProgram;
+}
+
+void NCSRegistry::preload(const std::vector<Common::UString> &names) {
+	for (std::vector<Common::UString>::const_iterator n = names.begin(); n != names.end(); ++n) {
+		try {
+			get(*n);
+		} catch (...) {
+			Common::exceptionDispatcherWarning("Failed preloading script \"%s\"", n->c_str());
+		}
+	}
+}
+
+void NCSRegistry::remove(const Common::UString &name) {
+	_programs.erase(ResRef(name));
+}
+
+NCSProgram *NCSRegistry::load(const ResRef &name) {
+	Common::SeekableReadStream *ncs = ResMan.getResource(name, kFileTypeNCS);
+	if (!ncs)
+		throw Common::Exception("No such NCS \"%s\"", name.getString().c_str());
+
+	return new NCSProgram(ncs, name.getString());
+}
+
+} // End of namespace NWScript
+
+} // End of namespace Aurora
@@ -0,0 +1,93 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  The global registry of loaded NWScript programs.
+ */
+
+#ifndef AURORA_NWSCRIPT_NCSREG_H
+#define AURORA_NWSCRIPT_NCSREG_H
+
+#include <vector>
+
+#include <boost/unordered/unordered_map.hpp>
+
+#include "src/common/singleton.h"
+#include "src/common/ustring.h"
+
+#include "src/aurora/resref.h"
+
+#include "src/aurora/nwscript/ncsfile.h"
+
+namespace Aurora {
+
+namespace NWScript {
+
+/** The global NCS registry, holding the programs of all scripts run so far.
+ *
+ *  Scripts like heartbeats and conversation conditionals are run over and
+ *  over again. Instead of loading them anew each time, an NCSFile created
+ *  by name takes the program out of this registry, and only the state of
+ *  the run itself is created fresh.
+ *
+ *  Like the TwoDARegistry, all programs are held in memory until clear()
+ *  is called. This has to be done whenever the resources the scripts come
+ *  from change, most likely when a module is unloaded. Scripts still
+ *  running keep their program alive on their own.
+ *
+ *  The modules of the Aurora games list scripts that should be cached in
+ *  their IFO, see IFOFile::getNSSCache(). These can be loaded up front with
+ *  preload().
+ */
+class NCSRegistry : public Common::Singleton<NCSRegistry> {
+public:
+	NCSRegistry();
+	~NCSRegistry();
+
+	void clear();
+
+	/** Get the program of a certain script, loading it if necessary. */
+	NCSProgramPtr get(const Common::UString &name);
+
+	/** Load the programs of all these scripts that aren't loaded yet.
+	 *
+	 *  Scripts that fail to load are skipped with a warning.
+	 */
+	void preload(const std::vector<Common::UString> &names);
+
+	/** Remove the program of a certain script from the registry. */
+	void remove(const Common::UString &name);
+
+private:
+	typedef boost::unordered_map<ResRef, NCSProgramPtr> ProgramMap;
+
+	ProgramMap _programs;
+
+	NCSProgram *load(const ResRef &name);
+};
+
+} // End of namespace NWScript
+
+} // End of namespace Aurora
+
+/** Shortcut for accessing the NCS registry. */
+#define NCSReg ::Aurora::NWScript::NCSRegistry::instance()
+
+#endif // AURORA_NWSCRIPT_NCSREG_H
@@ -0,0 +1,179 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Reading resources in the background.
+ */
+
+#include "src/common/util.h"
+#include "src/common/readstream.h"
+
+#include "src/aurora/prefetch.h"
+
+namespace Aurora {
+
+AsyncResource::AsyncResource(const Reader &reader) : _reader(reader), _state(kStateQueued),
+	_failed(false), _done(_mutex) {
+
+}
+
+AsyncResource::AsyncResource(Common::SeekableReadStream *stream) : _state(kStateDone),
+	_stream(stream), _failed(false), _done(_mutex) {
+
+}
+
+AsyncResource::~AsyncResource() {
+}
+
+bool AsyncResource::isDone() {
+	Common::StackLock lock(_mutex);
+
+	return _state == kStateDone;
+}
+
+void AsyncResource::wait() {
+	// If no thread has picked us up yet, don't wait for one
+	read();
+
+	Common::StackLock lock(_mutex);
+
+	while (_state != kStateDone)
+		_done.wait();
+}
+
+Common::SeekableReadStream *AsyncResource::getStream() {
+	wait();
+
+	Common::StackLock lock(_mutex);
+
+	if (_failed) {
+		_failed = false;
+
+		throw _error;
+	}
+
+	return _stream.release();
+}
+
+void AsyncResource::read() {
+	{
+		Common::StackLock lock(_mutex);
+
+		if (_state != kStateQueued)
+			return;
+
+		_state = kStateReading;
+	}
+
+	Common::ScopedPtr<Common::SeekableReadStream> stream;
+	Common::Exception error;
+	bool failed = false;
+
+	try {
+		stream.reset(_reader());
+	} catch (Common::Exception &e) {
+		error  = e;
+		failed = true;
+	} catch (std::exception &e) {
+		error  = Common::Exception(e);
+		failed = true;
+	}
+
+	Common::StackLock lock(_mutex);
+
+	_stream.reset(stream.release());
+	_failed = failed;
+	_error  = error;
+
+	_state = kStateDone;
+	_done.broadcast();
+}
+
+void AsyncResource::cancel() {
+	Common::StackLock lock(_mutex);
+
+	if (_state != kStateQueued)
+		return;
+
+	_state = kStateDone;
+	_done.broadcast();
+}
+
+
+ResourcePrefetcher::ReadJob::ReadJob(const AsyncResourcePtr &resource) : _resource(resource) {
+}
+
+ResourcePrefetcher::ReadJob::~ReadJob() {
+}
+
+AsyncResource &ResourcePrefetcher::ReadJob::getResource() {
+	return *_resource;
+}
+
+void ResourcePrefetcher::ReadJob::run() {
+	_resource->read();
+}
+
+
+ResourcePrefetcher::ResourcePrefetcher() {
+}
+
+ResourcePrefetcher::~ResourcePrefetcher() {
+	cancel();
+
+	// The canceled jobs don't read anything anymore, so this is quick
+	for (Jobs::iterator j = _jobs.begin(); j != _jobs.end(); ++j) {
+		JobMan.wait(**j);
+
+		delete *j;
+	}
+}
+
+void ResourcePrefetcher::queue(const AsyncResourcePtr &resource) {
+	Common::StackLock lock(_mutex);
+
+	collect();
+
+	_jobs.push_back(new ReadJob(resource));
+
+	// If no worker picks it up, the resource will be read when it's waited for
+	JobMan.addBackground(*_jobs.back());
+}
+
+void ResourcePrefetcher::cancel() {
+	Common::StackLock lock(_mutex);
+
+	for (Jobs::iterator j = _jobs.begin(); j != _jobs.end(); ++j)
+		(*j)->getResource().cancel();
+
+	collect();
+}
+
+void ResourcePrefetcher::collect() {
+	for (Jobs::iterator j = _jobs.begin(); j != _jobs.end(); ) {
+		if ((*j)->isDone()) {
+			delete *j;
+			j = _jobs.erase(j);
+		} else
+			++j;
+	}
+}
+
+} // End of namespace Aurora
@@ -0,0 +1,158 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Reading resources in the background.
+ */
+
+#ifndef AURORA_PREFETCH_H
+#define AURORA_PREFETCH_H
+
+#include <list>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/function.hpp>
+
+#include "src/common/types.h"
+#include "src/common/error.h"
+#include "src/common/scopedptr.h"
+#include "src/common/mutex.h"
+#include "src/common/jobs.h"
+
+namespace Common {
+	class SeekableReadStream;
+}
+
+namespace Aurora {
+
+/** A resource that is read in the background.
+ *
+ *  This works like a future: the resource is read by a job the
+ *  ResourcePrefetcher queued, and the stream can be collected with getStream()
+ *  once it's done. If the resource hasn't been picked up by any thread yet when
+ *  getStream() is called, it is read directly in the calling thread instead.
+ */
+class AsyncResource : boost::noncopyable {
+public:
+	/** A function doing the actual reading of the resource. */
+	typedef boost::function<Common::SeekableReadStream *()> Reader;
+
+	/** Create an asynchronous resource that will be read with this reader. */
+	AsyncResource(const Reader &reader);
+	/** Create an asynchronous resource that's already done, with this result. */
+	AsyncResource(Common::SeekableReadStream *stream);
+	~AsyncResource();
+
+	/** Has the resource been read yet? */
+	bool isDone();
+
+	/** Wait until the resource has been read. */
+	void wait();
+
+	/** Wait until the resource has been read, and take over its stream.
+	 *
+	 *  If reading the resource failed, the exception is rethrown here.
+	 *
+	 *  @return The resource stream, or 0 if the resource doesn't exist or
+	 *          the stream has already been taken.
+	 */
+	Common::SeekableReadStream *getStream();
+
+private:
+	enum State {
+		kStateQueued,  ///< Waiting for a thread to read it.
+		kStateReading, ///< A thread is reading it right now.
+		kStateDone     ///< Reading has finished (or was canceled).
+	};
+
+	Reader _reader;
+	State  _state;
+
+	Common::ScopedPtr<Common::SeekableReadStream> _stream;
+
+	bool _failed;
+	Common::Exception _error;
+
+	Common::Mutex     _mutex;
+	Common::Condition _done;
+
+	/** Read the resource, unless another thread already took care of it. */
+	void read();
+	/** Don't read the resource if no thread has started reading it yet. */
+	void cancel();
+
+	friend class ResourcePrefetcher;
+};
+
+typedef boost::shared_ptr<AsyncResource> AsyncResourcePtr;
+
+
+/** Reads AsyncResources in the background, as jobs of the JobManager.
+ *
+ *  The reads are queued as background jobs (see JobManager::addBackground()),
+ *  since they take the ResourceManager's lock, which a thread waiting for
+ *  other jobs might hold.
+ */
+class ResourcePrefetcher : boost::noncopyable {
+public:
+	ResourcePrefetcher();
+	~ResourcePrefetcher();
+
+	/** Queue a resource to be read in the background. */
+	void queue(const AsyncResourcePtr &resource);
+
+	/** Cancel all queued resources.
+	 *
+	 *  Resources that are currently being read are not waited for. Their
+	 *  readers are expected to notice themselves if what they were meant to
+	 *  read has gone away in the meantime.
+	 */
+	void cancel();
+
+private:
+	/** A job reading one resource. */
+	class ReadJob : public Common::Job {
+	public:
+		ReadJob(const AsyncResourcePtr &resource);
+		~ReadJob();
+
+		AsyncResource &getResource();
+
+	protected:
+		void run();
+
+	private:
+		AsyncResourcePtr _resource;
+	};
+
+	typedef std::list<ReadJob *> Jobs;
+
+	Jobs _jobs; ///< All jobs that were queued and not collected yet.
+
+	Common::Mutex _mutex;
+
+	/** Delete all jobs that have finished. */
+	void collect();
+};
+
+} // End of namespace Aurora
+
+#endif // AURORA_PREFETCH_H
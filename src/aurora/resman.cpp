@@ -24,7 +24,10 @@
 
 #include <cassert>
 
+#include <algorithm>
+
 #include <boost/scope_exit.hpp>
+#include <boost/bind.hpp>
 
 #include "src/common/util.h"
 #include "src/common/scopedptr.h"
@@ -32,7 +35,14 @@
 #include "src/common/readstream.h"
 #include "src/common/filepath.h"
 #include "src/common/readfile.h"
+#include "src/common/mappedfile.h"
 #include "src/common/writefile.h"
+#include "src/common/memwritestream.h"
+#include "src/common/encoding.h"
+#include "src/common/hash.h"
+#include "src/common/ptrvector.h"
+#include "src/common/thread.h"
+#include "src/common/jobs.h"
 
 #include "src/aurora/resman.h"
 #include "src/aurora/util.h"
@@ -69,6 +79,16 @@ ResourceManager::KnownArchive::KnownArchive(ArchiveType t, const Common::UString
 ResourceManager::OpenedArchive::OpenedArchive() : archive(0), known(0), parent(0) {
 }
 
+ResourceManager::BatchArchive::BatchArchive(const Common::UString &f, uint32 p, bool o, Common::ChangeID *c) :
+	file(f), priority(p), optional(o), changeID(c) {
+
+}
+
+ResourceManager::PendingArchives::~PendingArchives() {
+	for (std::vector<Archive *>::iterator a = archives.begin(); a != archives.end(); ++a)
+		delete *a;
+}
+
 void ResourceManager::OpenedArchive::set(KnownArchive &kA, Archive &a) {
 	archive = &a;
 	known   = &kA;
@@ -105,7 +125,7 @@ bool ResourceManager::Resource::operator<(const Resource &right) const {
 
 
 ResourceManager::ResourceManager() : _hasSmall(false),
-	_hashAlgo(Common::kHashFNV64) {
+	_hashAlgo(Common::kHashFNV64), _mapArchives(true), _generation(0) {
 
 	// These file types are archives
 
@@ -172,16 +192,29 @@ ResourceManager::~ResourceManager() {
 }
 
 void ResourceManager::clear() {
+	Common::WriteLock lock(_resourceLock);
+
 	_typeAliases.clear();
 
-	_hasSmall = false;
-	_hashAlgo = Common::kHashFNV64;
+	_hasSmall    = false;
+	_hashAlgo    = Common::kHashFNV64;
+	_mapArchives = true;
+
+	setCacheBudget(0);
 
 	setRIMsAreERFs(false);
 	clearResources();
 }
 
 void ResourceManager::clearResources() {
+	cancelPrefetches();
+	clearCache();
+
+	_generation++;
+
+	_indexCache.save();
+	_indexCache.clear();
+
 	_cursorRemap.clear();
 
 	_baseDir.clear();
@@ -194,12 +227,17 @@ void ResourceManager::clearResources() {
 		delete a->archive;
 	_openedArchives.clear();
 
+	for (ResourceMap::iterator r = _resources.begin(); r != _resources.end(); ++r)
+		for (ResourceList::iterator res = r->second.begin(); res != r->second.end(); ++res)
+			delete *res;
 	_resources.clear();
 
 	_changes.clear();
 }
 
 void ResourceManager::setRIMsAreERFs(bool rimsAreERFs) {
+	Common::WriteLock lock(_resourceLock);
+
 	// Treat RIM and RIMP as either RIM or ERF
 
 	_archiveTypeTypes[kArchiveRIM].erase(kFileTypeRIM);
@@ -217,21 +255,85 @@ void ResourceManager::setRIMsAreERFs(bool rimsAreERFs) {
 }
 
 void ResourceManager::setHasSmall(bool hasSmall) {
+	Common::WriteLock lock(_resourceLock);
+
 	_hasSmall = hasSmall;
 }
 
 void ResourceManager::setHashAlgo(Common::HashAlgo algo) {
+	Common::WriteLock lock(_resourceLock);
+
 	if ((algo != _hashAlgo) && !_resources.empty())
 		throw Common::Exception("ResourceManager::setHashAlgo(): We already have resources!");
 
 	_hashAlgo = algo;
 }
 
+void ResourceManager::setMapArchives(bool mapArchives) {
+	Common::WriteLock lock(_resourceLock);
+
+	_mapArchives = mapArchives;
+}
+
+void ResourceManager::setCacheBudget(size_t budget) {
+	Common::StackLock lock(_cacheMutex);
+
+	_cache.setBudget(budget);
+}
+
+ResourceCache::Stats ResourceManager::getCacheStats() const {
+	Common::StackLock lock(_cacheMutex);
+
+	return _cache.getStats();
+}
+
+void ResourceManager::clearCache() {
+	Common::StackLock lock(_cacheMutex);
+
+	_cache.clear();
+}
+
+void ResourceManager::setTracing(bool enabled) {
+	_trace.setEnabled(enabled);
+}
+
+bool ResourceManager::isTracing() const {
+	return _trace.isEnabled();
+}
+
+void ResourceManager::beginTraceSection(const Common::UString &name) {
+	_trace.beginSection(name);
+}
+
+size_t ResourceManager::getTraceRequestCount() const {
+	return _trace.getRequestCount();
+}
+
+void ResourceManager::clearTrace() {
+	_trace.clear();
+}
+
+void ResourceManager::writeTraceReport(const Common::UString &fileName, size_t topCount) const {
+	Common::WriteFile file;
+
+	if (!file.open(fileName))
+		throw Common::Exception(Common::kOpenError);
+
+	_trace.writeReport(file, topCount);
+
+	file.flush();
+	file.close();
+}
+
 void ResourceManager::setCursorRemap(const std::vector<Common::UString> &remap) {
+	Common::WriteLock lock(_resourceLock);
+
 	_cursorRemap = remap;
 }
 
 void ResourceManager::registerDataBase(const Common::UString &path) {
+	Common::WriteLock lock(_resourceLock);
+
 	clearResources();
 
 	Common::UString base = Common::FilePath::canonicalize(path);
@@ -240,12 +342,16 @@ void ResourceManager::registerDataBase(const Common::UString &path) {
 
 		_baseDir = base;
 
+		loadIndexCache();
+
 		indexResourceDir("", 0, 0, 1);
 
 	} else if (Common::FilePath::isRegularFile(base)) {
 
 		_baseArchive = base;
 
+		loadIndexCache();
+
 		indexResourceFile(_baseArchive, 1);
 		indexArchive     (_baseArchive, 1);
 
@@ -254,6 +360,14 @@ void ResourceManager::registerDataBase(const Common::UString &path) {
 
 }
 
+void ResourceManager::loadIndexCache() {
+	// Each data base gets its own cache file
+	const Common::UString file = "indexcache/" +
+		Common::formatHash(Common::hashString(getDataBase(), Common::kHashFNV64)) + ".xidx";
+
+	_indexCache.load(Common::FilePath::getUserDataFile(file));
+}
+
 const Common::UString &ResourceManager::getDataBase() const {
 	if (!_baseArchive.empty())
 		return _baseArchive;
@@ -281,6 +395,8 @@ ResourceManager::KnownArchive *ResourceManager::findArchive(Common::UString file
 }
 
 bool ResourceManager::hasArchive(const Common::UString &file) {
+	Common::ReadLock lock(_resourceLock);
+
 	return findArchive(file) != 0;
 }
 
@@ -288,12 +404,24 @@ Common::SeekableReadStream *ResourceManager::openArchiveStream(const KnownArchiv
 	if (!archive.resource)
 		throw Common::Exception("Archive without resource reference");
 
-	return getResource(*archive.resource, true);
+	const Resource &res = *archive.resource;
+	if (_mapArchives && (res.source == kSourceFile) && !res.isSmall) {
+		try {
+			return new Common::MappedFile(Common::FileMappingPtr(new Common::FileMapping(res.path)));
+		} catch (Common::Exception &e) {
+			e.add("Failed to map archive \"%s\"", res.path.c_str());
+			Common::printException(e, "WARNING: ");
+		}
+	}
+
+	return getResource(res, true);
 }
 
 void ResourceManager::indexArchive(const Common::UString &file, uint32 priority,
                                    const std::vector<byte> &password, Common::ChangeID *changeID) {
 
+	Common::WriteLock lock(_resourceLock);
+
 	KnownArchive *knownArchive = findArchive(file);
 	if (!knownArchive)
 		throw Common::Exception("No such archive file \"%s\"", file.c_str());
@@ -305,57 +433,104 @@ void ResourceManager::indexArchive(const Common::UString &file, uint32 priority,
 	if (changeID)
 		change = newChangeSet(*changeID);
 
-	Common::SeekableReadStream *archiveStream = openArchiveStream(*knownArchive);
+	PendingArchives pending;
+	openArchives(*knownArchive, password, pending);
 
-	Common::ScopedPtr<Archive> archive;
-	switch (knownArchive->type) {
-		case kArchiveKEY:
-			indexKEY(archiveStream, priority, change);
-			break;
+	indexArchives(pending, priority, change);
+}
 
+void ResourceManager::indexArchive(const Common::UString &file, uint32 priority, Common::ChangeID *changeID) {
+	std::vector<byte> password;
+
+	indexArchive(file, priority, password, changeID);
+}
+
+Archive *ResourceManager::openArchive(const KnownArchive &knownArchive, const std::vector<byte> &password) {
+	Common::SeekableReadStream *archiveStream = openArchiveStream(knownArchive);
+
+	switch (knownArchive.type) {
 		case kArchiveNDS:
-			archive.reset(new NDSFile(archiveStream));
-			break;
+			return new NDSFile(archiveStream);
 
 		case kArchiveHERF:
-			archive.reset(new HERFFile(archiveStream));
-			break;
+			return new HERFFile(archiveStream);
 
 		case kArchiveERF:
-			archive.reset(new ERFFile(archiveStream, password));
-			break;
+			return new ERFFile(archiveStream, password);
 
 		case kArchiveRIM:
-			archive.reset(new RIMFile(archiveStream));
-			break;
+			return new RIMFile(archiveStream);
 
 		case kArchiveZIP:
-			archive.reset(new ZIPFile(archiveStream));
-			break;
+			return new ZIPFile(archiveStream);
 
 		case kArchiveEXE:
-			archive.reset(new PEFile(archiveStream, _cursorRemap));
-			break;
+			return new PEFile(archiveStream, _cursorRemap);
 
 		case kArchiveNSBTX:
-			archive.reset(new NSBTXFile(archiveStream));
-			break;
+			return new NSBTXFile(archiveStream);
 
 		default:
-			throw Common::Exception("Invalid archive type %d", knownArchive->type);
+			break;
 	}
 
-	if (archive)
-		indexArchive(*knownArchive, archive.release(), priority, change);
+	delete archiveStream;
+	throw Common::Exception("Invalid archive type %d", knownArchive.type);
 }
 
-void ResourceManager::indexArchive(const Common::UString &file, uint32 priority, Common::ChangeID *changeID) {
-	std::vector<byte> password;
+bool ResourceManager::getIndexSignature(const KnownArchive &knownArchive, IndexCache::Signature &signature) const {
+	if (!_indexCache.isLoaded() || !knownArchive.resource)
+		return false;
 
-	indexArchive(file, priority, password, changeID);
+	// Only archives directly on disk can be checked for changes
+	const Resource &res = *knownArchive.resource;
+	if ((res.source != kSourceFile) || res.isSmall)
+		return false;
+
+	signature.push_back((uint64) knownArchive.type);
+
+	return IndexCache::addSignature(signature, res.path);
+}
+
+Archive *ResourceManager::openCachedArchive(const KnownArchive &knownArchive) {
+	if ((knownArchive.type != kArchiveERF) && (knownArchive.type != kArchiveRIM))
+		return 0;
+
+	IndexCache::Signature signature;
+	if (!getIndexSignature(knownArchive, signature))
+		return 0;
+
+	Common::ScopedPtr<Common::SeekableReadStream> index(_indexCache.get(knownArchive.resource->path, signature));
+	if (!index)
+		return 0;
+
+	try {
+		if (knownArchive.type == kArchiveERF)
+			return new ERFFile(openArchiveStream(knownArchive), *index);
+
+		return new RIMFile(openArchiveStream(knownArchive), *index);
+
+	} catch (Common::Exception &e) {
+		e.add("Failed to open archive \"%s\" from the index cache", knownArchive.name.c_str());
+		Common::printException(e, "WARNING: ");
+	}
+
+	return 0;
+}
+
+void ResourceManager::cacheArchiveIndex(const KnownArchive &knownArchive, const Archive &archive) {
+	IndexCache::Signature signature;
+	if (!getIndexSignature(knownArchive, signature))
+		return;
+
+	Common::MemoryWriteStreamDynamic index(true);
+	if (!archive.writeIndex(index))
+		return;
+
+	_indexCache.set(knownArchive.resource->path, signature, index.getData(), index.size());
 }
 
-uint32 ResourceManager::openKEYBIFs(Common::SeekableReadStream *keyStream,
+uint32 ResourceManager::openKEYBIFs(const KnownArchive &keyArchive,
                                     std::vector<KnownArchive *> &archives,
                                     std::vector<BIFFile *> &bifs) {
 
@@ -370,8 +545,8 @@ uint32 ResourceManager::openKEYBIFs(Common::SeekableReadStream *keyStream,
 		}
 	} BOOST_SCOPE_EXIT_END
 
-	Common::ScopedPtr<Common::SeekableReadStream> stream(keyStream);
-	KEYFile key(*keyStream);
+	Common::ScopedPtr<Common::SeekableReadStream> stream(openArchiveStream(keyArchive));
+	KEYFile key(*stream);
 
 	const KEYFile::BIFList &keyBIFs = key.getBIFs();
 	archives.resize(keyBIFs.size(), 0);
@@ -386,18 +561,226 @@ uint32 ResourceManager::openKEYBIFs(Common::SeekableReadStream *keyStream,
 		bifs[i]->mergeKEY(key, i);
 	}
 
+	cacheKEYIndex(keyArchive, keyBIFs, archives, bifs);
+
 	success = true;
 	return archives.size();
 }
 
-void ResourceManager::indexKEY(Common::SeekableReadStream *stream, uint32 priority, Change *change) {
-	std::vector<KnownArchive *> archives;
-	std::vector<BIFFile *> bifs;
+/* A KEY's entry in the index cache holds the indices of all its BIFs,
+ * each one with the BIF's name within the KEY and the BIF's own signature. */
+
+bool ResourceManager::openCachedKEYBIFs(const KnownArchive &keyArchive,
+                                        std::vector<KnownArchive *> &archives,
+                                        std::vector<BIFFile *> &bifs) {
+
+	IndexCache::Signature keySignature;
+	if (!getIndexSignature(keyArchive, keySignature))
+		return false;
+
+	Common::ScopedPtr<Common::SeekableReadStream> index(_indexCache.get(keyArchive.resource->path, keySignature));
+	if (!index)
+		return false;
+
+	bool success = false;
+	BOOST_SCOPE_EXIT( (&success) (&archives) (&bifs) ) {
+		if (!success) {
+			for (std::vector<BIFFile *>::iterator b = bifs.begin(); b != bifs.end(); ++b)
+				delete *b;
+
+			bifs.clear();
+			archives.clear();
+		}
+	} BOOST_SCOPE_EXIT_END
+
+	try {
+		// Each BIF needs at least 5 bytes: its name's terminator and the signature size
+		const uint32 count = index->readUint32LE();
+		if (count > ((index->size() - index->pos()) / 5))
+			throw Common::Exception("Invalid BIF count %u", count);
+
+		archives.resize(count, 0);
+		bifs.resize(count, 0);
+
+		for (uint32 i = 0; i < count; i++) {
+			const Common::UString bifName = Common::readString(*index, Common::kEncodingUTF8);
+
+			IndexCache::Signature cachedSignature;
+			IndexCache::readSignature(*index, cachedSignature);
+
+			archives[i] = findArchive(bifName, _knownArchives[kArchiveBIF]);
+
+			IndexCache::Signature bifSignature;
+			if (!archives[i] || !getIndexSignature(*archives[i], bifSignature) || (bifSignature != cachedSignature))
+				return false;
+
+			bifs[i] = new BIFFile(openArchiveStream(*archives[i]), *index);
+		}
+
+	} catch (Common::Exception &e) {
+		e.add("Failed to open KEY \"%s\" from the index cache", keyArchive.name.c_str());
+		Common::printException(e, "WARNING: ");
+
+		return false;
+	}
+
+	success = true;
+	return true;
+}
+
+void ResourceManager::cacheKEYIndex(const KnownArchive &keyArchive, const std::vector<Common::UString> &bifNames,
+                                    const std::vector<KnownArchive *> &archives,
+                                    const std::vector<BIFFile *> &bifs) {
 
-	const uint32 count = openKEYBIFs(stream, archives, bifs);
+	IndexCache::Signature keySignature;
+	if (!getIndexSignature(keyArchive, keySignature))
+		return;
 
-	for (uint32 i = 0; i < count; i++)
-		indexArchive(*archives[i], bifs[i], priority, change);
+	Common::MemoryWriteStreamDynamic index(true);
+
+	index.writeUint32LE(bifs.size());
+	for (size_t i = 0; i < bifs.size(); i++) {
+		IndexCache::Signature bifSignature;
+		if (!getIndexSignature(*archives[i], bifSignature))
+			return;
+
+		Common::writeString(index, bifNames[i], Common::kEncodingUTF8);
+
+		IndexCache::writeSignature(index, bifSignature);
+
+		if (!bifs[i]->writeIndex(index))
+			return;
+	}
+
+	_indexCache.set(keyArchive.resource->path, keySignature, index.getData(), index.size());
+}
+
+void ResourceManager::openArchives(KnownArchive &knownArchive, const std::vector<byte> &password,
+                                   PendingArchives &pending) {
+
+	// A KEY is indexed by indexing all the BIFs it references
+	if (knownArchive.type == kArchiveKEY) {
+		std::vector<BIFFile *> bifs;
+
+		if (!openCachedKEYBIFs(knownArchive, pending.knownArchives, bifs))
+			openKEYBIFs(knownArchive, pending.knownArchives, bifs);
+
+		pending.archives.assign(bifs.begin(), bifs.end());
+		return;
+	}
+
+	Common::ScopedPtr<Archive> archive;
+	if (password.empty())
+		archive.reset(openCachedArchive(knownArchive));
+
+	if (!archive) {
+		archive.reset(openArchive(knownArchive, password));
+
+		cacheArchiveIndex(knownArchive, *archive);
+	}
+
+	pending.knownArchives.push_back(&knownArchive);
+	pending.archives.push_back(archive.release());
+}
+
+void ResourceManager::indexArchives(PendingArchives &pending, uint32 priority, Change *change) {
+	assert(pending.knownArchives.size() == pending.archives.size());
+
+	for (size_t i = 0; i < pending.archives.size(); i++) {
+		// indexArchive() takes over the archive
+		Archive *archive = pending.archives[i];
+		pending.archives[i] = 0;
+
+		indexArchive(*pending.knownArchives[i], archive, priority, change);
+	}
+}
+
+/** An archive of a batch, to be opened by one of the jobs of indexArchives(). */
+struct ResourceManager::BatchJob {
+	const BatchArchive *archive;
+	KnownArchive *knownArchive;
+
+	PendingArchives pending;
+
+	bool failed;
+	Common::Exception error;
+
+	BatchJob(const BatchArchive &a, KnownArchive *k) : archive(&a), knownArchive(k), failed(false) {
+	}
+};
+
+/** The archives of a batch, opened in parallel by JobManager::parallelFor(). */
+struct ResourceManager::Batch {
+	ResourceManager *resMan;
+	Common::PtrVector<BatchJob> jobs;
+
+	Batch(ResourceManager &r) : resMan(&r) {
+	}
+
+	void operator()(size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++)
+			resMan->openBatchJob(*jobs[i]);
+	}
+};
+
+void ResourceManager::indexArchives(const ArchiveBatch &batch) {
+	Common::WriteLock lock(_resourceLock);
+
+	Batch opening(*this);
+
+	// Finding the archives needs to happen before any job is running
+	for (ArchiveBatch::const_iterator a = batch.begin(); a != batch.end(); ++a) {
+		KnownArchive *knownArchive = findArchive(a->file);
+
+		opening.jobs.push_back(new BatchJob(*a, knownArchive));
+
+		BatchJob &job = *opening.jobs.back();
+		if (!knownArchive) {
+			job.error  = Common::Exception("No such archive file \"%s\"", a->file.c_str());
+			job.failed = !a->optional;
+		} else if (knownArchive->type == kArchiveBIF) {
+			job.error  = Common::Exception("Attempted to index a lone BIF");
+			job.failed = true;
+		}
+	}
+
+	/* Each archive is a job of its own. The jobs must not take _resourceLock,
+	 * since we're holding it while waiting for them. */
+	JobMan.parallelFor(0, opening.jobs.size(), 1, opening);
+
+	// Index the opened archives in the order they were given
+	for (Common::PtrVector<BatchJob>::iterator j = opening.jobs.begin(); j != opening.jobs.end(); ++j) {
+		BatchJob &job = **j;
+
+		if (job.failed) {
+			job.error.add("Failed to index archive \"%s\"", job.archive->file.c_str());
+			throw job.error;
+		}
+
+		if (!job.knownArchive)
+			continue;
+
+		Change *change = 0;
+		if (job.archive->changeID)
+			change = newChangeSet(*job.archive->changeID);
+
+		indexArchives(job.pending, job.archive->priority, change);
+	}
+}
+
+void ResourceManager::openBatchJob(BatchJob &job) {
+	if (job.failed || !job.knownArchive)
+		return;
+
+	try {
+		openArchives(*job.knownArchive, job.archive->password, job.pending);
+	} catch (Common::Exception &e) {
+		job.error  = e;
+		job.failed = true;
+	} catch (std::exception &e) {
+		job.error  = Common::Exception(e);
+		job.failed = true;
+	}
 }
 
 void ResourceManager::indexArchive(KnownArchive &knownArchive, Archive *archive,
@@ -458,6 +841,8 @@ void ResourceManager::indexArchive(KnownArchive &knownArchive, Archive *archive,
 }
 
 bool ResourceManager::hasResourceDir(const Common::UString &dir) {
+	Common::ReadLock lock(_resourceLock);
+
 	if (_baseDir.empty())
 		return false;
 
@@ -467,6 +852,8 @@ bool ResourceManager::hasResourceDir(const Common::UString &dir) {
 void ResourceManager::indexResourceFile(const Common::UString &file, uint32 priority,
                                         Common::ChangeID *changeID) {
 
+	Common::WriteLock lock(_resourceLock);
+
 	Common::UString path;
 	path = _baseDir.empty() ? file : (_baseDir + "/" + file);
 	path = Common::FilePath::normalize(path, false);
@@ -483,6 +870,8 @@ void ResourceManager::indexResourceFile(const Common::UString &file, uint32 prio
 
 void ResourceManager::indexResourceDir(const Common::UString &dir, const char *glob, int depth,
                                        uint32 priority, Common::ChangeID *changeID) {
+	Common::WriteLock lock(_resourceLock);
+
 	if (_baseDir.empty())
 		throw Common::Exception("No base data directory set");
 
@@ -514,10 +903,18 @@ void ResourceManager::indexResourceDir(const Common::UString &dir, const char *g
 }
 
 void ResourceManager::undo(Common::ChangeID &changeID) {
+	Common::WriteLock lock(_resourceLock);
+
 	Change *change = dynamic_cast<Change *>(changeID.getContent());
 	if (!change || (change->_change == _changes.end()))
 		return;
 
+	// Background reads and cached data might reference resources we're about to remove
+	cancelPrefetches();
+	clearCache();
+
+	_generation++;
+
 	// Removing all changes in the opened archives list
 	for (OpenedArchiveChanges::iterator oaChange = change->_change->openedArchives.begin();
 	     oaChange != change->_change->openedArchives.end(); ++oaChange) {
@@ -569,20 +966,29 @@ void ResourceManager::undo(Common::ChangeID &changeID) {
 	for (ResourceChanges::iterator resChange = change->_change->resources.begin();
 	     resChange != change->_change->resources.end(); ++resChange) {
 
+		Resource *res = resChange->resource;
+
 		// If the resource still has an archive attached, it was added by a
 		// declareResources() call and needs to be removed manually
-		if (resChange->resIt->selfArchive.first) {
-			if (resChange->resIt->selfArchive.second->opened)
+		if (res->selfArchive.first) {
+			if (res->selfArchive.second->opened)
 				throw Common::Exception("Attempted to deindex an archive resource that's still opened");
 
-			resChange->resIt->selfArchive.first->erase(resChange->resIt->selfArchive.second);
+			res->selfArchive.first->erase(res->selfArchive.second);
 		}
 
 		// Remove the resource, and the name list too if it's empty
-		resChange->hashIt->second.erase(resChange->resIt);
+		ResourceMap::iterator resList = _resources.find(resChange->hash);
+		assert(resList != _resources.end());
 
-		if (resChange->hashIt->second.empty())
-			_resources.erase(resChange->hashIt);
+		ResourceList::iterator r = std::find(resList->second.begin(), resList->second.end(), res);
+		assert(r != resList->second.end());
+
+		resList->second.erase(r);
+		delete res;
+
+		if (resList->second.empty())
+			_resources.erase(resList);
 	}
 
 	// Now we can remove the change set from our list of change sets
@@ -593,19 +999,25 @@ void ResourceManager::undo(Common::ChangeID &changeID) {
 }
 
 void ResourceManager::addTypeAlias(FileType alias, FileType realType) {
+	Common::WriteLock lock(_resourceLock);
+
 	_typeAliases[alias] = realType;
 }
 
 void ResourceManager::blacklist(const Common::UString &name, FileType type) {
+	Common::WriteLock lock(_resourceLock);
+
 	ResourceMap::iterator resList = _resources.find(getHash(name, type));
 	if (resList == _resources.end())
 		return;
 
 	for (ResourceList::iterator res = resList->second.begin(); res != resList->second.end(); ++res)
-		res->priority = 0;
+		(*res)->priority = 0;
 }
 
 void ResourceManager::declareResource(const Common::UString &name, FileType type) {
+	Common::WriteLock lock(_resourceLock);
+
 	bool isSmall = false;
 
 	ResourceMap::iterator resList = _resources.find(getHash(name, type));
@@ -622,11 +1034,11 @@ void ResourceManager::declareResource(const Common::UString &name, FileType type
 	}
 
 	for (ResourceList::iterator r = resList->second.begin(); r != resList->second.end(); ++r) {
-		r->name    = name;
-		r->type    = type;
-		r->isSmall = isSmall;
+		(*r)->name    = name;
+		(*r)->type    = type;
+		(*r)->isSmall = isSmall;
 
-		checkResourceIsArchive(*r, 0);
+		checkResourceIsArchive(**r, 0);
 	}
 }
 
@@ -653,10 +1065,20 @@ bool ResourceManager::hasResource(const Common::UString &name) const {
 }
 
 bool ResourceManager::hasResource(const Common::UString &name, const std::vector<FileType> &types) const {
+	Common::ReadLock lock(_resourceLock);
+
 	return getRes(name, types) != 0;
 }
 
+bool ResourceManager::hasResource(const ResRef &name, FileType type) const {
+	Common::ReadLock lock(_resourceLock);
+
+	return getRes(name, type) != 0;
+}
+
 bool ResourceManager::hasResource(uint64 hash) const {
+	Common::ReadLock lock(_resourceLock);
+
 	return getRes(hash) != 0;
 }
 
@@ -680,6 +1102,8 @@ Common::UString ResourceManager::findResourceFile(const Common::UString &name) c
 
 Common::UString ResourceManager::findResourceFile(const Common::UString &name,
                                                   const std::vector<FileType> &types) const {
+	Common::ReadLock lock(_resourceLock);
+
 	const Resource *res = getRes(name, types);
 	if (res && (res->source == kSourceFile))
 		return res->path;
@@ -687,6 +1111,44 @@ Common::UString ResourceManager::findResourceFile(const Common::UString &name,
 	return "";
 }
 
+bool ResourceManager::getResourceIdentity(const Common::UString &name, FileType type,
+                                          Common::UString &file, IndexCache::Signature &signature) const {
+
+	Common::ReadLock lock(_resourceLock);
+
+	file.clear();
+	signature.clear();
+
+	const Resource *res = getRes(name, type);
+	if (!res)
+		return false;
+
+	return getResourceIdentity(*res, file, signature);
+}
+
+bool ResourceManager::getResourceIdentity(const Resource &res, Common::UString &file,
+                                          IndexCache::Signature &signature) const {
+
+	if (res.source == kSourceFile) {
+		file = res.path;
+
+		return IndexCache::addSignature(signature, res.path);
+	}
+
+	if ((res.source != kSourceArchive) || (res.archiveIndex == 0xFFFFFFFF) ||
+	    !res.archive || !res.archive->known || !res.archive->known->resource)
+		return false;
+
+	// First identify the archive, then the resource within it
+	if (!getResourceIdentity(*res.archive->known->resource, file, signature))
+		return false;
+
+	signature.push_back(res.archiveIndex);
+	signature.push_back(getResourcePackedSize(res));
+
+	return true;
+}
+
 uint32 ResourceManager::getResourceSize(const Resource &res) const {
 	if (res.source == kSourceArchive) {
 		if ((res.archive == 0) || (res.archive->archive == 0) || (res.archiveIndex == 0xFFFFFFFF))
@@ -701,11 +1163,42 @@ uint32 ResourceManager::getResourceSize(const Resource &res) const {
 	return 0xFFFFFFFF;
 }
 
+uint32 ResourceManager::getResourcePackedSize(const Resource &res) const {
+	if (res.source == kSourceArchive) {
+		if ((res.archive == 0) || (res.archive->archive == 0) || (res.archiveIndex == 0xFFFFFFFF))
+			return 0xFFFFFFFF;
+
+		return res.archive->archive->getResourcePackedSize(res.archiveIndex);
+	}
+
+	if (res.source == kSourceFile)
+		return Common::FilePath::getFileSize(res.path);
+
+	return 0xFFFFFFFF;
+}
+
+Common::UString ResourceManager::getResourceSource(const Resource &res) const {
+	if ((res.source == kSourceArchive) && res.archive && res.archive->known)
+		return res.archive->known->name;
+
+	if (res.source == kSourceFile)
+		return res.path;
+
+	return "";
+}
+
 Common::SeekableReadStream *ResourceManager::getArchiveResource(const Resource &res, bool tryNoCopy) const {
 	if ((res.archive == 0) || (res.archive->archive == 0) || (res.archiveIndex == 0xFFFFFFFF))
 		throw Common::Exception("Archive resource has no archive");
 
-	return res.archive->archive->getResource(res.archiveIndex, tryNoCopy);
+	const Archive &archive = *res.archive->archive;
+	if (archive.isThreadSafe())
+		return archive.getResource(res.archiveIndex, tryNoCopy);
+
+	// This archive can't be read from multiple threads at once
+	Common::StackLock lock(_readMutex);
+
+	return archive.getResource(res.archiveIndex, tryNoCopy);
 }
 
 Common::SeekableReadStream *ResourceManager::getResource(const Common::UString &name, FileType type) const {
@@ -723,9 +1216,43 @@ Common::SeekableReadStream *ResourceManager::getResource(const Common::UString &
 Common::SeekableReadStream *ResourceManager::getResource(const Common::UString &name,
 		const std::vector<FileType> &types, FileType *foundType) const {
 
+	Common::ReadLock lock(_resourceLock);
+
 	const Resource *res = getRes(name, types);
-	if (!res)
+	if (!res) {
+		traceMissing(name, types.empty() ? kFileTypeNone : types.front());
 		return 0;
+	}
+
+	// Return the actually found type
+	if (foundType)
+		*foundType = res->type;
+
+	return getResource(*res);
+}
+
+Common::SeekableReadStream *ResourceManager::getResource(const ResRef &name, FileType type) const {
+	Common::ReadLock lock(_resourceLock);
+
+	const Resource *res = getRes(name, type);
+	if (!res) {
+		traceMissing(name.getString(), type);
+		return 0;
+	}
+
+	return getResource(*res);
+}
+
+Common::SeekableReadStream *ResourceManager::getResource(const ResRef &name,
+		const std::vector<FileType> &types, FileType *foundType) const {
+
+	Common::ReadLock lock(_resourceLock);
+
+	const Resource *res = getRes(name, types);
+	if (!res) {
+		traceMissing(name.getString(), types.empty() ? kFileTypeNone : types.front());
+		return 0;
+	}
 
 	// Return the actually found type
 	if (foundType)
@@ -735,9 +1262,13 @@ Common::SeekableReadStream *ResourceManager::getResource(const Common::UString &
 }
 
 Common::SeekableReadStream *ResourceManager::getResource(uint64 hash, FileType *type) const {
+	Common::ReadLock lock(_resourceLock);
+
 	const Resource *res = getRes(hash);
-	if (!res)
+	if (!res) {
+		traceMissing(Common::formatHash(hash), kFileTypeNone);
 		return 0;
+	}
 
 	// Return the actually found type
 	if (type)
@@ -747,6 +1278,40 @@ Common::SeekableReadStream *ResourceManager::getResource(uint64 hash, FileType *
 }
 
 Common::SeekableReadStream *ResourceManager::getResource(const Resource &res, bool tryNoCopy) const {
+	// Archives opening other archives are not requests worth tracing
+	if (!tryNoCopy && _trace.isEnabled())
+		return getResourceTraced(res);
+
+	/* Was this resource prefetched? Archives are opened with tryNoCopy, possibly
+	 * by the jobs of a batch, which can't wait for the prefetching jobs. */
+	if (!tryNoCopy) {
+		AsyncResourcePtr prefetched = takePrefetched(res);
+		if (prefetched)
+			return prefetched->getStream();
+	}
+
+	return readResource(res, tryNoCopy);
+}
+
+Common::SeekableReadStream *ResourceManager::readResource(const Resource &res, bool tryNoCopy,
+                                                          ResourceTrace::Request *request) const {
+
+	// Only resources that need to be unpacked are worth caching
+	const bool cacheable = !tryNoCopy && isResourceCompressed(res);
+	if (cacheable) {
+		Common::StackLock lock(_cacheMutex);
+
+		Common::SeekableReadStream *cached = _cache.get(&res);
+		if (cached) {
+			if (request)
+				request->origin = ResourceTrace::kOriginCache;
+
+			return cached;
+		}
+	}
+
+	const uint64 readStart = request ? ResourceTrace::getTime() : 0;
+
 	Common::SeekableReadStream *stream = 0;
 
 	switch (res.source) {
@@ -767,9 +1332,73 @@ Common::SeekableReadStream *ResourceManager::getResource(const Resource &res, bo
 	if (res.isSmall)
 		stream = Small::decompress(stream);
 
+	if (request) {
+		request->origin   = ResourceTrace::kOriginRead;
+		request->readTime = ResourceTrace::getTime() - readStart;
+	}
+
+	if (cacheable) {
+		Common::StackLock lock(_cacheMutex);
+
+		stream = _cache.add(&res, stream);
+	}
+
 	return stream;
 }
 
+Common::SeekableReadStream *ResourceManager::getResourceTraced(const Resource &res) const {
+	ResourceTrace::Request request;
+
+	request.name       = res.name;
+	request.type       = res.type;
+	request.source     = getResourceSource(res);
+	request.packedSize = getResourcePackedSize(res);
+	request.thread     = SDL_ThreadID();
+
+	const uint64 start = ResourceTrace::getTime();
+
+	Common::SeekableReadStream *stream = 0;
+
+	AsyncResourcePtr prefetched = takePrefetched(res);
+	if (prefetched) {
+		request.origin = ResourceTrace::kOriginPrefetch;
+
+		stream = prefetched->getStream();
+	} else
+		stream = readResource(res, false, &request);
+
+	request.wallTime = ResourceTrace::getTime() - start;
+	request.size     = stream ? stream->size() : 0;
+
+	_trace.add(request);
+
+	return stream;
+}
+
+void ResourceManager::traceMissing(const Common::UString &name, FileType type) const {
+	if (!_trace.isEnabled())
+		return;
+
+	ResourceTrace::Request request;
+
+	request.name   = name;
+	request.type   = type;
+	request.origin = ResourceTrace::kOriginMissing;
+	request.thread = SDL_ThreadID();
+
+	_trace.add(request);
+}
+
+bool ResourceManager::isResourceCompressed(const Resource &res) const {
+	if (res.isSmall)
+		return true;
+
+	if ((res.source == kSourceArchive) && res.archive && res.archive->archive)
+		return res.archive->archive->isResourceCompressed(res.archiveIndex);
+
+	return false;
+}
+
 Common::SeekableReadStream *ResourceManager::getResource(ResourceType resType,
 		const Common::UString &name, FileType *foundType) const {
 
@@ -784,15 +1413,93 @@ Common::SeekableReadStream *ResourceManager::getResource(ResourceType resType,
 	return 0;
 }
 
+Common::SeekableReadStream *ResourceManager::getResource(ResourceType resType,
+		const ResRef &name, FileType *foundType) const {
+
+	assert((resType >= 0) && (resType < kResourceMAX));
+
+	return getResource(name, _resourceTypeTypes[resType], foundType);
+}
+
+void ResourceManager::prefetch(const Common::UString &name, FileType type) {
+	Common::ReadLock lock(_resourceLock);
+
+	const Resource *res = getRes(name, type);
+	if (!res)
+		return;
+
+	Common::StackLock prefetchLock(_prefetchMutex);
+
+	if (_prefetches.find(res) != _prefetches.end())
+		return;
+
+	_prefetches.insert(std::make_pair(res, readResourceAsync(*res)));
+}
+
+AsyncResourcePtr ResourceManager::getResourceAsync(const Common::UString &name, FileType type) {
+	Common::ReadLock lock(_resourceLock);
+
+	const Resource *res = getRes(name, type);
+	if (!res)
+		return AsyncResourcePtr(new AsyncResource(0));
+
+	AsyncResourcePtr prefetched = takePrefetched(*res);
+	if (prefetched)
+		return prefetched;
+
+	return readResourceAsync(*res);
+}
+
+AsyncResourcePtr ResourceManager::readResourceAsync(const Resource &res) {
+	AsyncResourcePtr resource(new AsyncResource(boost::bind(&ResourceManager::readPrefetched,
+	                                                        this, &res, _generation)));
+
+	_prefetcher.queue(resource);
+
+	return resource;
+}
+
+Common::SeekableReadStream *ResourceManager::readPrefetched(const Resource *res, uint32 generation) const {
+	Common::ReadLock lock(_resourceLock);
+
+	// If resources were removed in the meantime, this one might be gone
+	if (generation != _generation)
+		return 0;
+
+	return readResource(*res, false);
+}
+
+AsyncResourcePtr ResourceManager::takePrefetched(const Resource &res) const {
+	Common::StackLock lock(_prefetchMutex);
+
+	PrefetchMap::iterator p = _prefetches.find(&res);
+	if (p == _prefetches.end())
+		return AsyncResourcePtr();
+
+	AsyncResourcePtr resource = p->second;
+	_prefetches.erase(p);
+
+	return resource;
+}
+
+void ResourceManager::cancelPrefetches() {
+	_prefetcher.cancel();
+
+	Common::StackLock lock(_prefetchMutex);
+	_prefetches.clear();
+}
+
 void ResourceManager::getAvailableResources(FileType type,
 		std::list<ResourceID> &list) const {
 
+	Common::ReadLock lock(_resourceLock);
+
 	for (ResourceMap::const_iterator r = _resources.begin(); r != _resources.end(); ++r) {
-		if (!r->second.empty() && (r->second.front().type == type)) {
+		if (!r->second.empty() && (r->second.front()->type == type)) {
 			list.push_back(ResourceID());
 
-			list.back().name = r->second.front().name;
-			list.back().type = r->second.front().type;
+			list.back().name = r->second.front()->name;
+			list.back().type = r->second.front()->type;
 			list.back().hash = r->first;
 		}
 	}
@@ -801,13 +1508,15 @@ void ResourceManager::getAvailableResources(FileType type,
 void ResourceManager::getAvailableResources(const std::vector<FileType> &types,
 		std::list<ResourceID> &list) const {
 
+	Common::ReadLock lock(_resourceLock);
+
 	for (ResourceMap::const_iterator r = _resources.begin(); r != _resources.end(); ++r) {
 		for (std::vector<FileType>::const_iterator t = types.begin(); t != types.end(); ++t) {
-			if (!r->second.empty() && (r->second.front().type == *t)) {
+			if (!r->second.empty() && (r->second.front()->type == *t)) {
 				list.push_back(ResourceID());
 
-				list.back().name = r->second.front().name;
-				list.back().type = r->second.front().type;
+				list.back().name = r->second.front()->name;
+				list.back().type = r->second.front()->type;
 				list.back().hash = r->first;
 			}
 		}
@@ -887,17 +1596,25 @@ inline uint64 ResourceManager::getHash(const Common::UString &name) const {
 	return Common::hashString(name.toLower(), _hashAlgo);
 }
 
-void ResourceManager::checkHashCollision(const Resource &resource, ResourceMap::const_iterator resList) {
-	if (resource.name.empty() || resList->second.empty())
+inline uint64 ResourceManager::getHash(const ResRef &name, FileType type) const {
+	// A name that looks like a path needs the full extension swapping treatment
+	if (name.hasPathCharacters())
+		return getHash(name.getString(), type);
+
+	return name.hash(_hashAlgo, TypeMan.getExtension(type));
+}
+
+void ResourceManager::checkHashCollision(const Resource &resource, const ResourceList &resList) {
+	if (resource.name.empty() || resList.empty())
 		return;
 
 	Common::UString newName = TypeMan.setFileType(resource.name, resource.type).toLower();
 
-	for (ResourceList::const_iterator r = resList->second.begin(); r != resList->second.end(); ++r) {
-		if (r->name.empty())
+	for (ResourceList::const_iterator r = resList.begin(); r != resList.end(); ++r) {
+		if ((*r)->name.empty())
 			continue;
 
-		Common::UString oldName = TypeMan.setFileType(r->name, r->type).toLower();
+		Common::UString oldName = TypeMan.setFileType((*r)->name, (*r)->type).toLower();
 		if (oldName != newName) {
 			warning("ResourceManager: Found hash collision: %s (\"%s\" and \"%s\")",
 					Common::formatHash(getHash(oldName)).c_str(), oldName.c_str(), newName.c_str());
@@ -937,37 +1654,33 @@ bool ResourceManager::checkResourceIsArchive(Resource &resource, Change *change)
 	return true;
 }
 
-void ResourceManager::addResource(Resource &resource, uint64 hash, Change *change) {
-	ResourceMap::iterator resList = _resources.find(hash);
-	if (resList == _resources.end()) {
-		// We don't have a resource with this name yet, create a new resource list for it
-
-		std::pair<ResourceMap::iterator, bool> result;
-
-		result = _resources.insert(std::make_pair(hash, ResourceList()));
+bool ResourceManager::compareResourcePriority(const Resource *a, const Resource *b) {
+	return *a < *b;
+}
 
-		resList = result.first;
-	}
+void ResourceManager::addResource(Resource &resource, uint64 hash, Change *change) {
+	// Find the resource list for this name, or create a new one
+	ResourceList &resList = _resources[hash];
 
 #ifdef CHECK_HASH_COLLISION
 	checkHashCollision(resource, resList);
 #endif
 
-	// Add the resource to the list
-	resList->second.push_back(resource);
-	Resource *res = &resList->second.back();
+	// Add the resource to the list, sorted by priority
+	Common::ScopedPtr<Resource> newRes(new Resource(resource));
+	resList.insert(std::upper_bound(resList.begin(), resList.end(), newRes.get(), compareResourcePriority),
+	               newRes.get());
+
+	Resource *res = newRes.release();
 
 	checkResourceIsArchive(*res, change);
 
 	// Remember the resource in the change set
 	if (change) {
 		change->_change->resources.push_back(ResourceChange());
-		change->_change->resources.back().hashIt = resList;
-		change->_change->resources.back().resIt  = --resList->second.end();
+		change->_change->resources.back().hash     = hash;
+		change->_change->resources.back().resource = res;
 	}
-
-	// Resort the list by priority
-	resList->second.sort();
 }
 
 void ResourceManager::addResource(const Common::UString &path, Change *change, uint32 priority) {
@@ -1002,10 +1715,10 @@ void ResourceManager::addResources(const Common::FileList &files, Change *change
 
 const ResourceManager::Resource *ResourceManager::getRes(uint64 hash) const {
 	ResourceMap::const_iterator r = _resources.find(hash);
-	if ((r == _resources.end()) || r->second.empty() || (r->second.back().priority == 0))
+	if ((r == _resources.end()) || r->second.empty() || (r->second.back()->priority == 0))
 		return 0;
 
-	return &r->second.back();
+	return r->second.back();
 }
 
 const ResourceManager::Resource *ResourceManager::getRes(const Common::UString &name,
@@ -1036,7 +1749,35 @@ const ResourceManager::Resource *ResourceManager::getRes(const Common::UString &
 	return getRes(name, types);
 }
 
+const ResourceManager::Resource *ResourceManager::getRes(const ResRef &name,
+		const std::vector<FileType> &types) const {
+
+	const Resource *result = 0;
+	for (std::vector<FileType>::const_iterator type = types.begin(); type != types.end(); ++type) {
+		const Resource *res = getRes(getHash(name, *type));
+		if (res && (!result || *result < *res))
+			result = res;
+	}
+
+	// Compressed "small" files are rare enough to be looked up by the full name string
+	if (!result && _hasSmall)
+		return getRes(name.getString(), types);
+
+	return result;
+}
+
+const ResourceManager::Resource *ResourceManager::getRes(const ResRef &name, FileType type) const {
+	const Resource *res = getRes(getHash(name, type));
+
+	if (!res && _hasSmall)
+		return getRes(name.getString(), type);
+
+	return res;
+}
+
 void ResourceManager::dumpResourcesList(const Common::UString &fileName) const {
+	Common::ReadLock lock(_resourceLock);
+
 	Common::WriteFile file;
 
 	if (!file.open(fileName))
@@ -1045,15 +1786,22 @@ void ResourceManager::dumpResourcesList(const Common::UString &fileName) const {
 	file.writeString("                Name                 |        Hash        |     Size    \n");
 	file.writeString("-------------------------------------|--------------------|-------------\n");
 
-	for (ResourceMap::const_iterator r = _resources.begin(); r != _resources.end(); ++r) {
-		if (r->second.empty())
-			continue;
+	// The resource map isn't ordered, so sort the list by hash
+	std::vector<uint64> hashes;
+	hashes.reserve(_resources.size());
+
+	for (ResourceMap::const_iterator r = _resources.begin(); r != _resources.end(); ++r)
+		if (!r->second.empty())
+			hashes.push_back(r->first);
+
+	std::sort(hashes.begin(), hashes.end());
 
-		const Resource &res = r->second.back();
+	for (std::vector<uint64>::const_iterator h = hashes.begin(); h != hashes.end(); ++h) {
+		const Resource &res = *_resources.find(*h)->second.back();
 
 		const Common::UString &name = res.name;
 		const Common::UString   ext = TypeMan.setFileType("", res.type);
-		const uint64           hash = r->first;
+		const uint64           hash = *h;
 		const uint32           size = getResourceSize(res);
 
 		const Common::UString line =
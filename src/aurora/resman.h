@@ -30,14 +30,23 @@
 #include <map>
 #include <set>
 
+#include <boost/noncopyable.hpp>
+
 #include "src/common/types.h"
 #include "src/common/ustring.h"
 #include "src/common/singleton.h"
 #include "src/common/filelist.h"
 #include "src/common/hash.h"
 #include "src/common/changeid.h"
+#include "src/common/flathashmap.h"
+#include "src/common/mutex.h"
 
 #include "src/aurora/types.h"
+#include "src/aurora/resref.h"
+#include "src/aurora/indexcache.h"
+#include "src/aurora/prefetch.h"
+#include "src/aurora/resourcecache.h"
+#include "src/aurora/resourcetrace.h"
 
 namespace Common {
 	class SeekableReadStream;
@@ -60,6 +69,22 @@ public:
 		uint64 hash;
 	};
 
+	/** An archive to be indexed as part of a batch, see indexArchives(). */
+	struct BatchArchive {
+		Common::UString file; ///< The name of the archive file to index.
+		uint32 priority;      ///< The priority of the archive's resources.
+
+		std::vector<byte> password; ///< Use this password to decrypt the archive file, if necessary.
+
+		bool optional; ///< Silently skip this archive if it doesn't exist?
+
+		Common::ChangeID *changeID; ///< If given, record the changes done by this archive here.
+
+		BatchArchive(const Common::UString &f, uint32 p, bool o = false, Common::ChangeID *c = 0);
+	};
+
+	typedef std::vector<BatchArchive> ArchiveBatch;
+
 	ResourceManager();
 	~ResourceManager();
 
@@ -76,6 +101,26 @@ public:
 	/** With which hash algorithm are/should the names be hashed? */
 	void setHashAlgo(Common::HashAlgo algo);
 
+	/** Should archive files be memory-mapped?
+	 *
+	 *  If enabled (the default), archive files found directly on disk are mapped
+	 *  into memory when they are indexed. Uncompressed resources of these archives
+	 *  are then handed out as views into the mapping, without any copying.
+	 *
+	 *  Only affects archives that are indexed afterwards.
+	 */
+	void setMapArchives(bool mapArchives);
+
+	/** Set the memory budget, in bytes, of the cache for unpacked resources.
+	 *
+	 *  Resources stored compressed or encrypted within their archives are
+	 *  kept in this cache after they were unpacked, so that they don't need
+	 *  to be unpacked again when they are requested the next time.
+	 *
+	 *  A budget of 0 (the default) disables the cache.
+	 */
+	void setCacheBudget(size_t budget);
+
 	/** Set the array used to map cursor ID to cursor names. */
 	void setCursorRemap(const std::vector<Common::UString> &remap);
 
@@ -99,6 +144,11 @@ public:
 	 *  All further games files and archives are assumed to be inside
 	 *  this directory or archive.
 	 *
+	 *  This also loads the index cache of this data base, which holds the
+	 *  already parsed resource tables of its KEY/BIF, ERF and RIM archives.
+	 *  The index cache is updated and written back when the resources are
+	 *  cleared again.
+	 *
 	 *  @param path The path to a base data directory or archive.
 	 */
 	void registerDataBase(const Common::UString &path);
@@ -135,6 +185,18 @@ public:
 	 */
 	void indexArchive(const Common::UString &file, uint32 priority, const std::vector<byte> &password,
 	                  Common::ChangeID *changeID = 0);
+
+	/** Add all the resources of several archives to the resource manager.
+	 *
+	 *  The archives are opened and their resource tables are read in parallel,
+	 *  but their resources are added strictly in the order of the batch. The
+	 *  result is the same as calling indexArchive() for each archive in turn:
+	 *  if an archive fails to be indexed, the archives before it in the batch
+	 *  stay indexed, and the exception is thrown.
+	 *
+	 *  @param batch The archives to index.
+	 */
+	void indexArchives(const ArchiveBatch &batch);
 	// '---
 
 	// .--- Directories and files
@@ -219,6 +281,14 @@ public:
 	 */
 	bool hasResource(const Common::UString &name, FileType type) const;
 
+	/** Does a specific resource exist?
+	 *
+	 *  @param  name The name (ResRef) of the resource.
+	 *  @param  type The resource's type.
+	 *  @return true if the resource exists, false otherwise.
+	 */
+	bool hasResource(const ResRef &name, FileType type) const;
+
 	/** Does a specific resource exist?
 	 *
 	 *  @param  name The name (ResRef) of the resource.
@@ -242,6 +312,22 @@ public:
 	 */
 	bool hasResource(const Common::UString &name, const std::vector<FileType> &types) const;
 
+	/** Identify the current data of a resource, to recognize it again in later sessions.
+	 *
+	 *  A resource is identified by the file on disk it is found in, either
+	 *  directly or within an archive (or an archive within an archive), the
+	 *  size and modification time of that file, and the index and size of
+	 *  the resource within each of the archives.
+	 *
+	 *  @param  name The name (ResRef) of the resource.
+	 *  @param  type The resource's type.
+	 *  @param  file The path of the file on disk the resource is found in.
+	 *  @param  signature The signature identifying the resource's data.
+	 *  @return true if the resource exists and could be identified.
+	 */
+	bool getResourceIdentity(const Common::UString &name, FileType type,
+	                         Common::UString &file, IndexCache::Signature &signature) const;
+
 	/** Find and return the absolute filesystem file behind a resource.
 	 *
 	 *  If this resources does not exist, or the resource is not a direct file
@@ -297,6 +383,16 @@ public:
 	 */
 	Common::SeekableReadStream *getResource(const Common::UString &name, FileType type) const;
 
+	/** Return a resource.
+	 *
+	 *  Looking up a ResRef doesn't need to case-fold or hash its name again.
+	 *
+	 *  @param  name The name (ResRef) of the resource.
+	 *  @param  type The resource's type.
+	 *  @return The resource stream or 0 if the resource doesn't exist.
+	 */
+	Common::SeekableReadStream *getResource(const ResRef &name, FileType type) const;
+
 	/** Return a resource.
 	 *
 	 *  @param  name The name (with extension) of the resource.
@@ -317,6 +413,19 @@ public:
 	Common::SeekableReadStream *getResource(const Common::UString &name,
 			const std::vector<FileType> &types, FileType *foundType = 0) const;
 
+	/** Return a resource.
+	 *
+	 *  This only returns one stream, even if more than one of the specified file types exist
+	 *  for the given name.
+	 *
+	 *  @param  name The name (ResRef) of the resource.
+	 *  @param  types A list of file types to look for.
+	 *  @param  foundType If != 0, that's where the actually found type is stored.
+	 *  @return The resource stream or 0 if the resource doesn't exist.
+	 */
+	Common::SeekableReadStream *getResource(const ResRef &name,
+			const std::vector<FileType> &types, FileType *foundType = 0) const;
+
 	/** Return a resource of a specific type.
 	 *
 	 *  @param  resType The type of the resource.
@@ -327,6 +436,46 @@ public:
 	Common::SeekableReadStream *getResource(ResourceType resType,
 			const Common::UString &name, FileType *foundType = 0) const;
 
+	/** Return a resource of a specific type.
+	 *
+	 *  @param  resType The type of the resource.
+	 *  @param  name The name (ResRef) of the resource.
+	 *  @param  foundType If != 0, that's where the actually found type is stored.
+	 *  @return The resource stream or 0 if the music resource doesn't exist.
+	 */
+	Common::SeekableReadStream *getResource(ResourceType resType,
+			const ResRef &name, FileType *foundType = 0) const;
+
+	/** Start reading a resource in the background.
+	 *
+	 *  The resource is read and decompressed by a worker thread. A later
+	 *  getResource() call for this resource picks up the prefetched data,
+	 *  waiting for it if necessary, instead of reading the resource itself.
+	 *
+	 *  Useful when the full list of needed resources is known in advance,
+	 *  so that reading the resources overlaps with parsing them.
+	 *
+	 *  @param name The name (ResRef) of the resource.
+	 *  @param type The resource's type.
+	 */
+	void prefetch(const Common::UString &name, FileType type);
+
+	/** Read a resource in the background.
+	 *
+	 *  All pending background reads are canceled when resources are removed
+	 *  from the resource manager (by undo() or clear()); getStream() on a
+	 *  canceled AsyncResource returns 0.
+	 *
+	 *  Like all methods that only look up or read resources, this can be
+	 *  called from any thread.
+	 *
+	 *  @param  name The name (ResRef) of the resource.
+	 *  @param  type The resource's type.
+	 *  @return A handle to the resource being read. If the resource doesn't
+	 *          exist, its getStream() returns 0.
+	 */
+	AsyncResourcePtr getResourceAsync(const Common::UString &name, FileType type);
+
 	/** Return a list of all available resources of the specified type. */
 	void getAvailableResources(FileType type, std::list<ResourceID> &list) const;
 	/** Return a list of all available resources of the specified type. */
@@ -338,6 +487,38 @@ public:
 	/** Dump a list of all resources into a file. */
 	void dumpResourcesList(const Common::UString &fileName) const;
 
+	/** Return statistics about the cache for unpacked resources. */
+	ResourceCache::Stats getCacheStats() const;
+	/** Remove all resources from the cache for unpacked resources. */
+	void clearCache();
+
+	// .--- Tracing
+	/** Start or stop recording every resource request.
+	 *
+	 *  While tracing, each getResource() call is recorded with where the
+	 *  resource was found, its sizes, how long it took and which thread
+	 *  made the request. See ResourceTrace.
+	 */
+	void setTracing(bool enabled);
+	/** Are resource requests being recorded? */
+	bool isTracing() const;
+
+	/** Start a new section in the trace, for example because an area is being loaded. */
+	void beginTraceSection(const Common::UString &name);
+
+	/** Return the number of recorded resource requests. */
+	size_t getTraceRequestCount() const;
+	/** Remove all recorded resource requests. */
+	void clearTrace();
+
+	/** Write a report of the recorded resource requests into a file.
+	 *
+	 *  @param fileName The file to write the report into.
+	 *  @param topCount How many resources to list in each section's top lists.
+	 */
+	void writeTraceReport(const Common::UString &fileName, size_t topCount = 20) const;
+	// '---
+
 
 private:
 	typedef std::vector<FileType> FileTypeList;
@@ -382,6 +563,17 @@ private:
 	typedef std::list<KnownArchive> KnownArchives;
 	/** List of all opened archive files. */
 	typedef std::list<OpenedArchive> OpenedArchives;
+
+	/** Archives that have been opened, but not yet indexed. */
+	struct PendingArchives : boost::noncopyable {
+		std::vector<KnownArchive *> knownArchives;
+		std::vector<Archive *> archives;
+
+		~PendingArchives();
+	};
+
+	struct BatchJob;
+	struct Batch;
 	// '---
 
 	// .--- Resources
@@ -421,10 +613,13 @@ private:
 		bool operator<(const Resource &right) const;
 	};
 
-	/** List of resources, sorted by priority. */
-	typedef std::list<Resource> ResourceList;
-	/** Map over resources, indexed by their hashed name. */
-	typedef std::map<uint64, ResourceList> ResourceMap;
+	/** Resources currently being prefetched. */
+	typedef std::map<const Resource *, AsyncResourcePtr> PrefetchMap;
+
+	/** List of resources with the same name, sorted by priority. */
+	typedef std::vector<Resource *> ResourceList;
+	/** Map over resources, indexed by their hashed name. Owns the resources. */
+	typedef Common::FlatHashMap<ResourceList> ResourceMap;
 	// '---
 
 	// .--- Changes
@@ -434,8 +629,8 @@ private:
 	typedef OpenedArchives::iterator OpenedArchiveChange;
 	/** A change produced by indexing archive resources. */
 	struct ResourceChange {
-		ResourceMap::iterator  hashIt;
-		ResourceList::iterator resIt;
+		uint64    hash;     ///< The hashed name of the resource.
+		Resource *resource; ///< The resource itself.
 	};
 
 	typedef std::list<KnownArchiveChange>  KnownArchiveChanges;
@@ -473,6 +668,12 @@ private:
 	/** With which hash algorithm are/should the names be hashed? */
 	Common::HashAlgo _hashAlgo;
 
+	/** Should archive files be memory-mapped? */
+	bool _mapArchives;
+
+	/** The parsed indices of the archives within the current data base. */
+	IndexCache _indexCache;
+
 	/** Cursor ID -> cursor name. */
 	std::vector<Common::UString> _cursorRemap;
 
@@ -493,18 +694,57 @@ private:
 	FileTypeSet  _archiveTypeTypes [kArchiveMAX];  ///< All valid archive types file types.
 	FileTypeList _resourceTypeTypes[kResourceMAX]; ///< All valid resource type file types.
 
+	ResourcePrefetcher _prefetcher; ///< Reads resources in the background.
+
+	mutable PrefetchMap _prefetches; ///< Resources prefetched by prefetch().
+
+	/** Incremented whenever resources are removed, to invalidate background reads. */
+	uint32 _generation;
+
+	mutable ResourceCache _cache; ///< Unpacked resources, protected by _cacheMutex.
+
+	mutable ResourceTrace _trace; ///< The recorded resource requests.
+
+	/** Lock protecting all resource and archive information.
+	 *
+	 *  Looking up and reading resources only needs a read lock, and can
+	 *  therefore happen in several threads at once. Anything that changes
+	 *  the known resources, like indexing or undoing, needs a write lock.
+	 */
+	mutable Common::ReadWriteLock _resourceLock;
+
+	mutable Common::Mutex _prefetchMutex; ///< Mutex protecting the prefetched resources list.
+	mutable Common::Mutex _cacheMutex;    ///< Mutex protecting the unpacked resources cache.
+	mutable Common::Mutex _readMutex;     ///< Mutex serializing the access to non-thread-safe archives.
+
 
 	void clearResources();
 
+	void loadIndexCache();
+
 	// .--- Searching for archives
 	KnownArchive *findArchive(const Common::UString &file);
 	KnownArchive *findArchive(Common::UString file, KnownArchives &archives);
 	// '---
 
 	// .--- Indexing archives
-	void indexKEY(Common::SeekableReadStream *stream, uint32 priority, Change *change);
-	uint32 openKEYBIFs(Common::SeekableReadStream *keyStream,
+	void openArchives(KnownArchive &knownArchive, const std::vector<byte> &password,
+	                  PendingArchives &pending);
+	void indexArchives(PendingArchives &pending, uint32 priority, Change *change);
+
+	void openBatchJob(BatchJob &job);
+	uint32 openKEYBIFs(const KnownArchive &keyArchive,
 	                   std::vector<KnownArchive *> &archives, std::vector<BIFFile *> &bifs);
+	bool openCachedKEYBIFs(const KnownArchive &keyArchive,
+	                       std::vector<KnownArchive *> &archives, std::vector<BIFFile *> &bifs);
+	void cacheKEYIndex(const KnownArchive &keyArchive, const std::vector<Common::UString> &bifNames,
+	                   const std::vector<KnownArchive *> &archives, const std::vector<BIFFile *> &bifs);
+
+	Archive *openArchive(const KnownArchive &knownArchive, const std::vector<byte> &password);
+	Archive *openCachedArchive(const KnownArchive &knownArchive);
+	void cacheArchiveIndex(const KnownArchive &knownArchive, const Archive &archive);
+
+	bool getIndexSignature(const KnownArchive &knownArchive, IndexCache::Signature &signature) const;
 
 	void indexArchive(KnownArchive &knownArchive, Archive *archive,
 	                  uint32 priority, Change *change);
@@ -516,6 +756,8 @@ private:
 
 	bool checkResourceIsArchive(Resource &resource, Change *change);
 
+	static bool compareResourcePriority(const Resource *a, const Resource *b);
+
 	void addResource(Resource &resource, uint64 hash, Change *change);
 	void addResource(const Common::UString &path, Change *change, uint32 priority);
 
@@ -526,12 +768,29 @@ private:
 	const Resource *getRes(uint64 hash) const;
 	const Resource *getRes(const Common::UString &name, const std::vector<FileType> &types) const;
 	const Resource *getRes(const Common::UString &name, FileType type) const;
+	const Resource *getRes(const ResRef &name, const std::vector<FileType> &types) const;
+	const Resource *getRes(const ResRef &name, FileType type) const;
 
 	Common::SeekableReadStream *getResource(const Resource &res, bool tryNoCopy = false) const;
 
 	Common::SeekableReadStream *getArchiveResource(const Resource &res, bool tryNoCopy = false) const;
 
+	Common::SeekableReadStream *readResource(const Resource &res, bool tryNoCopy,
+	                                         ResourceTrace::Request *request = 0) const;
+	bool isResourceCompressed(const Resource &res) const;
+
+	Common::SeekableReadStream *getResourceTraced(const Resource &res) const;
+	void traceMissing(const Common::UString &name, FileType type) const;
+
+	AsyncResourcePtr readResourceAsync(const Resource &res);
+	Common::SeekableReadStream *readPrefetched(const Resource *res, uint32 generation) const;
+	AsyncResourcePtr takePrefetched(const Resource &res) const;
+	void cancelPrefetches();
+
 	uint32 getResourceSize(const Resource &res) const;
+	uint32 getResourcePackedSize(const Resource &res) const;
+	bool getResourceIdentity(const Resource &res, Common::UString &file, IndexCache::Signature &signature) const;
+	Common::UString getResourceSource(const Resource &res) const;
 	// '---
 
 	// .--- Resource utility methods
@@ -543,8 +802,9 @@ private:
 
 	inline uint64 getHash(const Common::UString &name, FileType type) const;
 	inline uint64 getHash(const Common::UString &name) const;
+	inline uint64 getHash(const ResRef &name, FileType type) const;
 
-	void checkHashCollision(const Resource &resource, ResourceMap::const_iterator resList);
+	void checkHashCollision(const Resource &resource, const ResourceList &resList);
 
 	Change *newChangeSet(Common::ChangeID &changeID);
 	// '---
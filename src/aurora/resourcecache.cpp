@@ -0,0 +1,171 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A cache for decompressed resource data.
+ */
+
+#include <cassert>
+
+#include "src/common/error.h"
+#include "src/common/scopedptr.h"
+#include "src/common/memreadstream.h"
+
+#include "src/aurora/resourcecache.h"
+
+namespace Aurora {
+
+/** A read-only stream onto cached resource data, sharing the data with the cache. */
+class CachedResourceStream : public Common::MemoryReadStream {
+public:
+	CachedResourceStream(const boost::shared_array<byte> &data, size_t size) :
+		Common::MemoryReadStream(data.get(), size), _data(data) {
+
+	}
+
+	~CachedResourceStream() {
+	}
+
+private:
+	boost::shared_array<byte> _data;
+};
+
+
+ResourceCache::ResourceCache(size_t budget) : _budget(budget), _size(0), _hits(0), _misses(0) {
+}
+
+ResourceCache::~ResourceCache() {
+}
+
+void ResourceCache::setBudget(size_t budget) {
+	_budget = budget;
+
+	evict(0);
+}
+
+ResourceCache::Stats ResourceCache::getStats() const {
+	Stats stats;
+
+	stats.budget = _budget;
+	stats.size   = _size;
+	stats.count  = _entries.size();
+	stats.hits   = _hits;
+	stats.misses = _misses;
+
+	return stats;
+}
+
+void ResourceCache::clear() {
+	_entries.clear();
+	_lru.clear();
+
+	_size = 0;
+}
+
+void ResourceCache::resetStats() {
+	_hits   = 0;
+	_misses = 0;
+}
+
+Common::SeekableReadStream *ResourceCache::get(Key key) {
+	if (_budget == 0)
+		return 0;
+
+	EntryMap::iterator entry = _entries.find(key);
+	if (entry == _entries.end()) {
+		_misses++;
+		return 0;
+	}
+
+	_hits++;
+
+	// Move the entry to the front of the LRU list
+	_lru.splice(_lru.begin(), _lru, entry->second.lru);
+
+	return createStream(entry->second);
+}
+
+Common::SeekableReadStream *ResourceCache::add(Key key, Common::SeekableReadStream *stream) {
+	Common::ScopedPtr<Common::SeekableReadStream> original(stream);
+
+	const size_t size = original->size();
+	if ((size == 0) || (size > _budget))
+		return original.release();
+
+	Data data;
+
+	/* Unpacked resources usually come as a MemoryReadStream owning its buffer.
+	 * In that case, we take over the buffer instead of copying it. */
+	Common::MemoryReadStream *memory = dynamic_cast<Common::MemoryReadStream *>(original.get());
+	const byte *buffer = memory ? memory->releaseData() : 0;
+
+	if (buffer) {
+		data.reset(const_cast<byte *>(buffer));
+	} else {
+		data.reset(new byte[size]);
+
+		original->seek(0);
+		if (original->read(data.get(), size) != size)
+			throw Common::Exception(Common::kReadError);
+	}
+
+	original.reset();
+
+	// Replace any older data for this resource
+	EntryMap::iterator old = _entries.find(key);
+	if (old != _entries.end()) {
+		_size -= old->second.size;
+
+		_lru.erase(old->second.lru);
+		_entries.erase(old);
+	}
+
+	evict(size);
+
+	_lru.push_front(key);
+
+	Entry &entry = _entries[key];
+
+	entry.data = data;
+	entry.size = size;
+	entry.lru  = _lru.begin();
+
+	_size += size;
+
+	return createStream(entry);
+}
+
+void ResourceCache::evict(size_t size) {
+	while (!_lru.empty() && ((_size + size) > _budget)) {
+		EntryMap::iterator entry = _entries.find(_lru.back());
+		assert(entry != _entries.end());
+
+		_size -= entry->second.size;
+
+		_entries.erase(entry);
+		_lru.pop_back();
+	}
+}
+
+Common::SeekableReadStream *ResourceCache::createStream(const Entry &entry) {
+	return new CachedResourceStream(entry.data, entry.size);
+}
+
+} // End of namespace Aurora
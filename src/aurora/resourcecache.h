@@ -0,0 +1,122 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A cache for decompressed resource data.
+ */
+
+#ifndef AURORA_RESOURCECACHE_H
+#define AURORA_RESOURCECACHE_H
+
+#include <list>
+#include <map>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_array.hpp>
+
+#include "src/common/types.h"
+
+namespace Common {
+	class SeekableReadStream;
+}
+
+namespace Aurora {
+
+/** A cache for the data of resources that are expensive to read.
+ *
+ *  Resources that are stored compressed or encrypted need to be unpacked
+ *  every time they are requested. The ResourceCache keeps the unpacked data
+ *  of recently used resources around, up to a memory budget. When the budget
+ *  is exceeded, the least recently used data is evicted.
+ *
+ *  The streams handed out by the cache are read-only views onto the cached
+ *  data, which is shared between all of them and not copied.
+ */
+class ResourceCache : boost::noncopyable {
+public:
+	/** An identifier for a resource, unique as long as the resource exists. */
+	typedef const void *Key;
+
+	ResourceCache(size_t budget = 0);
+	~ResourceCache();
+
+	/** Statistics about the cache's usage. */
+	struct Stats {
+		size_t budget; ///< The memory budget in bytes.
+		size_t size;   ///< Number of bytes currently cached.
+		size_t count;  ///< Number of resources currently cached.
+
+		uint64 hits;   ///< Number of requests that could be served from the cache.
+		uint64 misses; ///< Number of requests that could not be served from the cache.
+	};
+
+	/** Set the memory budget in bytes. 0 disables the cache. */
+	void setBudget(size_t budget);
+
+	/** Return statistics about the cache's usage. */
+	Stats getStats() const;
+
+	/** Remove all cached data. */
+	void clear();
+	/** Reset the hit and miss counters. */
+	void resetStats();
+
+	/** Return a stream of the cached resource data, or 0 if it's not in the cache. */
+	Common::SeekableReadStream *get(Key key);
+
+	/** Add the contents of a stream to the cache.
+	 *
+	 *  Takes over the stream, and returns a stream of the cached data in its
+	 *  place. If the data doesn't fit into the budget, the original stream is
+	 *  returned instead.
+	 */
+	Common::SeekableReadStream *add(Key key, Common::SeekableReadStream *stream);
+
+private:
+	typedef boost::shared_array<byte> Data;
+	typedef std::list<Key> LRUList;
+
+	struct Entry {
+		Data data;
+		size_t size;
+
+		LRUList::iterator lru;
+	};
+
+	typedef std::map<Key, Entry> EntryMap;
+
+	size_t _budget;
+	size_t _size;
+
+	uint64 _hits;
+	uint64 _misses;
+
+	EntryMap _entries;
+	LRUList  _lru; ///< The cached resources, the most recently used first.
+
+	/** Evict the least recently used data until this many bytes fit into the budget. */
+	void evict(size_t size);
+
+	static Common::SeekableReadStream *createStream(const Entry &entry);
+};
+
+} // End of namespace Aurora
+
+#endif // AURORA_RESOURCECACHE_H
@@ -0,0 +1,266 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Tracing of resource requests.
+ */
+
+#include <map>
+#include <set>
+#include <algorithm>
+
+#include <SDL_timer.h>
+
+#include "src/common/util.h"
+#include "src/common/strutil.h"
+#include "src/common/writestream.h"
+
+#include "src/aurora/resourcetrace.h"
+#include "src/aurora/util.h"
+
+namespace Aurora {
+
+ResourceTrace::Request::Request() : type(kFileTypeNone), origin(kOriginMissing),
+	packedSize(0), size(0), readTime(0), wallTime(0), thread(0) {
+
+}
+
+
+/** Statistics of all requests of one resource within a section. */
+struct TracedResource {
+	Common::UString name; ///< The resource's name, type and source.
+
+	size_t count; ///< Number of times the resource was requested.
+
+	uint32 packedSize;
+	uint32 size;
+
+	uint64 readTime;
+	uint64 wallTime;
+
+	TracedResource() : count(0), packedSize(0), size(0), readTime(0), wallTime(0) {
+	}
+};
+
+static bool compareWallTime(const TracedResource *a, const TracedResource *b) {
+	if (a->wallTime != b->wallTime)
+		return a->wallTime > b->wallTime;
+
+	return a->name < b->name;
+}
+
+static bool compareCount(const TracedResource *a, const TracedResource *b) {
+	if (a->count != b->count)
+		return a->count > b->count;
+
+	return compareWallTime(a, b);
+}
+
+static Common::UString formatTime(uint64 time) {
+	return Common::UString::format("%10.3f", time / 1000.0);
+}
+
+static void writeSummary(Common::WriteStream &stream, const std::vector<ResourceTrace::Request> &requests,
+                         size_t begin, size_t end) {
+
+	std::set<uint64> threads;
+
+	uint64 bytes = 0, readTime = 0, wallTime = 0;
+	size_t origins[ResourceTrace::kOriginMAX] = { 0 };
+
+	for (size_t i = begin; i < end; i++) {
+		const ResourceTrace::Request &request = requests[i];
+
+		threads.insert(request.thread);
+
+		bytes    += request.size;
+		readTime += request.readTime;
+		wallTime += request.wallTime;
+
+		origins[request.origin]++;
+	}
+
+	stream.writeString(Common::UString::format("Requests: %u by %u thread(s), %s bytes\n",
+	                   (uint) (end - begin), (uint) threads.size(), Common::composeString(bytes).c_str()));
+	stream.writeString(Common::UString::format("Origins : %u read, %u from cache, %u prefetched, %u missing\n",
+	                   (uint) origins[ResourceTrace::kOriginRead], (uint) origins[ResourceTrace::kOriginCache],
+	                   (uint) origins[ResourceTrace::kOriginPrefetch], (uint) origins[ResourceTrace::kOriginMissing]));
+	stream.writeString(Common::UString::format("Time    : %.3f ms total, %.3f ms reading and unpacking\n",
+	                   wallTime / 1000.0, readTime / 1000.0));
+}
+
+
+ResourceTrace::ResourceTrace() : _enabled(false) {
+}
+
+ResourceTrace::~ResourceTrace() {
+}
+
+void ResourceTrace::setEnabled(bool enabled) {
+	_enabled = enabled;
+}
+
+bool ResourceTrace::isEnabled() const {
+	return _enabled;
+}
+
+void ResourceTrace::clear() {
+	Common::StackLock lock(_mutex);
+
+	_requests.clear();
+	_sections.clear();
+}
+
+void ResourceTrace::beginSection(const Common::UString &name) {
+	Common::StackLock lock(_mutex);
+
+	Section section;
+	section.name         = name;
+	section.firstRequest = _requests.size();
+
+	// Replace an earlier section that didn't see any requests
+	if (!_sections.empty() && (_sections.back().firstRequest == _requests.size()))
+		_sections.back() = section;
+	else
+		_sections.push_back(section);
+}
+
+void ResourceTrace::add(const Request &request) {
+	if (!_enabled)
+		return;
+
+	Common::StackLock lock(_mutex);
+
+	_requests.push_back(request);
+}
+
+size_t ResourceTrace::getRequestCount() const {
+	Common::StackLock lock(_mutex);
+
+	return _requests.size();
+}
+
+void ResourceTrace::writeReport(Common::WriteStream &stream, size_t topCount) const {
+	Common::StackLock lock(_mutex);
+
+	stream.writeString("Resource trace report\n");
+	stream.writeString("=====================\n\n");
+
+	writeSummary(stream, _requests, 0, _requests.size());
+
+	// Requests made before the first section was started get a section of their own
+	if (_sections.empty() || (_sections.front().firstRequest > 0)) {
+		Section start;
+		start.name         = "Start";
+		start.firstRequest = 0;
+
+		const size_t end = _sections.empty() ? _requests.size() : _sections.front().firstRequest;
+
+		writeSection(stream, start, 0, end, topCount);
+	}
+
+	for (size_t i = 0; i < _sections.size(); i++) {
+		const size_t end = ((i + 1) < _sections.size()) ? _sections[i + 1].firstRequest : _requests.size();
+
+		writeSection(stream, _sections[i], _sections[i].firstRequest, end, topCount);
+	}
+}
+
+void ResourceTrace::writeSection(Common::WriteStream &stream, const Section &section,
+                                 size_t begin, size_t end, size_t topCount) const {
+
+	if (begin == end)
+		return;
+
+	// Sum up the requests for each resource
+	typedef std::map<Common::UString, TracedResource> ResourceMap;
+
+	ResourceMap resources;
+	for (size_t i = begin; i < end; i++) {
+		const Request &request = _requests[i];
+
+		Common::UString name = TypeMan.setFileType(request.name, request.type);
+		if (!request.source.empty())
+			name += " (" + request.source + ")";
+
+		TracedResource &resource = resources[name];
+
+		resource.name        = name;
+		resource.count      += 1;
+		resource.packedSize  = MAX(resource.packedSize, request.packedSize);
+		resource.size        = MAX(resource.size, request.size);
+		resource.readTime   += request.readTime;
+		resource.wallTime   += request.wallTime;
+	}
+
+	std::vector<const TracedResource *> sorted;
+	sorted.reserve(resources.size());
+
+	for (ResourceMap::const_iterator r = resources.begin(); r != resources.end(); ++r)
+		sorted.push_back(&r->second);
+
+	stream.writeString("\n--- " + section.name + " ---\n\n");
+
+	writeSummary(stream, _requests, begin, end);
+
+	// The resources taking up the most time
+	std::sort(sorted.begin(), sorted.end(), compareWallTime);
+
+	stream.writeString(Common::UString::format("\nHottest resources (%u different):\n\n", (uint) sorted.size()));
+	stream.writeString("  Count |   Total ms |    Read ms |     Packed |   Unpacked | Resource\n");
+	stream.writeString("--------|------------|------------|------------|------------|---------\n");
+
+	for (size_t i = 0; (i < sorted.size()) && (i < topCount); i++) {
+		const TracedResource &r = *sorted[i];
+
+		stream.writeString(Common::UString::format("%7u | %s | %s | %10u | %10u | %s\n", (uint) r.count,
+		                   formatTime(r.wallTime).c_str(), formatTime(r.readTime).c_str(),
+		                   r.packedSize, r.size, r.name.c_str()));
+	}
+
+	// The resources that were requested more than once
+	std::sort(sorted.begin(), sorted.end(), compareCount);
+
+	size_t repeated = 0;
+	while ((repeated < sorted.size()) && (sorted[repeated]->count > 1))
+		repeated++;
+
+	stream.writeString(Common::UString::format("\nRepeated fetches (%u resources):\n\n", (uint) repeated));
+	stream.writeString("  Count |   Total ms |  Total bytes | Resource\n");
+	stream.writeString("--------|------------|--------------|---------\n");
+
+	for (size_t i = 0; (i < repeated) && (i < topCount); i++) {
+		const TracedResource &r = *sorted[i];
+
+		stream.writeString(Common::UString::format("%7u | %s | %12s | %s\n", (uint) r.count,
+		                   formatTime(r.wallTime).c_str(),
+		                   Common::composeString((uint64) r.count * r.size).c_str(), r.name.c_str()));
+	}
+}
+
+uint64 ResourceTrace::getTime() {
+	const uint64 frequency = SDL_GetPerformanceFrequency();
+	const uint64 counter   = SDL_GetPerformanceCounter();
+
+	// Split the conversion, to avoid overflowing
+	return (counter / frequency) * 1000000 + ((counter % frequency) * 1000000) / frequency;
+}
+
+} // End of namespace Aurora
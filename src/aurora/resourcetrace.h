@@ -0,0 +1,137 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Tracing of resource requests.
+ */
+
+#ifndef AURORA_RESOURCETRACE_H
+#define AURORA_RESOURCETRACE_H
+
+#include "src/common/atomic.h"
+
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+#include "src/common/mutex.h"
+
+#include "src/aurora/types.h"
+
+namespace Common {
+	class WriteStream;
+}
+
+namespace Aurora {
+
+/** A recording of all resource requests made to the ResourceManager.
+ *
+ *  Every request is recorded together with where the resource was found,
+ *  how big it is and how long it took to get it. The recording is split
+ *  into sections, usually one for each area load, so that the report shows
+ *  where the time is going while loading an area.
+ *
+ *  Requests can be added from any thread.
+ */
+class ResourceTrace : boost::noncopyable {
+public:
+	/** How a request was served. */
+	enum Origin {
+		kOriginMissing , ///< The resource doesn't exist.
+		kOriginRead    , ///< The resource was read (and unpacked) from its source.
+		kOriginCache   , ///< The resource was found in the cache of unpacked resources.
+		kOriginPrefetch, ///< The resource was read in the background, see ResourceManager::prefetch().
+		kOriginMAX
+	};
+
+	/** A single resource request. */
+	struct Request {
+		Common::UString name;   ///< The resource's name.
+		FileType        type;   ///< The resource's type.
+		Common::UString source; ///< The archive or file the resource was found in.
+
+		Origin origin; ///< How the request was served.
+
+		uint32 packedSize; ///< The size of the resource within its source.
+		uint32 size;       ///< The size of the data that was handed out.
+
+		uint64 readTime; ///< Microseconds spent reading and unpacking the data.
+		uint64 wallTime; ///< Microseconds the whole request took.
+
+		uint64 thread; ///< ID of the thread that made the request.
+
+		Request();
+	};
+
+	ResourceTrace();
+	~ResourceTrace();
+
+	/** Start or stop recording requests. */
+	void setEnabled(bool enabled);
+	/** Are requests being recorded? */
+	bool isEnabled() const;
+
+	/** Remove all recorded requests and sections. */
+	void clear();
+
+	/** Start a new section, for example because a new area is being loaded.
+	 *
+	 *  All following requests are grouped under this section in the report.
+	 */
+	void beginSection(const Common::UString &name);
+
+	/** Record a request. Ignored if recording is disabled. */
+	void add(const Request &request);
+
+	/** Return the number of recorded requests. */
+	size_t getRequestCount() const;
+
+	/** Write a report of all recorded requests.
+	 *
+	 *  @param stream The stream to write the report into.
+	 *  @param topCount How many resources to list in each section's top lists.
+	 */
+	void writeReport(Common::WriteStream &stream, size_t topCount) const;
+
+	/** Return a monotonic timestamp in microseconds, for measuring requests. */
+	static uint64 getTime();
+
+private:
+	struct Section {
+		Common::UString name;
+		size_t firstRequest; ///< Index of the section's first request.
+	};
+
+	boost::atomic<bool> _enabled;
+
+	std::vector<Request> _requests;
+	std::vector<Section> _sections;
+
+	mutable Common::Mutex _mutex;
+
+	void writeSection(Common::WriteStream &stream, const Section &section,
+	                  size_t begin, size_t end, size_t topCount) const;
+};
+
+} // End of namespace Aurora
+
+#endif // AURORA_RESOURCETRACE_H
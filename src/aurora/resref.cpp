@@ -0,0 +1,194 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Interned resource names.
+ */
+
+#include <cstring>
+
+#include <boost/unordered/unordered_map.hpp>
+
+#include "src/common/ptrvector.h"
+#include "src/common/mutex.h"
+
+#include "src/aurora/resref.h"
+
+namespace Aurora {
+
+/** A pooled name, together with the states of all hash algorithms after hashing it. */
+struct ResRef::Entry {
+	Common::UString name;
+
+	bool hasPathCharacters;
+
+	uint32 djb2;
+	uint32 fnv32;
+	uint64 fnv64;
+	uint32 crc32; ///< Before the final inversion.
+
+	Entry(const Common::UString &n) : name(n), hasPathCharacters(false),
+		djb2(5381), fnv32(0x811C9DC5), fnv64(0xCBF29CE484222325LL), crc32(0xFFFFFFFF) {
+
+		for (Common::UString::iterator c = name.begin(); c != name.end(); ++c) {
+			if ((*c == '.') || (*c == '/') || (*c == '\\'))
+				hasPathCharacters = true;
+
+			djb2  = Common::hashDJB2 (djb2 , *c);
+			fnv32 = Common::hashFNV32(fnv32, *c);
+			fnv64 = Common::hashFNV64(fnv64, *c);
+			crc32 = Common::hashCRC32(crc32, *c);
+		}
+	}
+};
+
+/** The global pool of all names. */
+class ResRef::Pool {
+public:
+	const Entry *get(const Common::UString &name) {
+		Common::StackLock lock(_mutex);
+
+		EntryMap::const_iterator entry = _map.find(name);
+		if (entry != _map.end())
+			return entry->second;
+
+		_entries.push_back(new Entry(name));
+		_map.insert(std::make_pair(name, _entries.back()));
+
+		return _entries.back();
+	}
+
+	static Pool &instance() {
+		static Pool pool;
+
+		return pool;
+	}
+
+private:
+	typedef boost::unordered_map<Common::UString, const Entry *, Common::hashUStringCaseSensitive> EntryMap;
+
+	Common::PtrVector<Entry> _entries;
+	EntryMap _map;
+
+	Common::Mutex _mutex;
+};
+
+
+ResRef::ResRef() : _entry(0) {
+}
+
+ResRef::ResRef(const Common::UString &name) : _entry(0) {
+	set(name);
+}
+
+ResRef::ResRef(const char *name) : _entry(0) {
+	set(name);
+}
+
+void ResRef::set(const Common::UString &name) {
+	if (name.empty())
+		return;
+
+	_entry = Pool::instance().get(name.toLower());
+}
+
+static const Common::UString kEmptyString;
+
+const Common::UString &ResRef::getString() const {
+	return _entry ? _entry->name : kEmptyString;
+}
+
+bool ResRef::empty() const {
+	return _entry == 0;
+}
+
+bool ResRef::hasPathCharacters() const {
+	return _entry && _entry->hasPathCharacters;
+}
+
+size_t ResRef::getHash() const {
+	return _entry ? (size_t) _entry->fnv64 : 0;
+}
+
+uint64 ResRef::hash(Common::HashAlgo algo, const char *suffix) const {
+	const Entry empty("");
+	const Entry &entry = _entry ? *_entry : empty;
+
+	switch (algo) {
+		case Common::kHashDJB2: {
+				uint32 hash = entry.djb2;
+				for (const char *c = suffix; *c; c++)
+					hash = Common::hashDJB2(hash, (byte) *c);
+
+				return hash;
+			}
+
+		case Common::kHashFNV32: {
+				uint32 hash = entry.fnv32;
+				for (const char *c = suffix; *c; c++)
+					hash = Common::hashFNV32(hash, (byte) *c);
+
+				return hash;
+			}
+
+		case Common::kHashFNV64: {
+				uint64 hash = entry.fnv64;
+				for (const char *c = suffix; *c; c++)
+					hash = Common::hashFNV64(hash, (byte) *c);
+
+				return hash;
+			}
+
+		case Common::kHashCRC32: {
+				uint32 hash = entry.crc32;
+				for (const char *c = suffix; *c; c++)
+					hash = Common::hashCRC32(hash, (byte) *c);
+
+				return hash ^ 0xFFFFFFFF;
+			}
+
+		default:
+			break;
+	}
+
+	return 0;
+}
+
+bool ResRef::operator==(const ResRef &right) const {
+	return _entry == right._entry;
+}
+
+bool ResRef::operator!=(const ResRef &right) const {
+	return _entry != right._entry;
+}
+
+bool ResRef::operator<(const ResRef &right) const {
+	if (_entry == right._entry)
+		return false;
+
+	// Order by name, so that iterating over a map of ResRefs gives the same order in every session
+	return std::strcmp(getString().c_str(), right.getString().c_str()) < 0;
+}
+
+size_t hash_value(const ResRef &resRef) {
+	return resRef.getHash();
+}
+
+} // End of namespace Aurora
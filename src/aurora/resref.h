@@ -0,0 +1,97 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Interned resource names.
+ */
+
+#ifndef AURORA_RESREF_H
+#define AURORA_RESREF_H
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+#include "src/common/hash.h"
+
+namespace Aurora {
+
+/** An interned, case-folded resource name.
+ *
+ *  Resource names ("ResRefs") are case-insensitive. A ResRef stores
+ *  its name in lowercase, in a global pool that holds each different
+ *  name exactly once. A ResRef itself is only a pointer into that pool,
+ *  so it's cheap to copy, and two ResRefs are equal if and only if they
+ *  point to the same pooled name.
+ *
+ *  Together with the name, the pool keeps the state of each hash
+ *  algorithm after hashing the name. The ResourceManager can therefore
+ *  hash a ResRef with a file extension without touching the name again.
+ *
+ *  Creating a ResRef needs to look up the name in the pool, which is
+ *  about as expensive as a single lookup of the name in a map. ResRefs
+ *  pay off when they are created once and then used for many lookups.
+ *
+ *  ResRefs can be created and used from several threads at once. Pooled
+ *  names are never freed.
+ */
+class ResRef {
+public:
+	/** Create an empty ResRef. */
+	ResRef();
+	explicit ResRef(const Common::UString &name);
+	explicit ResRef(const char *name);
+
+	/** Return the name, in lowercase. */
+	const Common::UString &getString() const;
+
+	bool empty() const;
+
+	/** Does the name contain characters that make it more than a plain name, like '.' or '/'? */
+	bool hasPathCharacters() const;
+
+	/** Return a hash of the name, for use in hash maps. */
+	size_t getHash() const;
+
+	/** Return the hash of the name with a suffix appended.
+	 *
+	 *  This is the same as Common::hashString(getString() + suffix, algo).
+	 *  The suffix is expected to consist of ASCII characters only, like a
+	 *  file extension.
+	 */
+	uint64 hash(Common::HashAlgo algo, const char *suffix = "") const;
+
+	bool operator==(const ResRef &right) const;
+	bool operator!=(const ResRef &right) const;
+	bool operator<(const ResRef &right) const;
+
+private:
+	struct Entry;
+	class Pool;
+
+	const Entry *_entry; ///< The pooled name, or 0 if empty.
+
+	void set(const Common::UString &name);
+};
+
+/** Hash function for ResRefs in boost::unordered_map and similar containers. */
+size_t hash_value(const ResRef &resRef);
+
+} // End of namespace Aurora
+
+#endif // AURORA_RESREF_H
@@ -27,6 +27,7 @@
 #include "src/common/util.h"
 #include "src/common/strutil.h"
 #include "src/common/memreadstream.h"
+#include "src/common/writestream.h"
 #include "src/common/error.h"
 #include "src/common/encoding.h"
 
@@ -43,6 +44,12 @@ RIMFile::RIMFile(Common::SeekableReadStream *rim) : _rim(rim) {
 	load(*_rim);
 }
 
+RIMFile::RIMFile(Common::SeekableReadStream *rim, Common::SeekableReadStream &index) : _rim(rim) {
+	assert(_rim);
+
+	readIndex(index);
+}
+
 RIMFile::~RIMFile() {
 }
 
@@ -90,6 +97,34 @@ void RIMFile::readResList(Common::SeekableReadStream &rim, uint32 offset) {
 	}
 }
 
+bool RIMFile::writeIndex(Common::WriteStream &index) const {
+	index.writeUint32BE(_id);
+	index.writeUint32BE(_version);
+
+	writeResourceList(index, _resources);
+
+	index.writeUint32LE(_iResources.size());
+	for (IResourceList::const_iterator res = _iResources.begin(); res != _iResources.end(); ++res) {
+		index.writeUint32LE(res->offset);
+		index.writeUint32LE(res->size);
+	}
+
+	return true;
+}
+
+void RIMFile::readIndex(Common::SeekableReadStream &index) {
+	_id      = index.readUint32BE();
+	_version = index.readUint32BE();
+
+	readResourceList(index, _resources);
+
+	_iResources.resize(readIndexCount(index, 8));
+	for (IResourceList::iterator res = _iResources.begin(); res != _iResources.end(); ++res) {
+		res->offset = index.readUint32LE();
+		res->size   = index.readUint32LE();
+	}
+}
+
 const Archive::ResourceList &RIMFile::getResources() const {
 	return _resources;
 }
@@ -108,12 +143,18 @@ uint32 RIMFile::getResourceSize(uint32 index) const {
 Common::SeekableReadStream *RIMFile::getResource(uint32 index, bool tryNoCopy) const {
 	const IResource &res = getIResource(index);
 
+	Common::SeekableReadStream *view = getMappedView(*_rim, res.offset, res.size);
+	if (view)
+		return view;
+
 	if (tryNoCopy)
-		return new Common::SeekableSubReadStream(_rim.get(), res.offset, res.offset + res.size);
+		return new Common::PositionalSubReadStream(_rim.get(), res.offset, res.offset + res.size);
 
-	_rim->seek(res.offset);
+	return _rim->readStreamAt(res.offset, res.size);
+}
 
-	return _rim->readStream(res.size);
+bool RIMFile::isThreadSafe() const {
+	return _rim->isReadAtThreadSafe();
 }
 
 } // End of namespace Aurora
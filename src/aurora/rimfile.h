@@ -36,6 +36,7 @@
 
 namespace Common {
 	class SeekableReadStream;
+	class WriteStream;
 }
 
 namespace Aurora {
@@ -62,6 +63,8 @@ class RIMFile : public Archive, public AuroraFile {
 public:
 	/** Take over this stream and read a RIM file out of it. */
 	RIMFile(Common::SeekableReadStream *rim);
+	/** Take over this stream and recreate a RIM file out of a previously written index. */
+	RIMFile(Common::SeekableReadStream *rim, Common::SeekableReadStream &index);
 	~RIMFile();
 
 	/** Return the list of resources. */
@@ -73,6 +76,12 @@ public:
 	/** Return a stream of the resource's contents. */
 	Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const;
 
+	/** Can resources be read from several threads at the same time? */
+	bool isThreadSafe() const;
+
+	/** Write the RIM's index. */
+	bool writeIndex(Common::WriteStream &index) const;
+
 private:
 	/** Internal resource information. */
 	struct IResource {
@@ -93,6 +102,8 @@ private:
 	void load(Common::SeekableReadStream &rim);
 	void readResList(Common::SeekableReadStream &rim, uint32 offset);
 
+	void readIndex(Common::SeekableReadStream &index);
+
 	const IResource &getIResource(uint32 index) const;
 };
 
@@ -36,7 +36,12 @@ src_aurora_libaurora_la_SOURCES += \
     src/aurora/rimfile.h \
     src/aurora/ndsrom.h \
     src/aurora/zipfile.h \
+    src/aurora/resref.h \
     src/aurora/resman.h \
+    src/aurora/indexcache.h \
+    src/aurora/prefetch.h \
+    src/aurora/resourcecache.h \
+    src/aurora/resourcetrace.h \
     src/aurora/talktable.h \
     src/aurora/talktable_tlk.h \
     src/aurora/talktable_gff.h \
@@ -46,6 +51,7 @@ src_aurora_libaurora_la_SOURCES += \
     src/aurora/gdafile.h \
     src/aurora/gdaheaders.h \
     src/aurora/2dareg.h \
+    src/aurora/2dacache.h \
     src/aurora/locstring.h \
     src/aurora/gff3file.h \
     src/aurora/gff4file.h \
@@ -74,7 +80,12 @@ src_aurora_libaurora_la_SOURCES += \
     src/aurora/rimfile.cpp \
     src/aurora/ndsrom.cpp \
     src/aurora/zipfile.cpp \
+    src/aurora/resref.cpp \
     src/aurora/resman.cpp \
+    src/aurora/indexcache.cpp \
+    src/aurora/prefetch.cpp \
+    src/aurora/resourcecache.cpp \
+    src/aurora/resourcetrace.cpp \
     src/aurora/talktable.cpp \
     src/aurora/talktable_tlk.cpp \
     src/aurora/talktable_gff.cpp \
@@ -84,6 +95,7 @@ src_aurora_libaurora_la_SOURCES += \
     src/aurora/gdafile.cpp \
     src/aurora/gdaheaders.cpp \
     src/aurora/2dareg.cpp \
+    src/aurora/2dacache.cpp \
     src/aurora/locstring.cpp \
     src/aurora/gff3file.cpp \
     src/aurora/gff4file.cpp \
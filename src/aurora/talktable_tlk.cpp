@@ -44,9 +44,19 @@ static const uint32 kVersion4 = MKTAG('V', '4', '.', '0');
 namespace Aurora {
 
 TalkTable_TLK::TalkTable_TLK(Common::SeekableReadStream *tlk, Common::Encoding encoding) :
-	TalkTable(encoding), _tlk(tlk) {
+	TalkTable(encoding) {
 
-	assert(_tlk);
+	assert(tlk);
+
+	/* Strings are decoded straight out of memory, so that several threads
+	 * can decode them without having to share a stream position. */
+	_tlk.reset(dynamic_cast<Common::MemoryReadStream *>(tlk));
+	if (!_tlk) {
+		Common::ScopedPtr<Common::SeekableReadStream> tlkStream(tlk);
+
+		tlkStream->seek(0);
+		_tlk.reset(tlkStream->readStream(tlkStream->size()));
+	}
 
 	load();
 }
@@ -69,6 +79,10 @@ void TalkTable_TLK::load() {
 		uint32 stringCount = _tlk->readUint32LE();
 		_entries.resize(stringCount);
 
+		_decoded.reset(new boost::atomic<bool>[stringCount]);
+		for (uint32 i = 0; i < stringCount; i++)
+			_decoded[i].store(false, boost::memory_order_relaxed);
+
 		// V4 added this field; it's right after the header in V3
 		uint32 tableOffset = 20;
 		if (_version == kVersion4)
@@ -112,26 +126,30 @@ void TalkTable_TLK::readEntryTableV4() {
 	}
 }
 
-void TalkTable_TLK::readString(Entry &entry) const {
-	if (!entry.text.empty() || (entry.length == 0) || !(entry.flags & kFlagTextPresent))
-		// We already have the string
+void TalkTable_TLK::readString(uint32 strRef) const {
+	Common::StackLock lock(_mutex);
+
+	// Another thread might have decoded this string while we were waiting
+	if (_decoded[strRef].load(boost::memory_order_relaxed))
 		return;
 
-	assert(_tlk);
+	Entry &entry = _entries[strRef];
 
-	_tlk->seek(entry.offset);
+	const size_t size = _tlk->size();
 
-	uint32 length = MIN<size_t>(entry.length, _tlk->size() - _tlk->pos());
-	if (length == 0)
-		return;
+	if ((entry.length > 0) && (entry.flags & kFlagTextPresent) && (entry.offset < size)) {
+		const uint32 length = MIN<size_t>(entry.length, size - entry.offset);
+
+		Common::MemoryReadStream data(_tlk->getData() + entry.offset, length);
+		Common::ScopedPtr<Common::MemoryReadStream> parsed(LangMan.preParseColorCodes(data));
 
-	Common::ScopedPtr<Common::MemoryReadStream> data(_tlk->readStream(length));
-	Common::ScopedPtr<Common::MemoryReadStream> parsed(LangMan.preParseColorCodes(*data));
+		if (_encoding != Common::kEncodingInvalid)
+			entry.text = Common::readString(*parsed, _encoding);
+		else
+			entry.text = "[???]";
+	}
 
-	if (_encoding != Common::kEncodingInvalid)
-		entry.text = Common::readString(*parsed, _encoding);
-	else
-		entry.text = "[???]";
+	_decoded[strRef].store(true, boost::memory_order_release);
 }
 
 uint32 TalkTable_TLK::getLanguageID() const {
@@ -147,7 +165,8 @@ const Common::UString &TalkTable_TLK::getString(uint32 strRef) const {
 	if (strRef >= _entries.size())
 		return kEmptyString;
 
-	readString(_entries[strRef]);
+	if (!_decoded[strRef].load(boost::memory_order_acquire))
+		readString(strRef);
 
 	return _entries[strRef].text;
 }
@@ -25,15 +25,22 @@
 #ifndef AURORA_TALKTABLE_TLK_H
 #define AURORA_TALKTABLE_TLK_H
 
+#include "src/common/atomic.h"
+
 #include <vector>
 
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
 #include "src/common/ustring.h"
+#include "src/common/mutex.h"
 
 #include "src/aurora/aurorafile.h"
 #include "src/aurora/talktable.h"
 
+namespace Common {
+	class MemoryReadStream;
+}
+
 namespace Aurora {
 
 /** Loading BioWare's TLK talk tables.
@@ -49,6 +56,11 @@ namespace Aurora {
  *  - V3.0, used by Neverwinter Nights, Neverwinter Nights 2, Knight of
  *    the Old Republic, Knight of the Old Republic II and The Witcher
  *  - V4.0, used by Jade Empire
+ *
+ *  The whole TLK is held in memory, and each string is decoded the
+ *  first time it is requested. Strings can be requested from several
+ *  threads at once: decoding a string is serialized, but returning
+ *  a string that has already been decoded does not need any locking.
  */
 class TalkTable_TLK : public AuroraFile, public TalkTable {
 public:
@@ -96,18 +108,23 @@ private:
 	typedef std::vector<Entry> Entries;
 
 
-	Common::ScopedPtr<Common::SeekableReadStream> _tlk;
+	Common::ScopedPtr<Common::MemoryReadStream> _tlk;
 
 	uint32 _languageID;
 
 	mutable Entries _entries;
 
+	/** Has the text of this entry been decoded yet? */
+	Common::ScopedArray< boost::atomic<bool> > _decoded;
+
+	mutable Common::Mutex _mutex; ///< Mutex protecting the decoding of strings.
+
 	void load();
 
 	void readEntryTableV3(uint32 stringsOffset);
 	void readEntryTableV4();
 
-	void readString(Entry &entry) const;
+	void readString(uint32 strRef) const;
 };
 
 } // End of namespace Aurora
@@ -55,6 +55,9 @@ public:
 	/** Return the file name with a swapped extensions according to the specified file type. */
 	Common::UString setFileType(const Common::UString &path, FileType type);
 
+	/** Return the extension of a file type, including the leading '.', or "" if it has none. */
+	const char *getExtension(FileType type);
+
 
 private:
 	/** File type <-> extension mapping. */
@@ -22,6 +22,7 @@
  *  A ZIP archive.
  */
 
+#include "src/common/util.h"
 #include "src/common/zipfile.h"
 #include "src/common/filepath.h"
 
@@ -49,10 +50,22 @@ uint32 ZIPFile::getResourceSize(uint32 index) const {
 	return _zipFile->getFileSize(index);
 }
 
+uint32 ZIPFile::getResourcePackedSize(uint32 index) const {
+	return _zipFile->getFilePackedSize(index);
+}
+
+bool ZIPFile::isResourceCompressed(uint32 index) const {
+	return _zipFile->isFileCompressed(index);
+}
+
 Common::SeekableReadStream *ZIPFile::getResource(uint32 index, bool tryNoCopy) const {
 	return _zipFile->getFile(index, tryNoCopy);
 }
 
+bool ZIPFile::isThreadSafe() const {
+	return _zipFile->isThreadSafe();
+}
+
 void ZIPFile::load() {
 	const Common::ZipFile::FileList &files = _zipFile->getFiles();
 	for (Common::ZipFile::FileList::const_iterator file = files.begin(); file != files.end(); ++file) {
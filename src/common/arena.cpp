@@ -0,0 +1,199 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A bump-pointer memory arena, for data that is freed all at once.
+ */
+
+#include "src/common/atomic.h"
+
+#include <cassert>
+#include <cstdlib>
+
+#include "src/common/arena.h"
+#include "src/common/util.h"
+
+namespace Common {
+
+static boost::atomic<uint64> arenaAllocations(0);
+static boost::atomic<uint64> arenaBytes(0);
+static boost::atomic<uint64> arenaBlocks(0);
+
+static boost::atomic<uint64> liveArenas(0);
+static boost::atomic<uint64> liveBlocks(0);
+static boost::atomic<uint64> liveBlockBytes(0);
+
+/** The size of a block header, keeping the data behind it aligned. */
+static const size_t kBlockHeaderSize = 4 * sizeof(void *);
+
+static inline byte *alignPointer(byte *pointer, size_t alignment) {
+	const uintptr_t p = reinterpret_cast<uintptr_t>(pointer);
+
+	return reinterpret_cast<byte *>((p + alignment - 1) & ~((uintptr_t) alignment - 1));
+}
+
+
+MemoryArena::Statistics::Statistics() : allocations(0), bytes(0), blocks(0),
+	liveArenas(0), liveBlocks(0), liveBlockBytes(0) {
+}
+
+byte *MemoryArena::Block::data() {
+	return reinterpret_cast<byte *>(this) + kBlockHeaderSize;
+}
+
+
+MemoryArena::MemoryArena(size_t blockSize) : _blockSize(MAX<size_t>(blockSize, kFirstBlockSize)),
+	_nextBlockSize(kFirstBlockSize), _block(0), _spare(0), _position(0), _end(0), _destructors(0),
+	_allocations(0), _bytes(0), _blocks(0) {
+
+	liveArenas++;
+}
+
+MemoryArena::~MemoryArena() {
+	clear();
+
+	if (_spare)
+		releaseBlock(_spare);
+
+	liveArenas--;
+}
+
+void *MemoryArena::allocate(size_t size, size_t alignment) {
+	assert((alignment != 0) && ((alignment & (alignment - 1)) == 0));
+
+	byte *data = alignPointer(_position, alignment);
+	if (!_block || (data > _end) || (size > (size_t) (_end - data))) {
+		newBlock(size, alignment);
+
+		data = alignPointer(_position, alignment);
+	}
+
+	_position = data + size;
+
+	_allocations++;
+	_bytes += size;
+
+	return data;
+}
+
+void MemoryArena::newBlock(size_t size, size_t alignment) {
+	const size_t needed = size + alignment;
+
+	Block *block = 0;
+	if (_spare && (_spare->size >= needed)) {
+		block  = _spare;
+		_spare = 0;
+	} else {
+		const size_t blockSize = MAX(_nextBlockSize, needed);
+
+		_nextBlockSize = MIN(_nextBlockSize * 2, _blockSize);
+
+		block = static_cast<Block *>(std::malloc(kBlockHeaderSize + blockSize));
+		if (!block)
+			throw std::bad_alloc();
+
+		block->size = blockSize;
+
+		_blocks++;
+
+		liveBlocks++;
+		liveBlockBytes += kBlockHeaderSize + blockSize;
+	}
+
+	block->previous = _block;
+
+	_block    = block;
+	_position = block->data();
+	_end      = block->data() + block->size;
+}
+
+void MemoryArena::freeBlock(Block *block) {
+	/* Keep one block around, so that a cleared arena doesn't need to allocate again.
+	 * The newest block is freed first, and that's the biggest one of regular size. */
+	if (!_spare && (block->size <= _blockSize)) {
+		_spare = block;
+		return;
+	}
+
+	releaseBlock(block);
+}
+
+void MemoryArena::releaseBlock(Block *block) {
+	liveBlocks--;
+	liveBlockBytes -= kBlockHeaderSize + block->size;
+
+	std::free(block);
+}
+
+void MemoryArena::clear() {
+	// Destroy the objects, newest first
+	while (_destructors) {
+		Destructor *destructor = _destructors;
+		_destructors = destructor->previous;
+
+		destructor->destroy(destructor->object);
+	}
+
+	while (_block) {
+		Block *block = _block;
+		_block = block->previous;
+
+		freeBlock(block);
+	}
+
+	_position = 0;
+	_end      = 0;
+
+	flushStatistics();
+}
+
+size_t MemoryArena::getAllocationCount() const {
+	return _allocations;
+}
+
+size_t MemoryArena::getBlockCount() const {
+	return _blocks;
+}
+
+void MemoryArena::flushStatistics() {
+	arenaAllocations += _allocations;
+	arenaBytes       += _bytes;
+	arenaBlocks      += _blocks;
+
+	_allocations = 0;
+	_bytes       = 0;
+	_blocks      = 0;
+}
+
+MemoryArena::Statistics MemoryArena::getStatistics() {
+	Statistics statistics;
+
+	statistics.allocations = arenaAllocations;
+	statistics.bytes       = arenaBytes;
+	statistics.blocks      = arenaBlocks;
+
+	statistics.liveArenas     = liveArenas;
+	statistics.liveBlocks     = liveBlocks;
+	statistics.liveBlockBytes = liveBlockBytes;
+
+	return statistics;
+}
+
+} // End of namespace Common
@@ -0,0 +1,268 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A bump-pointer memory arena, for data that is freed all at once.
+ */
+
+#ifndef COMMON_ARENA_H
+#define COMMON_ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <limits>
+
+#include <boost/noncopyable.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/type_traits/has_trivial_destructor.hpp>
+
+#include "src/common/system.h"
+#include "src/common/types.h"
+
+namespace Common {
+
+/** A memory arena, handing out memory by bumping a pointer through big blocks.
+ *
+ *  Parsing a file creates a lot of small objects that all die together,
+ *  when the file or the whole load is done. Allocating them from an arena
+ *  replaces a malloc() and free() for each of them with a pointer bump,
+ *  and keeps them from fragmenting the heap.
+ *
+ *  Memory is never freed individually. It is freed when the arena is
+ *  cleared or destroyed. Objects made with create() are destroyed then
+ *  as well, in reverse order of creation.
+ *
+ *  The first block is small, and each further block is twice the size of
+ *  the one before, up to the maximum block size. An arena that only ever
+ *  holds a few objects therefore doesn't cost much more than they do.
+ *
+ *  An arena is not thread-safe.
+ */
+class MemoryArena : boost::noncopyable {
+public:
+	/** Numbers about arena use, to compare against plain heap allocations. */
+	struct Statistics {
+		uint64 allocations; ///< Number of allocations served by arenas.
+		uint64 bytes;       ///< Number of bytes served by arenas.
+		uint64 blocks;      ///< Number of blocks arenas allocated from the heap.
+
+		uint64 liveArenas;     ///< Number of arenas currently existing.
+		uint64 liveBlocks;     ///< Number of blocks currently held by arenas, including spare ones.
+		uint64 liveBlockBytes; ///< Size of the blocks currently held by arenas.
+
+		Statistics();
+	};
+
+	static const size_t kFirstBlockSize   =  1 * 1024;
+	static const size_t kDefaultBlockSize = 64 * 1024;
+
+	/** Create an arena whose blocks grow up to blockSize bytes. */
+	explicit MemoryArena(size_t blockSize = kDefaultBlockSize);
+	~MemoryArena();
+
+	/** Allocate size bytes, aligned to alignment, which has to be a power of 2. */
+	void *allocate(size_t size, size_t alignment = kDefaultAlignment);
+
+	/** Allocate uninitialized memory for count objects of type T. */
+	template<typename T>
+	T *allocateArray(size_t count) {
+		return static_cast<T *>(allocate(count * sizeof(T), boost::alignment_of<T>::value));
+	}
+
+	/** Create an object in the arena. It is destroyed along with the arena memory.
+	 *
+	 *  If T has a private constructor or destructor, it has to befriend MemoryArena.
+	 */
+	template<typename T>
+	T *create() {
+		return track(new(allocateArray<T>(1)) T());
+	}
+
+	template<typename T, typename A1>
+	T *create(const A1 &a1) {
+		return track(new(allocateArray<T>(1)) T(a1));
+	}
+
+	template<typename T, typename A1, typename A2>
+	T *create(const A1 &a1, const A2 &a2) {
+		return track(new(allocateArray<T>(1)) T(a1, a2));
+	}
+
+	template<typename T, typename A1, typename A2, typename A3>
+	T *create(const A1 &a1, const A2 &a2, const A3 &a3) {
+		return track(new(allocateArray<T>(1)) T(a1, a2, a3));
+	}
+
+	/** Destroy all objects and free all memory, except for one block to reuse. */
+	void clear();
+
+	/** Return the number of allocations served by this arena since it was last cleared. */
+	size_t getAllocationCount() const;
+	/** Return the number of blocks this arena allocated from the heap since it was last cleared. */
+	size_t getBlockCount() const;
+
+	/** Return the combined statistics of all arenas.
+	 *
+	 *  The allocations, bytes and blocks of an arena are added once it's
+	 *  cleared or destroyed. The live numbers are always up to date.
+	 */
+	static Statistics getStatistics();
+
+private:
+	static const size_t kDefaultAlignment = 2 * sizeof(void *);
+
+	/** A block of memory. The usable memory directly follows this header. */
+	struct Block {
+		Block *previous; ///< The block that was in use before this one.
+		size_t size;     ///< Usable size of the block, in bytes.
+
+		byte *data();
+	};
+
+	/** A created object that needs to be destroyed. */
+	struct Destructor {
+		Destructor *previous;
+
+		void (*destroy)(void *);
+		void *object;
+	};
+
+	size_t _blockSize;     ///< The maximum size of a block.
+	size_t _nextBlockSize; ///< The size of the next block to allocate.
+
+	Block *_block; ///< The block currently in use.
+	Block *_spare; ///< A free block, kept around to be reused.
+
+	byte *_position; ///< The next free byte in the current block.
+	byte *_end;      ///< The end of the current block.
+
+	Destructor *_destructors; ///< The latest created object needing destruction.
+
+	size_t _allocations;
+	size_t _bytes;
+	size_t _blocks;
+
+	/** Start a new block that can hold at least size bytes at this alignment. */
+	void newBlock(size_t size, size_t alignment);
+	/** Free a block no longer in use, or keep it as the spare. */
+	void freeBlock(Block *block);
+	/** Return a block's memory to the heap. */
+	static void releaseBlock(Block *block);
+
+	/** Add the arena's numbers to the global statistics and reset them. */
+	void flushStatistics();
+
+	template<typename T>
+	static void destroyObject(void *object) {
+		static_cast<T *>(object)->~T();
+	}
+
+	template<typename T>
+	T *track(T *object) {
+		if (!boost::has_trivial_destructor<T>::value) {
+			Destructor *destructor = allocateArray<Destructor>(1);
+
+			destructor->previous = _destructors;
+			destructor->destroy  = &destroyObject<T>;
+			destructor->object   = object;
+
+			_destructors = destructor;
+		}
+
+		return object;
+	}
+};
+
+/** An STL allocator handing out memory from a MemoryArena.
+ *
+ *  Deallocation does nothing; the memory is reclaimed with the arena. This
+ *  is useful for containers that are filled once and then only read.
+ */
+template<typename T>
+class ArenaAllocator {
+public:
+	typedef T value_type;
+	typedef T *pointer;
+	typedef const T *const_pointer;
+	typedef T &reference;
+	typedef const T &const_reference;
+	typedef std::size_t size_type;
+	typedef std::ptrdiff_t difference_type;
+
+	template<typename U>
+	struct rebind {
+		typedef ArenaAllocator<U> other;
+	};
+
+	explicit ArenaAllocator(MemoryArena &arena) : _arena(&arena) {
+	}
+
+	template<typename U>
+	ArenaAllocator(const ArenaAllocator<U> &allocator) : _arena(allocator.getArena()) {
+	}
+
+	MemoryArena *getArena() const {
+		return _arena;
+	}
+
+	pointer address(reference x) const {
+		return &x;
+	}
+
+	const_pointer address(const_reference x) const {
+		return &x;
+	}
+
+	pointer allocate(size_type n, const void * UNUSED(hint) = 0) {
+		return _arena->allocateArray<T>(n);
+	}
+
+	void deallocate(pointer UNUSED(p), size_type UNUSED(n)) {
+	}
+
+	size_type max_size() const {
+		return std::numeric_limits<size_type>::max() / sizeof(T);
+	}
+
+	void construct(pointer p, const T &value) {
+		new(p) T(value);
+	}
+
+	void destroy(pointer p) {
+		p->~T();
+	}
+
+private:
+	MemoryArena *_arena;
+};
+
+template<typename T, typename U>
+inline bool operator==(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) {
+	return a.getArena() == b.getArena();
+}
+
+template<typename T, typename U>
+inline bool operator!=(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) {
+	return a.getArena() != b.getArena();
+}
+
+} // End of namespace Common
+
+#endif // COMMON_ARENA_H
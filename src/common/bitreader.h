@@ -0,0 +1,356 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A fast bit reader over data in memory.
+ */
+
+#ifndef COMMON_BITREADER_H
+#define COMMON_BITREADER_H
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/endianness.h"
+#include "src/common/disposableptr.h"
+#include "src/common/error.h"
+#include "src/common/readstream.h"
+#include "src/common/memreadstream.h"
+
+namespace Common {
+
+/**
+ * A bit reader over data in memory.
+ *
+ * Unlike BitStream, this is not a virtual interface over a ReadStream.
+ * It works on a contiguous buffer and keeps a 64-bit cache of the
+ * upcoming bits, refilled with a single load. This makes peeking,
+ * skipping and reading up to 32 bits constant-time operations that
+ * the compiler can inline into the decoder loops.
+ *
+ * The layout parameters are the same as BitStreamImpl's: the data is
+ * made of valueBits-wide values, in little- or big-endian, and their
+ * bits are handed out MSB or LSB first. 8-, 16- and 32-bit values are
+ * supported.
+ */
+template<int valueBits, bool isLE, bool isMSB2LSB>
+class BitReaderImpl : boost::noncopyable {
+public:
+	/** Create a bit reader over this data and optionally delete[] it on destruction. */
+	BitReaderImpl(const byte *data, size_t size, bool disposeAfterUse = false) :
+		_data(data, disposeAfterUse) {
+
+		checkLayout();
+		setData(0, size);
+	}
+
+	/** Create a bit reader over this stream, starting at its current position.
+	 *
+	 *  If the stream is a MemoryReadStream, its data is used directly, and
+	 *  it has to outlive the bit reader. Otherwise, the data is copied.
+	 */
+	BitReaderImpl(SeekableReadStream &stream) : _data(0, false) {
+		checkLayout();
+
+		const size_t start = stream.pos();
+		const size_t size  = stream.size();
+
+		MemoryReadStream *memStream = dynamic_cast<MemoryReadStream *>(&stream);
+		if (memStream) {
+			_data.reset(memStream->getData());
+		} else {
+			byte *data = new byte[size];
+
+			_data.reset(data);
+			_data.setDisposable(true);
+
+			stream.seek(0);
+			if (stream.read(data, size) != size)
+				throw Exception(kReadError);
+
+			stream.seek(start);
+		}
+
+		setData(start, size);
+	}
+
+	~BitReaderImpl() {
+	}
+
+	/** Read a bit from the bit stream. */
+	inline uint32 getBit() {
+		if (_cacheBits < 1)
+			fill(1);
+
+		const uint32 b = isMSB2LSB ? (uint32) (_cache >> 63) : (uint32) (_cache & 1);
+
+		consume(1);
+		return b;
+	}
+
+	/** Read a multi-bit value from the bit stream. */
+	inline uint32 getBits(size_t n) {
+		if (n == 0)
+			return 0;
+
+		if (n > 32)
+			throw Exception("Too many bits requested to be read");
+
+		if (_cacheBits < n)
+			fill(n);
+
+		const uint32 v = peekCache(n);
+
+		consume(n);
+		return v;
+	}
+
+	/** Read a multi-bit value from the bit stream, without consuming the bits.
+	 *
+	 *  Bits past the end of the stream are read as 0.
+	 */
+	inline uint32 peekBits(size_t n) {
+		if (n == 0)
+			return 0;
+
+		if (n > 32)
+			throw Exception("Too many bits requested to be read");
+
+		if (_cacheBits < n)
+			refill();
+
+		return peekCache(n);
+	}
+
+	/** Add a bit to the n-bit value x, making it an (n+1)-bit value. */
+	inline void addBit(uint32 &x, size_t n) {
+		if (n >= 32)
+			throw Exception("Too many bits requested to be read");
+
+		if (isMSB2LSB)
+			x = (x << 1) | getBit();
+		else
+			x = (x & ~(1 << n)) | (getBit() << n);
+	}
+
+	/** Skip the specified amount of bits. */
+	inline void skip(size_t n) {
+		if (n < _cacheBits) {
+			consume(n);
+			return;
+		}
+
+		// Drop the cache and skip whole values
+		n -= _cacheBits;
+
+		_cache     = 0;
+		_cacheBits = 0;
+
+		const size_t skipBytes = (n / valueBits) * (valueBits / 8);
+		if ((size_t) (_end - _ptr) < skipBytes)
+			throw Exception("BitReader::skip(): End of bit stream reached");
+
+		_ptr += skipBytes;
+		n    %= valueBits;
+
+		if (n > 0) {
+			fill(n);
+			consume(n);
+		}
+	}
+
+	/** Rewind the bit stream back to the start. */
+	void rewind() {
+		_ptr = _data.get();
+
+		_cache     = 0;
+		_cacheBits = 0;
+	}
+
+	/** Return the stream position in bits. */
+	inline size_t pos() const {
+		return (_ptr - _data.get()) * 8 - _cacheBits;
+	}
+
+	/** Return the stream size in bits. */
+	inline size_t size() const {
+		return (_end - _data.get()) * 8;
+	}
+
+	/** Has the end of the stream been reached? */
+	inline bool eos() const {
+		return pos() >= size();
+	}
+
+	/** Are the bits handed out from MSB to LSB? */
+	inline bool isMSBFirst() const {
+		return isMSB2LSB;
+	}
+
+private:
+	DisposableArray<const byte> _data; ///< The input data.
+
+	const byte *_ptr; ///< The next value to load into the cache.
+	const byte *_end; ///< The end of the last whole value.
+
+	/** The upcoming bits. MSB-aligned when reading MSB first, LSB-aligned otherwise. */
+	uint64 _cache;
+	/** The number of valid bits in the cache. */
+	size_t _cacheBits;
+
+	void checkLayout() {
+		if ((valueBits != 8) && (valueBits != 16) && (valueBits != 32))
+			throw Exception("BitReader: Invalid memory layout %d, %d, %d", valueBits, isLE, isMSB2LSB);
+	}
+
+	void setData(size_t start, size_t size) {
+		const size_t valueBytes = valueBits / 8;
+
+		start = MIN(start, size);
+
+		_ptr = _data.get() + start;
+		_end = _data.get() + (size & ~(valueBytes - 1));
+
+		if (_ptr > _end)
+			_ptr = _end;
+
+		_cache     = 0;
+		_cacheBits = 0;
+	}
+
+	/** Read a single value. */
+	static inline uint64 readValue(const byte *data) {
+		if (valueBits == 8)
+			return *data;
+
+		if (valueBits == 16)
+			return isLE ? READ_LE_UINT16(data) : READ_BE_UINT16(data);
+
+		return isLE ? READ_LE_UINT32(data) : READ_BE_UINT32(data);
+	}
+
+	/** Read 64 bits worth of values, ordered the way they go into the cache. */
+	static inline uint64 readChunk(const byte *data) {
+		// Byte-wise, the bit order alone decides
+		if ((valueBits == 8) || (isLE != isMSB2LSB))
+			return isMSB2LSB ? READ_BE_UINT64(data) : READ_LE_UINT64(data);
+
+		uint64 chunk = 0;
+		for (int i = 0; i < (64 / valueBits); i++) {
+			const uint64 value = readValue(data + i * (valueBits / 8));
+
+			if (isMSB2LSB)
+				chunk |= value << (64 - (i + 1) * valueBits);
+			else
+				chunk |= value << (i * valueBits);
+		}
+
+		return chunk;
+	}
+
+	/** Load as many whole values into the cache as fit. */
+	inline void refill() {
+		if ((_end - _ptr) >= 8) {
+			// The bits beyond the whole values are loaded as well. But since they're
+			// the same bits the next refill will load again, that's harmless.
+
+			const uint64 chunk = readChunk(_ptr);
+
+			if (isMSB2LSB)
+				_cache |= chunk >> _cacheBits;
+			else
+				_cache |= chunk << _cacheBits;
+
+			const size_t values = (64 - _cacheBits) / valueBits;
+
+			_ptr       += values * (valueBits / 8);
+			_cacheBits += values * valueBits;
+			return;
+		}
+
+		// Close to the end, load value by value
+		while ((_cacheBits <= (size_t) (64 - valueBits)) && (_ptr < _end)) {
+			const uint64 value = readValue(_ptr);
+
+			if (isMSB2LSB)
+				_cache |= (value << (64 - valueBits)) >> _cacheBits;
+			else
+				_cache |= value << _cacheBits;
+
+			_ptr       += valueBits / 8;
+			_cacheBits += valueBits;
+		}
+	}
+
+	/** Make sure at least n bits are in the cache. */
+	inline void fill(size_t n) {
+		refill();
+
+		if (_cacheBits < n)
+			throw Exception("BitReader: End of bit stream reached");
+	}
+
+	/** Return the next n (1 to 32) bits in the cache. */
+	inline uint32 peekCache(size_t n) const {
+		if (isMSB2LSB)
+			return (uint32) (_cache >> (64 - n));
+
+		return (uint32) (_cache & (0xFFFFFFFFULL >> (32 - n)));
+	}
+
+	/** Remove the next n (less than 64) bits from the cache. */
+	inline void consume(size_t n) {
+		if (isMSB2LSB)
+			_cache <<= n;
+		else
+			_cache >>= n;
+
+		_cacheBits -= n;
+	}
+};
+
+// typedefs for various memory layouts.
+
+/** 8-bit data, MSB to LSB. */
+typedef BitReaderImpl<8, false, true > BitReader8MSB;
+/** 8-bit data, LSB to MSB. */
+typedef BitReaderImpl<8, false, false> BitReader8LSB;
+
+/** 16-bit little-endian data, MSB to LSB. */
+typedef BitReaderImpl<16, true , true > BitReader16LEMSB;
+/** 16-bit little-endian data, LSB to MSB. */
+typedef BitReaderImpl<16, true , false> BitReader16LELSB;
+/** 16-bit big-endian data, MSB to LSB. */
+typedef BitReaderImpl<16, false, true > BitReader16BEMSB;
+/** 16-bit big-endian data, LSB to MSB. */
+typedef BitReaderImpl<16, false, false> BitReader16BELSB;
+
+/** 32-bit little-endian data, MSB to LSB. */
+typedef BitReaderImpl<32, true , true > BitReader32LEMSB;
+/** 32-bit little-endian data, LSB to MSB. */
+typedef BitReaderImpl<32, true , false> BitReader32LELSB;
+/** 32-bit big-endian data, MSB to LSB. */
+typedef BitReaderImpl<32, false, true > BitReader32BEMSB;
+/** 32-bit big-endian data, LSB to MSB. */
+typedef BitReaderImpl<32, false, false> BitReader32BELSB;
+
+} // End of namespace Common
+
+#endif // COMMON_BITREADER_H
@@ -31,6 +31,7 @@
 
 #include "src/common/types.h"
 #include "src/common/disposableptr.h"
+#include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/readstream.h"
 
@@ -63,6 +64,15 @@ public:
 	/** Read a multi-bit value from the bit stream. */
 	virtual uint32 getBits(size_t n) = 0;
 
+	/** Read a multi-bit value from the bit stream, without consuming the bits.
+	 *
+	 *  Bits past the end of the stream are read as 0.
+	 */
+	virtual uint32 peekBits(size_t n) = 0;
+
+	/** Are the bits handed out from MSB to LSB? */
+	virtual bool isMSBFirst() const = 0;
+
 	/** Add a bit to the n-bit value x, making it an (n+1)-bit value. */
 	virtual void addBit(uint32 &x, size_t n) = 0;
 
@@ -198,6 +208,45 @@ public:
 		return v;
 	}
 
+	/** Read a multi-bit value from the bit stream, without consuming the bits. */
+	uint32 peekBits(size_t n) {
+		if (n == 0)
+			return 0;
+
+		if (n > 32)
+			throw Exception("Too many bits requested to be read");
+
+		// Start with what's left of the current value
+		size_t available = (_inValue == 0) ? 0 : (valueBits - _inValue);
+		uint64 bits      = (_inValue == 0) ? 0 : _value;
+
+		// Append whole values until we have enough. Bits past the end stay 0
+		const size_t streamPos = _stream->pos();
+		while ((available < n) && ((_stream->size() - _stream->pos()) >= (valueBits / 8))) {
+			const uint64 data = readData();
+
+			if (isMSB2LSB)
+				bits |= (data << (64 - valueBits)) >> available;
+			else
+				bits |= data << available;
+
+			available += valueBits;
+		}
+
+		if (_stream->pos() != streamPos)
+			_stream->seek(streamPos);
+
+		if (isMSB2LSB)
+			return (uint32) (bits >> (64 - n));
+
+		return (uint32) (bits & (0xFFFFFFFFULL >> (32 - n)));
+	}
+
+	/** Are the bits handed out from MSB to LSB? */
+	bool isMSBFirst() const {
+		return isMSB2LSB;
+	}
+
 	/** Add a bit to the n-bit value x, making it an (n+1)-bit value. */
 	void addBit(uint32 &x, size_t n) {
 		if (n >= 32)
@@ -219,8 +268,46 @@ public:
 
 	/** Skip the specified amount of bits. */
 	void skip(size_t n) {
-		while (n-- > 0)
-			getBit();
+		// Skip within the current value
+		if ((_inValue != 0) && (n < (size_t) (valueBits - _inValue))) {
+			if (isMSB2LSB)
+				_value <<= n;
+			else
+				_value >>= n;
+
+			_inValue += n;
+			return;
+		}
+
+		// Skip the rest of the current value
+		if (_inValue != 0) {
+			n -= valueBits - _inValue;
+
+			_value   = 0;
+			_inValue = 0;
+		}
+
+		// Skip whole values
+		const size_t values = n / valueBits;
+		if (values > 0) {
+			if ((size() - pos()) < (values * valueBits))
+				throw Exception("BitStream::skip(): End of bit stream reached");
+
+			_stream->skip(values * (valueBits / 8));
+			n -= values * valueBits;
+		}
+
+		// Skip into the next value
+		if (n > 0) {
+			readValue();
+
+			if (isMSB2LSB)
+				_value <<= n;
+			else
+				_value >>= n;
+
+			_inValue = n;
+		}
 	}
 
 	/** Return the stream position in bits. */
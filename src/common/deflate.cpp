@@ -22,13 +22,19 @@
  *  Compress (deflate) and decompress (inflate) using zlib's DEFLATE algorithm.
  */
 
+#include <cassert>
+#include <cstring>
+
 #include <zlib.h>
 
+#include <boost/noncopyable.hpp>
 #include <boost/scope_exit.hpp>
 
 #include "src/common/deflate.h"
+#include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/scopedptr.h"
+#include "src/common/ptrvector.h"
 #include "src/common/memreadstream.h"
 
 namespace Common {
@@ -93,4 +99,296 @@ SeekableReadStream *decompressDeflate(ReadStream &input, size_t inputSize,
 	return new MemoryReadStream(decompressedData, outputSize, true);
 }
 
+
+/** A stream inflating DEFLATE-compressed data on demand, while it is being read. */
+class InflateReadStream : boost::noncopyable, public SeekableReadStream {
+public:
+	InflateReadStream(SeekableReadStream *input, size_t outputSize, int windowBits);
+	~InflateReadStream();
+
+	size_t read(void *dataPtr, size_t dataSize);
+
+	bool eos() const;
+
+	size_t pos() const;
+	size_t size() const;
+
+	size_t seek(ptrdiff_t offset, Origin whence = kOriginBegin);
+
+private:
+	static const size_t kInputBufferSize  =  16 * 1024;
+	static const size_t kOutputBufferSize =  64 * 1024;
+
+	/** The minimum number of decompressed bytes between two checkpoints. */
+	static const size_t kCheckpointInterval = 1024 * 1024;
+	/** The maximum number of checkpoints, each of which costs about 40KB. */
+	static const size_t kCheckpointCountMax = 64;
+
+	/** A saved state of the decompressor, to restart decompressing from. */
+	struct Checkpoint : boost::noncopyable {
+		z_stream strm;
+
+		size_t inputPos;  ///< Position of the next compressed byte to decompress.
+		size_t outputPos; ///< Position of the next byte that will be decompressed.
+
+		Checkpoint(z_stream &source, size_t input, size_t output);
+		~Checkpoint();
+	};
+
+	ScopedPtr<SeekableReadStream> _input;
+
+	const size_t _size;
+
+	size_t _pos;
+	bool _eos;
+
+	z_stream _strm;
+
+	size_t _inputPos;  ///< Position of the compressed data after the input buffer.
+	size_t _outputPos; ///< Position of the next byte that will be decompressed.
+
+	ScopedArray<byte> _inputBuffer;
+
+	/** The most recently decompressed data, ending at _outputPos. */
+	ScopedArray<byte> _outputBuffer;
+	size_t _outputBufferSize;
+
+	PtrVector<Checkpoint> _checkpoints; ///< Sorted by position, starting at 0.
+	size_t _checkpointInterval;
+
+	/** Move the decompressor to the closest checkpoint before this position, if that helps. */
+	void restore(size_t position);
+
+	/** Decompress the next dataSize bytes into this buffer. */
+	void inflateInto(byte *data, size_t dataSize);
+	/** Decompress the next chunk of data into the output buffer. */
+	void inflateBuffer();
+	/** Remember the last bytes of data decompressed directly into a caller's buffer. */
+	void keepOutput(const byte *data, size_t dataSize);
+
+	void addCheckpoint();
+};
+
+InflateReadStream::Checkpoint::Checkpoint(z_stream &source, size_t input, size_t output) :
+	inputPos(input), outputPos(output) {
+
+	const int zResult = inflateCopy(&strm, &source);
+	if (zResult != Z_OK)
+		throw Exception("Could not copy zlib inflate state: %s (%d)", zError(zResult), zResult);
+}
+
+InflateReadStream::Checkpoint::~Checkpoint() {
+	inflateEnd(&strm);
+}
+
+InflateReadStream::InflateReadStream(SeekableReadStream *input, size_t outputSize, int windowBits) :
+	_input(input), _size(outputSize), _pos(0), _eos(false), _inputPos(0), _outputPos(0),
+	_inputBuffer(new byte[kInputBufferSize]), _outputBuffer(new byte[kOutputBufferSize]),
+	_outputBufferSize(0) {
+
+	assert(_input);
+
+	_checkpointInterval = MAX(kCheckpointInterval, _size / kCheckpointCountMax);
+
+	_strm.zalloc   = Z_NULL;
+	_strm.zfree    = Z_NULL;
+	_strm.opaque   = Z_NULL;
+	_strm.avail_in = 0;
+	_strm.next_in  = Z_NULL;
+
+	const int zResult = inflateInit2(&_strm, windowBits);
+	if (zResult != Z_OK)
+		throw Exception("Could not initialize zlib inflate: %s (%d)", zError(zResult), zResult);
+
+	// Checkpoint the initial state, so that we can always restart from the beginning
+	try {
+		addCheckpoint();
+	} catch (...) {
+		inflateEnd(&_strm);
+		throw;
+	}
+}
+
+InflateReadStream::~InflateReadStream() {
+	inflateEnd(&_strm);
+}
+
+size_t InflateReadStream::read(void *dataPtr, size_t dataSize) {
+	assert(dataPtr);
+
+	// Read at most as many bytes as are still available...
+	if (dataSize > _size - _pos) {
+		dataSize = _size - _pos;
+		_eos = true;
+	}
+
+	byte *data = reinterpret_cast<byte *>(dataPtr);
+	size_t left = dataSize;
+
+	while (left > 0) {
+		const size_t bufferStart = _outputPos - _outputBufferSize;
+
+		// Copy whatever we already have in the output buffer
+		if ((_pos >= bufferStart) && (_pos < _outputPos)) {
+			const size_t n = MIN(left, _outputPos - _pos);
+
+			std::memcpy(data, _outputBuffer.get() + (_pos - bufferStart), n);
+
+			data += n;
+			left -= n;
+			_pos += n;
+			continue;
+		}
+
+		restore(_pos);
+
+		// Decompress big reads directly into the caller's buffer
+		if ((_pos == _outputPos) && (left >= kOutputBufferSize)) {
+			inflateInto(data, left);
+			keepOutput(data, left);
+
+			data += left;
+			_pos += left;
+			left  = 0;
+			continue;
+		}
+
+		inflateBuffer();
+	}
+
+	return dataSize;
+}
+
+void InflateReadStream::restore(size_t position) {
+	// Find the last checkpoint before the position
+	size_t i = _checkpoints.size() - 1;
+	while ((i > 0) && (_checkpoints[i]->outputPos > position))
+		i--;
+
+	Checkpoint &checkpoint = *_checkpoints[i];
+
+	// If we're already past the checkpoint, just continue decompressing from here
+	if ((position >= _outputPos) && (checkpoint.outputPos <= _outputPos))
+		return;
+
+	inflateEnd(&_strm);
+
+	const int zResult = inflateCopy(&_strm, &checkpoint.strm);
+	if (zResult != Z_OK)
+		throw Exception("Could not copy zlib inflate state: %s (%d)", zError(zResult), zResult);
+
+	_strm.avail_in = 0;
+	_strm.next_in  = Z_NULL;
+
+	_inputPos  = checkpoint.inputPos;
+	_outputPos = checkpoint.outputPos;
+
+	_outputBufferSize = 0;
+}
+
+void InflateReadStream::inflateInto(byte *data, size_t dataSize) {
+	// The output buffer won't end at the decompression position anymore
+	_outputBufferSize = 0;
+
+	while (dataSize > 0) {
+		// Refill the input buffer
+		if (_strm.avail_in == 0) {
+			const size_t n = MIN<size_t>(kInputBufferSize, _input->size() - _inputPos);
+			if (n == 0)
+				throw Exception("Failed to inflate: premature end of input");
+
+			if (_input->readAt(_inputPos, _inputBuffer.get(), n) != n)
+				throw Exception(kReadError);
+
+			_inputPos += n;
+
+			_strm.avail_in = n;
+			_strm.next_in  = _inputBuffer.get();
+		}
+
+		// Decompress in chunks, so that we can regularly add checkpoints
+		const size_t chunkSize = MIN(dataSize, kOutputBufferSize);
+
+		_strm.avail_out = chunkSize;
+		_strm.next_out  = data;
+
+		const int zResult = inflate(&_strm, Z_NO_FLUSH);
+
+		const size_t n = chunkSize - _strm.avail_out;
+
+		data       += n;
+		dataSize   -= n;
+		_outputPos += n;
+
+		if (zResult == Z_STREAM_END) {
+			if (dataSize != 0)
+				throw Exception("Failed to inflate: output buffer not completely filled");
+
+			break;
+		}
+
+		if (zResult != Z_OK)
+			throw Exception("Failed to inflate: %s (%d)", zError(zResult), zResult);
+
+		if (_outputPos >= (_checkpoints.back()->outputPos + _checkpointInterval))
+			addCheckpoint();
+	}
+}
+
+void InflateReadStream::inflateBuffer() {
+	const size_t n = MIN(kOutputBufferSize, _size - _outputPos);
+	if (n == 0)
+		throw Exception(kReadError);
+
+	inflateInto(_outputBuffer.get(), n);
+
+	_outputBufferSize = n;
+}
+
+void InflateReadStream::keepOutput(const byte *data, size_t dataSize) {
+	const size_t n = MIN(dataSize, kOutputBufferSize);
+
+	std::memcpy(_outputBuffer.get(), data + dataSize - n, n);
+
+	_outputBufferSize = n;
+}
+
+void InflateReadStream::addCheckpoint() {
+	ScopedPtr<Checkpoint> checkpoint(new Checkpoint(_strm, _inputPos - _strm.avail_in, _outputPos));
+
+	_checkpoints.push_back(checkpoint.get());
+	checkpoint.release();
+}
+
+bool InflateReadStream::eos() const {
+	return _eos;
+}
+
+size_t InflateReadStream::pos() const {
+	return _pos;
+}
+
+size_t InflateReadStream::size() const {
+	return _size;
+}
+
+size_t InflateReadStream::seek(ptrdiff_t offset, Origin whence) {
+	const size_t oldPos = _pos;
+	const size_t newPos = evalSeek(offset, whence, _pos, 0, size());
+	if (newPos > _size)
+		throw Exception(kSeekError);
+
+	// Nothing is decompressed yet, that only happens once data is read
+	_pos = newPos;
+
+	// Reset end-of-stream flag on a successful seek
+	_eos = false;
+
+	return oldPos;
+}
+
+SeekableReadStream *decompressDeflateOnDemand(SeekableReadStream *input, size_t outputSize, int windowBits) {
+	return new InflateReadStream(input, outputSize, windowBits);
+}
+
 } // End of namespace Common
@@ -41,6 +41,12 @@ class SeekableReadStream;
 static const int kWindowBitsMax    =  15;
 static const int kWindowBitsMaxRaw = -kWindowBitsMax;
 
+/** Decompressed data of at least this size should rather be inflated on demand.
+ *
+ *  See decompressDeflateOnDemand().
+ */
+static const size_t kInflateOnDemandSize = 1024 * 1024;
+
 /** Decompress (inflate) using zlib's DEFLATE algorithm.
  *
  *  @param  data       The compressed input data.
@@ -73,6 +79,28 @@ byte *decompressDeflate(const byte *data, size_t inputSize,
 SeekableReadStream *decompressDeflate(ReadStream &input, size_t inputSize,
                                       size_t outputSize, int windowBits);
 
+/** Decompress (inflate) using zlib's DEFLATE algorithm, on demand.
+ *
+ *  Instead of decompressing all the data up front, the returned stream
+ *  inflates the data in chunks while it is being read. Only a small window
+ *  of the decompressed data is held in memory at any time.
+ *
+ *  Reading sequentially is fast. Seeking forward needs to decompress all
+ *  data up to the new position. While decompressing, the stream regularly
+ *  saves the state of the decompressor, so that seeking backwards only
+ *  needs to restart at the closest of these checkpoints, not at the very
+ *  beginning of the data.
+ *
+ *  @param  input      The compressed input data. The stream will take over
+ *                     this input stream and delete it when done.
+ *  @param  outputSize The size of the decompressed output data.
+ *  @param windowBits  The base two logarithm of the window size (the size of
+ *                     the history buffer). See the zlib documentation on
+ *                     inflateInit2() for details.
+ *  @return A stream of the decompressed data.
+ */
+SeekableReadStream *decompressDeflateOnDemand(SeekableReadStream *input, size_t outputSize, int windowBits);
+
 } // End of namespace Common
 
 #endif // COMMON_DEFLATE_H
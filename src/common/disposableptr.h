@@ -97,6 +97,9 @@ public:
 	 */
 	PointerType get() const { return _pointer; }
 
+	/** Return the disposable flag. */
+	bool isDisposable() const { return _dispose; }
+
 	/** Change the disposable flag. */
 	void setDisposable(bool d) { _dispose = d; }
 
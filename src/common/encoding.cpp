@@ -28,11 +28,14 @@
 #include <iconv.h>
 
 #include <vector>
+#include <string>
+#include <iterator>
 
 #include "src/common/encoding.h"
 #include "src/common/error.h"
 #include "src/common/scopedptr.h"
 #include "src/common/singleton.h"
+#include "src/common/mutex.h"
 #include "src/common/ustring.h"
 #include "src/common/memreadstream.h"
 #include "src/common/writestream.h"
@@ -87,6 +90,8 @@ public:
 		if (((size_t) encoding) >= kEncodingMAX)
 			throw Exception("Invalid encoding %d", encoding);
 
+		StackLock lock(_mutex);
+
 		return convert(_contextFrom[encoding], data, n, kEncodingGrowthFrom[encoding], 1);
 	}
 
@@ -94,6 +99,8 @@ public:
 		if (((size_t) encoding) >= kEncodingMAX)
 			throw Exception("Invalid encoding %d", encoding);
 
+		StackLock lock(_mutex);
+
 		return convert(_contextTo[encoding], str, kEncodingGrowthTo[encoding],
 		               terminate ? kTerminatorLength[encoding] : 0);
 	}
@@ -102,6 +109,9 @@ private:
 	iconv_t _contextFrom[kEncodingMAX];
 	iconv_t _contextTo  [kEncodingMAX];
 
+	/** The iconv contexts keep state, so only one conversion can run at a time. */
+	Mutex _mutex;
+
 	byte *doConvert(iconv_t &ctx, byte *data, size_t nIn, size_t nOut, size_t &size) {
 		size_t inBytes  = nIn;
 		size_t outBytes = nOut;
@@ -169,6 +179,193 @@ DECLARE_SINGLETON(Common::ConversionManager)
 
 namespace Common {
 
+/* Tables mapping the upper half (0x80-0xFF) of the single-byte encodings
+ * onto Unicode codepoints. 0 marks a byte that's undefined in the codepage. */
+
+static const uint16 kLatin9High[128] = {
+	0x0080, 0x0081, 0x0082, 0x0083, 0x0084, 0x0085, 0x0086, 0x0087,
+	0x0088, 0x0089, 0x008A, 0x008B, 0x008C, 0x008D, 0x008E, 0x008F,
+	0x0090, 0x0091, 0x0092, 0x0093, 0x0094, 0x0095, 0x0096, 0x0097,
+	0x0098, 0x0099, 0x009A, 0x009B, 0x009C, 0x009D, 0x009E, 0x009F,
+	0x00A0, 0x00A1, 0x00A2, 0x00A3, 0x20AC, 0x00A5, 0x0160, 0x00A7,
+	0x0161, 0x00A9, 0x00AA, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x00AF,
+	0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x017D, 0x00B5, 0x00B6, 0x00B7,
+	0x017E, 0x00B9, 0x00BA, 0x00BB, 0x0152, 0x0153, 0x0178, 0x00BF,
+	0x00C0, 0x00C1, 0x00C2, 0x00C3, 0x00C4, 0x00C5, 0x00C6, 0x00C7,
+	0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF,
+	0x00D0, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x00D5, 0x00D6, 0x00D7,
+	0x00D8, 0x00D9, 0x00DA, 0x00DB, 0x00DC, 0x00DD, 0x00DE, 0x00DF,
+	0x00E0, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x00E7,
+	0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF,
+	0x00F0, 0x00F1, 0x00F2, 0x00F3, 0x00F4, 0x00F5, 0x00F6, 0x00F7,
+	0x00F8, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x00FD, 0x00FE, 0x00FF
+};
+
+static const uint16 kCP1250High[128] = {
+	0x20AC, 0x0000, 0x201A, 0x0000, 0x201E, 0x2026, 0x2020, 0x2021,
+	0x0000, 0x2030, 0x0160, 0x2039, 0x015A, 0x0164, 0x017D, 0x0179,
+	0x0000, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+	0x0000, 0x2122, 0x0161, 0x203A, 0x015B, 0x0165, 0x017E, 0x017A,
+	0x00A0, 0x02C7, 0x02D8, 0x0141, 0x00A4, 0x0104, 0x00A6, 0x00A7,
+	0x00A8, 0x00A9, 0x015E, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x017B,
+	0x00B0, 0x00B1, 0x02DB, 0x0142, 0x00B4, 0x00B5, 0x00B6, 0x00B7,
+	0x00B8, 0x0105, 0x015F, 0x00BB, 0x013D, 0x02DD, 0x013E, 0x017C,
+	0x0154, 0x00C1, 0x00C2, 0x0102, 0x00C4, 0x0139, 0x0106, 0x00C7,
+	0x010C, 0x00C9, 0x0118, 0x00CB, 0x011A, 0x00CD, 0x00CE, 0x010E,
+	0x0110, 0x0143, 0x0147, 0x00D3, 0x00D4, 0x0150, 0x00D6, 0x00D7,
+	0x0158, 0x016E, 0x00DA, 0x0170, 0x00DC, 0x00DD, 0x0162, 0x00DF,
+	0x0155, 0x00E1, 0x00E2, 0x0103, 0x00E4, 0x013A, 0x0107, 0x00E7,
+	0x010D, 0x00E9, 0x0119, 0x00EB, 0x011B, 0x00ED, 0x00EE, 0x010F,
+	0x0111, 0x0144, 0x0148, 0x00F3, 0x00F4, 0x0151, 0x00F6, 0x00F7,
+	0x0159, 0x016F, 0x00FA, 0x0171, 0x00FC, 0x00FD, 0x0163, 0x02D9
+};
+
+static const uint16 kCP1251High[128] = {
+	0x0402, 0x0403, 0x201A, 0x0453, 0x201E, 0x2026, 0x2020, 0x2021,
+	0x20AC, 0x2030, 0x0409, 0x2039, 0x040A, 0x040C, 0x040B, 0x040F,
+	0x0452, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+	0x0000, 0x2122, 0x0459, 0x203A, 0x045A, 0x045C, 0x045B, 0x045F,
+	0x00A0, 0x040E, 0x045E, 0x0408, 0x00A4, 0x0490, 0x00A6, 0x00A7,
+	0x0401, 0x00A9, 0x0404, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x0407,
+	0x00B0, 0x00B1, 0x0406, 0x0456, 0x0491, 0x00B5, 0x00B6, 0x00B7,
+	0x0451, 0x2116, 0x0454, 0x00BB, 0x0458, 0x0405, 0x0455, 0x0457,
+	0x0410, 0x0411, 0x0412, 0x0413, 0x0414, 0x0415, 0x0416, 0x0417,
+	0x0418, 0x0419, 0x041A, 0x041B, 0x041C, 0x041D, 0x041E, 0x041F,
+	0x0420, 0x0421, 0x0422, 0x0423, 0x0424, 0x0425, 0x0426, 0x0427,
+	0x0428, 0x0429, 0x042A, 0x042B, 0x042C, 0x042D, 0x042E, 0x042F,
+	0x0430, 0x0431, 0x0432, 0x0433, 0x0434, 0x0435, 0x0436, 0x0437,
+	0x0438, 0x0439, 0x043A, 0x043B, 0x043C, 0x043D, 0x043E, 0x043F,
+	0x0440, 0x0441, 0x0442, 0x0443, 0x0444, 0x0445, 0x0446, 0x0447,
+	0x0448, 0x0449, 0x044A, 0x044B, 0x044C, 0x044D, 0x044E, 0x044F
+};
+
+static const uint16 kCP1252High[128] = {
+	0x20AC, 0x0000, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+	0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x0000, 0x017D, 0x0000,
+	0x0000, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+	0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x0000, 0x017E, 0x0178,
+	0x00A0, 0x00A1, 0x00A2, 0x00A3, 0x00A4, 0x00A5, 0x00A6, 0x00A7,
+	0x00A8, 0x00A9, 0x00AA, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x00AF,
+	0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x00B4, 0x00B5, 0x00B6, 0x00B7,
+	0x00B8, 0x00B9, 0x00BA, 0x00BB, 0x00BC, 0x00BD, 0x00BE, 0x00BF,
+	0x00C0, 0x00C1, 0x00C2, 0x00C3, 0x00C4, 0x00C5, 0x00C6, 0x00C7,
+	0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF,
+	0x00D0, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x00D5, 0x00D6, 0x00D7,
+	0x00D8, 0x00D9, 0x00DA, 0x00DB, 0x00DC, 0x00DD, 0x00DE, 0x00DF,
+	0x00E0, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x00E7,
+	0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF,
+	0x00F0, 0x00F1, 0x00F2, 0x00F3, 0x00F4, 0x00F5, 0x00F6, 0x00F7,
+	0x00F8, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x00FD, 0x00FE, 0x00FF
+};
+
+/** Return the table for the upper half of a single-byte encoding, or 0 if there is none. */
+static const uint16 *getSingleByteTable(Encoding encoding) {
+	switch (encoding) {
+		case kEncodingLatin9:
+			return kLatin9High;
+
+		case kEncodingCP1250:
+			return kCP1250High;
+
+		case kEncodingCP1251:
+			return kCP1251High;
+
+		case kEncodingCP1252:
+			return kCP1252High;
+
+		default:
+			break;
+	}
+
+	return 0;
+}
+
+/** Decode a single-byte encoding into UTF-8, without going through iconv.
+ *
+ *  Like the iconv conversion, the result ends at the first \0. If the data
+ *  contains a byte undefined in the codepage, false is returned so that the
+ *  caller can fall back onto iconv and its error handling.
+ */
+static bool decodeSingleByte(const uint16 *high, const byte *data, size_t n, UString &str) {
+	const byte *end = data + n;
+
+	std::string utf8;
+	utf8.reserve(n + 8);
+
+	for (; data < end; data++) {
+		// Copy runs of ASCII characters in one go
+		const byte *run = data;
+		while ((data < end) && (*data < 0x80) && (*data != 0))
+			data++;
+
+		utf8.append(reinterpret_cast<const char *>(run), data - run);
+		if ((data == end) || (*data == 0))
+			break;
+
+		const uint16 c = high[*data - 0x80];
+		if (c == 0)
+			return false;
+
+		utf8::unchecked::append(c, std::back_inserter(utf8));
+	}
+
+	// Everything after the terminator still has to be valid
+	for (; data < end; data++)
+		if ((*data >= 0x80) && (high[*data - 0x80] == 0))
+			return false;
+
+	str = utf8;
+	return true;
+}
+
+/** Decode UTF-16 into UTF-8, without going through iconv.
+ *
+ *  Like the iconv conversion, the result ends at the first \0. On a dangling
+ *  byte or a broken surrogate pair, false is returned so that the caller can
+ *  fall back onto iconv and its error handling.
+ */
+static bool decodeUTF16(const byte *data, size_t n, bool bigEndian, UString &str) {
+	if ((n % 2) != 0)
+		return false;
+
+	std::string utf8;
+	utf8.reserve(n + 8);
+
+	bool terminated = false;
+	for (size_t i = 0; i < n; i += 2) {
+		uint32 c = bigEndian ? READ_BE_UINT16(data + i) : READ_LE_UINT16(data + i);
+
+		if ((c >= 0xDC00) && (c <= 0xDFFF))
+			return false;
+
+		if ((c >= 0xD800) && (c <= 0xDBFF)) {
+			if ((i + 2) >= n)
+				return false;
+
+			const uint32 low = bigEndian ? READ_BE_UINT16(data + i + 2) : READ_LE_UINT16(data + i + 2);
+			if ((low < 0xDC00) || (low > 0xDFFF))
+				return false;
+
+			c  = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+			i += 2;
+		}
+
+		if (c == 0)
+			terminated = true;
+
+		if (terminated)
+			continue;
+
+		if (c < 0x80)
+			utf8 += (char) c;
+		else
+			utf8::unchecked::append(c, std::back_inserter(utf8));
+	}
+
+	str = utf8;
+	return true;
+}
+
 static uint32 readFakeChar(SeekableReadStream &stream, Encoding encoding) {
 	byte data[2];
 
@@ -242,17 +439,40 @@ static void writeFakeChar(std::vector<byte> &output, uint32 c, Encoding encoding
 }
 
 static UString createString(std::vector<byte> &output, Encoding encoding) {
+	UString str;
+
 	switch (encoding) {
 		case kEncodingASCII:
 		case kEncodingUTF8:
 			output.push_back('\0');
 			return UString(reinterpret_cast<const char *>(&output[0]));
 
+		case kEncodingLatin9:
+		case kEncodingCP1250:
+		case kEncodingCP1251:
+		case kEncodingCP1252:
+			if (output.empty())
+				return "";
+
+			if (decodeSingleByte(getSingleByteTable(encoding), &output[0], output.size(), str))
+				return str;
+			break;
+
+		case kEncodingUTF16LE:
+		case kEncodingUTF16BE:
+			if (output.empty())
+				return "";
+
+			if (decodeUTF16(&output[0], output.size(), encoding == kEncodingUTF16BE, str))
+				return str;
+			break;
+
 		default:
-			return ConvMan.convert(encoding, &output[0], output.size());
+			break;
 	}
 
-	return "";
+	// Multi-byte encodings and broken data go through iconv
+	return ConvMan.convert(encoding, &output[0], output.size());
 }
 
 UString readString(SeekableReadStream &stream, Encoding encoding) {
@@ -22,6 +22,7 @@
  *  Utility class for manipulating file paths.
  */
 
+#include <ctime>
 #include <list>
 
 #include <boost/algorithm/string.hpp>
@@ -40,6 +41,7 @@ using boost::filesystem::exists;
 using boost::filesystem::is_regular_file;
 using boost::filesystem::is_directory;
 using boost::filesystem::file_size;
+using boost::filesystem::last_write_time;
 using boost::filesystem::directory_iterator;
 using boost::filesystem::create_directories;
 
@@ -78,6 +80,17 @@ size_t FilePath::getFileSize(const UString &p) {
 	return size;
 }
 
+uint64 FilePath::getModificationTime(const UString &p) {
+	try {
+		const std::time_t t = last_write_time(p.c_str());
+		if (t > 0)
+			return (uint64) t;
+	} catch (...) {
+	}
+
+	return 0;
+}
+
 UString FilePath::getFile(const UString &p) {
 	path file(p.c_str());
 
@@ -345,6 +358,35 @@ bool FilePath::createDirectories(const UString &path) {
 	}
 }
 
+UString FilePath::getUniquePath(const UString &p) {
+	try {
+		UString unique;
+		do {
+			unique = boost::filesystem::unique_path((p + ".%%%%-%%%%-%%%%").c_str()).generic_string();
+		} while (exists(unique.c_str()));
+
+		return unique;
+	} catch (std::exception &se) {
+		throw Exception(se);
+	}
+}
+
+void FilePath::renameFile(const UString &oldPath, const UString &newPath) {
+	try {
+		boost::filesystem::rename(oldPath.c_str(), newPath.c_str());
+	} catch (std::exception &se) {
+		throw Exception(se);
+	}
+}
+
+bool FilePath::removeFile(const UString &p) {
+	try {
+		return boost::filesystem::remove(p.c_str());
+	} catch (...) {
+		return false;
+	}
+}
+
 UString FilePath::escapeStringLiteral(const UString &str) {
 	const boost::regex esc("[\\^\\.\\$\\|\\(\\)\\[\\]\\*\\+\\?\\/\\\\]");
 	const std::string  rep("\\\\\\1&");
@@ -58,6 +58,13 @@ public:
 	 */
 	static size_t getFileSize(const UString &p);
 
+	/** Return the time a file was last modified.
+	 *
+	 *  @param  p The file to look up.
+	 *  @return The modification time in seconds since the epoch, or 0 if not a valid file.
+	 */
+	static uint64 getModificationTime(const UString &p);
+
 	/** Return a file name without its path.
 	 *
 	 *  Example: "/path/to/file.ext" > "file.ext"
@@ -201,6 +208,26 @@ public:
 	 */
 	static bool createDirectories(const UString &path);
 
+	/** Return a path to a file in the same directory as this one, that doesn't exist yet.
+	 *
+	 *  The path is made unique by appending random characters to it. This
+	 *  is useful for writing a file under a temporary name first.
+	 */
+	static UString getUniquePath(const UString &p);
+
+	/** Rename a file, replacing any file already found under the new name.
+	 *
+	 *  On most systems, the old file is replaced in one step: anyone opening
+	 *  the file sees either the old or the new one, never something in between.
+	 */
+	static void renameFile(const UString &oldPath, const UString &newPath);
+
+	/** Remove a file.
+	 *
+	 *  @return true if the file existed and was removed.
+	 */
+	static bool removeFile(const UString &p);
+
 	/** Escape a string literal for use in a regexp. */
 	static UString escapeStringLiteral(const UString &str);
 
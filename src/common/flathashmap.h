@@ -0,0 +1,300 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  An open-addressing hash map, keyed by 64-bit hashes.
+ */
+
+#ifndef COMMON_FLATHASHMAP_H
+#define COMMON_FLATHASHMAP_H
+
+#include <cassert>
+
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+
+#include "src/common/types.h"
+
+namespace Common {
+
+/** A hash map with open addressing and linear probing, for keys that already
+ *  are (good) 64-bit hash values, like the hashed resource names.
+ *
+ *  All entries live in one contiguous array, so a lookup usually only touches
+ *  a single cache line, instead of walking a tree of separately allocated nodes.
+ *
+ *  Unlike a std::map, the entries are not sorted, and any insertion or erasure
+ *  invalidates all iterators and references into the map. Values are moved
+ *  around with swap(), which should be cheap for the value type.
+ */
+template<typename T>
+class FlatHashMap {
+public:
+	typedef uint64 key_type;
+	typedef T mapped_type;
+	typedef std::pair<uint64, T> value_type;
+
+private:
+	struct Slot {
+		value_type value;
+		bool used;
+
+		Slot() : used(false) { }
+	};
+
+	typedef std::vector<Slot> SlotArray;
+
+	template<typename SlotIterator, typename Reference, typename Pointer>
+	class Iterator {
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef typename FlatHashMap::value_type value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef Pointer pointer;
+		typedef Reference reference;
+
+		Iterator() { }
+		Iterator(SlotIterator slot, SlotIterator end) : _slot(slot), _end(end) {
+			skipUnused();
+		}
+
+		template<typename S, typename R, typename P>
+		Iterator(const Iterator<S, R, P> &it) : _slot(it._slot), _end(it._end) { }
+
+		reference operator*() const { return _slot->value; }
+		pointer operator->() const { return &_slot->value; }
+
+		Iterator &operator++() {
+			++_slot;
+			skipUnused();
+			return *this;
+		}
+
+		Iterator operator++(int) {
+			Iterator it(*this);
+			++*this;
+			return it;
+		}
+
+		template<typename S, typename R, typename P>
+		bool operator==(const Iterator<S, R, P> &it) const { return _slot == it._slot; }
+		template<typename S, typename R, typename P>
+		bool operator!=(const Iterator<S, R, P> &it) const { return _slot != it._slot; }
+
+	private:
+		SlotIterator _slot;
+		SlotIterator _end;
+
+		void skipUnused() {
+			while ((_slot != _end) && !_slot->used)
+				++_slot;
+		}
+
+		template<typename S, typename R, typename P>
+		friend class Iterator;
+		friend class FlatHashMap;
+	};
+
+public:
+	typedef Iterator<typename SlotArray::iterator, value_type &, value_type *> iterator;
+	typedef Iterator<typename SlotArray::const_iterator, const value_type &, const value_type *> const_iterator;
+
+	FlatHashMap() : _size(0), _shift(64) {
+	}
+
+	iterator begin() { return iterator(_slots.begin(), _slots.end()); }
+	iterator end() { return iterator(_slots.end(), _slots.end()); }
+	const_iterator begin() const { return const_iterator(_slots.begin(), _slots.end()); }
+	const_iterator end() const { return const_iterator(_slots.end(), _slots.end()); }
+
+	bool empty() const { return _size == 0; }
+	size_t size() const { return _size; }
+
+	void clear() {
+		SlotArray().swap(_slots);
+
+		_size  = 0;
+		_shift = 64;
+	}
+
+	/** Make room for this many entries without the need to grow the map. */
+	void reserve(size_t count) {
+		size_t capacity = 16;
+		while (!fits(count, capacity))
+			capacity *= 2;
+
+		if (capacity > _slots.size())
+			rehash(capacity);
+	}
+
+	iterator find(uint64 key) {
+		const size_t slot = findSlot(key);
+		if (slot == kSlotNone)
+			return end();
+
+		return iterator(_slots.begin() + slot, _slots.end());
+	}
+
+	const_iterator find(uint64 key) const {
+		const size_t slot = findSlot(key);
+		if (slot == kSlotNone)
+			return end();
+
+		return const_iterator(_slots.begin() + slot, _slots.end());
+	}
+
+	/** Insert a value, unless there is already one with that key. */
+	std::pair<iterator, bool> insert(const value_type &value) {
+		size_t slot = findSlot(value.first);
+		if (slot != kSlotNone)
+			return std::make_pair(iterator(_slots.begin() + slot, _slots.end()), false);
+
+		if (!fits(_size + 1, _slots.size()))
+			rehash(std::max<size_t>(16, _slots.size() * 2));
+
+		slot = findFreeSlot(value.first);
+
+		_slots[slot].value = value;
+		_slots[slot].used  = true;
+		_size++;
+
+		return std::make_pair(iterator(_slots.begin() + slot, _slots.end()), true);
+	}
+
+	T &operator[](uint64 key) {
+		return insert(value_type(key, T())).first->second;
+	}
+
+	size_t erase(uint64 key) {
+		const size_t slot = findSlot(key);
+		if (slot == kSlotNone)
+			return 0;
+
+		eraseSlot(slot);
+		return 1;
+	}
+
+	void erase(iterator position) {
+		assert(position._slot != _slots.end());
+
+		eraseSlot(position._slot - _slots.begin());
+	}
+
+	void swap(FlatHashMap &map) {
+		_slots.swap(map._slots);
+
+		std::swap(_size , map._size);
+		std::swap(_shift, map._shift);
+	}
+
+private:
+	static const size_t kSlotNone = SIZE_MAX;
+
+	SlotArray _slots;
+
+	size_t _size;  ///< Number of used slots.
+	uint   _shift; ///< 64 - log2(number of slots).
+
+	/** Keep the load factor below 3/4. */
+	static bool fits(size_t count, size_t capacity) {
+		return (count * 4) <= (capacity * 3);
+	}
+
+	/** Fibonacci hashing, to spread badly distributed keys over all slots. */
+	size_t getIdealSlot(uint64 key) const {
+		return (size_t) ((key * UINT64_C(0x9E3779B97F4A7C15)) >> _shift);
+	}
+
+	size_t findSlot(uint64 key) const {
+		if (_slots.empty())
+			return kSlotNone;
+
+		const size_t mask = _slots.size() - 1;
+		for (size_t slot = getIdealSlot(key); _slots[slot].used; slot = (slot + 1) & mask)
+			if (_slots[slot].value.first == key)
+				return slot;
+
+		return kSlotNone;
+	}
+
+	size_t findFreeSlot(uint64 key) const {
+		const size_t mask = _slots.size() - 1;
+
+		size_t slot = getIdealSlot(key);
+		while (_slots[slot].used)
+			slot = (slot + 1) & mask;
+
+		return slot;
+	}
+
+	void rehash(size_t capacity) {
+		assert((capacity & (capacity - 1)) == 0);
+
+		SlotArray oldSlots(capacity);
+		_slots.swap(oldSlots);
+
+		_shift = 64;
+		while (capacity > 1) {
+			capacity >>= 1;
+			_shift--;
+		}
+
+		for (typename SlotArray::iterator s = oldSlots.begin(); s != oldSlots.end(); ++s) {
+			if (!s->used)
+				continue;
+
+			Slot &slot = _slots[findFreeSlot(s->value.first)];
+
+			slot.value.first = s->value.first;
+			std::swap(slot.value.second, s->value.second);
+			slot.used = true;
+		}
+	}
+
+	/** Erase a slot, moving following entries back so that no probe chain is broken. */
+	void eraseSlot(size_t slot) {
+		const size_t mask = _slots.size() - 1;
+
+		size_t next = (slot + 1) & mask;
+		while (_slots[next].used) {
+			const size_t ideal = getIdealSlot(_slots[next].value.first);
+
+			// Can the next entry be moved into the hole without leaving its probe chain?
+			if (((next - ideal) & mask) >= ((next - slot) & mask)) {
+				_slots[slot].value.first = _slots[next].value.first;
+				std::swap(_slots[slot].value.second, _slots[next].value.second);
+
+				slot = next;
+			}
+
+			next = (next + 1) & mask;
+		}
+
+		_slots[slot].value.second = T();
+		_slots[slot].used = false;
+		_size--;
+	}
+};
+
+} // End of namespace Common
+
+#endif // COMMON_FLATHASHMAP_H
@@ -24,14 +24,17 @@
 
 #include <cassert>
 
+#include <map>
+
 #include "src/common/huffman.h"
 #include "src/common/util.h"
-#include "src/common/error.h"
-#include "src/common/bitstream.h"
 
 namespace Common {
 
-Huffman::Symbol::Symbol(uint32 c, uint32 s) : code(c), symbol(s) {
+Huffman::TableEntry::TableEntry() : value(0), length(0) {
+}
+
+Huffman::Code::Code(uint32 c, uint8 l, uint32 i) : code(c), length(l), index(i) {
 }
 
 
@@ -59,19 +62,22 @@ void Huffman::init(uint8 maxLength, size_t codeCount, const uint32 *codes,
 
 	assert(maxLength <= 32);
 
-	_codes.resize(maxLength);
 	_symbols.resize(codeCount);
+	setSymbols(symbols);
 
-	for (size_t i = 0; i < codeCount; i++) {
-		// The symbol. If none were specified, just assume it's identical to the code index
-		uint32 symbol = symbols ? symbols[i] : i;
+	// Sort the codes by length, keeping the original order within a length.
+	// When codes collide, the shortest and then the first one wins.
+	// Codes with bits set beyond their length can never match.
+	CodeList sorted;
+	sorted.reserve(codeCount);
 
-		// Put the code and symbol into the correct list
-		_codes[lengths[i] - 1].push_back(Symbol(codes[i], symbol));
+	for (uint8 length = 1; length <= maxLength; length++)
+		for (size_t i = 0; i < codeCount; i++)
+			if ((lengths[i] == length) && ((length == 32) || ((codes[i] >> length) == 0)))
+				sorted.push_back(Code(codes[i], length, i));
 
-		// And put the pointer to the symbol/code struct into the symbol list.
-		_symbols[i] = &_codes[lengths[i] - 1].back();
-	}
+	buildTable(_tableMSB2LSB, sorted, true , _tableBits);
+	buildTable(_tableLSB2MSB, sorted, false, _tableBits);
 }
 
 Huffman::~Huffman() {
@@ -79,21 +85,73 @@ Huffman::~Huffman() {
 
 void Huffman::setSymbols(const uint32 *symbols) {
 	for (size_t i = 0; i < _symbols.size(); i++)
-		_symbols[i]->symbol = symbols ? *symbols++ : i;
+		_symbols[i] = symbols ? *symbols++ : i;
 }
 
-uint32 Huffman::getSymbol(BitStream &bits) const {
-	uint32 code = 0;
+uint32 Huffman::buildTable(Table &table, const CodeList &codes, bool isMSB2LSB, uint8 &tableBits) {
+	uint8 maxLength = 0;
+	for (CodeList::const_iterator c = codes.begin(); c != codes.end(); ++c)
+		maxLength = MAX(maxLength, c->length);
+
+	tableBits = MIN(maxLength, kTableBits);
+
+	const uint32 offset = table.size();
+	table.resize(offset + (1 << tableBits));
+
+	// Codes fitting into this table fill all entries starting with them
+
+	for (CodeList::const_iterator c = codes.begin(); c != codes.end(); ++c) {
+		if (c->length > tableBits)
+			continue;
+
+		const uint32 fillBits = tableBits - c->length;
+		for (uint32 i = 0; i < (1U << fillBits); i++) {
+			const uint32 entry = isMSB2LSB ? ((c->code << fillBits) | i) : (c->code | (i << c->length));
+
+			if (table[offset + entry].length != 0)
+				continue;
+
+			table[offset + entry].value  = c->index;
+			table[offset + entry].length = c->length;
+		}
+	}
+
+	// Longer codes go into sub tables, one for each prefix
+
+	typedef std::map<uint32, CodeList> SubCodes;
+	SubCodes subCodes;
+
+	for (CodeList::const_iterator c = codes.begin(); c != codes.end(); ++c) {
+		if (c->length <= tableBits)
+			continue;
+
+		const uint8 restLength = c->length - tableBits;
+
+		uint32 prefix, rest;
+		if (isMSB2LSB) {
+			prefix = c->code >> restLength;
+			rest   = c->code & (0xFFFFFFFF >> (32 - restLength));
+		} else {
+			prefix = c->code & ((1U << tableBits) - 1);
+			rest   = c->code >> tableBits;
+		}
+
+		// A shorter code already claimed this prefix
+		if (table[offset + prefix].length != 0)
+			continue;
+
+		subCodes[prefix].push_back(Code(rest, restLength, c->index));
+	}
 
-	for (size_t i = 0; i < _codes.size(); i++) {
-		bits.addBit(code, i);
+	for (SubCodes::const_iterator s = subCodes.begin(); s != subCodes.end(); ++s) {
+		uint8 subBits;
+		const uint32 subOffset = buildTable(table, s->second, isMSB2LSB, subBits);
 
-		for (CodeList::const_iterator cCode = _codes[i].begin(); cCode != _codes[i].end(); ++cCode)
-			if (code == cCode->code)
-				return cCode->symbol;
+		table[offset + s->first].value  = subOffset;
+		table[offset + s->first].length = -((int8) subBits);
 	}
 
-	throw Exception("Unknown Huffman code");
+	return offset;
 }
 
 } // End of namespace Common
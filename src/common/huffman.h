@@ -26,14 +26,12 @@
 #define COMMON_HUFFMAN_H
 
 #include <vector>
-#include <list>
 
 #include "src/common/types.h"
+#include "src/common/error.h"
 
 namespace Common {
 
-class BitStream;
-
 struct HuffmanTable {
 	uint8  maxLength; ///< Maximal code length. If 0, it's searched for.
 	size_t codeCount; ///< Number of codes.
@@ -43,7 +41,14 @@ struct HuffmanTable {
 	const uint32 *symbols; ///< The symbols, 0 if identical to the codes.
 };
 
-/** Decode a Huffman'd bitstream. */
+/** Decode a Huffman'd bitstream.
+ *
+ *  The codes are resolved through multi-level lookup tables: the decoder
+ *  peeks at the next few bits, and a single table hit yields either the
+ *  symbol and the length of its code, or a sub table for the longer codes
+ *  sharing that prefix. Since the table layout depends on the order the
+ *  bits are read in, a table for each order is built.
+ */
 class Huffman {
 public:
 	/** Construct a Huffman decoder.
@@ -62,29 +67,74 @@ public:
 	/** Modify the codes' symbols. */
 	void setSymbols(const uint32 *symbols = 0);
 
-	/** Return the next symbol in the bitstream. */
-	uint32 getSymbol(BitStream &bits) const;
+	/** Return the next symbol in the bitstream.
+	 *
+	 *  Works on both a BitStream and a BitReaderImpl.
+	 */
+	template<class BitReader>
+	uint32 getSymbol(BitReader &bits) const {
+		const Table &table = bits.isMSBFirst() ? _tableMSB2LSB : _tableLSB2MSB;
+
+		size_t tableBits = _tableBits;
+		const TableEntry *entry = &table[bits.peekBits(tableBits)];
+
+		while (entry->length < 0) {
+			bits.skip(tableBits);
+
+			tableBits = -entry->length;
+			entry     = &table[entry->value + bits.peekBits(tableBits)];
+		}
+
+		if (entry->length == 0)
+			throw Exception("Unknown Huffman code");
+
+		bits.skip(entry->length);
+
+		return _symbols[entry->value];
+	}
 
 private:
-	struct Symbol {
-		uint32 code;
-		uint32 symbol;
+	/** The number of bits a lookup table resolves at most. */
+	static const uint8 kTableBits = 9;
+
+	/** An entry in a lookup table. */
+	struct TableEntry {
+		/** The index of the code, or the offset of the sub table. */
+		uint32 value;
+		/** The code bits to consume, negative bits of the sub table, or 0 for an invalid code. */
+		int8 length;
+
+		TableEntry();
+	};
+
+	/** A code, as seen from the current table level. */
+	struct Code {
+		uint32 code;   ///< The remaining bits of the code.
+		uint8  length; ///< The number of remaining bits.
+		uint32 index;  ///< The index of the code.
 
-		Symbol(uint32 c, uint32 s);
+		Code(uint32 c, uint8 l, uint32 i);
 	};
 
-	typedef std::list<Symbol>     CodeList;
-	typedef std::vector<CodeList> CodeLists;
-	typedef std::vector<Symbol *> SymbolList;
+	typedef std::vector<TableEntry> Table;
+	typedef std::vector<Code>       CodeList;
 
-	/** Lists of codes and their symbols, sorted by code length. */
-	CodeLists _codes;
+	/** The symbols, indexed by the code index. */
+	std::vector<uint32> _symbols;
 
-	/** Sorted list of pointers to the symbols. */
-	SymbolList _symbols;
+	/** The lookup tables for bits read from MSB to LSB. */
+	Table _tableMSB2LSB;
+	/** The lookup tables for bits read from LSB to MSB. */
+	Table _tableLSB2MSB;
+
+	/** The number of bits the first-level table resolves. */
+	uint8 _tableBits;
 
 	void init(uint8 maxLength, size_t codeCount, const uint32 *codes,
 	          const uint8 *lengths, const uint32 *symbols);
+
+	/** Append a lookup table for these codes, plus its sub tables, and return its offset. */
+	static uint32 buildTable(Table &table, const CodeList &codes, bool isMSB2LSB, uint8 &tableBits);
 };
 
 } // End of namespace Common
@@ -0,0 +1,414 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A process-wide pool of worker threads running small jobs.
+ */
+
+#include <cassert>
+
+#include <algorithm>
+
+#include <SDL_cpuinfo.h>
+#include <SDL_thread.h>
+#include <SDL_timer.h>
+
+#include "src/common/jobs.h"
+#include "src/common/thread.h"
+
+DECLARE_SINGLETON(Common::JobManager)
+
+namespace Common {
+
+Job::Job() : _state(kStateIdle), _blockers(1), _dependentsLock(false), _background(false), _failed(false) {
+}
+
+Job::~Job() {
+	assert((_state == kStateIdle) || (_state == kStateDone));
+}
+
+void Job::lockDependents() {
+	while (_dependentsLock.exchange(true, boost::memory_order_acquire))
+		;
+}
+
+void Job::unlockDependents() {
+	_dependentsLock.store(false, boost::memory_order_release);
+}
+
+void Job::dependsOn(Job &job) {
+	assert(_state != kStatePending);
+
+	job.lockDependents();
+
+	// Jobs that ran already can't hold us up anymore
+	if ((job._state == kStateIdle) || (job._state == kStatePending)) {
+		job._dependents.push_back(this);
+		_blockers++;
+	}
+
+	job.unlockDependents();
+}
+
+bool Job::isDone() const {
+	return _state.load(boost::memory_order_acquire) == kStateDone;
+}
+
+
+/** A worker thread, running jobs from its own queue. */
+class JobManager::Worker : public Thread {
+public:
+	Worker(JobManager &manager, size_t queue) : _manager(&manager), _queue(queue), _id(0) {
+	}
+
+	~Worker() {
+		destroyThread();
+	}
+
+	SDL_threadID getID() const {
+		return _id.load(boost::memory_order_acquire);
+	}
+
+private:
+	JobManager *_manager;
+	size_t      _queue;
+
+	boost::atomic<SDL_threadID> _id;
+
+	void threadMethod() {
+		_id.store(SDL_ThreadID(), boost::memory_order_release);
+
+		_manager->workerLoop(_queue);
+	}
+};
+
+
+JobManager::JobManager() : _queued(0), _queuedBackground(0), _stealer(0), _jobQueued(_idleMutex), _jobFinished(_idleMutex),
+	_idleWorkers(0), _idleWaiters(0), _shutdown(false) {
+
+	_queues.push_back(new Queue);
+}
+
+JobManager::~JobManager() {
+	deinit();
+}
+
+void JobManager::init(size_t workerCount) {
+	assert(_workers.empty());
+
+	if (workerCount == 0)
+		workerCount = MAX(SDL_GetCPUCount(), 2) - 1;
+
+	_shutdown = false;
+
+	for (size_t i = 0; i < workerCount; i++)
+		_queues.push_back(new Queue);
+
+	for (size_t i = 0; i < workerCount; i++) {
+		_workers.push_back(new Worker(*this, i + 1));
+
+		if (!_workers.back()->createThread())
+			throw Exception("Failed to create job worker thread %u", (uint) i);
+
+		// Wait for the thread to come up, so that it can be found and stopped again
+		while (_workers.back()->getID() == 0)
+			SDL_Delay(1);
+	}
+}
+
+void JobManager::deinit() {
+	if (_workers.empty())
+		return;
+
+	_shutdown = true;
+
+	_idleMutex.lock();
+	_jobQueued.broadcast();
+	_idleMutex.unlock();
+
+	_workers.clear();
+
+	// Move what's left in the queues of the workers into the shared queue
+	Queue &shared = *_queues[0];
+	while (_queues.size() > 1) {
+		Queue &queue = *_queues.back();
+
+		shared.jobs.insert(shared.jobs.end(), queue.jobs.begin(), queue.jobs.end());
+		_queues.pop_back();
+	}
+}
+
+size_t JobManager::getWorkerCount() const {
+	return _workers.size();
+}
+
+size_t JobManager::findQueue() const {
+	const SDL_threadID id = SDL_ThreadID();
+
+	for (size_t i = 0; i < _workers.size(); i++)
+		if (_workers[i]->getID() == id)
+			return i + 1;
+
+	return 0;
+}
+
+void JobManager::add(Job &job) {
+	assert(job._state != Job::kStatePending);
+
+	job._background = false;
+	job._failed     = false;
+	job._state      = Job::kStatePending;
+
+	release(job);
+}
+
+void JobManager::addBackground(Job &job) {
+	assert(job._state != Job::kStatePending);
+
+	job._background = true;
+	job._failed     = false;
+	job._state      = Job::kStatePending;
+
+	release(job);
+}
+
+void JobManager::release(Job &job) {
+	if (--job._blockers == 0)
+		enqueue(job);
+}
+
+void JobManager::enqueue(Job &job) {
+	if (job._background) {
+		_queuedBackground++;
+
+		_background.mutex.lock();
+		_background.jobs.push_back(&job);
+		_background.mutex.unlock();
+
+		// Wake up a sleeping worker, and a thread that might be waiting for this very job
+		if ((_idleWorkers > 0) || (_idleWaiters > 0)) {
+			StackLock lock(_idleMutex);
+
+			_jobQueued.signal();
+			_jobFinished.broadcast();
+		}
+
+		return;
+	}
+
+	Queue &queue = *_queues[findQueue()];
+
+	_queued++;
+
+	queue.mutex.lock();
+	queue.jobs.push_back(&job);
+	queue.mutex.unlock();
+
+	// Wake up a sleeping worker, and any waiting thread that might want to help out
+	if ((_idleWorkers > 0) || (_idleWaiters > 0)) {
+		StackLock lock(_idleMutex);
+
+		_jobQueued.signal();
+		_jobFinished.broadcast();
+	}
+}
+
+Job *JobManager::grab(size_t queue) {
+	if (_queued == 0)
+		return 0;
+
+	// Our own queue first, newest job first, since its data is probably still in the cache
+	{
+		Queue &own = *_queues[queue];
+		StackLock lock(own.mutex);
+
+		if (!own.jobs.empty()) {
+			Job *job = own.jobs.back();
+			own.jobs.pop_back();
+
+			_queued--;
+			return job;
+		}
+	}
+
+	// Then steal the oldest job from somebody else
+	const size_t count = _queues.size();
+	const size_t start = _stealer++;
+
+	for (size_t i = 0; i < count; i++) {
+		const size_t victim = (start + i) % count;
+		if (victim == queue)
+			continue;
+
+		Queue &other = *_queues[victim];
+		StackLock lock(other.mutex);
+
+		if (!other.jobs.empty()) {
+			Job *job = other.jobs.front();
+			other.jobs.pop_front();
+
+			_queued--;
+			return job;
+		}
+	}
+
+	return 0;
+}
+
+Job *JobManager::grabBackground() {
+	if (_queuedBackground == 0)
+		return 0;
+
+	StackLock lock(_background.mutex);
+
+	if (_background.jobs.empty())
+		return 0;
+
+	Job *job = _background.jobs.front();
+	_background.jobs.pop_front();
+
+	_queuedBackground--;
+	return job;
+}
+
+bool JobManager::isQueuedBackground(Job &job) {
+	StackLock lock(_background.mutex);
+
+	return std::find(_background.jobs.begin(), _background.jobs.end(), &job) != _background.jobs.end();
+}
+
+bool JobManager::takeBackground(Job &job) {
+	if (_queuedBackground == 0)
+		return false;
+
+	StackLock lock(_background.mutex);
+
+	std::deque<Job *>::iterator j = std::find(_background.jobs.begin(), _background.jobs.end(), &job);
+	if (j == _background.jobs.end())
+		return false;
+
+	_background.jobs.erase(j);
+
+	_queuedBackground--;
+	return true;
+}
+
+void JobManager::execute(Job &job) {
+	try {
+		job.run();
+	} catch (Exception &e) {
+		job._failed    = true;
+		job._exception = e;
+	} catch (std::exception &e) {
+		job._failed    = true;
+		job._exception = Exception(e);
+	} catch (...) {
+		job._failed    = true;
+		job._exception = Exception("Unknown exception in job");
+	}
+
+	std::vector<Job *> dependents;
+
+	job.lockDependents();
+
+	job._dependents.swap(dependents);
+	job._blockers = 1;
+	job._state    = Job::kStateFinishing;
+
+	job.unlockDependents();
+
+	for (std::vector<Job *>::iterator d = dependents.begin(); d != dependents.end(); ++d)
+		release(**d);
+
+	/* From here on, the job might be destroyed by its owner at any time.
+	 *
+	 * Storing the state and then checking for waiters has to be sequentially
+	 * consistent, pairing with wait() announcing itself and then checking the
+	 * state. Otherwise, the two could pass each other, leaving the waiter
+	 * asleep with nobody to wake it up. */
+	job._state.store(Job::kStateDone, boost::memory_order_seq_cst);
+
+	if (_idleWaiters.load(boost::memory_order_seq_cst) > 0) {
+		StackLock lock(_idleMutex);
+
+		_jobFinished.broadcast();
+	}
+}
+
+void JobManager::wait(Job &job) {
+	assert(job._state != Job::kStateIdle);
+
+	const size_t queue = findQueue();
+
+	while (!job.isDone()) {
+		// A background job nobody took yet is ours to run
+		if (job._background && takeBackground(job)) {
+			execute(job);
+			continue;
+		}
+
+		Job *next = grab(queue);
+		if (next) {
+			execute(*next);
+			continue;
+		}
+
+		// Nothing to help with, sleep until something changes
+		StackLock lock(_idleMutex);
+
+		_idleWaiters++;
+
+		/* See execute() on why this can't just be isDone(). Queueing a background
+		 * job checks for waiters after taking the queue's mutex, so we either see
+		 * it queued here, or get woken up. */
+		if ((job._state.load(boost::memory_order_seq_cst) != Job::kStateDone) && (_queued == 0) &&
+		    !(job._background && isQueuedBackground(job)))
+			_jobFinished.wait();
+
+		_idleWaiters--;
+	}
+
+	if (job._failed)
+		throw job._exception;
+}
+
+void JobManager::workerLoop(size_t queue) {
+	while (!_shutdown) {
+		Job *job = grab(queue);
+		if (!job)
+			job = grabBackground();
+
+		if (job) {
+			execute(*job);
+			continue;
+		}
+
+		StackLock lock(_idleMutex);
+
+		_idleWorkers++;
+
+		if (!_shutdown && (_queued == 0) && (_queuedBackground == 0))
+			_jobQueued.wait();
+
+		_idleWorkers--;
+	}
+}
+
+} // End of namespace Common
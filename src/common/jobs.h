@@ -0,0 +1,307 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A process-wide pool of worker threads running small jobs.
+ */
+
+#ifndef COMMON_JOBS_H
+#define COMMON_JOBS_H
+
+#include "src/common/atomic.h"
+
+#include <vector>
+#include <deque>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/singleton.h"
+#include "src/common/mutex.h"
+#include "src/common/ptrvector.h"
+#include "src/common/scopedptr.h"
+
+namespace Common {
+
+class JobManager;
+
+/** A unit of work that can be run by the JobManager.
+ *
+ *  A job is owned by whoever created it, usually on the stack. It has to
+ *  stay alive until JobManager::wait() on it returned; in particular,
+ *  having waited on a job that depends on it is not enough.
+ *
+ *  A job that has finished can be added again.
+ */
+class Job : boost::noncopyable {
+public:
+	Job();
+	virtual ~Job();
+
+	/** Don't start this job before that other job has finished.
+	 *
+	 *  This has to be called before this job is added to the JobManager.
+	 *  A dependency on a job that has already finished is ignored.
+	 */
+	void dependsOn(Job &job);
+
+	/** Has this job finished running? */
+	bool isDone() const;
+
+protected:
+	/** The actual work. Exceptions are rethrown by JobManager::wait(). */
+	virtual void run() = 0;
+
+private:
+	enum State {
+		kStateIdle,      ///< Not added to the JobManager.
+		kStatePending,   ///< Added, waiting for its dependencies or a thread.
+		kStateFinishing, ///< Ran, but still notifying the jobs depending on it.
+		kStateDone       ///< Finished.
+	};
+
+	boost::atomic<int>    _state;
+	boost::atomic<uint32> _blockers; ///< Unfinished dependencies, plus one until the job is added.
+
+	boost::atomic<bool> _dependentsLock;
+	std::vector<Job *>  _dependents; ///< Jobs waiting for this one.
+
+	bool _background; ///< Only run by the workers, see JobManager::addBackground().
+
+	bool      _failed;
+	Exception _exception;
+
+	void lockDependents();
+	void unlockDependents();
+
+	friend class JobManager;
+};
+
+/** The job manager, running jobs on a fixed pool of worker threads.
+ *
+ *  Each worker has its own queue of jobs. Jobs added from within a job go
+ *  into the queue of the thread running it, and a worker that runs out of
+ *  work steals the oldest job from another queue. Jobs added by any other
+ *  thread go into a shared queue.
+ *
+ *  A thread waiting for a job helps out by running queued jobs in the
+ *  meantime. Only the main thread and jobs themselves should wait, though,
+ *  since a thread blocked elsewhere stalls the jobs it took on.
+ *
+ *  Background jobs go into a queue of their own, which only the workers
+ *  look at once they have nothing else to do.
+ */
+class JobManager : public Singleton<JobManager> {
+public:
+	JobManager();
+	~JobManager();
+
+	/** Start the worker threads.
+	 *
+	 *  With a count of 0, one worker is started for each CPU core besides
+	 *  the one running the main thread.
+	 */
+	void init(size_t workerCount = 0);
+	/** Stop the worker threads.
+	 *
+	 *  Jobs still queued then are only run when they're waited for.
+	 */
+	void deinit();
+
+	/** Return the number of worker threads. */
+	size_t getWorkerCount() const;
+
+	/** Queue this job for running, once all its dependencies finished. */
+	void add(Job &job);
+	/** Queue this job for running in the background, once all its dependencies finished.
+	 *
+	 *  Background jobs are only picked up by idle workers, never by threads
+	 *  helping out while waiting for other jobs. This is meant for jobs that
+	 *  might block, for example on a lock a waiting thread could be holding.
+	 *
+	 *  A thread waiting for a background job no worker took yet runs it itself.
+	 */
+	void addBackground(Job &job);
+
+	/** Wait for this job to finish, running other jobs in the meantime.
+	 *
+	 *  If the job threw an exception, it is rethrown here.
+	 */
+	void wait(Job &job);
+
+	/** Call func(rangeBegin, rangeEnd) on sub-ranges of [begin, end), in parallel.
+	 *
+	 *  The range is cut into chunks of at least grainSize elements. The
+	 *  calling thread works on the range as well, so this can also be
+	 *  used when no worker threads exist.
+	 */
+	template<typename Func>
+	void parallelFor(size_t begin, size_t end, size_t grainSize, Func &func);
+
+private:
+	class Worker;
+
+	/** A queue of jobs ready to be run. */
+	struct Queue {
+		Mutex mutex;
+		std::deque<Job *> jobs;
+	};
+
+	template<typename Func>
+	class RangeJob : public Job {
+	public:
+		RangeJob() : _func(0), _begin(0), _end(0) {
+		}
+
+		void set(Func &func, size_t begin, size_t end) {
+			_func  = &func;
+			_begin = begin;
+			_end   = end;
+		}
+
+	protected:
+		void run() {
+			(*_func)(_begin, _end);
+		}
+
+	private:
+		Func *_func;
+
+		size_t _begin;
+		size_t _end;
+	};
+
+	PtrVector<Worker> _workers;
+	PtrVector<Queue>  _queues; ///< The shared queue, followed by one queue per worker.
+
+	Queue _background; ///< The queue of background jobs.
+
+	boost::atomic<size_t> _queued;           ///< Number of jobs in all queues but the background one.
+	boost::atomic<size_t> _queuedBackground; ///< Number of jobs in the background queue.
+	boost::atomic<size_t> _stealer; ///< Rotating start index for stealing.
+
+	Mutex     _idleMutex;
+	Condition _jobQueued;   ///< Signalled when a job was queued.
+	Condition _jobFinished; ///< Broadcast when a job finished.
+
+	boost::atomic<size_t> _idleWorkers; ///< Workers sleeping on _jobQueued.
+	boost::atomic<size_t> _idleWaiters; ///< Threads sleeping on _jobFinished.
+
+	boost::atomic<bool> _shutdown;
+
+	/** Return the index of the calling thread's queue. */
+	size_t findQueue() const;
+
+	/** Push a job whose dependencies have all finished into a queue. */
+	void enqueue(Job &job);
+	/** Take a job from this thread's queue, or steal one from another. */
+	Job *grab(size_t queue);
+	/** Take the oldest job from the background queue. */
+	Job *grabBackground();
+	/** Is this job in the background queue? */
+	bool isQueuedBackground(Job &job);
+	/** Take this job out of the background queue, if it's still in there. */
+	bool takeBackground(Job &job);
+	/** Run a job and notify the jobs depending on it. */
+	void execute(Job &job);
+	/** Remove one blocker from this job, and queue it if there are none left. */
+	void release(Job &job);
+
+	/** Run jobs until told to shut down. Called by the workers. */
+	void workerLoop(size_t queue);
+
+	/** Wait for all these jobs, then rethrow the first exception any of them threw. */
+	template<typename Func>
+	void waitAll(RangeJob<Func> *jobs, size_t count, bool failed, Exception &exception);
+};
+
+template<typename Func>
+void JobManager::parallelFor(size_t begin, size_t end, size_t grainSize, Func &func) {
+	if (begin >= end)
+		return;
+
+	grainSize = MAX<size_t>(grainSize, 1);
+
+	// Split into a few chunks per thread, so that faster threads can steal the rest
+	const size_t size      = end - begin;
+	const size_t maxChunks = (_workers.size() + 1) * 4;
+	const size_t chunks    = MIN<size_t>((size + grainSize - 1) / grainSize, maxChunks);
+
+	if ((chunks <= 1) || _workers.empty()) {
+		func(begin, end);
+		return;
+	}
+
+	const size_t chunkSize = (size + chunks - 1) / chunks;
+
+	// The first chunk is run right here, the rest is queued
+	ScopedArray< RangeJob<Func> > jobs(new RangeJob<Func>[chunks - 1]);
+
+	size_t count = 0;
+	for (size_t b = begin + chunkSize; b < end; b += chunkSize, count++) {
+		jobs[count].set(func, b, MIN(b + chunkSize, end));
+		add(jobs[count]);
+	}
+
+	bool failed = false;
+	Exception exception;
+
+	try {
+		func(begin, begin + chunkSize);
+	} catch (Exception &e) {
+		failed    = true;
+		exception = e;
+	} catch (std::exception &e) {
+		failed    = true;
+		exception = Exception(e);
+	} catch (...) {
+		failed    = true;
+		exception = Exception("Unknown exception in parallelFor()");
+	}
+
+	waitAll(jobs.get(), count, failed, exception);
+}
+
+template<typename Func>
+void JobManager::waitAll(RangeJob<Func> *jobs, size_t count, bool failed, Exception &exception) {
+	// The jobs reference our caller's stack, so we wait for all of them even after an error
+	for (size_t i = 0; i < count; i++) {
+		try {
+			wait(jobs[i]);
+		} catch (Exception &e) {
+			if (!failed)
+				exception = e;
+
+			failed = true;
+		}
+	}
+
+	if (failed)
+		throw exception;
+}
+
+} // End of namespace Common
+
+/** Shortcut for accessing the job manager. */
+#define JobMan Common::JobManager::instance()
+
+#endif // COMMON_JOBS_H
@@ -0,0 +1,210 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Implementing the stream reading interfaces for memory-mapped files.
+ */
+
+#include "src/common/system.h"
+
+#if defined(WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+#elif defined(UNIX)
+	#include <sys/types.h>
+	#include <sys/stat.h>
+	#include <sys/mman.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+#include <cassert>
+
+#include <boost/filesystem/path.hpp>
+
+#include "src/common/mappedfile.h"
+#include "src/common/error.h"
+#include "src/common/ustring.h"
+#include "src/common/scopedptr.h"
+#include "src/common/readfile.h"
+
+namespace Common {
+
+FileMapping::FileMapping(const UString &fileName) : _data(0), _size(0), _handle(0) {
+	map(fileName);
+}
+
+FileMapping::~FileMapping() {
+	unmap();
+}
+
+const byte *FileMapping::getData() const {
+	return _data;
+}
+
+size_t FileMapping::getSize() const {
+	return _size;
+}
+
+#if defined(WIN32)
+
+void FileMapping::map(const UString &fileName) {
+	HANDLE file = CreateFileW(boost::filesystem::path(fileName.c_str()).c_str(), GENERIC_READ,
+	                          FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+	if (file == INVALID_HANDLE_VALUE)
+		throw Exception("Can't open file \"%s\"", fileName.c_str());
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || ((uint64) fileSize.QuadPart > (uint64) SIZE_MAX)) {
+		CloseHandle(file);
+		throw Exception("Can't determine the size of file \"%s\"", fileName.c_str());
+	}
+
+	_size = (size_t) fileSize.QuadPart;
+	if (_size == 0) {
+		CloseHandle(file);
+		return;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, 0, PAGE_READONLY, 0, 0, 0);
+	CloseHandle(file);
+
+	if (!mapping)
+		throw Exception("Can't map file \"%s\"", fileName.c_str());
+
+	_data = static_cast<const byte *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (!_data) {
+		CloseHandle(mapping);
+		throw Exception("Can't map file \"%s\"", fileName.c_str());
+	}
+
+	_handle = mapping;
+}
+
+void FileMapping::unmap() {
+	if (_data)
+		UnmapViewOfFile(_data);
+	if (_handle)
+		CloseHandle(static_cast<HANDLE>(_handle));
+
+	_data   = 0;
+	_size   = 0;
+	_handle = 0;
+}
+
+#elif defined(UNIX)
+
+void FileMapping::map(const UString &fileName) {
+	int fd = ::open(boost::filesystem::path(fileName.c_str()).c_str(), O_RDONLY);
+	if (fd < 0)
+		throw Exception("Can't open file \"%s\"", fileName.c_str());
+
+	struct stat fileStat;
+	if ((fstat(fd, &fileStat) != 0) || ((uint64) fileStat.st_size > (uint64) SIZE_MAX)) {
+		::close(fd);
+		throw Exception("Can't determine the size of file \"%s\"", fileName.c_str());
+	}
+
+	_size = (size_t) fileStat.st_size;
+	if (_size == 0) {
+		::close(fd);
+		return;
+	}
+
+	void *data = mmap(0, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// The mapping stays valid after closing the file descriptor
+	::close(fd);
+
+	if (data == MAP_FAILED) {
+		_size = 0;
+		throw Exception("Can't map file \"%s\"", fileName.c_str());
+	}
+
+	_data = static_cast<const byte *>(data);
+}
+
+void FileMapping::unmap() {
+	if (_data)
+		munmap(const_cast<byte *>(_data), _size);
+
+	_data = 0;
+	_size = 0;
+}
+
+#else
+
+/* No memory-mapping available on this platform. Fall back to reading
+ * the whole file into memory, which at least keeps the views working. */
+
+void FileMapping::map(const UString &fileName) {
+	ReadFile file(fileName);
+
+	_size = file.size();
+	if (_size == 0)
+		return;
+
+	ScopedArray<byte> data(new byte[_size]);
+	if (file.read(data.get(), _size) != _size)
+		throw Exception(kReadError);
+
+	_data = data.release();
+}
+
+void FileMapping::unmap() {
+	delete[] _data;
+
+	_data = 0;
+	_size = 0;
+}
+
+#endif
+
+
+MappedFile::MappedFile(const FileMappingPtr &mapping) :
+	MemoryReadStream(mapping->getData(), mapping->getSize()), _mapping(mapping), _offset(0) {
+
+}
+
+/** Return the start of the range [begin, end) within the mapping, after checking it. */
+static const byte *getMappedRange(const FileMappingPtr &mapping, size_t begin, size_t end) {
+	if ((begin > end) || (end > mapping->getSize()))
+		throw Exception("Invalid mapped file range [%u, %u) (%u)",
+		                (uint) begin, (uint) end, (uint) mapping->getSize());
+
+	return mapping->getData() + begin;
+}
+
+MappedFile::MappedFile(const FileMappingPtr &mapping, size_t begin, size_t end) :
+	MemoryReadStream(getMappedRange(mapping, begin, end), end - begin), _mapping(mapping), _offset(begin) {
+
+}
+
+MappedFile::~MappedFile() {
+}
+
+MappedFile *MappedFile::getView(size_t begin, size_t end) const {
+	if ((begin > end) || (end > size()))
+		throw Exception("Invalid view range [%u, %u) (%u)", (uint) begin, (uint) end, (uint) size());
+
+	return new MappedFile(_mapping, _offset + begin, _offset + end);
+}
+
+} // End of namespace Common
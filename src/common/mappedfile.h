@@ -0,0 +1,97 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Implementing the stream reading interfaces for memory-mapped files.
+ */
+
+#ifndef COMMON_MAPPEDFILE_H
+#define COMMON_MAPPEDFILE_H
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "src/common/types.h"
+#include "src/common/memreadstream.h"
+
+namespace Common {
+
+class UString;
+
+/** A read-only mapping of a whole file into memory.
+ *
+ *  On systems that support it, the file is mapped into the address
+ *  space of the process (mmap() or MapViewOfFile()). On all other
+ *  systems, the whole file is read into memory instead.
+ */
+class FileMapping : boost::noncopyable {
+public:
+	/** Map the file with the given name. Throws on failure. */
+	FileMapping(const UString &fileName);
+	~FileMapping();
+
+	/** Return the mapped data. */
+	const byte *getData() const;
+	/** Return the size of the mapped data. */
+	size_t getSize() const;
+
+private:
+	const byte *_data;
+	size_t _size;
+
+	void *_handle; ///< Platform-specific handle of the mapping.
+
+	void map(const UString &fileName);
+	void unmap();
+};
+
+typedef boost::shared_ptr<FileMapping> FileMappingPtr;
+
+
+/** A stream reading a memory-mapped file.
+ *
+ *  Since all data of the file is directly accessible in memory, views onto
+ *  parts of a MappedFile can be created without copying any data. All views
+ *  share the same mapping, which is only unmapped once the last stream using
+ *  it is destroyed.
+ */
+class MappedFile : public MemoryReadStream {
+public:
+	/** Create a stream over the whole of an existing mapping. */
+	MappedFile(const FileMappingPtr &mapping);
+	/** Create a stream over a part [begin, end) of an existing mapping. */
+	MappedFile(const FileMappingPtr &mapping, size_t begin, size_t end);
+	~MappedFile();
+
+	/** Create a new stream viewing the range [begin, end) of this stream.
+	 *
+	 *  The data is not copied; the new stream shares this stream's mapping.
+	 */
+	MappedFile *getView(size_t begin, size_t end) const;
+
+private:
+	FileMappingPtr _mapping;
+
+	size_t _offset; ///< Our offset within the mapping.
+};
+
+} // End of namespace Common
+
+#endif // COMMON_MAPPEDFILE_H
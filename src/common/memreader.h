@@ -0,0 +1,231 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A fast reader for data in memory.
+ */
+
+#ifndef COMMON_MEMREADER_H
+#define COMMON_MEMREADER_H
+
+#include <cstring>
+
+#include "src/common/types.h"
+#include "src/common/endianness.h"
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/memreadstream.h"
+
+namespace Common {
+
+/** A non-virtual, bounds-checked cursor over data in memory.
+ *
+ *  Every scalar read on a ReadStream goes through its virtual read(),
+ *  even if the stream is a MemoryReadStream with all its data loaded.
+ *  A MemoryReader instead reads straight out of the buffer, with inline
+ *  scalar reads and bulk reads of whole arrays.
+ *
+ *  The reader does not own the data. Copying a reader creates another
+ *  cursor over the same data.
+ *
+ *  Like a ReadStream, reading past the end throws kReadError, and seeking
+ *  past the end throws kSeekError.
+ */
+class MemoryReader {
+public:
+	/** Create an empty reader. */
+	MemoryReader() : _data(0), _size(0), _pos(0) {
+	}
+
+	/** Create a reader over this data. */
+	MemoryReader(const byte *data, size_t size) : _data(data), _size(size), _pos(0) {
+	}
+
+	/** Create a reader over the data of this stream, starting at its current position.
+	 *
+	 *  The stream has to outlive the reader.
+	 */
+	explicit MemoryReader(const MemoryReadStream &stream) :
+		_data(stream.getData()), _size(stream.size()), _pos(stream.pos()) {
+	}
+
+	/** Return the current position. */
+	size_t pos() const {
+		return _pos;
+	}
+
+	/** Return the size of the data. */
+	size_t size() const {
+		return _size;
+	}
+
+	/** Has the end of the data been reached? */
+	bool eos() const {
+		return _pos >= _size;
+	}
+
+	/** Return the data, starting at the current position. */
+	const byte *getData() const {
+		return _data + _pos;
+	}
+
+	/** Seek to this offset from the start of the data, and return the old position. */
+	size_t seek(size_t offset) {
+		if (offset > _size)
+			throw Exception(kSeekError);
+
+		const size_t oldPos = _pos;
+
+		_pos = offset;
+		return oldPos;
+	}
+
+	/** Skip this many bytes. */
+	void skip(size_t n) {
+		take(n);
+	}
+
+	/** Read this many bytes. */
+	void read(void *dataPtr, size_t dataSize) {
+		std::memcpy(dataPtr, take(dataSize), dataSize);
+	}
+
+	byte readByte() {
+		return *take(1);
+	}
+
+	int8 readSByte() {
+		return (int8) readByte();
+	}
+
+	uint16 readUint16LE() {
+		return READ_LE_UINT16(take(2));
+	}
+
+	uint32 readUint32LE() {
+		return READ_LE_UINT32(take(4));
+	}
+
+	uint64 readUint64LE() {
+		return READ_LE_UINT64(take(8));
+	}
+
+	uint16 readUint16BE() {
+		return READ_BE_UINT16(take(2));
+	}
+
+	uint32 readUint32BE() {
+		return READ_BE_UINT32(take(4));
+	}
+
+	uint64 readUint64BE() {
+		return READ_BE_UINT64(take(8));
+	}
+
+	int16 readSint16LE() {
+		return (int16) readUint16LE();
+	}
+
+	int32 readSint32LE() {
+		return (int32) readUint32LE();
+	}
+
+	int16 readSint16BE() {
+		return (int16) readUint16BE();
+	}
+
+	int32 readSint32BE() {
+		return (int32) readUint32BE();
+	}
+
+	float readIEEEFloatLE() {
+		return convertIEEEFloat(readUint32LE());
+	}
+
+	float readIEEEFloatBE() {
+		return convertIEEEFloat(readUint32BE());
+	}
+
+	/** Read n little-endian 16-bit values. */
+	void readUint16LE(uint16 *values, size_t n) {
+		const byte *data = takeArray(n, 2);
+
+#if defined(XOREOS_LITTLE_ENDIAN)
+		std::memcpy(values, data, n * 2);
+#else
+		for (size_t i = 0; i < n; i++, data += 2)
+			values[i] = READ_LE_UINT16(data);
+#endif
+	}
+
+	/** Read n little-endian 32-bit values. */
+	void readUint32LE(uint32 *values, size_t n) {
+		const byte *data = takeArray(n, 4);
+
+#if defined(XOREOS_LITTLE_ENDIAN)
+		std::memcpy(values, data, n * 4);
+#else
+		for (size_t i = 0; i < n; i++, data += 4)
+			values[i] = READ_LE_UINT32(data);
+#endif
+	}
+
+	/** Read n little-endian 32-bit IEEE floats. */
+	void readIEEEFloatLE(float *values, size_t n) {
+		const byte *data = takeArray(n, 4);
+
+#if defined(XOREOS_LITTLE_ENDIAN)
+		std::memcpy(values, data, n * 4);
+#else
+		for (size_t i = 0; i < n; i++, data += 4)
+			values[i] = convertIEEEFloat(READ_LE_UINT32(data));
+#endif
+	}
+
+private:
+	const byte *_data;
+
+	size_t _size;
+	size_t _pos;
+
+	/** Advance by n bytes and return the data that was passed over. */
+	const byte *take(size_t n) {
+		if (n > (_size - _pos))
+			throw Exception(kReadError);
+
+		const byte *data = _data + _pos;
+
+		_pos += n;
+		return data;
+	}
+
+	/** Advance over an array of n elements of elemSize bytes each. */
+	const byte *takeArray(size_t n, size_t elemSize) {
+		// Checked by count, so that n * elemSize can't overflow
+		if (n > ((_size - _pos) / elemSize))
+			throw Exception(kReadError);
+
+		return take(n * elemSize);
+	}
+};
+
+} // End of namespace Common
+
+#endif // COMMON_MEMREADER_H
@@ -97,6 +97,22 @@ size_t MemoryReadStream::seek(ptrdiff_t offset, Origin whence) {
 	return oldPos;
 }
 
+size_t MemoryReadStream::readAt(size_t offset, void *dataPtr, size_t dataSize) {
+	assert(dataPtr);
+
+	if (offset > _size)
+		throw Exception(kSeekError);
+
+	dataSize = MIN(dataSize, _size - offset);
+	std::memcpy(dataPtr, _ptrOrig.get() + offset, dataSize);
+
+	return dataSize;
+}
+
+bool MemoryReadStream::isReadAtThreadSafe() const {
+	return true;
+}
+
 bool MemoryReadStream::eos() const {
 	return _eos;
 }
@@ -113,6 +129,15 @@ const byte *MemoryReadStream::getData() const {
 	return _ptrOrig.get();
 }
 
+const byte *MemoryReadStream::releaseData() {
+	if (!_ptrOrig.isDisposable())
+		return 0;
+
+	_ptrOrig.setDisposable(false);
+
+	return _ptrOrig.get();
+}
+
 
 MemoryReadStreamEndian::MemoryReadStreamEndian(const byte *dataPtr, size_t dataSize,
                                                bool bigEndian, bool disposeMemory) :
@@ -123,4 +148,29 @@ MemoryReadStreamEndian::MemoryReadStreamEndian(const byte *dataPtr, size_t dataS
 MemoryReadStreamEndian::~MemoryReadStreamEndian() {
 }
 
+
+MemoryReadStream *toMemoryReadStream(SeekableReadStream *stream) {
+	if (!stream)
+		return 0;
+
+	MemoryReadStream *memory = dynamic_cast<MemoryReadStream *>(stream);
+	if (memory)
+		return memory;
+
+	try {
+		const size_t pos = stream->pos();
+
+		stream->seek(0);
+		memory = stream->readStream(stream->size());
+		memory->seek(pos);
+
+	} catch (...) {
+		delete stream;
+		throw;
+	}
+
+	delete stream;
+	return memory;
+}
+
 } // End of namespace Common
@@ -81,8 +81,23 @@ public:
 
 	size_t seek(ptrdiff_t offset, Origin whence = kOriginBegin);
 
+	size_t readAt(size_t offset, void *dataPtr, size_t dataSize);
+
+	bool isReadAtThreadSafe() const;
+
 	const byte *getData() const;
 
+	/** Hand the ownership of the memory buffer over to the caller.
+	 *
+	 *  This is only possible if the stream owns the buffer, i.e. if it was
+	 *  created with disposeMemory set. The stream still reads out of the
+	 *  buffer afterwards, so it must be destroyed before the buffer is.
+	 *
+	 *  @return The buffer, to be delete[]'d by the caller, or 0 if the stream
+	 *          doesn't own its buffer.
+	 */
+	const byte *releaseData();
+
 private:
 	DisposableArray<const byte> _ptrOrig;
 	const byte *_ptr;
@@ -140,6 +155,14 @@ public:
 	}
 };
 
+/** Return this stream as a MemoryReadStream, taking over the stream.
+ *
+ *  If the stream isn't a MemoryReadStream already, its whole data is read
+ *  into a new MemoryReadStream and the original stream is deleted. The
+ *  position within the stream is kept.
+ */
+MemoryReadStream *toMemoryReadStream(SeekableReadStream *stream);
+
 } // End of namespace Common
 
 #endif // COMMON_MEMREADSTREAM_H
@@ -139,4 +139,80 @@ void Condition::signal() {
 	SDL_CondSignal(_condition);
 }
 
+void Condition::broadcast() {
+	SDL_CondBroadcast(_condition);
+}
+
+
+ReadWriteLock::ReadWriteLock() : _released(_mutex), _readers(0), _writeDepth(0), _writer(0) {
+}
+
+ReadWriteLock::~ReadWriteLock() {
+	assert((_readers == 0) && (_writeDepth == 0));
+}
+
+bool ReadWriteLock::isWriter() const {
+	return (_writeDepth > 0) && (_writer == SDL_ThreadID());
+}
+
+void ReadWriteLock::lockRead() {
+	StackLock lock(_mutex);
+
+	while ((_writeDepth > 0) && !isWriter())
+		_released.wait();
+
+	_readers++;
+}
+
+void ReadWriteLock::unlockRead() {
+	StackLock lock(_mutex);
+
+	assert(_readers > 0);
+
+	if (--_readers == 0)
+		_released.broadcast();
+}
+
+void ReadWriteLock::lockWrite() {
+	StackLock lock(_mutex);
+
+	if (isWriter()) {
+		_writeDepth++;
+		return;
+	}
+
+	while ((_writeDepth > 0) || (_readers > 0))
+		_released.wait();
+
+	_writer     = SDL_ThreadID();
+	_writeDepth = 1;
+}
+
+void ReadWriteLock::unlockWrite() {
+	StackLock lock(_mutex);
+
+	assert(isWriter());
+
+	if (--_writeDepth == 0)
+		_released.broadcast();
+}
+
+
+ReadLock::ReadLock(ReadWriteLock &lock) : _lock(&lock) {
+	_lock->lockRead();
+}
+
+ReadLock::~ReadLock() {
+	_lock->unlockRead();
+}
+
+
+WriteLock::WriteLock(ReadWriteLock &lock) : _lock(&lock) {
+	_lock->lockWrite();
+}
+
+WriteLock::~WriteLock() {
+	_lock->unlockWrite();
+}
+
 } // End of namespace Common
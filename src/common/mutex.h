@@ -85,6 +85,7 @@ public:
 
 	bool wait(uint32 timeout = 0);
 	void signal();
+	void broadcast();
 
 private:
 	bool _ownMutex;
@@ -93,6 +94,59 @@ private:
 	SDL_cond *_condition;
 };
 
+/** A lock that can be held by many readers, or by one writer.
+ *
+ *  Read locks can be nested, and the thread holding the write lock can
+ *  take the write lock again, as well as read locks. A thread holding only
+ *  a read lock can not take the write lock, though.
+ *
+ *  Readers are preferred over a waiting writer, so that nested read locks
+ *  can't deadlock. This lock is meant for data that is read often and only
+ *  changed rarely.
+ */
+class ReadWriteLock : boost::noncopyable {
+public:
+	ReadWriteLock();
+	~ReadWriteLock();
+
+	void lockRead();
+	void unlockRead();
+
+	void lockWrite();
+	void unlockWrite();
+
+private:
+	Mutex     _mutex;
+	Condition _released;
+
+	size_t _readers;    ///< Number of read locks currently held.
+	size_t _writeDepth; ///< Number of write locks currently held by the writer.
+
+	SDL_threadID _writer; ///< The thread holding the write lock.
+
+	bool isWriter() const;
+};
+
+/** Convenience class that read-locks a ReadWriteLock on creation and unlocks it on destruction. */
+class ReadLock : boost::noncopyable {
+public:
+	ReadLock(ReadWriteLock &lock);
+	~ReadLock();
+
+private:
+	ReadWriteLock *_lock;
+};
+
+/** Convenience class that write-locks a ReadWriteLock on creation and unlocks it on destruction. */
+class WriteLock : boost::noncopyable {
+public:
+	WriteLock(ReadWriteLock &lock);
+	~WriteLock();
+
+private:
+	ReadWriteLock *_lock;
+};
+
 } // End of namespace Common
 
 #endif // COMMON_MUTEX_H
@@ -92,7 +92,7 @@ UString PEResourceID::toString() const {
 	if (_idType == kIDTypeString)
 		return _name;
 	else if (_idType == kIDTypeNumerical) {
-		static char name[9];
+		char name[9];
 		std::sprintf(name, "%08x", _id);
 		name[8] = 0;
 		return name;
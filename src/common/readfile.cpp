@@ -22,6 +22,13 @@
  *  Implementing the stream reading interfaces for files.
  */
 
+#include "src/common/system.h"
+
+#if !defined(WIN32)
+	#include <unistd.h>
+	#include <cerrno>
+#endif
+
 #include <cassert>
 
 #include "src/common/readfile.h"
@@ -139,4 +146,57 @@ size_t ReadFile::read(void *dataPtr, size_t dataSize) {
 	return std::fread(dataPtr, 1, dataSize, _handle);
 }
 
+#if defined(WIN32)
+
+size_t ReadFile::readAt(size_t offset, void *dataPtr, size_t dataSize) {
+	if (!_handle)
+		return 0;
+
+	return SeekableReadStream::readAt(offset, dataPtr, dataSize);
+}
+
+bool ReadFile::isReadAtThreadSafe() const {
+	return false;
+}
+
+#else
+
+size_t ReadFile::readAt(size_t offset, void *dataPtr, size_t dataSize) {
+	if (!_handle)
+		return 0;
+
+	if (offset > _size)
+		throw Exception(kSeekError);
+
+	assert(dataPtr);
+
+	const int fd = fileno(_handle);
+
+	byte  *data      = (byte *) dataPtr;
+	size_t bytesRead = 0;
+
+	while (bytesRead < dataSize) {
+		const ssize_t n = pread(fd, data + bytesRead, dataSize - bytesRead, offset + bytesRead);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+
+			throw Exception(kReadError);
+		}
+
+		if (n == 0)
+			break;
+
+		bytesRead += n;
+	}
+
+	return bytesRead;
+}
+
+bool ReadFile::isReadAtThreadSafe() const {
+	return _handle != 0;
+}
+
+#endif
+
 } // End of namespace Common
@@ -67,6 +67,15 @@ public:
 	size_t seek(ptrdiff_t offset, Origin whence = kOriginBegin);
 	size_t read(void *dataPtr, size_t dataSize);
 
+	/** Read data from a specific position, without touching the file position.
+	 *
+	 *  On POSIX systems, this uses pread() and can be called from several
+	 *  threads at once. Elsewhere, it falls back to seeking and reading.
+	 */
+	size_t readAt(size_t offset, void *dataPtr, size_t dataSize);
+
+	bool isReadAtThreadSafe() const;
+
 protected:
 	std::FILE *_handle; ///< The actual file handle.
 	size_t _size;       ///< The file's size.
@@ -95,6 +95,32 @@ size_t SeekableReadStream::evalSeek(ptrdiff_t offset, Origin whence, size_t pos,
 	throw Exception("Invalid whence (%d)", (int) whence);
 }
 
+size_t SeekableReadStream::readAt(size_t offset, void *dataPtr, size_t dataSize) {
+	if (offset > size())
+		throw Exception(kSeekError);
+
+	const size_t oldPos = seek(offset);
+
+	dataSize = read(dataPtr, dataSize);
+
+	seek(oldPos);
+
+	return dataSize;
+}
+
+bool SeekableReadStream::isReadAtThreadSafe() const {
+	return false;
+}
+
+MemoryReadStream *SeekableReadStream::readStreamAt(size_t offset, size_t dataSize) {
+	ScopedArray<byte> buf(new byte[dataSize]);
+
+	if (readAt(offset, buf.get(), dataSize) != dataSize)
+		throw Exception(kReadError);
+
+	return new MemoryReadStream(buf.release(), dataSize, true);
+}
+
 
 SubReadStream::SubReadStream(ReadStream *parentStream, size_t end, bool disposeParentStream) :
 	_parentStream(parentStream, disposeParentStream), _pos(0), _end(end), _eos(false) {
@@ -170,4 +196,76 @@ SeekableSubReadStreamEndian::SeekableSubReadStreamEndian(SeekableReadStream *par
 SeekableSubReadStreamEndian::~SeekableSubReadStreamEndian() {
 }
 
+
+PositionalSubReadStream::PositionalSubReadStream(SeekableReadStream *parentStream, size_t begin,
+                                                 size_t end, bool disposeParentStream) :
+	_parentStream(parentStream, disposeParentStream), _begin(begin), _end(end), _pos(begin), _eos(false) {
+
+	assert(parentStream);
+	assert(_begin <= _end);
+}
+
+PositionalSubReadStream::~PositionalSubReadStream() {
+}
+
+bool PositionalSubReadStream::eos() const {
+	return _eos;
+}
+
+size_t PositionalSubReadStream::read(void *dataPtr, size_t dataSize) {
+	if (dataSize > (size_t)(_end - _pos)) {
+		dataSize = _end - _pos;
+		_eos = true;
+	}
+
+	if (dataSize == 0)
+		return 0;
+
+	const size_t bytesRead = _parentStream->readAt(_pos, dataPtr, dataSize);
+	if (bytesRead != dataSize)
+		_eos = true;
+
+	_pos += bytesRead;
+
+	return bytesRead;
+}
+
+size_t PositionalSubReadStream::pos() const {
+	return _pos - _begin;
+}
+
+size_t PositionalSubReadStream::size() const {
+	return _end - _begin;
+}
+
+size_t PositionalSubReadStream::seek(ptrdiff_t offset, Origin whence) {
+	assert(_pos >= _begin);
+	assert(_pos <= _end);
+
+	const size_t oldPos = _pos;
+	const size_t newPos = evalSeek(offset, whence, _pos, _begin, size());
+	if ((newPos < _begin) || (newPos > _end))
+		throw Exception(kSeekError);
+
+	_pos = newPos;
+	_eos = false; // reset eos on successful seek
+
+	return oldPos - _begin;
+}
+
+size_t PositionalSubReadStream::readAt(size_t offset, void *dataPtr, size_t dataSize) {
+	if (offset > size())
+		throw Exception(kSeekError);
+
+	dataSize = MIN(dataSize, size() - offset);
+	if (dataSize == 0)
+		return 0;
+
+	return _parentStream->readAt(_begin + offset, dataPtr, dataSize);
+}
+
+bool PositionalSubReadStream::isReadAtThreadSafe() const {
+	return _parentStream->isReadAtThreadSafe();
+}
+
 } // End of namespace Common
@@ -318,6 +318,36 @@ public:
 		return seek(offset, kOriginCurrent);
 	}
 
+	/** Read data from a specific position in the stream.
+	 *
+	 *  Unlike read(), this is meant to not depend on or change the stream
+	 *  position. The default implementation still has to seek to the offset,
+	 *  read and then seek back, though. Streams that can do better, and which
+	 *  can then be read from several threads at once, override this method
+	 *  as well as isReadAtThreadSafe().
+	 *
+	 *  When trying to read from outside the stream, a kSeekError exception
+	 *  is thrown.
+	 *
+	 *  @param  offset the position, from the beginning of the stream, to read from.
+	 *  @param  dataPtr pointer to a buffer into which the data is read.
+	 *  @param  dataSize number of bytes to be read.
+	 *  @return the number of bytes which were actually read.
+	 */
+	virtual size_t readAt(size_t offset, void *dataPtr, size_t dataSize);
+
+	/** Can readAt() safely be called by several threads at the same time? */
+	virtual bool isReadAtThreadSafe() const;
+
+	/** Read the specified amount of data from a specific position into a
+	 *  new[]'ed buffer, which then is wrapped into a MemoryReadStream.
+	 *
+	 *  This does not change the stream position, see readAt().
+	 *
+	 *  When reading fails, a kReadError exception is thrown.
+	 */
+	MemoryReadStream *readStreamAt(size_t offset, size_t dataSize);
+
 	/** Evaluate the seek offset relative to whence into a position from the beginning. */
 	static size_t evalSeek(ptrdiff_t offset, Origin whence, size_t pos, size_t begin, size_t size);
 };
@@ -422,6 +452,47 @@ public:
 	}
 };
 
+
+/** PositionalSubReadStream provides access to a SeekableReadStream restricted
+ *  to the range [begin, end).
+ *
+ *  Unlike SeekableSubReadStream, it keeps its own position and reads all data
+ *  with the parent stream's readAt(). Several PositionalSubReadStreams of the
+ *  same parent therefore don't step on each others toes, and, if the parent's
+ *  readAt() is thread-safe, they can even be read from different threads.
+ *
+ *  Seeking or reading the parent stream directly does not affect a
+ *  PositionalSubReadStream.
+ */
+class PositionalSubReadStream : public SeekableReadStream {
+public:
+	PositionalSubReadStream(SeekableReadStream *parentStream, size_t begin, size_t end,
+	                        bool disposeParentStream = false);
+	~PositionalSubReadStream();
+
+	bool eos() const;
+
+	size_t read(void *dataPtr, size_t dataSize);
+
+	size_t pos() const;
+	size_t size() const;
+
+	size_t seek(ptrdiff_t offset, Origin whence = kOriginBegin);
+
+	size_t readAt(size_t offset, void *dataPtr, size_t dataSize);
+
+	bool isReadAtThreadSafe() const;
+
+private:
+	DisposablePtr<SeekableReadStream> _parentStream;
+
+	size_t _begin;
+	size_t _end;
+	size_t _pos;
+
+	bool _eos;
+};
+
 } // End of namespace Common
 
 #endif // COMMON_READSTREAM_H
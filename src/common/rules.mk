@@ -33,6 +33,8 @@ src_common_libcommon_la_SOURCES += \
     src/common/ptrlist.h \
     src/common/ptrvector.h \
     src/common/ptrmap.h \
+    src/common/arena.h \
+    src/common/flathashmap.h \
     src/common/singleton.h \
     src/common/maths.h \
     src/common/sinetables.h \
@@ -45,6 +47,7 @@ src_common_libcommon_la_SOURCES += \
     src/common/threads.h \
     src/common/thread.h \
     src/common/mutex.h \
+    src/common/jobs.h \
     src/common/ustring.h \
     src/common/hash.h \
     src/common/md5.h \
@@ -63,17 +66,20 @@ src_common_libcommon_la_SOURCES += \
     src/common/datetime.h \
     src/common/readstream.h \
     src/common/memreadstream.h \
+    src/common/memreader.h \
     src/common/writestream.h \
     src/common/memwritestream.h \
     src/common/streamtokenizer.h \
     src/common/stringmap.h \
     src/common/readline.h \
     src/common/readfile.h \
+    src/common/mappedfile.h \
     src/common/writefile.h \
     src/common/filepath.h \
     src/common/filelist.h \
     src/common/binsearch.h \
     src/common/bitstream.h \
+    src/common/bitreader.h \
     src/common/huffman.h \
     src/common/vector3.h \
     src/common/matrix4x4.h \
@@ -89,6 +95,7 @@ src_common_libcommon_la_SOURCES += \
     $(EMPTY)
 
 src_common_libcommon_la_SOURCES += \
+    src/common/arena.cpp \
     src/common/maths.cpp \
     src/common/sinetables.cpp \
     src/common/cosinetables.cpp \
@@ -100,6 +107,7 @@ src_common_libcommon_la_SOURCES += \
     src/common/threads.cpp \
     src/common/thread.cpp \
     src/common/mutex.cpp \
+    src/common/jobs.cpp \
     src/common/ustring.cpp \
     src/common/md5.cpp \
     src/common/blowfish.cpp \
@@ -122,6 +130,7 @@ src_common_libcommon_la_SOURCES += \
     src/common/stringmap.cpp \
     src/common/readline.cpp \
     src/common/readfile.cpp \
+    src/common/mappedfile.cpp \
     src/common/writefile.cpp \
     src/common/filepath.cpp \
     src/common/filelist.cpp \
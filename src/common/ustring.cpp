@@ -165,34 +165,36 @@ UString &UString::operator+=(uint32 c) {
 	return *this;
 }
 
-int UString::strcmp(const UString &str) const {
-	UString::iterator it1 = begin();
-	UString::iterator it2 = str.begin();
-	for (; (it1 != end()) && (it2 != str.end()); ++it1, ++it2) {
-		uint32 c1 = *it1;
-		uint32 c2 = *it2;
-
-		if (c1 < c2)
-			return -1;
-		if (c1 > c2)
-			return  1;
-	}
+/* Comparing UTF-8 strings byte by byte orders them the same way as comparing
+ * their codepoints does. And since bytes of multi-byte sequences are never in
+ * the ASCII range, the same is true when lowercasing the ASCII bytes first.
+ * So neither of the comparisons needs to decode the strings. */
 
-	if ((it1 == end()) && (it2 == str.end()))
-		return 0;
+int UString::strcmp(const UString &str) const {
+	const int cmp = _string.compare(str._string);
 
-	if (it1 == end())
+	if (cmp < 0)
 		return -1;
+	if (cmp > 0)
+		return  1;
 
-	return 1;
+	return 0;
 }
 
 int UString::stricmp(const UString &str) const {
-	UString::iterator it1 = begin();
-	UString::iterator it2 = str.begin();
-	for (; (it1 != end()) && (it2 != str.end()); ++it1, ++it2) {
-		uint32 c1 = toLower(*it1);
-		uint32 c2 = toLower(*it2);
+	const byte *s1 = reinterpret_cast<const byte *>(_string.data());
+	const byte *s2 = reinterpret_cast<const byte *>(str._string.data());
+
+	const size_t size1 = _string.size();
+	const size_t size2 = str._string.size();
+
+	const size_t size = MIN(size1, size2);
+	for (size_t i = 0; i < size; i++) {
+		if (s1[i] == s2[i])
+			continue;
+
+		const byte c1 = toLowerASCII(s1[i]);
+		const byte c2 = toLowerASCII(s2[i]);
 
 		if (c1 < c2)
 			return -1;
@@ -200,10 +202,10 @@ int UString::stricmp(const UString &str) const {
 			return  1;
 	}
 
-	if ((it1 == end()) && (it2 == str.end()))
+	if (size1 == size2)
 		return 0;
 
-	if (it1 == end())
+	if (size1 < size2)
 		return -1;
 
 	return 1;
@@ -244,6 +246,10 @@ bool UString::empty() const {
 	return _string.empty() || (_string[0] == '\0');
 }
 
+bool UString::isASCII() const {
+	return _size == _string.size();
+}
+
 const char *UString::c_str() const {
 	return _string.c_str();
 }
@@ -257,6 +263,15 @@ UString::iterator UString::end() const {
 }
 
 UString::iterator UString::findFirst(uint32 c) const {
+	// An ASCII byte within an UTF-8 string is always an ASCII character
+	if (isASCII(c)) {
+		const size_t index = _string.find((char) c);
+		if (index == std::string::npos)
+			return end();
+
+		return iterator(_string.begin() + index, _string.begin(), _string.end());
+	}
+
 	for (iterator it = begin(); it != end(); ++it)
 		if (*it == c)
 			return it;
@@ -278,6 +293,14 @@ UString::iterator UString::findLast(uint32 c) const {
 	if (empty())
 		return end();
 
+	if (isASCII(c)) {
+		const size_t index = _string.rfind((char) c);
+		if (index == std::string::npos)
+			return end();
+
+		return iterator(_string.begin() + index, _string.begin(), _string.end());
+	}
+
 	iterator it = end();
 	do {
 		--it;
@@ -339,24 +362,30 @@ bool UString::contains(uint32 c) const {
 }
 
 void UString::truncate(const iterator &it) {
-	UString temp;
+	const size_t bytes = it.base() - begin().base();
+	if (bytes >= _string.size())
+		return;
 
-	for (iterator i = begin(); i != it; ++i)
-		temp += *i;
+	const bool ascii = isASCII();
 
-	swap(temp);
+	_string.resize(bytes);
+
+	if (ascii)
+		_size = bytes;
+	else
+		recalculateSize();
 }
 
 void UString::truncate(size_t n) {
 	if (n >= _size)
 		return;
 
-	UString temp;
+	if (isASCII())
+		_string.resize(n);
+	else
+		_string.resize(getPosition(n).base() - begin().base());
 
-	for (iterator it = begin(); n > 0; ++it, n--)
-		temp += *it;
-
-	swap(temp);
+	_size = n;
 }
 
 void UString::trim() {
@@ -473,32 +502,37 @@ void UString::makeUpper() {
 }
 
 UString UString::toLower() const {
-	UString str;
+	// Only ASCII characters change, so this can be done in-place on the bytes
+	UString str(*this);
 
-	str._string.reserve(_string.size());
-	for (iterator it = begin(); it != end(); ++it)
-		str += toLower(*it);
+	for (std::string::iterator it = str._string.begin(); it != str._string.end(); ++it)
+		*it = (char) toLowerASCII((byte) *it);
 
 	return str;
 }
 
 UString UString::toUpper() const {
-	UString str;
+	UString str(*this);
 
-	str._string.reserve(_string.size());
-	for (iterator it = begin(); it != end(); ++it)
-		str += toUpper(*it);
+	for (std::string::iterator it = str._string.begin(); it != str._string.end(); ++it)
+		*it = (char) toUpperASCII((byte) *it);
 
 	return str;
 }
 
 UString::iterator UString::getPosition(size_t n) const {
+	if (isASCII())
+		return iterator(_string.begin() + MIN(n, _string.size()), _string.begin(), _string.end());
+
 	iterator it = begin();
 	for (size_t i = 0; (i < n) && (it != end()); i++, ++it);
 	return it;
 }
 
 size_t UString::getPosition(iterator it) const {
+	if (isASCII())
+		return it.base() - begin().base();
+
 	size_t n = 0;
 	for (iterator i = begin(); i != it; ++i, n++);
 	return n;
@@ -748,6 +782,19 @@ size_t UString::split(const UString &text, uint32 delim, std::vector<UString> &t
 }
 
 void UString::recalculateSize() {
+	// Pure ASCII strings, by far the most common, don't need to be decoded
+	const byte *data = reinterpret_cast<const byte *>(_string.data());
+	const size_t size = _string.size();
+
+	size_t ascii = 0;
+	while ((ascii < size) && (data[ascii] < 0x80))
+		ascii++;
+
+	if (ascii == size) {
+		_size = size;
+		return;
+	}
+
 	try {
 		// Calculate the "distance" in characters from the beginning and end
 		_size = utf8::distance(_string.begin(), _string.end());
@@ -63,6 +63,13 @@ public:
 		}
 	};
 
+	// Case insensitive equality
+	struct iequal : std::binary_function<UString, UString, bool> {
+		bool operator() (const UString &str1, const UString &str2) const {
+			return str1.equalsIgnoreCase(str2);
+		}
+	};
+
 	/** Construct an empty string. */
 	UString();
 	/** Copy constructor. */
@@ -119,6 +126,13 @@ public:
 	/** Is the string empty? */
 	bool empty() const;
 
+	/** Does the string consist of ASCII characters only?
+	 *
+	 *  Then every character is exactly one byte, and operations working with
+	 *  character positions can directly work on the bytes instead.
+	 */
+	bool isASCII() const;
+
 	/** Return the (utf8 encoded) string data. */
 	const char *c_str() const;
 
@@ -187,6 +201,16 @@ public:
 	static uint32 toLower(uint32 c);
 	static uint32 toUpper(uint32 c);
 
+	/** Lowercase a single byte of an UTF-8 string. Non-ASCII bytes are returned as-is. */
+	static inline byte toLowerASCII(byte c) {
+		return ((byte) (c - 'A') < 26) ? (c + ('a' - 'A')) : c;
+	}
+
+	/** Uppercase a single byte of an UTF-8 string. Non-ASCII bytes are returned as-is. */
+	static inline byte toUpperASCII(byte c) {
+		return ((byte) (c - 'a') < 26) ? (c - ('a' - 'A')) : c;
+	}
+
 	static bool isASCII(uint32 c); ///< Is the character an ASCII character?
 
 	static bool isSpace(uint32 c); ///< Is the character an ASCII space character?
@@ -200,6 +224,11 @@ public:
 private:
 	std::string _string; ///< Internal string holding the actual data.
 
+	/** The size of the string, in characters.
+	 *
+	 *  Is equal to the number of bytes in _string exactly if the string is
+	 *  pure ASCII, which makes this double as the isASCII() flag.
+	 */
 	size_t _size;
 
 	void recalculateSize();
@@ -218,12 +247,16 @@ static inline UString operator+(const char *left, const UString &right) {
 
 // Hash functions
 
+/* Both hash functions work on the UTF-8 bytes directly. Bytes of multi-byte
+ * sequences are never in the ASCII range, so lowercasing bytewise is the same
+ * as lowercasing codepoint-wise. */
+
 struct hashUStringCaseSensitive {
 	size_t operator()(const UString &str) const {
 		size_t seed = 0;
 
-		for (UString::iterator it = str.begin(); it != str.end(); ++it)
-			boost::hash_combine<uint32>(seed, *it);
+		for (const byte *s = reinterpret_cast<const byte *>(str.c_str()); *s; s++)
+			boost::hash_combine<byte>(seed, *s);
 
 		return seed;
 	}
@@ -233,8 +266,8 @@ struct hashUStringCaseInsensitive {
 	size_t operator()(const UString &str) const {
 		size_t seed = 0;
 
-		for (UString::iterator it = str.begin(); it != str.end(); ++it)
-			boost::hash_combine<uint32>(seed, UString::toLower(*it));
+		for (const byte *s = reinterpret_cast<const byte *>(str.c_str()); *s; s++)
+			boost::hash_combine<byte>(seed, UString::toLowerASCII(*s));
 
 		return seed;
 	}
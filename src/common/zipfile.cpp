@@ -29,6 +29,7 @@
 #include "src/common/util.h"
 #include "src/common/encoding.h"
 #include "src/common/memreadstream.h"
+#include "src/common/mappedfile.h"
 #include "src/common/deflate.h"
 
 namespace Common {
@@ -74,9 +75,10 @@ void ZipFile::load(SeekableReadStream &zip) {
 		 File  file;
 		IFile iFile;
 
-		zip.skip(20);
+		zip.skip(16);
 
-		iFile.size = zip.readUint32LE();
+		iFile.packedSize = zip.readUint32LE();
+		iFile.size       = zip.readUint32LE();
 
 		uint16 nameLength    = zip.readUint16LE();
 		uint16 extraLength   = zip.readUint16LE();
@@ -127,62 +129,105 @@ const ZipFile::IFile &ZipFile::getIFile(uint32 index) const {
 }
 
 void ZipFile::getFileProperties(SeekableReadStream &zip, const IFile &file,
-		uint16 &compMethod, uint32 &compSize, uint32 &realSize) const {
+		uint16 &compMethod, uint32 &compSize, uint32 &realSize, uint32 &dataOffset) const {
 
-	zip.seek(file.offset);
+	// Read the whole local file header in one go, without touching the stream position
+	byte header[30];
+	if (zip.readAt(file.offset, header, sizeof(header)) != sizeof(header))
+		throw Exception(kReadError);
 
-	uint32 tag = zip.readUint32LE();
+	uint32 tag = READ_LE_UINT32(header);
 	if (tag != 0x04034B50)
 		throw Exception("Unknown ZIP record %08X", tag);
 
-	zip.skip(4);
-
-	compMethod = zip.readUint16LE();
-
-	zip.skip(8);
+	compMethod = READ_LE_UINT16(header +  8);
 
-	compSize = zip.readUint32LE();
-	realSize = zip.readUint32LE();
+	compSize = READ_LE_UINT32(header + 18);
+	realSize = READ_LE_UINT32(header + 22);
 
-	uint16 nameLength  = zip.readUint16LE();
-	uint16 extraLength = zip.readUint16LE();
+	uint16 nameLength  = READ_LE_UINT16(header + 26);
+	uint16 extraLength = READ_LE_UINT16(header + 28);
 
-	zip.skip(nameLength);
-	zip.skip(extraLength);
+	dataOffset = file.offset + sizeof(header) + nameLength + extraLength;
 }
 
 size_t ZipFile::getFileSize(uint32 index) const {
 	return getIFile(index).size;
 }
 
+size_t ZipFile::getFilePackedSize(uint32 index) const {
+	return getIFile(index).packedSize;
+}
+
+bool ZipFile::isFileCompressed(uint32 index) const {
+	uint16 compMethod;
+	uint32 compSize;
+	uint32 realSize;
+	uint32 dataOffset;
+
+	getFileProperties(*_zip, getIFile(index), compMethod, compSize, realSize, dataOffset);
+
+	return (compMethod != 0) && (realSize < kInflateOnDemandSize);
+}
+
 SeekableReadStream *ZipFile::getFile(uint32 index, bool tryNoCopy) const {
 	const IFile &file = getIFile(index);
 
 	uint16 compMethod;
 	uint32 compSize;
 	uint32 realSize;
+	uint32 dataOffset;
+
+	getFileProperties(*_zip, file, compMethod, compSize, realSize, dataOffset);
+
+	// If the ZIP is memory-mapped, look directly into the mapping
+	const MappedFile *mapped = dynamic_cast<const MappedFile *>(_zip.get());
+	if (mapped) {
+		ScopedPtr<MappedFile> packed(mapped->getView(dataOffset, dataOffset + compSize));
+		if (compMethod == 0)
+			return packed.release();
+
+		if (compMethod != 8)
+			throw Exception("Unhandled Zip compression %d", compMethod);
+
+		// Inflate big files on demand, directly out of the mapping
+		if (realSize >= kInflateOnDemandSize)
+			return decompressDeflateOnDemand(packed.release(), realSize, kWindowBitsMaxRaw);
 
-	getFileProperties(*_zip, file, compMethod, compSize, realSize);
+		const byte *data = decompressDeflate(packed->getData(), compSize, realSize, kWindowBitsMaxRaw);
+		return new MemoryReadStream(data, realSize, true);
+	}
 
 	if (tryNoCopy && (compMethod == 0))
-		return new SeekableSubReadStream(_zip.get(), _zip->pos(), _zip->pos() + compSize);
+		return new PositionalSubReadStream(_zip.get(), dataOffset, dataOffset + compSize);
+
+	return decompressFile(*_zip, dataOffset, compMethod, compSize, realSize);
+}
 
-	return decompressFile(*_zip, compMethod, compSize, realSize);
+bool ZipFile::isThreadSafe() const {
+	return _zip->isReadAtThreadSafe();
 }
 
-SeekableReadStream *ZipFile::decompressFile(SeekableReadStream &zip, uint32 method,
+SeekableReadStream *ZipFile::decompressFile(SeekableReadStream &zip, uint32 offset, uint32 method,
 		uint32 compSize, uint32 realSize) {
 
 	if (method == 0) {
 		// Uncompressed
 
-		return zip.readStream(compSize);
+		return zip.readStreamAt(offset, compSize);
 	}
 
 	if (method != 8)
 		throw Exception("Unhandled Zip compression %d", method);
 
-	return decompressDeflate(zip, compSize, realSize, kWindowBitsMaxRaw);
+	// Inflate big files on demand. The compressed data has to be read, though,
+	// since the stream might outlive the ZIP file
+	if (realSize >= kInflateOnDemandSize)
+		return decompressDeflateOnDemand(zip.readStreamAt(offset, compSize), realSize, kWindowBitsMaxRaw);
+
+	PositionalSubReadStream packed(&zip, offset, offset + compSize);
+
+	return decompressDeflate(packed, compSize, realSize, kWindowBitsMaxRaw);
 }
 
 #define BUFREADCOMMENT (0x400)
@@ -57,15 +57,28 @@ public:
 
 	/** Return the size of a file. */
 	size_t getFileSize(uint32 index) const;
+	/** Return the size a file takes up within the ZIP, i.e. its compressed size. */
+	size_t getFilePackedSize(uint32 index) const;
+
+	/** Will getFile() inflate the whole file up front?
+	 *
+	 *  This follows the local file header, just like getFile() does. Stored
+	 *  files and big files that are inflated on demand are cheap to open.
+	 */
+	bool isFileCompressed(uint32 index) const;
 
 	/** Return a stream of the file's contents. */
 	SeekableReadStream *getFile(uint32 index, bool tryNoCopy = false) const;
 
+	/** Can getFile() safely be called by several threads at the same time? */
+	bool isThreadSafe() const;
+
 private:
 	/** Internal file information. */
 	struct IFile {
-		uint32 offset; ///< The offset of the file within the ZIP.
-		uint32 size;   ///< The file's size.
+		uint32 offset;     ///< The offset of the file within the ZIP.
+		uint32 size;       ///< The file's size.
+		uint32 packedSize; ///< The file's compressed size.
 	};
 
 	typedef std::vector<IFile> IFileList;
@@ -81,12 +94,12 @@ private:
 	void load(SeekableReadStream &zip);
 	size_t findCentralDirectoryEnd(SeekableReadStream &zip);
 
-	static SeekableReadStream *decompressFile(SeekableReadStream &zip, uint32 method,
+	static SeekableReadStream *decompressFile(SeekableReadStream &zip, uint32 offset, uint32 method,
 			uint32 compSize, uint32 realSize);
 
 	const IFile &getIFile(uint32 index) const;
 	void getFileProperties(SeekableReadStream &zip, const IFile &file,
-			uint16 &compMethod, uint32 &compSize, uint32 &realSize) const;
+			uint16 &compMethod, uint32 &compSize, uint32 &realSize, uint32 &dataOffset) const;
 };
 
 } // End of namespace Common
@@ -33,6 +33,7 @@
 #include "src/common/filepath.h"
 #include "src/common/readline.h"
 #include "src/common/configman.h"
+#include "src/common/arena.h"
 
 #include "src/aurora/resman.h"
 #include "src/aurora/talkman.h"
@@ -722,6 +723,14 @@ Console::Console(Engine &engine, const Common::UString &font, int fontHeight) :
 			"Usage: dumpreslist <file>\nDump the current list of resources to file");
 	registerCommand("dumpres"    , boost::bind(&Console::cmdDumpRes    , this, _1),
 			"Usage: dumpres <resource>\nDump a resource to file");
+	registerCommand("rescache"   , boost::bind(&Console::cmdResCache   , this, _1),
+			"Usage: rescache [clear|<budget>]\nShow the resource cache statistics, "
+			"clear the cache or set its budget in MiB");
+	registerCommand("restrace"   , boost::bind(&Console::cmdResTrace   , this, _1),
+			"Usage: restrace [on|off|clear|<file>]\nShow the state of the resource request tracing, "
+			"start or stop it, clear it or write a report into a file");
+	registerCommand("arenastats" , boost::bind(&Console::cmdArenaStats , this, _1),
+			"Usage: arenastats\nShow how many allocations the file parsers served from memory arenas");
 	registerCommand("dumptga"    , boost::bind(&Console::cmdDumpTGA    , this, _1),
 			"Usage: dumptga <resource>\nDump an image resource into a TGA");
 	registerCommand("dump2da"    , boost::bind(&Console::cmdDump2DA    , this, _1),
@@ -1211,6 +1220,69 @@ void Console::cmdDumpRes(const CommandLine &cl) {
 		printf("Failed dumping resource \"%s\"", cl.args.c_str());
 }
 
+void Console::cmdResCache(const CommandLine &cl) {
+	if (cl.args == "clear") {
+		ResMan.clearCache();
+	} else if (!cl.args.empty()) {
+		uint64 budget = 0;
+		try {
+			Common::parseString(cl.args, budget);
+		} catch (...) {
+			printCommandHelp(cl.cmd);
+			return;
+		}
+
+		budget = MIN<uint64>(budget, SIZE_MAX / (1024 * 1024));
+
+		ResMan.setCacheBudget((size_t) budget * 1024 * 1024);
+	}
+
+	const Aurora::ResourceCache::Stats stats = ResMan.getCacheStats();
+
+	printf("Resource cache: %u resources, %u of %u KiB used",
+	       (uint) stats.count, (uint) (stats.size / 1024), (uint) (stats.budget / 1024));
+	printf("%s hits, %s misses",
+	       Common::composeString(stats.hits).c_str(), Common::composeString(stats.misses).c_str());
+}
+
+void Console::cmdResTrace(const CommandLine &cl) {
+	if        (cl.args == "on") {
+		ResMan.setTracing(true);
+	} else if (cl.args == "off") {
+		ResMan.setTracing(false);
+	} else if (cl.args == "clear") {
+		ResMan.clearTrace();
+	} else if (!cl.args.empty()) {
+		Common::UString file = Common::FilePath::getUserDataFile(cl.args);
+
+		try {
+			ResMan.writeTraceReport(file);
+			printf("Wrote resource trace to file \"%s\"", file.c_str());
+		} catch (...) {
+			printf("Failed writing resource trace to file \"%s\"", file.c_str());
+		}
+
+		return;
+	}
+
+	printf("Resource tracing is %s, %u requests recorded", ResMan.isTracing() ? "on" : "off",
+	       (uint) ResMan.getTraceRequestCount());
+}
+
+void Console::cmdArenaStats(const CommandLine &UNUSED(cl)) {
+	const Common::MemoryArena::Statistics stats = Common::MemoryArena::getStatistics();
+
+	// The allocations of an arena are only counted once it was cleared or destroyed
+	printf("Memory arenas: %s allocations, %s KiB, from %s heap blocks",
+	       Common::composeString(stats.allocations).c_str(),
+	       Common::composeString(stats.bytes / 1024).c_str(),
+	       Common::composeString(stats.blocks).c_str());
+	printf("%s arenas alive, holding %s heap blocks of %s KiB",
+	       Common::composeString(stats.liveArenas).c_str(),
+	       Common::composeString(stats.liveBlocks).c_str(),
+	       Common::composeString(stats.liveBlockBytes / 1024).c_str());
+}
+
 void Console::cmdDumpTGA(const CommandLine &cl) {
 	if (cl.args.empty()) {
 		printCommandHelp(cl.cmd);
@@ -289,6 +289,9 @@ private:
 	void cmdQuit       (const CommandLine &cl);
 	void cmdDumpResList(const CommandLine &cl);
 	void cmdDumpRes    (const CommandLine &cl);
+	void cmdResCache   (const CommandLine &cl);
+	void cmdResTrace   (const CommandLine &cl);
+	void cmdArenaStats (const CommandLine &cl);
 	void cmdDumpTGA    (const CommandLine &cl);
 	void cmdDump2DA    (const CommandLine &cl);
 	void cmdDumpAll2DA (const CommandLine &cl);
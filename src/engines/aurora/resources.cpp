@@ -109,6 +109,46 @@ bool indexOptionalArchive(const Common::UString &file, uint32 priority, ChangeLi
 	return indexOptionalArchive(file, priority, password, changes);
 }
 
+void addMandatoryArchive(ArchiveBatch &batch, const Common::UString &file, uint32 priority,
+                         Common::ChangeID *changeID) {
+
+	batch.push_back(Aurora::ResourceManager::BatchArchive(file, priority, false, changeID));
+}
+
+void addMandatoryArchive(ArchiveBatch &batch, const Common::UString &file, uint32 priority,
+                         ChangeList &changes) {
+
+	changes.push_back(Common::ChangeID());
+	addMandatoryArchive(batch, file, priority, &changes.back());
+}
+
+bool addOptionalArchive(ArchiveBatch &batch, const Common::UString &file, uint32 priority,
+                        Common::ChangeID *changeID) {
+
+	if (!ResMan.hasArchive(file))
+		return false;
+
+	batch.push_back(Aurora::ResourceManager::BatchArchive(file, priority, true, changeID));
+	return true;
+}
+
+bool addOptionalArchive(ArchiveBatch &batch, const Common::UString &file, uint32 priority,
+                        ChangeList &changes) {
+
+	if (!ResMan.hasArchive(file))
+		return false;
+
+	changes.push_back(Common::ChangeID());
+	return addOptionalArchive(batch, file, priority, &changes.back());
+}
+
+void indexArchives(const ArchiveBatch &batch) {
+	if (EventMan.quitRequested())
+		return;
+
+	ResMan.indexArchives(batch);
+}
+
 void indexMandatoryDirectory(const Common::UString &dir, const char *glob, int depth,
                              uint32 priority, Common::ChangeID *changeID) {
 
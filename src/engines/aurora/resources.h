@@ -31,6 +31,7 @@
 #include "src/common/changeid.h"
 
 #include "src/aurora/types.h"
+#include "src/aurora/resman.h"
 
 namespace Common {
 	class UString;
@@ -40,6 +41,8 @@ namespace Engines {
 
 typedef std::list<Common::ChangeID> ChangeList;
 
+typedef Aurora::ResourceManager::ArchiveBatch ArchiveBatch;
+
 /** Add an archive file to the resource manager, erroring out if it does not exist. */
 void indexMandatoryArchive(const Common::UString &file, uint32 priority, Common::ChangeID *changeID = 0);
 void indexMandatoryArchive(const Common::UString &file, uint32 priority, ChangeList &changes);
@@ -56,6 +59,21 @@ bool indexOptionalArchive(const Common::UString &file, uint32 priority, const st
 bool indexOptionalArchive(const Common::UString &file, uint32 priority, const std::vector<byte> &password,
                           ChangeList &changes);
 
+/** Queue an archive file to be added by indexArchives(), erroring out if it does not exist. */
+void addMandatoryArchive(ArchiveBatch &batch, const Common::UString &file, uint32 priority,
+                         Common::ChangeID *changeID = 0);
+void addMandatoryArchive(ArchiveBatch &batch, const Common::UString &file, uint32 priority,
+                         ChangeList &changes);
+
+/** Queue an archive file to be added by indexArchives(), if it exists. */
+bool addOptionalArchive(ArchiveBatch &batch, const Common::UString &file, uint32 priority,
+                        Common::ChangeID *changeID = 0);
+bool addOptionalArchive(ArchiveBatch &batch, const Common::UString &file, uint32 priority,
+                        ChangeList &changes);
+
+/** Add all the archive files queued in a batch to the resource manager, reading them in parallel. */
+void indexArchives(const ArchiveBatch &batch);
+
 /** Add a directory to the resource manager, erroring out if it does not exist. */
 void indexMandatoryDirectory(const Common::UString &dir, const char *glob, int depth,
                              uint32 priority, Common::ChangeID *changeID = 0);
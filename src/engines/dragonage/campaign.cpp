@@ -34,6 +34,8 @@
 #include "src/aurora/2dareg.h"
 #include "src/aurora/gff4file.h"
 
+#include "src/aurora/nwscript/ncsreg.h"
+
 #include "src/graphics/camera.h"
 
 #include "src/engines/dragonage/game.h"
@@ -365,6 +367,7 @@ void Campaign::unload() {
 
 	clearObjects();
 	TwoDAReg.clear();
+	NCSReg.clear();
 
 	_game->unloadTalkTables(_tlks);
 
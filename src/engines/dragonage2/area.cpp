@@ -70,6 +70,8 @@ Area::Area(Campaign &campaign, const Common::UString &resRef,
            const Common::UString &env, const Common::UString &rim) :
 	Object(kObjectTypeArea), _campaign(&campaign), _resRef(resRef), _activeObject(0), _highlightAll(0) {
 
+	ResMan.beginTraceSection("Area " + resRef);
+
 	try {
 
 		load(resRef, env, rim);
@@ -188,10 +188,13 @@ void Game::loadResourceDir(const Common::UString &dir, uint32 priority, ChangeLi
 	files.sort(true);
 	files.relativize(ResMan.getDataBase());
 
+	ArchiveBatch archives;
 	for (Common::FileList::const_iterator f = files.begin(); f != files.end(); ++f)
 		if (Common::FilePath::getExtension(*f).equalsIgnoreCase(".erf") ||
 		    Common::FilePath::getExtension(*f).equalsIgnoreCase(".rimp"))
-			indexMandatoryArchive("/" + *f, priority++, changes);
+			addMandatoryArchive(archives, "/" + *f, priority++, changes);
+
+	indexArchives(archives);
 }
 
 void Game::unloadTalkTables(ChangeList &changes) {
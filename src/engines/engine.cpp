@@ -25,8 +25,13 @@
 #include <cassert>
 
 #include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/filepath.h"
 #include "src/common/configman.h"
 
+#include "src/aurora/resman.h"
+#include "src/aurora/2dareg.h"
+
 #include "src/graphics/aurora/fps.h"
 #include "src/graphics/aurora/fontman.h"
 
@@ -78,14 +83,39 @@ bool Engine::changeLanguage() {
 	return false;
 }
 
+static void writeResourceTrace(const Common::UString &file) {
+	try {
+		ResMan.writeTraceReport(file);
+		status("Wrote resource trace to \"%s\"", file.c_str());
+	} catch (...) {
+		Common::exceptionDispatcherWarning("Failed to write resource trace to \"%s\"", file.c_str());
+	}
+}
+
 void Engine::start(Aurora::GameID game, const Common::UString &target, Aurora::Platform platform) {
 	showFPS();
 
+	// The cache budget is configured in MiB, and capped to what fits into a size_t
+	const uint64 cacheBudget = MIN<uint64>(MAX(ConfigMan.getInt("resourcecache", 64), 0), SIZE_MAX / (1024 * 1024));
+	ResMan.setCacheBudget((size_t) cacheBudget * 1024 * 1024);
+
+	// Precompiled 2DAs are kept in the user data directory
+	if (ConfigMan.getBool("tablecache", true))
+		TwoDAReg.setCacheDirectory(Common::FilePath::getUserDataFile("tablecache"));
+	else
+		TwoDAReg.setCacheDirectory("");
+
+	const Common::UString traceFile = ConfigMan.getString("resourcetrace");
+	ResMan.setTracing(!traceFile.empty());
+
 	_game     = game;
 	_platform = platform;
 	_target   = target;
 
 	run();
+
+	if (!traceFile.empty())
+		writeResourceTrace(Common::FilePath::getUserDataFile(traceFile));
 }
 
 void Engine::showFPS() {
@@ -41,6 +41,8 @@
 #include "src/aurora/talkman.h"
 #include "src/aurora/2dareg.h"
 
+#include "src/aurora/nwscript/ncsreg.h"
+
 #include "src/graphics/graphics.h"
 
 #include "src/graphics/aurora/cursorman.h"
@@ -270,6 +272,7 @@ void EngineManager::cleanup() const {
 		LangMan.clear();
 		TalkMan.clear();
 		TwoDAReg.clear();
+		NCSReg.clear();
 		ResMan.clear();
 
 		ConfigMan.setGame();
@@ -51,6 +51,8 @@ namespace Jade {
 Area::Area(Module &module, const Common::UString &resRef) : Object(kObjectTypeArea),
 	_module(&module), _resRef(resRef), _visible(false), _activeObject(0), _highlightAll(false) {
 
+	ResMan.beginTraceSection("Area " + resRef);
+
 	try {
 		load();
 	} catch (...) {
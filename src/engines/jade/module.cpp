@@ -26,6 +26,8 @@
 #include "src/common/error.h"
 #include "src/common/ustring.h"
 
+#include "src/aurora/nwscript/ncsreg.h"
+
 #include "src/graphics/camera.h"
 
 #include "src/events/events.h"
@@ -157,6 +159,9 @@ void Module::unload(bool completeUnload) {
 
 void Module::unloadArea() {
 	_area.reset();
+
+	// Scripts might have come from the area's archives, which are gone now
+	NCSReg.clear();
 }
 
 void Module::unloadPC() {
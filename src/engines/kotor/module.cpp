@@ -35,6 +35,8 @@
 #include "src/aurora/rimfile.h"
 #include "src/aurora/gff3file.h"
 
+#include "src/aurora/nwscript/ncsreg.h"
+
 #include "src/graphics/camera.h"
 
 #include "src/graphics/aurora/textureman.h"
@@ -183,6 +185,8 @@ void Module::loadIFO() {
 	_name = _ifo.getName().getString();
 
 	readScripts(*_ifo.getGFF());
+
+	NCSReg.preload(_ifo.getNSSCache());
 }
 
 void Module::loadArea() {
@@ -243,6 +247,8 @@ void Module::unloadResources() {
 		deindexResources(*r);
 
 	_resources.clear();
+
+	NCSReg.clear();
 }
 
 void Module::unloadIFO() {
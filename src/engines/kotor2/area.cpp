@@ -56,6 +56,8 @@ namespace KotOR2 {
 Area::Area(Module &module, const Common::UString &resRef) : Object(kObjectTypeArea),
 	_module(&module), _resRef(resRef), _visible(false), _activeObject(0), _highlightAll(false) {
 
+	ResMan.beginTraceSection("Area " + resRef);
+
 	try {
 		load();
 	} catch (...) {
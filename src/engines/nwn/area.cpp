@@ -27,6 +27,7 @@
 #include "src/common/util.h"
 #include "src/common/error.h"
 
+#include "src/aurora/resman.h"
 #include "src/aurora/gff3file.h"
 #include "src/aurora/2dafile.h"
 #include "src/aurora/2dareg.h"
@@ -56,6 +57,8 @@ Area::Area(Module &module, const Common::UString &resRef) : Object(kObjectTypeAr
 	_module(&module), _resRef(resRef), _visible(false),
 	_activeObject(0), _highlightAll(false) {
 
+	ResMan.beginTraceSection("Area " + resRef);
+
 	try {
 		load();
 	} catch (...) {
@@ -442,6 +445,10 @@ void Area::unloadTileset() {
 }
 
 void Area::loadTiles() {
+	// We already know all tile models, so let them be read in the background
+	for (std::vector<Tile>::const_iterator t = _tiles.begin(); t != _tiles.end(); ++t)
+		ResMan.prefetch(_tileset->getTile(t->tileID).model, Aurora::kFileTypeMDL);
+
 	for (uint32 y = 0; y < _height; y++) {
 		for (uint32 x = 0; x < _width; x++) {
 			uint32 n = y * _width + x;
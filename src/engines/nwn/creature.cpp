@@ -729,126 +729,171 @@ void Creature::load(const Aurora::GFF3Struct &instance, const Aurora::GFF3Struct
 	setOrientation(0.0f, 0.0f, 1.0f, -Common::rad2deg(atan2(bearingX, bearingY)));
 }
 
-static const char * const kBodyPartFields[] = {
-	"Appearance_Head",
-	"BodyPart_Neck"  ,
-	"BodyPart_Torso" ,
-	"BodyPart_Pelvis",
-	"BodyPart_Belt"  ,
-	"ArmorPart_RFoot", "BodyPart_LFoot" ,
-	"BodyPart_RShin" , "BodyPart_LShin" ,
-	"BodyPart_LThigh", "BodyPart_RThigh",
-	"BodyPart_RFArm" , "BodyPart_LFArm" ,
-	"BodyPart_RBicep", "BodyPart_LBicep",
-	"BodyPart_RShoul", "BodyPart_LShoul",
-	"BodyPart_RHand" , "BodyPart_LHand"
+static const Aurora::GFF3Label kBodyPartFields[] = {
+	Aurora::GFF3Label("Appearance_Head"),
+	Aurora::GFF3Label("BodyPart_Neck"),
+	Aurora::GFF3Label("BodyPart_Torso"),
+	Aurora::GFF3Label("BodyPart_Pelvis"),
+	Aurora::GFF3Label("BodyPart_Belt"),
+	Aurora::GFF3Label("ArmorPart_RFoot"), Aurora::GFF3Label("BodyPart_LFoot"),
+	Aurora::GFF3Label("BodyPart_RShin"),  Aurora::GFF3Label("BodyPart_LShin"),
+	Aurora::GFF3Label("BodyPart_LThigh"), Aurora::GFF3Label("BodyPart_RThigh"),
+	Aurora::GFF3Label("BodyPart_RFArm"),  Aurora::GFF3Label("BodyPart_LFArm"),
+	Aurora::GFF3Label("BodyPart_RBicep"), Aurora::GFF3Label("BodyPart_LBicep"),
+	Aurora::GFF3Label("BodyPart_RShoul"), Aurora::GFF3Label("BodyPart_LShoul"),
+	Aurora::GFF3Label("BodyPart_RHand"),  Aurora::GFF3Label("BodyPart_LHand")
 };
 
+/* The labels of the creature fields, packed into GFF3Labels once, instead of
+ * for every field lookup of every creature. */
+static const Aurora::GFF3Label kLabelTag             ("Tag");
+static const Aurora::GFF3Label kLabelFirstName       ("FirstName");
+static const Aurora::GFF3Label kLabelLastName        ("LastName");
+static const Aurora::GFF3Label kLabelDescription     ("Description");
+static const Aurora::GFF3Label kLabelConversation    ("Conversation");
+static const Aurora::GFF3Label kLabelSoundSetFile    ("SoundSetFile");
+static const Aurora::GFF3Label kLabelGender          ("Gender");
+static const Aurora::GFF3Label kLabelRace            ("Race");
+static const Aurora::GFF3Label kLabelSubrace         ("Subrace");
+static const Aurora::GFF3Label kLabelIsPC            ("IsPC");
+static const Aurora::GFF3Label kLabelIsDM            ("IsDM");
+static const Aurora::GFF3Label kLabelAge             ("Age");
+static const Aurora::GFF3Label kLabelExperience      ("Experience");
+static const Aurora::GFF3Label kLabelStr             ("Str");
+static const Aurora::GFF3Label kLabelDex             ("Dex");
+static const Aurora::GFF3Label kLabelCon             ("Con");
+static const Aurora::GFF3Label kLabelInt             ("Int");
+static const Aurora::GFF3Label kLabelWis             ("Wis");
+static const Aurora::GFF3Label kLabelCha             ("Cha");
+static const Aurora::GFF3Label kLabelStartingPackage ("StartingPackage");
+static const Aurora::GFF3Label kLabelSkillList       ("SkillList");
+static const Aurora::GFF3Label kLabelRank            ("Rank");
+static const Aurora::GFF3Label kLabelFeatList        ("FeatList");
+static const Aurora::GFF3Label kLabelFeat            ("Feat");
+static const Aurora::GFF3Label kLabelDeity           ("Deity");
+static const Aurora::GFF3Label kLabelHitPoints       ("HitPoints");
+static const Aurora::GFF3Label kLabelMaxHitPoints    ("MaxHitPoints");
+static const Aurora::GFF3Label kLabelCurrentHitPoints("CurrentHitPoints");
+static const Aurora::GFF3Label kLabelGoodEvil        ("GoodEvil");
+static const Aurora::GFF3Label kLabelLawfulChaotic   ("LawfulChaotic");
+static const Aurora::GFF3Label kLabelAppearanceType  ("Appearance_Type");
+static const Aurora::GFF3Label kLabelPhenotype       ("Phenotype");
+static const Aurora::GFF3Label kLabelColorSkin       ("Color_Skin");
+static const Aurora::GFF3Label kLabelColorHair       ("Color_Hair");
+static const Aurora::GFF3Label kLabelColorTattoo1    ("Color_Tattoo1");
+static const Aurora::GFF3Label kLabelColorTattoo2    ("Color_Tattoo2");
+static const Aurora::GFF3Label kLabelPortraitId      ("PortraitId");
+static const Aurora::GFF3Label kLabelPortrait        ("Portrait");
+static const Aurora::GFF3Label kLabelEquipItemList   ("Equip_ItemList");
+static const Aurora::GFF3Label kLabelClassList       ("ClassList");
+static const Aurora::GFF3Label kLabelClass           ("Class");
+static const Aurora::GFF3Label kLabelClassLevel      ("ClassLevel");
+
 void Creature::loadProperties(const Aurora::GFF3Struct &gff) {
 	// Tag
 
-	_tag = gff.getString("Tag", _tag);
+	_tag = gff.getString(kLabelTag, _tag);
 
 	// Name
 
-	_firstName = gff.getString("FirstName", _firstName);
-	_lastName  = gff.getString("LastName" , _lastName);
+	_firstName = gff.getString(kLabelFirstName, _firstName);
+	_lastName  = gff.getString(kLabelLastName , _lastName);
 
 	_name = _firstName + " " + _lastName;
 	_name.trim();
 
 	// Description
 
-	_description = gff.getString("Description", _description);
+	_description = gff.getString(kLabelDescription, _description);
 
 	// Conversation
 
-	_conversation = gff.getString("Conversation", _conversation);
+	_conversation = gff.getString(kLabelConversation, _conversation);
 
 	// Sound Set
 
-	_soundSet = gff.getUint("SoundSetFile", Aurora::kFieldIDInvalid);
+	_soundSet = gff.getUint(kLabelSoundSetFile, Aurora::kFieldIDInvalid);
 
 	// Portrait
 
 	loadPortrait(gff, _portrait);
 
 	// Gender
-	_gender = (Gender) gff.getUint("Gender", (uint64) _gender);
+	_gender = (Gender) gff.getUint(kLabelGender, (uint64) _gender);
 
 	// Race
-	_race = gff.getUint("Race", _race);
+	_race = gff.getUint(kLabelRace, _race);
 
 	// Subrace
-	_subRace = gff.getString("Subrace", _subRace);
+	_subRace = gff.getString(kLabelSubrace, _subRace);
 
 	// PC and DM
-	_isPC = gff.getBool("IsPC", _isPC);
-	_isDM = gff.getBool("IsDM", _isDM);
+	_isPC = gff.getBool(kLabelIsPC, _isPC);
+	_isDM = gff.getBool(kLabelIsDM, _isDM);
 
 	// Age
-	_age = gff.getUint("Age", _age);
+	_age = gff.getUint(kLabelAge, _age);
 
 	// Experience
-	_xp = gff.getUint("Experience", _xp);
+	_xp = gff.getUint(kLabelExperience, _xp);
 
 	// Abilities
-	_abilities[kAbilityStrength]     = gff.getUint("Str", _abilities[kAbilityStrength]);
-	_abilities[kAbilityDexterity]    = gff.getUint("Dex", _abilities[kAbilityDexterity]);
-	_abilities[kAbilityConstitution] = gff.getUint("Con", _abilities[kAbilityConstitution]);
-	_abilities[kAbilityIntelligence] = gff.getUint("Int", _abilities[kAbilityIntelligence]);
-	_abilities[kAbilityWisdom]       = gff.getUint("Wis", _abilities[kAbilityWisdom]);
-	_abilities[kAbilityCharisma]     = gff.getUint("Cha", _abilities[kAbilityCharisma]);
+	_abilities[kAbilityStrength]     = gff.getUint(kLabelStr, _abilities[kAbilityStrength]);
+	_abilities[kAbilityDexterity]    = gff.getUint(kLabelDex, _abilities[kAbilityDexterity]);
+	_abilities[kAbilityConstitution] = gff.getUint(kLabelCon, _abilities[kAbilityConstitution]);
+	_abilities[kAbilityIntelligence] = gff.getUint(kLabelInt, _abilities[kAbilityIntelligence]);
+	_abilities[kAbilityWisdom]       = gff.getUint(kLabelWis, _abilities[kAbilityWisdom]);
+	_abilities[kAbilityCharisma]     = gff.getUint(kLabelCha, _abilities[kAbilityCharisma]);
 
 	// Classes
 	loadClasses(gff, _classes, _hitDice);
 
 	// Package
-	_startingPackage = gff.getUint("StartingPackage", _startingPackage);
+	_startingPackage = gff.getUint(kLabelStartingPackage, _startingPackage);
 
 	// Skills
-	if (gff.hasField("SkillList")) {
+	if (gff.hasField(kLabelSkillList)) {
 		_skills.clear();
 
-		const Aurora::GFF3List &skills = gff.getList("SkillList");
+		const Aurora::GFF3List &skills = gff.getList(kLabelSkillList);
 		for (Aurora::GFF3List::const_iterator s = skills.begin(); s != skills.end(); ++s) {
 			const Aurora::GFF3Struct &skill = **s;
 
-			_skills.push_back(skill.getSint("Rank"));
+			_skills.push_back(skill.getSint(kLabelRank));
 		}
 	}
 
 	// Feats
-	if (gff.hasField("FeatList")) {
+	if (gff.hasField(kLabelFeatList)) {
 		_feats.clear();
 
-		const Aurora::GFF3List &feats = gff.getList("FeatList");
+		const Aurora::GFF3List &feats = gff.getList(kLabelFeatList);
 		for (Aurora::GFF3List::const_iterator f = feats.begin(); f != feats.end(); ++f) {
 			const Aurora::GFF3Struct &feat = **f;
 
-			_feats.push_back(feat.getUint("Feat"));
+			_feats.push_back(feat.getUint(kLabelFeat));
 		}
 	}
 
 	// Deity
-	_deity = gff.getString("Deity", _deity);
+	_deity = gff.getString(kLabelDeity, _deity);
 
 	// Health
-	if (gff.hasField("HitPoints")) {
-		_baseHP    = gff.getSint("HitPoints");
-		_bonusHP   = gff.getSint("MaxHitPoints", _baseHP) - _baseHP;
-		_currentHP = gff.getSint("CurrentHitPoints", _baseHP);
+	if (gff.hasField(kLabelHitPoints)) {
+		_baseHP    = gff.getSint(kLabelHitPoints);
+		_bonusHP   = gff.getSint(kLabelMaxHitPoints, _baseHP) - _baseHP;
+		_currentHP = gff.getSint(kLabelCurrentHitPoints, _baseHP);
 	}
 
 	// Alignment
 
-	_goodEvil = gff.getUint("GoodEvil", _goodEvil);
-	_lawChaos = gff.getUint("LawfulChaotic", _lawChaos);
+	_goodEvil = gff.getUint(kLabelGoodEvil, _goodEvil);
+	_lawChaos = gff.getUint(kLabelLawfulChaotic, _lawChaos);
 
 	// Appearance
 
-	_appearanceID = gff.getUint("Appearance_Type", _appearanceID);
-	_phenotype    = gff.getUint("Phenotype"      , _phenotype);
+	_appearanceID = gff.getUint(kLabelAppearanceType, _appearanceID);
+	_phenotype    = gff.getUint(kLabelPhenotype      , _phenotype);
 
 	// Body parts
 	for (size_t i = 0; i < kBodyPartMAX; i++) {
@@ -857,10 +902,10 @@ void Creature::loadProperties(const Aurora::GFF3Struct &gff) {
 	}
 
 	// Colors
-	_colorSkin    = gff.getUint("Color_Skin", _colorSkin);
-	_colorHair    = gff.getUint("Color_Hair", _colorHair);
-	_colorTattoo1 = gff.getUint("Color_Tattoo1", _colorTattoo1);
-	_colorTattoo2 = gff.getUint("Color_Tattoo2", _colorTattoo2);
+	_colorSkin    = gff.getUint(kLabelColorSkin, _colorSkin);
+	_colorHair    = gff.getUint(kLabelColorHair, _colorHair);
+	_colorTattoo1 = gff.getUint(kLabelColorTattoo1, _colorTattoo1);
+	_colorTattoo2 = gff.getUint(kLabelColorTattoo2, _colorTattoo2);
 
 	// Equipped Items
 	loadEquippedItems(gff);
@@ -870,7 +915,7 @@ void Creature::loadProperties(const Aurora::GFF3Struct &gff) {
 }
 
 void Creature::loadPortrait(const Aurora::GFF3Struct &gff, Common::UString &portrait) {
-	uint32 portraitID = gff.getUint("PortraitId");
+	uint32 portraitID = gff.getUint(kLabelPortraitId);
 	if (portraitID != 0) {
 		const Aurora::TwoDAFile &twoda = TwoDAReg.get2DA("portraits");
 
@@ -879,14 +924,14 @@ void Creature::loadPortrait(const Aurora::GFF3Struct &gff, Common::UString &port
 			portrait = "po_" + portrait2DA;
 	}
 
-	portrait = gff.getString("Portrait", portrait);
+	portrait = gff.getString(kLabelPortrait, portrait);
 }
 
 void Creature::loadEquippedItems(const Aurora::GFF3Struct &gff) {
-	if (!gff.hasField("Equip_ItemList"))
+	if (!gff.hasField(kLabelEquipItemList))
 		return;
 
-	const Aurora::GFF3List &cEquipped = gff.getList("Equip_ItemList");
+	const Aurora::GFF3List &cEquipped = gff.getList(kLabelEquipItemList);
 	for (Aurora::GFF3List::const_iterator e = cEquipped.begin(); e != cEquipped.end(); ++e)
 		_equippedItems.push_back(new Item(**e));
 }
@@ -894,20 +939,20 @@ void Creature::loadEquippedItems(const Aurora::GFF3Struct &gff) {
 void Creature::loadClasses(const Aurora::GFF3Struct &gff,
                            std::vector<Class> &classes, uint8 &hitDice) {
 
-	if (!gff.hasField("ClassList"))
+	if (!gff.hasField(kLabelClassList))
 		return;
 
 	classes.clear();
 	hitDice = 0;
 
-	const Aurora::GFF3List &cClasses = gff.getList("ClassList");
+	const Aurora::GFF3List &cClasses = gff.getList(kLabelClassList);
 	for (Aurora::GFF3List::const_iterator c = cClasses.begin(); c != cClasses.end(); ++c) {
 		classes.push_back(Class());
 
 		const Aurora::GFF3Struct &cClass = **c;
 
-		classes.back().classID = cClass.getUint("Class");
-		classes.back().level   = cClass.getUint("ClassLevel");
+		classes.back().classID = cClass.getUint(kLabelClass);
+		classes.back().level   = cClass.getUint(kLabelClassLevel);
 
 		hitDice += classes.back().level;
 	}
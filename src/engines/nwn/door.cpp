@@ -65,19 +65,25 @@ void Door::load(const Aurora::GFF3Struct &door) {
 	setModelState();
 }
 
+/** Labels of the door-specific fields. */
+static const Aurora::GFF3Label kLabelGenericType   ("GenericType");
+static const Aurora::GFF3Label kLabelAnimationState("AnimationState");
+static const Aurora::GFF3Label kLabelLinkedToFlags ("LinkedToFlags");
+static const Aurora::GFF3Label kLabelLinkedTo      ("LinkedTo");
+
 void Door::loadObject(const Aurora::GFF3Struct &gff) {
 	// Generic type
 
-	_genericType = gff.getUint("GenericType", _genericType);
+	_genericType = gff.getUint(kLabelGenericType, _genericType);
 
 	// State
 
-	_state = (State) gff.getUint("AnimationState", (uint) _state);
+	_state = (State) gff.getUint(kLabelAnimationState, (uint) _state);
 
 	// Linked to
 
-	_linkedToFlag = (LinkedToFlag) gff.getUint("LinkedToFlags", (uint) _linkedToFlag);
-	_linkedTo     = gff.getString("LinkedTo", _linkedTo);
+	_linkedToFlag = (LinkedToFlag) gff.getUint(kLabelLinkedToFlags, (uint) _linkedToFlag);
+	_linkedTo     = gff.getString(kLabelLinkedTo, _linkedTo);
 }
 
 void Door::loadAppearance() {
@@ -308,41 +308,48 @@ void CharSpells::makeSpellsList() {
 
 	// Add spells to available and known list.
 	const Aurora::TwoDAFile &twodaSpells = TwoDAReg.get2DA("spells");
+
+	const Aurora::TwoDAColumn nameColumn   = twodaSpells.getColumn("Name");
+	const Aurora::TwoDAColumn levelColumn  = twodaSpells.getColumn(casterName);
+	const Aurora::TwoDAColumn schoolColumn = twodaSpells.getColumn("School");
+	const Aurora::TwoDAColumn iconColumn   = twodaSpells.getColumn("IconResRef");
+	const Aurora::TwoDAColumn descColumn   = twodaSpells.getColumn("SpellDesc");
+
 	for (size_t sp = 0; sp < twodaSpells.getRowCount(); ++sp) {
 		// TODO: Check if character already own the spell.
 		const Aurora::TwoDARow &spellRow = twodaSpells.getRow(sp);
 
-		if (spellRow.empty("Name"))
+		if (spellRow.empty(nameColumn))
 			continue;
 
-		if (spellRow.empty(casterName))
+		if (spellRow.empty(levelColumn))
 			continue;
 
 		// Check spell level.
-		uint32 spellLevel = static_cast<uint32>(spellRow.getInt(casterName));
+		uint32 spellLevel = static_cast<uint32>(spellRow.getInt(levelColumn));
 		if (spellLevel > _maxLevel)
 			continue;
 
 		// Check spell school.
-		if (spellRow.getString("School") == oppositeSchool)
+		if (spellRow.getString(schoolColumn) == oppositeSchool)
 			continue;
 
 		// The wizard knows all the level 0 spells.
 		if (gainTable == "CLS_SPGN_WIZ" && spellLevel == 0) {
 			Spell spell;
 			spell.spellID = sp;
-			spell.name = TalkMan.getString(spellRow.getInt("Name"));
-			spell.icon = spellRow.getString("IconResRef");
-			spell.desc = TalkMan.getString(spellRow.getInt("SpellDesc"));
+			spell.name = TalkMan.getString(spellRow.getInt(nameColumn));
+			spell.icon = spellRow.getString(iconColumn);
+			spell.desc = TalkMan.getString(spellRow.getInt(descColumn));
 			_knownSpells[spellLevel].push_back(spell);
 			continue;
 		}
 
 		Spell spell;
 		spell.spellID = sp;
-		spell.name = TalkMan.getString(spellRow.getInt("Name"));
-		spell.icon = spellRow.getString("IconResRef");
-		spell.desc = TalkMan.getString(spellRow.getInt("SpellDesc"));
+		spell.name = TalkMan.getString(spellRow.getInt(nameColumn));
+		spell.icon = spellRow.getString(iconColumn);
+		spell.desc = TalkMan.getString(spellRow.getInt(descColumn));
 		_availSpells[spellLevel].push_back(spell);
 	}
 
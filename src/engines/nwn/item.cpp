@@ -131,24 +131,32 @@ void Item::load(const Aurora::GFF3Struct &instance, const Aurora::GFF3Struct *bl
 	 */
 }
 
+/** Labels of the item fields, packed only once. */
+static const Aurora::GFF3Label kLabelTag          ("Tag");
+static const Aurora::GFF3Label kLabelLocalizedName("LocalizedName");
+static const Aurora::GFF3Label kLabelDescription  ("Description");
+static const Aurora::GFF3Label kLabelBaseItem     ("BaseItem");
+static const Aurora::GFF3Label kLabelPortraitId   ("PortraitId");
+static const Aurora::GFF3Label kLabelPortrait     ("Portrait");
+
 void Item::loadProperties(const Aurora::GFF3Struct &gff) {
-	static const char * const kColorNames[kColorMAX] = {
-		"Metal1Color"  , "Metal2Color",
-		"Leather1Color", "Leather2Color",
-		"Cloth1Color"  , "Cloth2Color"
+	static const Aurora::GFF3Label kColorNames[kColorMAX] = {
+		Aurora::GFF3Label("Metal1Color"),   Aurora::GFF3Label("Metal2Color"),
+		Aurora::GFF3Label("Leather1Color"), Aurora::GFF3Label("Leather2Color"),
+		Aurora::GFF3Label("Cloth1Color"),   Aurora::GFF3Label("Cloth2Color")
 	};
 
 	// Tag
-	_tag = gff.getString("Tag", _tag);
+	_tag = gff.getString(kLabelTag, _tag);
 
 	// Name
-	_name = gff.getString("LocalizedName", _name);
+	_name = gff.getString(kLabelLocalizedName, _name);
 
 	// Description
-	_description = gff.getString("Description", _description);
+	_description = gff.getString(kLabelDescription, _description);
 
 	// This is an index into basitem.2da which contains inventory slot info
-	_baseItem = gff.getUint("BaseItem", _baseItem);
+	_baseItem = gff.getUint(kLabelBaseItem, _baseItem);
 
 	// TODO: Are these armor only?
 	for (size_t i = 0; i < kColorMAX; i++)
@@ -165,7 +173,7 @@ void Item::loadProperties(const Aurora::GFF3Struct &gff) {
 }
 
 void Item::loadPortrait(const Aurora::GFF3Struct &gff) {
-	uint32 portraitID = gff.getUint("PortraitId");
+	uint32 portraitID = gff.getUint(kLabelPortraitId);
 	if (portraitID != 0) {
 		const Aurora::TwoDAFile &twoda = TwoDAReg.get2DA("portraits");
 
@@ -174,23 +182,23 @@ void Item::loadPortrait(const Aurora::GFF3Struct &gff) {
 			_portrait = "po_" + portrait;
 	}
 
-	_portrait = gff.getString("Portrait", _portrait);
+	_portrait = gff.getString(kLabelPortrait, _portrait);
 }
 
 void Item::loadArmorParts(const Aurora::GFF3Struct &gff) {
-	static const char * const kArmorPartNames[] = {
-		"Appearance_Head" ,  // Heads appear to be a special case
-		"ArmorPart_Neck"  ,
-		"ArmorPart_Torso" ,
-		"ArmorPart_Pelvis",
-		"ArmorPart_Belt"  ,
-		"ArmorPart_RFoot" , "ArmorPart_LFoot" ,
-		"ArmorPart_RShin" , "ArmorPart_LShin" ,
-		"ArmorPart_LThigh", "ArmorPart_RThigh",
-		"ArmorPart_RFArm" , "ArmorPart_LFArm" ,
-		"ArmorPart_RBicep", "ArmorPart_LBicep",
-		"ArmorPart_RShoul", "ArmorPart_LShoul",
-		"ArmorPart_RHand" , "ArmorPart_LHand"
+	static const Aurora::GFF3Label kArmorPartNames[] = {
+		Aurora::GFF3Label("Appearance_Head"), // Heads appear to be a special case
+		Aurora::GFF3Label("ArmorPart_Neck"),
+		Aurora::GFF3Label("ArmorPart_Torso"),
+		Aurora::GFF3Label("ArmorPart_Pelvis"),
+		Aurora::GFF3Label("ArmorPart_Belt"),
+		Aurora::GFF3Label("ArmorPart_RFoot"),  Aurora::GFF3Label("ArmorPart_LFoot"),
+		Aurora::GFF3Label("ArmorPart_RShin"),  Aurora::GFF3Label("ArmorPart_LShin"),
+		Aurora::GFF3Label("ArmorPart_LThigh"), Aurora::GFF3Label("ArmorPart_RThigh"),
+		Aurora::GFF3Label("ArmorPart_RFArm"),  Aurora::GFF3Label("ArmorPart_LFArm"),
+		Aurora::GFF3Label("ArmorPart_RBicep"), Aurora::GFF3Label("ArmorPart_LBicep"),
+		Aurora::GFF3Label("ArmorPart_RShoul"), Aurora::GFF3Label("ArmorPart_LShoul"),
+		Aurora::GFF3Label("ArmorPart_RHand"),  Aurora::GFF3Label("ArmorPart_LHand")
 	};
 
 	for (size_t i = 0; i < kArmorPartMAX; i++)
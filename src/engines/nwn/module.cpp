@@ -38,6 +38,8 @@
 #include "src/aurora/erffile.h"
 #include "src/aurora/resman.h"
 
+#include "src/aurora/nwscript/ncsreg.h"
+
 #include "src/graphics/camera.h"
 
 #include "src/graphics/aurora/textureman.h"
@@ -339,6 +341,7 @@ void Module::enter() {
 
 		loadTLK();
 		loadHAKs();
+		loadScripts();
 		loadAreas();
 
 	} catch (Common::Exception &e) {
@@ -549,6 +552,7 @@ void Module::unloadModule() {
 	_delayedActions.clear();
 
 	TwoDAReg.clear();
+	NCSReg.clear();
 
 	clearVariables();
 	clearScripts();
@@ -596,6 +600,13 @@ void Module::unloadHAKs() {
 	deindexResources(_resHAKs);
 }
 
+void Module::loadScripts() {
+	// The HAKs might override scripts that already ran, so start afresh
+	NCSReg.clear();
+
+	NCSReg.preload(_ifo.getNSSCache());
+}
+
 static const char * const texturePacks[4][4] = {
 	{ "textures_tpc.erf", "tiles_tpc.erf", "xp1_tex_tpc.erf", "xp2_tex_tpc.erf" }, // Worst
 	{ "textures_tpa.erf", "tiles_tpc.erf", "xp1_tex_tpc.erf", "xp2_tex_tpc.erf" }, // Bad
@@ -235,6 +235,7 @@ private:
 
 	void loadTLK();         ///< Load the TLK used by the module.
 	void loadHAKs();        ///< Load the HAKs required by the module.
+	void loadScripts();     ///< Load the scripts the module wants cached.
 	void loadTexturePack(); ///< Load the texture pack.
 	void loadAreas();       ///< Load the areas.
 	// '---
@@ -106,12 +106,16 @@ void Placeable::hide() {
 	Situated::hide();
 }
 
+/** Labels of the placeable-specific fields. */
+static const Aurora::GFF3Label kLabelAnimationState("AnimationState");
+static const Aurora::GFF3Label kLabelHasInventory  ("HasInventory");
+
 void Placeable::loadObject(const Aurora::GFF3Struct &gff) {
 	// State
 
-	_state = (State) gff.getUint("AnimationState", (uint) _state);
+	_state = (State) gff.getUint(kLabelAnimationState, (uint) _state);
 
-	_hasInventory = gff.getBool("HasInventory", _hasInventory);
+	_hasInventory = gff.getBool(kLabelHasInventory, _hasInventory);
 }
 
 void Placeable::loadAppearance() {
@@ -41,60 +41,60 @@ namespace NWN {
 
 struct ScriptName {
 	Script script;
-	const char *name;
+	Aurora::GFF3Label name;
 };
 
 static const ScriptName kScriptNames[] = {
-	{kScriptAcquireItem      , "Mod_OnAcquirItem"},
-	{kScriptUnacquireItem    , "Mod_OnUnAqreItem"},
-	{kScriptActivateItem     , "Mod_OnActvtItem" },
-	{kScriptEnter            , "Mod_OnClientEntr"},
-	{kScriptEnter            , "OnEnter"         },
-	{kScriptEnter            , "ScriptOnEnter"   },
-	{kScriptExit             , "Mod_OnClientLeav"},
-	{kScriptExit             , "OnExit"          },
-	{kScriptExit             , "ScriptOnExit"    },
-	{kScriptCutsceneAbort    , "Mod_OnCutsnAbort"},
-	{kScriptHeartbeat        , "Mod_OnHeartbeat" },
-	{kScriptHeartbeat        , "OnHeartbeat"     },
-	{kScriptHeartbeat        , "ScriptHeartbeat" },
-	{kScriptModuleLoad       , "Mod_OnModLoad"   },
-	{kScriptModuleStart      , "Mod_OnModStart"  },
-	{kScriptPlayerChat       , "Mod_OnPlrChat"   },
-	{kScriptPlayerDeath      , "Mod_OnPlrDeath"  },
-	{kScriptPlayerDying      , "Mod_OnPlrDying"  },
-	{kScriptPlayerEquipItem  , "Mod_OnPlrEqItm"  },
-	{kScriptPlayerUnequipItem, "Mod_OnPlrUnEqItm"},
-	{kScriptPlayerLevelUp    , "Mod_OnPlrLvlUp"  },
-	{kScriptPlayerRest       , "Mod_OnPlrRest"   },
-	{kScriptPlayerRespawn    , "Mod_OnSpawnBtnDn"},
-	{kScriptUserdefined      , "Mod_OnUsrDefined"},
-	{kScriptUserdefined      , "OnUserDefined"   },
-	{kScriptUserdefined      , "ScriptUserDefine"},
-	{kScriptUsed             , "OnUsed"          },
-	{kScriptClick            , "OnClick"         },
-	{kScriptOpen             , "OnOpen"          },
-	{kScriptClosed           , "OnClosed"        },
-	{kScriptDamaged          , "OnDamaged"       },
-	{kScriptDamaged          , "ScriptDamaged"   },
-	{kScriptDeath            , "OnDeath"         },
-	{kScriptDeath            , "ScriptDeath"     },
-	{kScriptDisarm           , "OnDisarm"        },
-	{kScriptLock             , "OnLock"          },
-	{kScriptUnlock           , "OnUnlock"        },
-	{kScriptAttacked         , "OnMeleeAttacked" },
-	{kScriptAttacked         , "ScriptAttacked"  },
-	{kScriptSpellCastAt      , "OnSpellCastAt"   },
-	{kScriptSpellCastAt      , "ScriptSpellAt"   },
-	{kScriptTrapTriggered    , "OnTrapTriggered" },
-	{kScriptDialogue         , "ScriptDialogue"  },
-	{kScriptDisturbed        , "ScriptDisturbed" },
-	{kScriptEndRound         , "ScriptEndRound"  },
-	{kScriptBlocked          , "ScriptOnBlocked" },
-	{kScriptNotice           , "ScriptOnNotice"  },
-	{kScriptRested           , "ScriptRested"    },
-	{kScriptSpawn            , "ScriptSpawn"     },
-	{kScriptFailToOpen       , "OnFailToOpen"    }
+	{kScriptAcquireItem      , Aurora::GFF3Label("Mod_OnAcquirItem") },
+	{kScriptUnacquireItem    , Aurora::GFF3Label("Mod_OnUnAqreItem") },
+	{kScriptActivateItem     , Aurora::GFF3Label("Mod_OnActvtItem")  },
+	{kScriptEnter            , Aurora::GFF3Label("Mod_OnClientEntr") },
+	{kScriptEnter            , Aurora::GFF3Label("OnEnter")          },
+	{kScriptEnter            , Aurora::GFF3Label("ScriptOnEnter")    },
+	{kScriptExit             , Aurora::GFF3Label("Mod_OnClientLeav") },
+	{kScriptExit             , Aurora::GFF3Label("OnExit")           },
+	{kScriptExit             , Aurora::GFF3Label("ScriptOnExit")     },
+	{kScriptCutsceneAbort    , Aurora::GFF3Label("Mod_OnCutsnAbort") },
+	{kScriptHeartbeat        , Aurora::GFF3Label("Mod_OnHeartbeat")  },
+	{kScriptHeartbeat        , Aurora::GFF3Label("OnHeartbeat")      },
+	{kScriptHeartbeat        , Aurora::GFF3Label("ScriptHeartbeat")  },
+	{kScriptModuleLoad       , Aurora::GFF3Label("Mod_OnModLoad")    },
+	{kScriptModuleStart      , Aurora::GFF3Label("Mod_OnModStart")   },
+	{kScriptPlayerChat       , Aurora::GFF3Label("Mod_OnPlrChat")    },
+	{kScriptPlayerDeath      , Aurora::GFF3Label("Mod_OnPlrDeath")   },
+	{kScriptPlayerDying      , Aurora::GFF3Label("Mod_OnPlrDying")   },
+	{kScriptPlayerEquipItem  , Aurora::GFF3Label("Mod_OnPlrEqItm")   },
+	{kScriptPlayerUnequipItem, Aurora::GFF3Label("Mod_OnPlrUnEqItm") },
+	{kScriptPlayerLevelUp    , Aurora::GFF3Label("Mod_OnPlrLvlUp")   },
+	{kScriptPlayerRest       , Aurora::GFF3Label("Mod_OnPlrRest")    },
+	{kScriptPlayerRespawn    , Aurora::GFF3Label("Mod_OnSpawnBtnDn") },
+	{kScriptUserdefined      , Aurora::GFF3Label("Mod_OnUsrDefined") },
+	{kScriptUserdefined      , Aurora::GFF3Label("OnUserDefined")    },
+	{kScriptUserdefined      , Aurora::GFF3Label("ScriptUserDefine") },
+	{kScriptUsed             , Aurora::GFF3Label("OnUsed")           },
+	{kScriptClick            , Aurora::GFF3Label("OnClick")          },
+	{kScriptOpen             , Aurora::GFF3Label("OnOpen")           },
+	{kScriptClosed           , Aurora::GFF3Label("OnClosed")         },
+	{kScriptDamaged          , Aurora::GFF3Label("OnDamaged")        },
+	{kScriptDamaged          , Aurora::GFF3Label("ScriptDamaged")    },
+	{kScriptDeath            , Aurora::GFF3Label("OnDeath")          },
+	{kScriptDeath            , Aurora::GFF3Label("ScriptDeath")      },
+	{kScriptDisarm           , Aurora::GFF3Label("OnDisarm")         },
+	{kScriptLock             , Aurora::GFF3Label("OnLock")           },
+	{kScriptUnlock           , Aurora::GFF3Label("OnUnlock")         },
+	{kScriptAttacked         , Aurora::GFF3Label("OnMeleeAttacked")  },
+	{kScriptAttacked         , Aurora::GFF3Label("ScriptAttacked")   },
+	{kScriptSpellCastAt      , Aurora::GFF3Label("OnSpellCastAt")    },
+	{kScriptSpellCastAt      , Aurora::GFF3Label("ScriptSpellAt")    },
+	{kScriptTrapTriggered    , Aurora::GFF3Label("OnTrapTriggered")  },
+	{kScriptDialogue         , Aurora::GFF3Label("ScriptDialogue")   },
+	{kScriptDisturbed        , Aurora::GFF3Label("ScriptDisturbed")  },
+	{kScriptEndRound         , Aurora::GFF3Label("ScriptEndRound")   },
+	{kScriptBlocked          , Aurora::GFF3Label("ScriptOnBlocked")  },
+	{kScriptNotice           , Aurora::GFF3Label("ScriptOnNotice")   },
+	{kScriptRested           , Aurora::GFF3Label("ScriptRested")     },
+	{kScriptSpawn            , Aurora::GFF3Label("ScriptSpawn")      },
+	{kScriptFailToOpen       , Aurora::GFF3Label("OnFailToOpen")     }
 };
 
 ScriptContainer::ScriptContainer() {
@@ -122,8 +122,8 @@ void ScriptContainer::readScripts(const Aurora::GFF3Struct &gff) {
 	clearScripts();
 
 	for (size_t i = 0; i < ARRAYSIZE(kScriptNames); i++) {
-		const Script script = kScriptNames[i].script;
-		const char  *name   = kScriptNames[i].name;
+		const Script             script = kScriptNames[i].script;
+		const Aurora::GFF3Label &name   = kScriptNames[i].name;
 
 		_scripts[script] = gff.getString(name, _scripts[script]);
 	}
@@ -175,40 +175,52 @@ void Situated::load(const Aurora::GFF3Struct &instance, const Aurora::GFF3Struct
 	setOrientation(0.0f, 0.0f, 1.0f, Common::rad2deg(bearing));
 }
 
+/** Labels of the fields shared by placeables and doors. */
+static const Aurora::GFF3Label kLabelTag         ("Tag");
+static const Aurora::GFF3Label kLabelLocName     ("LocName");
+static const Aurora::GFF3Label kLabelDescription ("Description");
+static const Aurora::GFF3Label kLabelAppearance  ("Appearance");
+static const Aurora::GFF3Label kLabelConversation("Conversation");
+static const Aurora::GFF3Label kLabelStatic      ("Static");
+static const Aurora::GFF3Label kLabelUseable     ("Useable");
+static const Aurora::GFF3Label kLabelLocked      ("Locked");
+static const Aurora::GFF3Label kLabelPortraitId  ("PortraitId");
+static const Aurora::GFF3Label kLabelPortrait    ("Portrait");
+
 void Situated::loadProperties(const Aurora::GFF3Struct &gff) {
 	// Tag
-	_tag = gff.getString("Tag", _tag);
+	_tag = gff.getString(kLabelTag, _tag);
 
 	// Name
-	_name = gff.getString("LocName", _name);
+	_name = gff.getString(kLabelLocName, _name);
 
 	// Description
-	_description = gff.getString("Description", _description);
+	_description = gff.getString(kLabelDescription, _description);
 
 	// Portrait
 	loadPortrait(gff);
 
 	// Appearance
-	_appearanceID = gff.getUint("Appearance", _appearanceID);
+	_appearanceID = gff.getUint(kLabelAppearance, _appearanceID);
 
 	// Conversation
-	_conversation = gff.getString("Conversation", _conversation);
+	_conversation = gff.getString(kLabelConversation, _conversation);
 
 	// Static
-	_static = gff.getBool("Static", _static);
+	_static = gff.getBool(kLabelStatic, _static);
 
 	// Usable
-	_usable = gff.getBool("Useable", _usable);
+	_usable = gff.getBool(kLabelUseable, _usable);
 
 	// Locked
-	_locked = gff.getBool("Locked", _locked);
+	_locked = gff.getBool(kLabelLocked, _locked);
 
 	// Scripts
 	readScripts(gff);
 }
 
 void Situated::loadPortrait(const Aurora::GFF3Struct &gff) {
-	uint32 portraitID = gff.getUint("PortraitId");
+	uint32 portraitID = gff.getUint(kLabelPortraitId);
 	if (portraitID != 0) {
 		const Aurora::TwoDAFile &twoda = TwoDAReg.get2DA("portraits");
 
@@ -217,7 +229,7 @@ void Situated::loadPortrait(const Aurora::GFF3Struct &gff) {
 			_portrait = "po_" + portrait;
 	}
 
-	_portrait = gff.getString("Portrait", _portrait);
+	_portrait = gff.getString(kLabelPortrait, _portrait);
 }
 
 void Situated::loadSounds() {
@@ -93,16 +93,22 @@ void Waypoint::load(const Aurora::GFF3Struct &instance, const Aurora::GFF3Struct
 	setOrientation(0.0f, 0.0f, 1.0f, -Common::rad2deg(atan2(bearingX, bearingY)));
 }
 
+/** Labels of the waypoint fields, packed only once. */
+static const Aurora::GFF3Label kLabelTag           ("Tag");
+static const Aurora::GFF3Label kLabelHasMapNote    ("HasMapNote");
+static const Aurora::GFF3Label kLabelMapNoteEnabled("MapNoteEnabled");
+static const Aurora::GFF3Label kLabelMapNote       ("MapNote");
+
 void Waypoint::loadProperties(const Aurora::GFF3Struct &gff) {
 	// Tag
-	_tag = gff.getString("Tag", _tag);
+	_tag = gff.getString(kLabelTag, _tag);
 
 	// Map note
 
-	_hasMapNote     = gff.getBool("HasMapNote"    , _hasMapNote);
-	_enabledMapNote = gff.getBool("MapNoteEnabled", _enabledMapNote);
+	_hasMapNote     = gff.getBool(kLabelHasMapNote    , _hasMapNote);
+	_enabledMapNote = gff.getBool(kLabelMapNoteEnabled, _enabledMapNote);
 
-	_mapNote = gff.getString("MapNote", _mapNote);
+	_mapNote = gff.getString(kLabelMapNote, _mapNote);
 
 	// Scripts
 	readScripts(gff);
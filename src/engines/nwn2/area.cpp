@@ -26,6 +26,7 @@
 #include "src/common/error.h"
 #include "src/common/configman.h"
 
+#include "src/aurora/resman.h"
 #include "src/aurora/gff3file.h"
 #include "src/aurora/2dafile.h"
 #include "src/aurora/2dareg.h"
@@ -59,6 +60,8 @@ Area::Area(Module &module, const Common::UString &resRef) : Object(kObjectTypeAr
 	_module(&module), _resRef(resRef), _visible(false),
 	_activeObject(0), _highlightAll(false) {
 
+	ResMan.beginTraceSection("Area " + resRef);
+
 	try {
 		// Load ARE and GIT
 
@@ -34,6 +34,8 @@
 #include "src/aurora/erffile.h"
 #include "src/aurora/gff3file.h"
 
+#include "src/aurora/nwscript/ncsreg.h"
+
 #include "src/graphics/camera.h"
 
 #include "src/events/events.h"
@@ -185,6 +187,7 @@ void Module::enter(Creature &pc, bool isNewCampaign) {
 
 		loadTLK();
 		loadHAKs();
+		loadScripts();
 		loadAreas();
 
 	} catch (Common::Exception &e) {
@@ -348,6 +351,8 @@ void Module::unloadModule() {
 
 	deindexResources(_resModule);
 
+	NCSReg.clear();
+
 	_newModule.clear();
 
 	_eventQueue.clear();
@@ -386,6 +391,13 @@ void Module::unloadHAKs() {
 	_resHAKs.clear();
 }
 
+void Module::loadScripts() {
+	// The HAKs might override scripts that already ran, so start afresh
+	NCSReg.clear();
+
+	NCSReg.preload(_ifo.getNSSCache());
+}
+
 void Module::loadAreas() {
 	status("Loading areas...");
 
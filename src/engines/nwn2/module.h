@@ -195,6 +195,7 @@ private:
 
 	void loadTLK();         ///< Load the TLK used by the module.
 	void loadHAKs();        ///< Load the HAKs required by the module.
+	void loadScripts();     ///< Load the scripts the module wants cached.
 	void loadAreas();       ///< Load the areas.
 	// '---
 
@@ -219,103 +219,117 @@ void NWN2Engine::initResources(LoadProgress &progress) {
 
 	progress.step("Loading main resource files");
 
-	indexMandatoryArchive("2da.zip"           , 10);
-	indexMandatoryArchive("actors.zip"        , 11);
-	indexMandatoryArchive("animtags.zip"      , 12);
-	indexMandatoryArchive("convo.zip"         , 13);
-	indexMandatoryArchive("ini.zip"           , 14);
-	indexMandatoryArchive("lod-merged.zip"    , 15);
-	indexMandatoryArchive("music.zip"         , 16);
-	indexMandatoryArchive("nwn2_materials.zip", 17);
-	indexMandatoryArchive("nwn2_models.zip"   , 18);
-	indexMandatoryArchive("nwn2_vfx.zip"      , 19);
-	indexMandatoryArchive("prefabs.zip"       , 20);
-	indexMandatoryArchive("scripts.zip"       , 21);
-	indexMandatoryArchive("sounds.zip"        , 22);
-	indexMandatoryArchive("soundsets.zip"     , 23);
-	indexMandatoryArchive("speedtree.zip"     , 24);
-	indexMandatoryArchive("templates.zip"     , 25);
-	indexMandatoryArchive("vo.zip"            , 26);
-	indexMandatoryArchive("walkmesh.zip"      , 27);
+	ArchiveBatch archives;
+
+	addMandatoryArchive(archives, "2da.zip"           , 10);
+	addMandatoryArchive(archives, "actors.zip"        , 11);
+	addMandatoryArchive(archives, "animtags.zip"      , 12);
+	addMandatoryArchive(archives, "convo.zip"         , 13);
+	addMandatoryArchive(archives, "ini.zip"           , 14);
+	addMandatoryArchive(archives, "lod-merged.zip"    , 15);
+	addMandatoryArchive(archives, "music.zip"         , 16);
+	addMandatoryArchive(archives, "nwn2_materials.zip", 17);
+	addMandatoryArchive(archives, "nwn2_models.zip"   , 18);
+	addMandatoryArchive(archives, "nwn2_vfx.zip"      , 19);
+	addMandatoryArchive(archives, "prefabs.zip"       , 20);
+	addMandatoryArchive(archives, "scripts.zip"       , 21);
+	addMandatoryArchive(archives, "sounds.zip"        , 22);
+	addMandatoryArchive(archives, "soundsets.zip"     , 23);
+	addMandatoryArchive(archives, "speedtree.zip"     , 24);
+	addMandatoryArchive(archives, "templates.zip"     , 25);
+	addMandatoryArchive(archives, "vo.zip"            , 26);
+	addMandatoryArchive(archives, "walkmesh.zip"      , 27);
+
+	indexArchives(archives);
+	archives.clear();
 
 	progress.step("Loading expansion 1 resource files");
 
 	// Expansion 1: Mask of the Betrayer (MotB)
 	_hasXP1 = ResMan.hasArchive("2da_x1.zip");
-	indexOptionalArchive("2da_x1.zip"           , 50);
-	indexOptionalArchive("actors_x1.zip"        , 51);
-	indexOptionalArchive("animtags_x1.zip"      , 52);
-	indexOptionalArchive("convo_x1.zip"         , 53);
-	indexOptionalArchive("ini_x1.zip"           , 54);
-	indexOptionalArchive("lod-merged_x1.zip"    , 55);
-	indexOptionalArchive("music_x1.zip"         , 56);
-	indexOptionalArchive("nwn2_materials_x1.zip", 57);
-	indexOptionalArchive("nwn2_models_x1.zip"   , 58);
-	indexOptionalArchive("nwn2_vfx_x1.zip"      , 59);
-	indexOptionalArchive("prefabs_x1.zip"       , 60);
-	indexOptionalArchive("scripts_x1.zip"       , 61);
-	indexOptionalArchive("soundsets_x1.zip"     , 62);
-	indexOptionalArchive("sounds_x1.zip"        , 63);
-	indexOptionalArchive("speedtree_x1.zip"     , 64);
-	indexOptionalArchive("templates_x1.zip"     , 65);
-	indexOptionalArchive("vo_x1.zip"            , 66);
-	indexOptionalArchive("walkmesh_x1.zip"      , 67);
+	addOptionalArchive (archives, "2da_x1.zip"           , 50);
+	addOptionalArchive (archives, "actors_x1.zip"        , 51);
+	addOptionalArchive (archives, "animtags_x1.zip"      , 52);
+	addOptionalArchive (archives, "convo_x1.zip"         , 53);
+	addOptionalArchive (archives, "ini_x1.zip"           , 54);
+	addOptionalArchive (archives, "lod-merged_x1.zip"    , 55);
+	addOptionalArchive (archives, "music_x1.zip"         , 56);
+	addOptionalArchive (archives, "nwn2_materials_x1.zip", 57);
+	addOptionalArchive (archives, "nwn2_models_x1.zip"   , 58);
+	addOptionalArchive (archives, "nwn2_vfx_x1.zip"      , 59);
+	addOptionalArchive (archives, "prefabs_x1.zip"       , 60);
+	addOptionalArchive (archives, "scripts_x1.zip"       , 61);
+	addOptionalArchive (archives, "soundsets_x1.zip"     , 62);
+	addOptionalArchive (archives, "sounds_x1.zip"        , 63);
+	addOptionalArchive (archives, "speedtree_x1.zip"     , 64);
+	addOptionalArchive (archives, "templates_x1.zip"     , 65);
+	addOptionalArchive (archives, "vo_x1.zip"            , 66);
+	addOptionalArchive (archives, "walkmesh_x1.zip"      , 67);
+
+	indexArchives(archives);
+	archives.clear();
 
 	progress.step("Loading expansion 2 resource files");
 
 	// Expansion 2: Storm of Zehir (SoZ)
 	_hasXP2 = ResMan.hasArchive("2da_x2.zip");
-	indexOptionalArchive("2da_x2.zip"           , 100);
-	indexOptionalArchive("actors_x2.zip"        , 101);
-	indexOptionalArchive("animtags_x2.zip"      , 102);
-	indexOptionalArchive("lod-merged_x2.zip"    , 103);
-	indexOptionalArchive("music_x2.zip"         , 104);
-	indexOptionalArchive("nwn2_materials_x2.zip", 105);
-	indexOptionalArchive("nwn2_models_x2.zip"   , 106);
-	indexOptionalArchive("nwn2_vfx_x2.zip"      , 107);
-	indexOptionalArchive("prefabs_x2.zip"       , 108);
-	indexOptionalArchive("scripts_x2.zip"       , 109);
-	indexOptionalArchive("soundsets_x2.zip"     , 110);
-	indexOptionalArchive("sounds_x2.zip"        , 111);
-	indexOptionalArchive("speedtree_x2.zip"     , 112);
-	indexOptionalArchive("templates_x2.zip"     , 113);
-	indexOptionalArchive("vo_x2.zip"            , 114);
+	addOptionalArchive (archives, "2da_x2.zip"           , 100);
+	addOptionalArchive (archives, "actors_x2.zip"        , 101);
+	addOptionalArchive (archives, "animtags_x2.zip"      , 102);
+	addOptionalArchive (archives, "lod-merged_x2.zip"    , 103);
+	addOptionalArchive (archives, "music_x2.zip"         , 104);
+	addOptionalArchive (archives, "nwn2_materials_x2.zip", 105);
+	addOptionalArchive (archives, "nwn2_models_x2.zip"   , 106);
+	addOptionalArchive (archives, "nwn2_vfx_x2.zip"      , 107);
+	addOptionalArchive (archives, "prefabs_x2.zip"       , 108);
+	addOptionalArchive (archives, "scripts_x2.zip"       , 109);
+	addOptionalArchive (archives, "soundsets_x2.zip"     , 110);
+	addOptionalArchive (archives, "sounds_x2.zip"        , 111);
+	addOptionalArchive (archives, "speedtree_x2.zip"     , 112);
+	addOptionalArchive (archives, "templates_x2.zip"     , 113);
+	addOptionalArchive (archives, "vo_x2.zip"            , 114);
+
+	indexArchives(archives);
+	archives.clear();
 
 	// Expansion 3: Mysteries of Westgate
 	_hasXP3 = ResMan.hasArchive("westgate.hak");
 
 	progress.step("Loading patch resource files");
 
-	indexOptionalArchive("actors_v103x1.zip"         , 150);
-	indexOptionalArchive("actors_v106.zip"           , 151);
-	indexOptionalArchive("lod-merged_v101.zip"       , 152);
-	indexOptionalArchive("lod-merged_v107.zip"       , 153);
-	indexOptionalArchive("lod-merged_v121.zip"       , 154);
-	indexOptionalArchive("lod-merged_x1_v121.zip"    , 155);
-	indexOptionalArchive("lod-merged_x2_v121.zip"    , 156);
-	indexOptionalArchive("nwn2_materials_v103x1.zip" , 157);
-	indexOptionalArchive("nwn2_materials_v104.zip"   , 158);
-	indexOptionalArchive("nwn2_materials_v106.zip"   , 159);
-	indexOptionalArchive("nwn2_materials_v107.zip"   , 160);
-	indexOptionalArchive("nwn2_materials_v110.zip"   , 161);
-	indexOptionalArchive("nwn2_materials_v112.zip"   , 162);
-	indexOptionalArchive("nwn2_materials_v121.zip"   , 163);
-	indexOptionalArchive("nwn2_materials_x1_v113.zip", 164);
-	indexOptionalArchive("nwn2_materials_x1_v121.zip", 165);
-	indexOptionalArchive("nwn2_models_v103x1.zip"    , 166);
-	indexOptionalArchive("nwn2_models_v104.zip"      , 167);
-	indexOptionalArchive("nwn2_models_v105.zip"      , 168);
-	indexOptionalArchive("nwn2_models_v106.zip"      , 169);
-	indexOptionalArchive("nwn2_models_v107.zip"      , 160);
-	indexOptionalArchive("nwn2_models_v112.zip"      , 171);
-	indexOptionalArchive("nwn2_models_v121.zip"      , 172);
-	indexOptionalArchive("nwn2_models_x1_v121.zip"   , 173);
-	indexOptionalArchive("nwn2_models_x2_v121.zip"   , 174);
-	indexOptionalArchive("templates_v112.zip"        , 175);
-	indexOptionalArchive("templates_v122.zip"        , 176);
-	indexOptionalArchive("templates_x1_v122.zip"     , 177);
-	indexOptionalArchive("vo_103x1.zip"              , 178);
-	indexOptionalArchive("vo_106.zip"                , 179);
+	addOptionalArchive (archives, "actors_v103x1.zip"         , 150);
+	addOptionalArchive (archives, "actors_v106.zip"           , 151);
+	addOptionalArchive (archives, "lod-merged_v101.zip"       , 152);
+	addOptionalArchive (archives, "lod-merged_v107.zip"       , 153);
+	addOptionalArchive (archives, "lod-merged_v121.zip"       , 154);
+	addOptionalArchive (archives, "lod-merged_x1_v121.zip"    , 155);
+	addOptionalArchive (archives, "lod-merged_x2_v121.zip"    , 156);
+	addOptionalArchive (archives, "nwn2_materials_v103x1.zip" , 157);
+	addOptionalArchive (archives, "nwn2_materials_v104.zip"   , 158);
+	addOptionalArchive (archives, "nwn2_materials_v106.zip"   , 159);
+	addOptionalArchive (archives, "nwn2_materials_v107.zip"   , 160);
+	addOptionalArchive (archives, "nwn2_materials_v110.zip"   , 161);
+	addOptionalArchive (archives, "nwn2_materials_v112.zip"   , 162);
+	addOptionalArchive (archives, "nwn2_materials_v121.zip"   , 163);
+	addOptionalArchive (archives, "nwn2_materials_x1_v113.zip", 164);
+	addOptionalArchive (archives, "nwn2_materials_x1_v121.zip", 165);
+	addOptionalArchive (archives, "nwn2_models_v103x1.zip"    , 166);
+	addOptionalArchive (archives, "nwn2_models_v104.zip"      , 167);
+	addOptionalArchive (archives, "nwn2_models_v105.zip"      , 168);
+	addOptionalArchive (archives, "nwn2_models_v106.zip"      , 169);
+	addOptionalArchive (archives, "nwn2_models_v107.zip"      , 160);
+	addOptionalArchive (archives, "nwn2_models_v112.zip"      , 171);
+	addOptionalArchive (archives, "nwn2_models_v121.zip"      , 172);
+	addOptionalArchive (archives, "nwn2_models_x1_v121.zip"   , 173);
+	addOptionalArchive (archives, "nwn2_models_x2_v121.zip"   , 174);
+	addOptionalArchive (archives, "templates_v112.zip"        , 175);
+	addOptionalArchive (archives, "templates_v122.zip"        , 176);
+	addOptionalArchive (archives, "templates_x1_v122.zip"     , 177);
+	addOptionalArchive (archives, "vo_103x1.zip"              , 178);
+	addOptionalArchive (archives, "vo_106.zip"                , 179);
+
+	indexArchives(archives);
+	archives.clear();
 
 	progress.step("Indexing extra sound resources");
 	indexMandatoryDirectory("ambient"   , 0,  0, 200);
@@ -25,6 +25,7 @@
 #include "src/common/util.h"
 #include "src/common/error.h"
 
+#include "src/aurora/resman.h"
 #include "src/aurora/gdafile.h"
 #include "src/aurora/2dareg.h"
 #include "src/aurora/gff4file.h"
@@ -54,6 +55,8 @@ Area::Area(Module &module, uint32 id) : Object(kObjectTypeArea),
 	_miniMapWidth(0), _miniMapHeight(0), _soundMapBank(-1), _sound(-1), _soundType(-1), _soundBank(-1),
 	_numberRings(0), _numberChaoEggs(0), _activeObject(0), _highlightAll(false) {
 
+	ResMan.beginTraceSection(Common::UString::format("Area %u", id));
+
 	_id = id;
 
 	load();
@@ -35,6 +35,8 @@
 #include "src/aurora/erffile.h"
 #include "src/aurora/gff3file.h"
 
+#include "src/aurora/nwscript/ncsreg.h"
+
 #include "src/graphics/camera.h"
 
 #include "src/events/events.h"
@@ -122,6 +124,8 @@ void Module::loadModule(const Common::UString &module, const Common::UString &en
 
 		readScripts(*_ifo.getGFF());
 
+		NCSReg.preload(_ifo.getNSSCache());
+
 	} catch (Common::Exception &e) {
 		e.add("Can't load module \"%s\"", module.c_str());
 		throw e;
@@ -363,6 +367,8 @@ void Module::unloadModule() {
 
 	deindexResources(_resModule);
 
+	NCSReg.clear();
+
 	_module.clear();
 	_newModule.clear();
 
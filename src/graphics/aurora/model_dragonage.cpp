@@ -35,7 +35,10 @@
 #include "src/common/strutil.h"
 #include "src/common/error.h"
 #include "src/common/maths.h"
+#include "src/common/scopedptr.h"
 #include "src/common/readstream.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memreader.h"
 #include "src/common/encoding.h"
 #include "src/common/filepath.h"
 #include "src/common/xml.h"
@@ -273,7 +276,7 @@ ModelNode_DragonAge::~ModelNode_DragonAge() {
 }
 
 // .--- Vertex value reading helpers
-void ModelNode_DragonAge::read2Float32(Common::ReadStream &stream, MeshDeclType type, float *&f) {
+void ModelNode_DragonAge::read2Float32(Common::MemoryReader &stream, MeshDeclType type, float *&f) {
 	switch (type) {
 		case kMeshDeclTypeFloat32_2:
 		case kMeshDeclTypeFloat32_3:
@@ -321,7 +324,7 @@ void ModelNode_DragonAge::read2Float32(Common::ReadStream &stream, MeshDeclType
 	}
 }
 
-void ModelNode_DragonAge::read3Float32(Common::ReadStream &stream, MeshDeclType type, float *&f) {
+void ModelNode_DragonAge::read3Float32(Common::MemoryReader &stream, MeshDeclType type, float *&f) {
 	switch (type) {
 		case kMeshDeclTypeFloat32_3:
 		case kMeshDeclTypeFloat32_4:
@@ -397,7 +400,7 @@ void ModelNode_DragonAge::read3Float32(Common::ReadStream &stream, MeshDeclType
 	}
 }
 
-void ModelNode_DragonAge::read4Float32(Common::ReadStream &stream, MeshDeclType type, float *&f) {
+void ModelNode_DragonAge::read4Float32(Common::MemoryReader &stream, MeshDeclType type, float *&f) {
 	switch (type) {
 		case kMeshDeclTypeFloat32_3:
 			*f++ = stream.readIEEEFloatLE();
@@ -625,9 +628,10 @@ void ModelNode_DragonAge::createIndexBuffer(const GFF4Struct &meshChunk,
 	const uint32 startIndex = meshChunk.getUint(kGFF4MeshChunkStartIndex);
 	indexData.skip(startIndex * 2);
 
-	uint16 *indices = reinterpret_cast<uint16 *>(_mesh->data->indexBuffer.getData());
-	while (indexCount-- > 0)
-		*indices++ = indexData.readUint16LE();
+	Common::ScopedPtr<Common::MemoryReadStream> indexStream(indexData.readStream(indexCount * 2));
+	Common::MemoryReader indices(*indexStream);
+
+	indices.readUint16LE(reinterpret_cast<uint16 *>(_mesh->data->indexBuffer.getData()), indexCount);
 }
 
 void ModelNode_DragonAge::createVertexBuffer(const GFF4Struct &meshChunk,
@@ -666,28 +670,34 @@ void ModelNode_DragonAge::createVertexBuffer(const GFF4Struct &meshChunk,
 
 	_mesh->data->vertexBuffer.setVertexDeclInterleave(vertexCount, vertexDecl);
 
+	// Pull all vertices of this chunk into memory in one go, then decode them from there
+	vertexData.seek(vertexPos + vertexOffset);
+
+	Common::ScopedPtr<Common::MemoryReadStream> vertexStream(vertexData.readStream(vertexCount * vertexSize));
+	Common::MemoryReader vertices(*vertexStream);
+
 	float *vData = reinterpret_cast<float *>(_mesh->data->vertexBuffer.getData());
 	for (uint32 v = 0; v < vertexCount; v++) {
 
 		for (MeshDeclarations::const_iterator d = meshDecl.begin(); d != meshDecl.end(); ++d) {
-			vertexData.seek(vertexPos + vertexOffset + v * vertexSize + d->offset);
+			vertices.seek(v * vertexSize + d->offset);
 
 			try {
 				switch (d->use) {
 					case kMeshDeclUsePosition:
-						read3Float32(vertexData, d->type, vData);
+						read3Float32(vertices, d->type, vData);
 						break;
 
 					case kMeshDeclUseNormal:
-						read3Float32(vertexData, d->type, vData);
+						read3Float32(vertices, d->type, vData);
 						break;
 
 					case kMeshDeclUseTexCoord:
-						read2Float32(vertexData, d->type, vData);
+						read2Float32(vertices, d->type, vData);
 						break;
 
 					case kMeshDeclUseColor:
-						read4Float32(vertexData, d->type, vData);
+						read4Float32(vertices, d->type, vData);
 						vData[-1] = 0xFF; // WORKAROUND: Shader side-stepping
 						break;
 
@@ -34,6 +34,7 @@
 
 namespace Common {
 	class SeekableReadStream;
+	class MemoryReader;
 }
 
 namespace Graphics {
@@ -187,9 +188,9 @@ private:
 	void fixTexturesAlpha(const std::vector<Common::UString> &textures);
 	void fixTexturesHair (const std::vector<Common::UString> &textures);
 
-	static void read2Float32(Common::ReadStream &stream, MeshDeclType type, float *&f);
-	static void read3Float32(Common::ReadStream &stream, MeshDeclType type, float *&f);
-	static void read4Float32(Common::ReadStream &stream, MeshDeclType type, float *&f);
+	static void read2Float32(Common::MemoryReader &stream, MeshDeclType type, float *&f);
+	static void read3Float32(Common::MemoryReader &stream, MeshDeclType type, float *&f);
+	static void read4Float32(Common::MemoryReader &stream, MeshDeclType type, float *&f);
 };
 
 } // End of namespace Aurora
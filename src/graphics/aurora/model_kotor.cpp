@@ -29,6 +29,8 @@
 #include "src/common/error.h"
 #include "src/common/maths.h"
 #include "src/common/readstream.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memreader.h"
 #include "src/common/encoding.h"
 
 #include "src/aurora/types.h"
@@ -41,6 +43,9 @@
 // Disable the "unused variable" warnings while most stuff is still stubbed
 IGNORE_UNUSED_VARIABLES
 
+/** The node list of a KotOR model rarely needs more than one block of this size. */
+static const size_t kArenaBlockSize = 4 * 1024;
+
 static const int kNodeFlagHasHeader    = 0x0001;
 static const int kNodeFlagHasLight     = 0x0002;
 static const int kNodeFlagHasEmitter   = 0x0004;
@@ -107,13 +112,14 @@ namespace Aurora {
 
 Model_KotOR::ParserContext::ParserContext(const Common::UString &name,
                                           const Common::UString &t, bool k2) :
-	mdl(0), mdx(0), state(0), texture(t), kotor2(k2) {
+	mdl(0), mdx(0), state(0), arena(kArenaBlockSize), nodes(NodeList::allocator_type(arena)),
+	texture(t), kotor2(k2) {
 
 	try {
 
-		if (!(mdl = ResMan.getResource(name, ::Aurora::kFileTypeMDL)))
+		if (!(mdl = Common::toMemoryReadStream(ResMan.getResource(name, ::Aurora::kFileTypeMDL))))
 			throw Common::Exception("No such MDL \"%s\"", name.c_str());
-		if (!(mdx = ResMan.getResource(name, ::Aurora::kFileTypeMDX)))
+		if (!(mdx = Common::toMemoryReadStream(ResMan.getResource(name, ::Aurora::kFileTypeMDX))))
 			throw Common::Exception("No such MDX \"%s\"", name.c_str());
 
 	} catch (...) {
@@ -131,7 +137,7 @@ Model_KotOR::ParserContext::~ParserContext() {
 }
 
 void Model_KotOR::ParserContext::clear() {
-	for (std::list<ModelNode_KotOR *>::iterator n = nodes.begin(); n != nodes.end(); ++n)
+	for (NodeList::iterator n = nodes.begin(); n != nodes.end(); ++n)
 		delete *n;
 	nodes.clear();
 
@@ -296,7 +302,7 @@ bool Model_KotOR::readAnim(ParserContext &ctx, uint32 offset) {
 
 	_animationMap.insert(std::make_pair(ctx.state->name, anim));
 
-	for (std::list<ModelNode_KotOR *>::iterator n = ctx.nodes.begin(); n != ctx.nodes.end(); ++n) {
+	for (Model_KotOR::ParserContext::NodeList::iterator n = ctx.nodes.begin(); n != ctx.nodes.end(); ++n) {
 		AnimNode *animnode = new AnimNode(*n);
 
 		anim->addAnimNode(animnode);
@@ -307,10 +313,12 @@ bool Model_KotOR::readAnim(ParserContext &ctx, uint32 offset) {
 
 void Model_KotOR::loadSuperModel(ModelCache *modelCache, bool kotor2) {
 	if (!_superModelName.empty() && _superModelName != "NULL") {
+		const ::Aurora::ResRef superModelName(_superModelName);
+
 		bool foundInCache = false;
 
 		if (modelCache) {
-			ModelCache::iterator super = modelCache->find(_superModelName);
+			ModelCache::iterator super = modelCache->find(superModelName);
 			if (super != modelCache->end()) {
 				_superModel = super->second;
 
@@ -322,7 +330,7 @@ void Model_KotOR::loadSuperModel(ModelCache *modelCache, bool kotor2) {
 			_superModel = new Model_KotOR(_superModelName, kotor2, _type, "", modelCache);
 
 		if (modelCache && !foundInCache)
-			modelCache->insert(std::make_pair(_superModelName, _superModel));
+			modelCache->insert(std::make_pair(superModelName, _superModel));
 	}
 }
 
@@ -354,7 +362,7 @@ void Model_KotOR::addState(ParserContext &ctx) {
 		return;
 	}
 
-	for (std::list<ModelNode_KotOR *>::iterator n = ctx.nodes.begin();
+	for (Model_KotOR::ParserContext::NodeList::iterator n = ctx.nodes.begin();
 	     n != ctx.nodes.end(); ++n) {
 
 		ctx.state->nodeList.push_back(*n);
@@ -606,26 +614,26 @@ void ModelNode_KotOR::readMesh(Model_KotOR::ParserContext &ctx) {
 
 	_mesh->data->vertexBuffer.setVertexDeclInterleave(vertexCount, vertexDecl);
 
+	Common::MemoryReader mdx(*ctx.mdx);
+
 	float *v = reinterpret_cast<float *>(_mesh->data->vertexBuffer.getData());
 	for (uint32 i = 0; i < vertexCount; i++) {
 		// Position
-		ctx.mdx->seek(offNodeData + i * mdxStructSize);
-		*v++ = ctx.mdx->readIEEEFloatLE();
-		*v++ = ctx.mdx->readIEEEFloatLE();
-		*v++ = ctx.mdx->readIEEEFloatLE();
+		mdx.seek(offNodeData + i * mdxStructSize);
+		mdx.readIEEEFloatLE(v, 3);
+		v += 3;
 
 		// Normal
-		//ctx.mdx->seek(offNodeData + i * mdxStructSize + offNormals);
-		*v++ = ctx.mdx->readIEEEFloatLE();
-		*v++ = ctx.mdx->readIEEEFloatLE();
-		*v++ = ctx.mdx->readIEEEFloatLE();
+		//mdx.seek(offNodeData + i * mdxStructSize + offNormals);
+		mdx.readIEEEFloatLE(v, 3);
+		v += 3;
 
 		// TexCoords
 		for (uint16 t = 0; t < textureCount; t++) {
 			if (offUV[t] != 0xFFFFFFFF) {
-				ctx.mdx->seek(offNodeData + i * mdxStructSize + offUV[t]);
-				*v++ = ctx.mdx->readIEEEFloatLE();
-				*v++ = ctx.mdx->readIEEEFloatLE();
+				mdx.seek(offNodeData + i * mdxStructSize + offUV[t]);
+				mdx.readIEEEFloatLE(v, 2);
+				v += 2;
 			} else {
 				*v++ = 0.0f;
 				*v++ = 0.0f;
@@ -639,13 +647,13 @@ void ModelNode_KotOR::readMesh(Model_KotOR::ParserContext &ctx) {
 	ctx.mdl->seek(ctx.offModelData + offOffVerts);
 	uint32 offVerts = ctx.mdl->readUint32LE();
 
-	ctx.mdl->seek(ctx.offModelData + offVerts);
-
 	_mesh->data->indexBuffer.setSize(facesCount * 3, sizeof(uint16), GL_UNSIGNED_SHORT);
 
+	Common::MemoryReader mdl(*ctx.mdl);
+	mdl.seek(ctx.offModelData + offVerts);
+
 	uint16 *f = reinterpret_cast<uint16 *>(_mesh->data->indexBuffer.getData());
-	for (uint32 i = 0; i < facesCount * 3; i++)
-		f[i] = ctx.mdl->readUint16LE();
+	mdl.readUint16LE(f, facesCount * 3);
 
 	createBound();
 
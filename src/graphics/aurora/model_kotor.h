@@ -25,11 +25,14 @@
 #ifndef GRAPHICS_AURORA_MODEL_KOTOR_H
 #define GRAPHICS_AURORA_MODEL_KOTOR_H
 
+#include "src/common/arena.h"
+
 #include "src/graphics/aurora/model.h"
 #include "src/graphics/aurora/modelnode.h"
 
 namespace Common {
 	class SeekableReadStream;
+	class MemoryReadStream;
 }
 
 namespace Graphics {
@@ -47,12 +50,16 @@ public:
 
 private:
 	struct ParserContext {
-		Common::SeekableReadStream *mdl;
-		Common::SeekableReadStream *mdx;
+		Common::MemoryReadStream *mdl;
+		Common::MemoryReadStream *mdx;
 
 		State *state;
 
-		std::list<ModelNode_KotOR *> nodes;
+		typedef std::list<ModelNode_KotOR *, Common::ArenaAllocator<ModelNode_KotOR *> > NodeList;
+
+		Common::MemoryArena arena; ///< Memory for the node list, freed with the context.
+
+		NodeList nodes;
 
 		Common::UString texture;
 
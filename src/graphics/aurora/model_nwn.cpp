@@ -29,6 +29,7 @@
  */
 
 #include <cassert>
+#include <algorithm>
 
 #include <boost/unordered_set.hpp>
 
@@ -37,6 +38,8 @@
 #include "src/common/maths.h"
 #include "src/common/debug.h"
 #include "src/common/readstream.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memreader.h"
 #include "src/common/strutil.h"
 #include "src/common/encoding.h"
 #include "src/common/streamtokenizer.h"
@@ -52,6 +55,9 @@
 // Disable the "unused variable" warnings while most stuff is still stubbed
 IGNORE_UNUSED_VARIABLES
 
+/** Block size of the parser context arena, which only holds the node list. */
+static const size_t kArenaBlockSize = 4 * 1024;
+
 using Common::kDebugGraphics;
 
 static const int kNodeFlagHasHeader    = 0x00000001;
@@ -120,9 +126,9 @@ namespace Aurora {
 
 Model_NWN::ParserContext::ParserContext(const Common::UString &name,
                                         const Common::UString &t) :
-	mdl(0), state(0), texture(t) {
+	mdl(0), state(0), arena(kArenaBlockSize), nodes(NodeList::allocator_type(arena)), texture(t) {
 
-	mdl = ResMan.getResource(name, ::Aurora::kFileTypeMDL);
+	mdl = Common::toMemoryReadStream(ResMan.getResource(name, ::Aurora::kFileTypeMDL));
 	if (!mdl)
 		throw Common::Exception("No such MDL \"%s\"", name.c_str());
 
@@ -147,7 +153,7 @@ Model_NWN::ParserContext::~ParserContext() {
 }
 
 void Model_NWN::ParserContext::clear() {
-	for (std::list<ModelNode *>::iterator n = nodes.begin(); n != nodes.end(); ++n)
+	for (NodeList::iterator n = nodes.begin(); n != nodes.end(); ++n)
 		delete *n;
 	nodes.clear();
 
@@ -163,7 +169,7 @@ bool Model_NWN::ParserContext::findNode(const Common::UString &name,
 	if (name.empty() || (name == "NULL"))
 		return true;
 
-	for (std::list<ModelNode *>::const_iterator n = nodes.begin();
+	for (NodeList::const_iterator n = nodes.begin();
 	     n != nodes.end(); ++n) {
 
 		if ((*n)->getName() == name) {
@@ -392,7 +398,7 @@ void Model_NWN::addState(ParserContext &ctx) {
 		return;
 	}
 
-	for (std::list<ModelNode *>::iterator n = ctx.nodes.begin();
+	for (Model_NWN::ParserContext::NodeList::iterator n = ctx.nodes.begin();
 	     n != ctx.nodes.end(); ++n) {
 
 		ctx.state->nodeList.push_back(*n);
@@ -462,7 +468,7 @@ void Model_NWN::readAnimBinary(ParserContext &ctx, uint32 offset) {
 	_animationMap.insert(std::make_pair(ctx.state->name, anim));
 	debugC(kDebugGraphics, 4, "Loaded animation \"%s\" in model \"%s\"", ctx.state->name.c_str(), _name.c_str());
 
-	for (std::list<ModelNode *>::iterator n = ctx.nodes.begin();
+	for (Model_NWN::ParserContext::NodeList::iterator n = ctx.nodes.begin();
 	     n != ctx.nodes.end(); ++n) {
 		AnimNode *animnode = new AnimNode(*n);
 		anim->addAnimNode(animnode);
@@ -472,10 +478,12 @@ void Model_NWN::readAnimBinary(ParserContext &ctx, uint32 offset) {
 
 void Model_NWN::loadSuperModel(ModelCache *modelCache) {
 	if (!_superModelName.empty() && _superModelName != "NULL") {
+		const ::Aurora::ResRef superModelName(_superModelName);
+
 		bool foundInCache = false;
 
 		if (modelCache) {
-			ModelCache::iterator super = modelCache->find(_superModelName);
+			ModelCache::iterator super = modelCache->find(superModelName);
 			if (super != modelCache->end()) {
 				_superModel = super->second;
 
@@ -487,7 +495,7 @@ void Model_NWN::loadSuperModel(ModelCache *modelCache) {
 			_superModel = new Model_NWN(_superModelName, _type, "", modelCache);
 
 		if (modelCache && !foundInCache)
-			modelCache->insert(std::make_pair(_superModelName, _superModel));
+			modelCache->insert(std::make_pair(superModelName, _superModel));
 	}
 }
 
@@ -654,7 +662,7 @@ void ModelNode_NWN_Binary::checkDuplicateNode(Model_NWN::ParserContext &ctx, Mod
 	Common::UString name = ModelNode_NWN_Binary::loadName(ctx);
 
 	ModelNode_NWN_Binary *oldChildNode = 0;
-	for (std::list<ModelNode *>::iterator n = ctx.nodes.begin(); n != ctx.nodes.end(); ++n) {
+	for (Model_NWN::ParserContext::NodeList::iterator n = ctx.nodes.begin(); n != ctx.nodes.end(); ++n) {
 		if ((*n)->getName().equalsIgnoreCase(name)) {
 			oldChildNode = dynamic_cast<ModelNode_NWN_Binary *>(*n);
 			break;
@@ -811,6 +819,9 @@ void ModelNode_NWN_Binary::readMesh(Model_NWN::ParserContext &ctx) {
 
 	size_t endPos = ctx.mdl->pos();
 
+	// The bulk mesh data is read straight out of memory
+	Common::MemoryReader mdl(*ctx.mdl);
+
 
 	// Read vertices
 
@@ -818,9 +829,8 @@ void ModelNode_NWN_Binary::readMesh(Model_NWN::ParserContext &ctx) {
 	vertices.resize(vertexCount * 3);
 
 	assert (vertexOffset != 0xFFFFFFFF);
-	ctx.mdl->seek(ctx.offRawData + vertexOffset);
-	for (std::vector<float>::iterator v = vertices.begin(); v != vertices.end(); ++v)
-		*v = ctx.mdl->readIEEEFloatLE();
+	mdl.seek(ctx.offRawData + vertexOffset);
+	mdl.readIEEEFloatLE(&vertices[0], vertices.size());
 
 	// Read faces
 
@@ -831,21 +841,17 @@ void ModelNode_NWN_Binary::readMesh(Model_NWN::ParserContext &ctx) {
 	vFaces.resize(vertexCount);
 
 	assert (facesOffset != 0xFFFFFFFF);
-	ctx.mdl->seek(ctx.offModelData + facesOffset);
+	mdl.seek(ctx.offModelData + facesOffset);
 	for (std::vector<Face>::iterator f = faces.begin(); f != faces.end(); ++f) {
-		f->normal[0] = ctx.mdl->readIEEEFloatLE();
-		f->normal[1] = ctx.mdl->readIEEEFloatLE();
-		f->normal[2] = ctx.mdl->readIEEEFloatLE();
+		mdl.readIEEEFloatLE(f->normal, 3);
 
-		ctx.mdl->skip(4); // Plane distance
+		mdl.skip(4); // Plane distance
 
-		f->smooth = ctx.mdl->readUint32LE();
+		f->smooth = mdl.readUint32LE();
 
-		ctx.mdl->skip(3 * 2); // Adjacent face number or -1
+		mdl.skip(3 * 2); // Adjacent face number or -1
 
-		f->index[0] = ctx.mdl->readUint16LE();
-		f->index[1] = ctx.mdl->readUint16LE();
-		f->index[2] = ctx.mdl->readUint16LE();
+		mdl.readUint16LE(f->index, 3);
 
 		// Assign this face to all vertices belonging to this face
 		for (int i = 0; i < 3; i++) {
@@ -865,15 +871,13 @@ void ModelNode_NWN_Binary::readMesh(Model_NWN::ParserContext &ctx) {
 	texCoords.resize(textureCount * vertexCount * 2);
 
 	for (uint16 t = 0; t < textureCount; t++) {
-		const bool hasTexture = textureVertexOffset[t] != 0xFFFFFFFF;
-		if (hasTexture)
-			ctx.mdl->seek(ctx.offRawData + textureVertexOffset[t]);
-
 		float *v = &texCoords[t * vertexCount * 2];
-		for (uint32 i = 0; i < vertexCount; i++) {
-			*v++ = hasTexture ? ctx.mdl->readIEEEFloatLE() : 0.0f;
-			*v++ = hasTexture ? ctx.mdl->readIEEEFloatLE() : 0.0f;
-		}
+
+		if (textureVertexOffset[t] != 0xFFFFFFFF) {
+			mdl.seek(ctx.offRawData + textureVertexOffset[t]);
+			mdl.readIEEEFloatLE(v, vertexCount * 2);
+		} else
+			std::fill(v, v + vertexCount * 2, 0.0f);
 	}
 
 	// Create vertex buffer
@@ -25,11 +25,13 @@
 #ifndef GRAPHICS_AURORA_MODEL_NWN_H
 #define GRAPHICS_AURORA_MODEL_NWN_H
 
+#include "src/common/arena.h"
+
 #include "src/graphics/aurora/model.h"
 #include "src/graphics/aurora/modelnode.h"
 
 namespace Common {
-	class SeekableReadStream;
+	class MemoryReadStream;
 	class StreamTokenizer;
 }
 
@@ -49,13 +51,17 @@ public:
 
 private:
 	struct ParserContext {
-		Common::SeekableReadStream *mdl;
+		Common::MemoryReadStream *mdl;
 
 		State *state;
 
 		bool isASCII;
 
-		std::list<ModelNode *> nodes;
+		typedef std::list<ModelNode *, Common::ArenaAllocator<ModelNode *> > NodeList;
+
+		Common::MemoryArena arena; ///< Backs the node list.
+
+		NodeList nodes;
 
 		Common::UString texture;
 
@@ -33,6 +33,8 @@
 #include "src/common/error.h"
 #include "src/common/maths.h"
 #include "src/common/readstream.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memreader.h"
 #include "src/common/encoding.h"
 
 #include "src/aurora/types.h"
@@ -43,6 +45,9 @@
 // Disable the "unused variable" warnings while most stuff is still stubbed
 IGNORE_UNUSED_VARIABLES
 
+/** Block size for the per-load data in the parser context. */
+static const size_t kArenaBlockSize = 4 * 1024;
+
 namespace Graphics {
 
 namespace Aurora {
@@ -78,8 +83,9 @@ enum NodeTrimeshControllerType {
 };
 
 
-Model_Witcher::ParserContext::ParserContext(const Common::UString &name) : mdb(0), state(0) {
-	mdb = ResMan.getResource(name, ::Aurora::kFileTypeMDB);
+Model_Witcher::ParserContext::ParserContext(const Common::UString &name) :
+	mdb(0), state(0), arena(kArenaBlockSize), nodes(NodeList::allocator_type(arena)) {
+	mdb = Common::toMemoryReadStream(ResMan.getResource(name, ::Aurora::kFileTypeMDB));
 	if (!mdb)
 		throw Common::Exception("No such MDB \"%s\"", name.c_str());
 }
@@ -91,7 +97,7 @@ Model_Witcher::ParserContext::~ParserContext() {
 }
 
 void Model_Witcher::ParserContext::clear() {
-	for (std::list<ModelNode_Witcher *>::iterator n = nodes.begin(); n != nodes.end(); ++n)
+	for (NodeList::iterator n = nodes.begin(); n != nodes.end(); ++n)
 		delete *n;
 	nodes.clear();
 
@@ -206,7 +212,7 @@ void Model_Witcher::addState(ParserContext &ctx) {
 		return;
 	}
 
-	for (std::list<ModelNode_Witcher *>::iterator n = ctx.nodes.begin();
+	for (Model_Witcher::ParserContext::NodeList::iterator n = ctx.nodes.begin();
 	     n != ctx.nodes.end(); ++n) {
 
 		ctx.state->nodeList.push_back(*n);
@@ -479,39 +485,26 @@ void ModelNode_Witcher::readMesh(Model_Witcher::ParserContext &ctx) {
 
 	_mesh->data->vertexBuffer.setVertexDeclLinear(vertexCount, vertexDecl);
 
+	// The bulk mesh data is read straight out of memory
+	Common::MemoryReader mdb(*ctx.mdb);
+
 	// Read vertex position
-	ctx.mdb->seek(ctx.offRawData + vertexOffset);
+	mdb.seek(ctx.offRawData + vertexOffset);
 	float *v = reinterpret_cast<float *>(_mesh->data->vertexBuffer.getData(0));
-	for (uint32 i = 0; i < vertexCount; i++) {
-		*v++ = ctx.mdb->readIEEEFloatLE();
-		*v++ = ctx.mdb->readIEEEFloatLE();
-		*v++ = ctx.mdb->readIEEEFloatLE();
-	}
+	mdb.readIEEEFloatLE(v, vertexCount * 3);
 
 	// Read vertex normals
 	assert(normalsCount == vertexCount);
-	ctx.mdb->seek(ctx.offRawData + normalsOffset);
+	mdb.seek(ctx.offRawData + normalsOffset);
 	v = reinterpret_cast<float *>(_mesh->data->vertexBuffer.getData(1));
-	for (uint32 i = 0; i < normalsCount; i++) {
-		*v++ = ctx.mdb->readIEEEFloatLE();
-		*v++ = ctx.mdb->readIEEEFloatLE();
-		*v++ = ctx.mdb->readIEEEFloatLE();
-	}
+	mdb.readIEEEFloatLE(v, normalsCount * 3);
 
 	// Read texture coordinates
 	for (uint t = 0; t < texCount; t++) {
 
-		ctx.mdb->seek(ctx.offRawData + tVertsOffset[t]);
+		mdb.seek(ctx.offRawData + tVertsOffset[t]);
 		v = reinterpret_cast<float *>(_mesh->data->vertexBuffer.getData(2 + t));
-		for (uint32 i = 0; i < tVertsCount[t]; i++) {
-			if (i < tVertsCount[t]) {
-				*v++ = ctx.mdb->readIEEEFloatLE();
-				*v++ = ctx.mdb->readIEEEFloatLE();
-			} else {
-				*v++ = 0.0f;
-				*v++ = 0.0f;
-			}
-		}
+		mdb.readIEEEFloatLE(v, tVertsCount[t] * 2);
 	}
 
 
@@ -519,21 +512,19 @@ void ModelNode_Witcher::readMesh(Model_Witcher::ParserContext &ctx) {
 
 	_mesh->data->indexBuffer.setSize(facesCount * 3, sizeof(uint32), GL_UNSIGNED_INT);
 
-	ctx.mdb->seek(ctx.offRawData + facesOffset);
+	mdb.seek(ctx.offRawData + facesOffset);
 	uint32 *f = reinterpret_cast<uint32 *>(_mesh->data->indexBuffer.getData());
-	for (uint32 i = 0; i < facesCount; i++) {
-		ctx.mdb->skip(4 * 4 + 4);
+	for (uint32 i = 0; i < facesCount; i++, f += 3) {
+		mdb.skip(4 * 4 + 4);
 
 		if (ctx.fileVersion == 133)
-			ctx.mdb->skip(3 * 4);
+			mdb.skip(3 * 4);
 
 		// Vertex indices
-		*f++ = ctx.mdb->readUint32LE();
-		*f++ = ctx.mdb->readUint32LE();
-		*f++ = ctx.mdb->readUint32LE();
+		mdb.readUint32LE(f, 3);
 
 		if (ctx.fileVersion == 133)
-			ctx.mdb->skip(4);
+			mdb.skip(4);
 	}
 
 	createBound();
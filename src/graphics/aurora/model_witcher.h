@@ -25,11 +25,13 @@
 #ifndef GRAPHICS_AURORA_MODEL_WITCHER_H
 #define GRAPHICS_AURORA_MODEL_WITCHER_H
 
+#include "src/common/arena.h"
+
 #include "src/graphics/aurora/model.h"
 #include "src/graphics/aurora/modelnode.h"
 
 namespace Common {
-	class SeekableReadStream;
+	class MemoryReadStream;
 }
 
 namespace Graphics {
@@ -46,11 +48,15 @@ public:
 
 private:
 	struct ParserContext {
-		Common::SeekableReadStream *mdb;
+		Common::MemoryReadStream *mdb;
 
 		State *state;
 
-		std::list<ModelNode_Witcher *> nodes;
+		typedef std::list<ModelNode_Witcher *, Common::ArenaAllocator<ModelNode_Witcher *> > NodeList;
+
+		Common::MemoryArena arena; ///< Holds the data only needed while loading.
+
+		NodeList nodes;
 
 		uint16 fileVersion;
 
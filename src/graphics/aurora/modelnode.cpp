@@ -29,6 +29,8 @@
 #include "src/common/maths.h"
 #include "src/common/error.h"
 
+#include "src/aurora/resref.h"
+
 #include "src/graphics/camera.h"
 
 #include "src/graphics/images/txi.h"
@@ -277,7 +279,7 @@ void ModelNode::loadTextures(const std::vector<Common::UString> &textures) {
 		try {
 
 			if (!textures[t].empty() && (textures[t] != "NULL")) {
-				_mesh->data->textures[t] = TextureMan.get(textures[t]);
+				_mesh->data->textures[t] = TextureMan.get(::Aurora::ResRef(textures[t]));
 				if (_mesh->data->textures[t].empty())
 					continue;
 
@@ -306,7 +308,7 @@ void ModelNode::loadTextures(const std::vector<Common::UString> &textures) {
 	envMap.trim();
 	if (!envMap.empty()) {
 		try {
-			_mesh->data->envMap = TextureMan.get(envMap);
+			_mesh->data->envMap = TextureMan.get(::Aurora::ResRef(envMap));
 		} catch (...) {
 			Common::exceptionDispatcherWarning();
 		}
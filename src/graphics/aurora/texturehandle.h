@@ -30,6 +30,8 @@
 #include "src/common/types.h"
 #include "src/common/ustring.h"
 
+#include "src/aurora/resref.h"
+
 namespace Graphics {
 
 namespace Aurora {
@@ -41,11 +43,14 @@ struct ManagedTexture {
 	Texture *texture;
 	uint32 referenceCount;
 
+	::Aurora::ResRef resRef; ///< The ResRef this texture was requested by, if any.
+
 	ManagedTexture(Texture *t);
 	~ManagedTexture();
 };
 
-typedef std::map<Common::UString, ManagedTexture *> TextureMap;
+/** Managed textures by name. Like resource names, texture names are case-insensitive. */
+typedef std::map<Common::UString, ManagedTexture *, Common::UString::iless> TextureMap;
 
 /** A handle to a texture. */
 class TextureHandle {
@@ -95,6 +95,7 @@ void TextureManager::clear() {
 	for (TextureMap::iterator t = _textures.begin(); t != _textures.end(); ++t)
 		delete t->second;
 	_textures.clear();
+	_resRefTextures.clear();
 
 	_recordNewTextures = false;
 	_newTextureNames.clear();
@@ -104,6 +105,7 @@ void TextureManager::addBogusTexture(const Common::UString &name) {
 	Common::StackLock lock(_mutex);
 
 	_bogusTextures.insert(name);
+	_resRefTextures.erase(::Aurora::ResRef(name));
 }
 
 bool TextureManager::hasTexture(const Common::UString &name) {
@@ -117,6 +119,15 @@ bool TextureManager::hasTexture(const Common::UString &name) {
 	return false;
 }
 
+bool TextureManager::hasTexture(const ::Aurora::ResRef &name) {
+	Common::StackLock lock(_mutex);
+
+	if (_resRefTextures.find(name) != _resRefTextures.end())
+		return true;
+
+	return hasTexture(name.getString());
+}
+
 TextureHandle TextureManager::add(Texture *texture, Common::UString name) {
 	Common::StackLock lock(_mutex);
 
@@ -169,6 +180,23 @@ TextureHandle TextureManager::get(Common::UString name) {
 	return TextureHandle(texture);
 }
 
+TextureHandle TextureManager::get(const ::Aurora::ResRef &name) {
+	Common::StackLock lock(_mutex);
+
+	ResRefMap::iterator texture = _resRefTextures.find(name);
+	if (texture != _resRefTextures.end()) {
+		if (_recordNewTextures)
+			_newTextureNames.push_back(texture->second->first);
+
+		return TextureHandle(texture->second);
+	}
+
+	TextureHandle handle = get(name.getString());
+	addResRef(name, handle);
+
+	return handle;
+}
+
 TextureHandle TextureManager::getIfExist(const Common::UString &name) {
 	Common::StackLock lock(_mutex);
 
@@ -182,6 +210,28 @@ TextureHandle TextureManager::getIfExist(const Common::UString &name) {
 	return TextureHandle();
 }
 
+TextureHandle TextureManager::getIfExist(const ::Aurora::ResRef &name) {
+	Common::StackLock lock(_mutex);
+
+	ResRefMap::iterator texture = _resRefTextures.find(name);
+	if (texture != _resRefTextures.end())
+		return TextureHandle(texture->second);
+
+	TextureHandle handle = getIfExist(name.getString());
+	addResRef(name, handle);
+
+	return handle;
+}
+
+void TextureManager::addResRef(const ::Aurora::ResRef &name, const TextureHandle &texture) {
+	// Dynamic textures are managed under a unique name each, and are never shared
+	if (texture._empty || texture._it->second->texture->isDynamic())
+		return;
+
+	texture._it->second->resRef = name;
+	_resRefTextures.insert(std::make_pair(name, texture._it));
+}
+
 void TextureManager::startRecordNewTextures() {
 	Common::StackLock lock(_mutex);
 
@@ -213,6 +263,9 @@ void TextureManager::release(TextureHandle &texture) {
 
 	if (!texture._empty && (texture._it != _textures.end())) {
 		if (--texture._it->second->referenceCount == 0) {
+			if (!texture._it->second->resRef.empty())
+				_resRefTextures.erase(texture._it->second->resRef);
+
 			delete texture._it->second;
 			_textures.erase(texture._it);
 		}
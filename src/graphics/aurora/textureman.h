@@ -28,11 +28,15 @@
 #include <set>
 #include <list>
 
+#include <boost/unordered_map.hpp>
+
 #include "src/common/types.h"
 #include "src/common/singleton.h"
 #include "src/common/mutex.h"
 #include "src/common/ustring.h"
 
+#include "src/aurora/resref.h"
+
 #include "src/graphics/aurora/texturehandle.h"
 
 namespace Graphics {
@@ -63,13 +67,23 @@ public:
 
 	/** Does this named managed texture exist? */
 	bool hasTexture(const Common::UString &name);
+	/** Does this named managed texture exist? */
+	bool hasTexture(const ::Aurora::ResRef &name);
 
 	/** Add this texture to the TextureManager. If name is empty, generate a random one. */
 	TextureHandle add(Texture *texture, Common::UString name = "");
 	/** Retrieve this named texture, loading it if it's not yet managed. */
 	TextureHandle get(Common::UString name);
+	/** Retrieve this named texture, loading it if it's not yet managed.
+	 *
+	 *  Textures requested by ResRef are remembered by it, so that the next
+	 *  request for the same ResRef doesn't need to compare any names.
+	 */
+	TextureHandle get(const ::Aurora::ResRef &name);
 	/** Retrieve this named texture, returning an empty handle if it's not managed. */
 	TextureHandle getIfExist(const Common::UString &name);
+	/** Retrieve this named texture, returning an empty handle if it's not managed. */
+	TextureHandle getIfExist(const ::Aurora::ResRef &name);
 
 	/** Start recording all names of newly created textures. */
 	void startRecordNewTextures();
@@ -93,15 +107,21 @@ public:
 	// '---
 
 private:
+	typedef boost::unordered_map< ::Aurora::ResRef, TextureMap::iterator > ResRefMap;
+
 	TextureMap _textures;
+	ResRefMap  _resRefTextures; ///< Managed textures already requested by ResRef.
 
-	std::set<Common::UString> _bogusTextures;
+	std::set<Common::UString, Common::UString::iless> _bogusTextures;
 
 	Common::Mutex _mutex;
 
 	bool _recordNewTextures;
 	std::list<Common::UString> _newTextureNames;
 
+	/** Remember this texture under this ResRef. */
+	void addResRef(const ::Aurora::ResRef &name, const TextureHandle &texture);
+
 	void assign(TextureHandle &texture, const TextureHandle &from);
 	void release(TextureHandle &texture);
 
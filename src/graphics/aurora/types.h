@@ -30,6 +30,8 @@
 #include "src/common/ptrmap.h"
 #include "src/common/ustring.h"
 
+#include "src/aurora/resref.h"
+
 #include "src/graphics/types.h"
 
 namespace Graphics {
@@ -50,7 +52,8 @@ class ModelNode;
 class Text;
 class GUIQuad;
 
-typedef Common::PtrMap<Common::UString, class Model, Common::UString::iless> ModelCache;
+/** Loaded super models, by their interned, case-folded name. */
+typedef Common::PtrMap< ::Aurora::ResRef, class Model > ModelCache;
 
 } // End of namespace Aurora
 
@@ -50,7 +50,10 @@
 #include <cstring>
 
 #include "src/common/util.h"
+#include "src/common/scopedptr.h"
 #include "src/common/readstream.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memreader.h"
 #include "src/common/error.h"
 
 #include "src/graphics/images/tga.h"
@@ -78,7 +81,18 @@ void TGA::load(Common::SeekableReadStream &tga) {
 		ImageType imageType;
 		byte pixelDepth, imageDesc;
 		readHeader(tga, imageType, pixelDepth, imageDesc);
-		readData  (tga, imageType, pixelDepth, imageDesc);
+
+		// The pixel data is decoded straight out of memory
+		Common::ScopedPtr<Common::MemoryReadStream> pixelStream;
+
+		const Common::MemoryReadStream *memory = dynamic_cast<const Common::MemoryReadStream *>(&tga);
+		if (!memory) {
+			pixelStream.reset(tga.readStream(tga.size() - tga.pos()));
+			memory = pixelStream.get();
+		}
+
+		Common::MemoryReader pixels(*memory);
+		readData(pixels, imageType, pixelDepth, imageDesc);
 
 	} catch (Common::Exception &e) {
 		e.add("Failed reading TGA file");
@@ -176,7 +190,7 @@ void TGA::readHeader(Common::SeekableReadStream &tga, ImageType &imageType, byte
 	tga.skip(idLength);
 }
 
-void TGA::readData(Common::SeekableReadStream &tga, ImageType imageType, byte pixelDepth, byte imageDesc) {
+void TGA::readData(Common::MemoryReader &tga, ImageType imageType, byte pixelDepth, byte imageDesc) {
 	for (size_t i = 0; i < _layerCount; i++) {
 		if (imageType == kImageTypeTrueColor || imageType == kImageTypeRLETrueColor) {
 			_mipMaps[i]->size = _mipMaps[i]->width * _mipMaps[i]->height;
@@ -235,7 +249,7 @@ void TGA::readData(Common::SeekableReadStream &tga, ImageType imageType, byte pi
 	}
 }
 
-void TGA::readRLE(Common::SeekableReadStream &tga, byte pixelDepth, size_t layer) {
+void TGA::readRLE(Common::MemoryReader &tga, byte pixelDepth, size_t layer) {
 	if (pixelDepth != 24 && pixelDepth != 32)
 		throw Common::Exception("Unhandled RLE depth %d", pixelDepth);
 
@@ -54,6 +54,7 @@
 
 namespace Common {
 	class SeekableReadStream;
+	class MemoryReader;
 }
 
 namespace Graphics {
@@ -78,8 +79,8 @@ private:
 	// Loading helpers
 	void load(Common::SeekableReadStream &tga);
 	void readHeader(Common::SeekableReadStream &tga, ImageType &imageType, byte &pixelDepth, byte &imageDesc);
-	void readData(Common::SeekableReadStream &tga, ImageType imageType, byte pixelDepth, byte imageDesc);
-	void readRLE(Common::SeekableReadStream &tga, byte pixelDepth, size_t layer);
+	void readData(Common::MemoryReader &tga, ImageType imageType, byte pixelDepth, byte imageDesc);
+	void readRLE(Common::MemoryReader &tga, byte pixelDepth, size_t layer);
 
 	bool isSupportedImageType(ImageType type) const;
 };
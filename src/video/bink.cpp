@@ -76,7 +76,7 @@
 #include "src/common/error.h"
 #include "src/common/maths.h"
 #include "src/common/readstream.h"
-#include "src/common/bitstream.h"
+#include "src/common/bitreader.h"
 #include "src/common/huffman.h"
 #include "src/common/rdft.h"
 #include "src/common/dct.h"
@@ -199,8 +199,7 @@ void Bink::processData() {
 			throw Common::Exception("Audio packet too big for the frame");
 
 		if (audioPacketLength >= 4) {
-			size_t audioPacketStart = _bink->pos();
-			size_t audioPacketEnd   = _bink->pos() + audioPacketLength;
+			size_t audioPacketEnd = _bink->pos() + audioPacketLength;
 
 			if (i == _audioTrack) {
 				// Only play one audio track
@@ -208,9 +207,7 @@ void Bink::processData() {
 				//                  Number of samples in bytes
 				audio.sampleCount = _bink->readUint32LE() / (2 * audio.channels);
 
-				audio.bits =
-					new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink.get(),
-					    audioPacketStart + 4, audioPacketEnd), true);
+				audio.bits = readBits(audioPacketLength - 4);
 
 				audioPacket(audio);
 
@@ -224,12 +221,7 @@ void Bink::processData() {
 		}
 	}
 
-	size_t videoPacketStart = _bink->pos();
-	size_t videoPacketEnd   = _bink->pos() + frameSize;
-
-	frame.bits =
-		new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink.get(),
-		    videoPacketStart, videoPacketEnd), true);
+	frame.bits = readBits(frameSize);
 
 	videoPacket(frame);
 
@@ -241,6 +233,15 @@ void Bink::processData() {
 	_curFrame++;
 }
 
+Common::BitReader32LELSB *Bink::readBits(size_t size) {
+	Common::ScopedArray<byte> data(new byte[size]);
+
+	if (_bink->read(data.get(), size) != size)
+		throw Common::Exception(Common::kReadError);
+
+	return new Common::BitReader32LELSB(data.release(), size, true);
+}
+
 void Bink::audioPacket(AudioTrack &audio) {
 	if (_disableAudio)
 		return;
@@ -75,12 +75,12 @@
 
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
+#include "src/common/bitreader.h"
 
 #include "src/video/decoder.h"
 
 namespace Common {
 	class SeekableReadStream;
-	class BitStream;
 	class Huffman;
 
 	class RDFT;
@@ -177,7 +177,7 @@ private:
 
 		uint32 sampleCount;
 
-		Common::BitStream *bits;
+		Common::BitReader32LELSB *bits;
 
 		bool first;
 
@@ -210,7 +210,7 @@ private:
 		uint32 offset;
 		uint32 size;
 
-		Common::BitStream *bits;
+		Common::BitReader32LELSB *bits;
 
 		VideoFrame();
 		~VideoFrame();
@@ -285,6 +285,9 @@ private:
 	/** Initialize the Huffman decoders. */
 	void initHuffman();
 
+	/** Read the next size bytes of the Bink file into a bit reader. */
+	Common::BitReader32LELSB *readBits(size_t size);
+
 	/** Decode an audio packet. */
 	void audioPacket(AudioTrack &audio);
 	/** Decode a video packet. */
@@ -38,6 +38,7 @@
 #include "src/common/platform.h"
 #include "src/common/filepath.h"
 #include "src/common/threads.h"
+#include "src/common/jobs.h"
 #include "src/common/debugman.h"
 #include "src/common/configman.h"
 #include "src/common/xml.h"
@@ -48,6 +49,8 @@
 #include "src/aurora/talkman.h"
 #include "src/aurora/util.h"
 
+#include "src/aurora/nwscript/ncsreg.h"
+
 #include "src/graphics/queueman.h"
 #include "src/graphics/graphics.h"
 
@@ -285,6 +288,9 @@ static void init() {
 	// Init threading system
 	Common::initThreads();
 
+	// Start the job worker threads
+	JobMan.init();
+
 	// Init libxml2
 	Common::initXML();
 
@@ -298,6 +304,10 @@ static void init() {
 }
 
 static void deinit() {
+	// Stop the job worker threads, regardless of whether the subsystems fail to deinit
+	if (Common::initedThreads())
+		JobMan.deinit();
+
 	// Deinit subsystems
 	try {
 		if (Common::initedThreads()) {
@@ -319,6 +329,7 @@ static void deinit() {
 	Aurora::LanguageManager::destroy();
 	Aurora::TalkManager::destroy();
 	Aurora::TwoDARegistry::destroy();
+	Aurora::NWScript::NCSRegistry::destroy();
 	Aurora::ResourceManager::destroy();
 	Aurora::FileTypeManager::destroy();
 
@@ -333,6 +344,7 @@ static void deinit() {
 	Graphics::GraphicsManager::destroy();
 	Graphics::QueueManager::destroy();
 
+	Common::JobManager::destroy();
 	Common::DebugManager::destroy();
 	Common::ConfigManager::destroy();
 }